@@ -0,0 +1,122 @@
+#include "AsyncLog.h"
+#include "MidiEventQueue.h"
+#include <chrono>
+#include <cstdio>
+
+// 静的メンバ変数の定義
+std::atomic<LogLevel> AsyncLog::minLevel{LOG_LEVEL_DEBUG};
+std::atomic<uint32_t> AsyncLog::categoryMask{~0u};
+std::atomic<bool> AsyncLog::running{false};
+std::atomic<uint64_t> AsyncLog::dropped{0};
+std::array<AsyncLog::Slot, AsyncLog::CAPACITY> AsyncLog::slots;
+std::atomic<std::size_t> AsyncLog::enqueuePosition{0};
+std::size_t AsyncLog::dequeuePosition = 0;
+std::thread AsyncLog::writer;
+
+static const char* const CATEGORY_NAMES[NUM_LOG_CATEGORIES] = {"APP", "MIDI", "INPUT", "SYSTEM", "GLITCH", "SESSION", "RENDER"};
+
+void AsyncLog::start() {
+    if (running) return;
+
+    // 書き出しスレッドを起動する前にリングを空にする
+    for (std::size_t i = 0; i < CAPACITY; i++) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    enqueuePosition.store(0, std::memory_order_relaxed);
+    dequeuePosition = 0;
+
+    running.store(true, std::memory_order_release);
+    writer = std::thread(&AsyncLog::writerLoop);
+}
+
+void AsyncLog::stop() {
+    if (!running) return;
+    running.store(false, std::memory_order_release);
+    writer.join();
+
+    // 停止直前に積まれた分
+    while (drainOne()) {}
+    fflush(stdout);
+}
+
+void AsyncLog::setCategoryEnabled(LogCategory category, bool enabled) {
+    if (enabled) {
+        categoryMask.fetch_or(1u << category);
+    } else {
+        categoryMask.fetch_and(~(1u << category));
+    }
+}
+
+void AsyncLog::write(LogLevel level, LogCategory category, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+
+    // 書き出しスレッドがなければその場で書く（起動前・終了後）
+    if (!running.load(std::memory_order_acquire)) {
+        char text[TEXT_SIZE];
+        vsnprintf(text, TEXT_SIZE, format, args);
+        va_end(args);
+        print(level, category, text);
+        fflush(stdout);
+        return;
+    }
+
+    // スロットを確保（満杯なら捨てる）
+    std::size_t position = enqueuePosition.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots[position & (CAPACITY - 1)];
+        std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)position;
+        if (diff == 0) {
+            if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            va_end(args);
+            return;
+        } else {
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->timestampMicros = midiNowMicros();
+    slot->level = level;
+    slot->category = category;
+    vsnprintf(slot->text, TEXT_SIZE, format, args);
+    va_end(args);
+    slot->sequence.store(position + 1, std::memory_order_release);
+}
+
+bool AsyncLog::drainOne() {
+    Slot& slot = slots[dequeuePosition & (CAPACITY - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition + 1) {
+        return false;
+    }
+
+    print(slot.level, slot.category, slot.text);
+    slot.sequence.store(dequeuePosition + CAPACITY, std::memory_order_release);
+    dequeuePosition++;
+    return true;
+}
+
+void AsyncLog::print(LogLevel level, LogCategory category, const char* text) {
+    const char* prefix = level == LOG_LEVEL_ERROR ? "ERROR: " : (level == LOG_LEVEL_WARN ? "WARN: " : "");
+    fprintf(stdout, "[%s] %s%s\n", CATEGORY_NAMES[category], prefix, text);
+}
+
+void AsyncLog::writerLoop() {
+    while (running.load(std::memory_order_acquire)) {
+        bool wrote = false;
+        while (drainOne()) {
+            wrote = true;
+        }
+
+        // 空になったときだけフラッシュ（連続したログは1回の書き込みにまとまる）
+        if (wrote) {
+            fflush(stdout);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+}
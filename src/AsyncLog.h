@@ -0,0 +1,109 @@
+#pragma once
+
+#include "ofMain.h"
+#include <array>
+#include <atomic>
+#include <cstdarg>
+#include <thread>
+
+// ログのレベルとカテゴリ
+enum LogLevel : uint8_t {
+    LOG_LEVEL_DEBUG = 0,   // イベントごとのログ（MIDI・キー入力など）。本番では止める
+    LOG_LEVEL_INFO,        // システム切替・録音再生などの状態変化
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_ERROR
+};
+
+enum LogCategory : uint8_t {
+    LOG_CATEGORY_APP = 0,
+    LOG_CATEGORY_MIDI,
+    LOG_CATEGORY_INPUT,
+    LOG_CATEGORY_SYSTEM,
+    LOG_CATEGORY_GLITCH,
+    LOG_CATEGORY_SESSION,
+    LOG_CATEGORY_RENDER,
+    NUM_LOG_CATEGORIES
+};
+
+// 非同期ロガー
+// - 呼び出し側は事前確保したリングのスロットにprintf形式で書くだけ（ロック・確保・フラッシュなし）
+// - バックグラウンドのスレッドがまとめて標準出力に書き、空になったときだけフラッシュする
+// - リングが満杯なら捨てて数える（呼び出し側は待たない）
+// - start()前・stop()後は呼び出し元でそのまま書く
+// MIDIVIS_LOG_MIN_LEVEL（既定0）より低いレベルのマクロは何も生成しない（1でDEBUGを除去）
+#ifndef MIDIVIS_LOG_MIN_LEVEL
+#define MIDIVIS_LOG_MIN_LEVEL 0
+#endif
+
+#define MVLOG(level, category, ...) \
+    do { if (AsyncLog::isEnabled(level, category)) AsyncLog::write(level, category, __VA_ARGS__); } while (0)
+
+#if MIDIVIS_LOG_MIN_LEVEL <= 0
+#define MVLOG_DEBUG(category, ...) MVLOG(LOG_LEVEL_DEBUG, category, __VA_ARGS__)
+#else
+#define MVLOG_DEBUG(category, ...) do {} while (0)
+#endif
+#if MIDIVIS_LOG_MIN_LEVEL <= 1
+#define MVLOG_INFO(category, ...) MVLOG(LOG_LEVEL_INFO, category, __VA_ARGS__)
+#else
+#define MVLOG_INFO(category, ...) do {} while (0)
+#endif
+#if MIDIVIS_LOG_MIN_LEVEL <= 2
+#define MVLOG_WARN(category, ...) MVLOG(LOG_LEVEL_WARN, category, __VA_ARGS__)
+#else
+#define MVLOG_WARN(category, ...) do {} while (0)
+#endif
+#define MVLOG_ERROR(category, ...) MVLOG(LOG_LEVEL_ERROR, category, __VA_ARGS__)
+
+class AsyncLog {
+public:
+    static void start();
+    static void stop();   // 残りを書き出してから止める
+
+    static bool isEnabled(LogLevel level, LogCategory category) {
+        return level >= minLevel.load(std::memory_order_relaxed) &&
+               (categoryMask.load(std::memory_order_relaxed) & (1u << category));
+    }
+
+    static void write(LogLevel level, LogCategory category, const char* format, ...)
+#if defined(__GNUC__) || defined(__clang__)
+        __attribute__((format(printf, 3, 4)))
+#endif
+        ;
+
+    // 実行時の切替（本番ではsetQuiet(true)でイベントごとのDEBUGログを止める）
+    static void setMinLevel(LogLevel level) { minLevel = level; }
+    static LogLevel getMinLevel() { return minLevel; }
+    static void setQuiet(bool quiet) { setMinLevel(quiet ? LOG_LEVEL_INFO : LOG_LEVEL_DEBUG); }
+    static bool isQuiet() { return minLevel.load() > LOG_LEVEL_DEBUG; }
+    static void setCategoryEnabled(LogCategory category, bool enabled);
+
+    static uint64_t getDroppedCount() { return dropped; }
+
+private:
+    static const std::size_t CAPACITY = 1024;   // 2のべき乗
+    static const std::size_t TEXT_SIZE = 232;
+
+    // 有界のMPMCリング（スロットごとの通し番号で空き・書き込み済みを判定）
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        uint64_t timestampMicros = 0;
+        LogLevel level = LOG_LEVEL_INFO;
+        LogCategory category = LOG_CATEGORY_APP;
+        char text[TEXT_SIZE];
+    };
+
+    static void writerLoop();
+    static bool drainOne();
+    static void print(LogLevel level, LogCategory category, const char* text);
+
+    static std::atomic<LogLevel> minLevel;
+    static std::atomic<uint32_t> categoryMask;
+    static std::atomic<bool> running;
+    static std::atomic<uint64_t> dropped;
+
+    static std::array<Slot, CAPACITY> slots;
+    static std::atomic<std::size_t> enqueuePosition;
+    static std::size_t dequeuePosition;   // 書き出しスレッドのみ
+    static std::thread writer;
+};
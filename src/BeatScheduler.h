@@ -0,0 +1,199 @@
+#pragma once
+
+#include "ofMain.h"
+#include "TempoEngine.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+// ビートに合わせて実行するアクション
+enum BeatActionType {
+    BEAT_ACTION_TRANSITION,   // value1: 切替先のシステム番号（-1なら再生順序の次）
+    BEAT_ACTION_GLITCH,       // value1: エリア数
+    BEAT_ACTION_IMPACT,       // value1: ノート, value2: ベロシティ（アクティブなシステムにノートオンとして送る）
+    BEAT_ACTION_FLASH         // 表示遅延の校正用の点滅
+};
+
+struct BeatAction {
+    BeatActionType type = BEAT_ACTION_GLITCH;
+    bool onBeat = true;       // trueならbeatが画面に出る時刻、falseならtimeに実行
+    double beat = 0.0;
+    double time = 0.0;
+    int leadFrames = 0;       // 反映が遅れるフレーム数（パイプライン化したシステムは1フレーム後に描かれる）
+    int value1 = 0;
+    int value2 = 0;
+};
+
+// ビートに量子化したアクションのスケジューラ
+// - フレームで組み立てた絵が画面に出るのは、バッファの入れ替え（垂直同期）とFBOの合成を経た数フレーム後
+// - アクションはビート（またはSimViewport時間軸の時刻）で予約し、そのビートの予測時刻が
+//   「このフレームが表示される時刻」に最も近いフレームで実行する（ビートの予測はTempoEngineが毎フレーム更新）
+// - 表示までの遅延 = フレーム間隔の移動平均 × PRESENT_FRAMES + 校正したディスプレイのオフセット
+// - 校正モードでは一定間隔で点滅させ、点滅に合わせた打鍵と予定した表示時刻の差の中央値でオフセットを合わせる
+// 固定dt再生・オフラインレンダーではフレームの時刻がそのまま表示（書き出し）の時刻なので遅延を0とする
+class BeatScheduler {
+public:
+    static const int CAPACITY = 32;
+    static const int PRESENT_FRAMES = 2;                 // バックバッファの入れ替え + コンポジタ
+    static constexpr double CALIBRATION_PERIOD = 0.5;    // 校正の点滅間隔（120BPM）
+    static const int MIN_CALIBRATION_TAPS = 8;
+
+    // フレーム頭で呼ぶ（frameSecondsは前フレームの所要時間）
+    void beginFrame(double time, float frameSeconds, bool compensateLatency) {
+        frameTime = time;
+        compensate = compensateLatency;
+        if (frameSeconds > 0.0f && frameSeconds < MAX_FRAME_SECONDS) {
+            frameInterval += (frameSeconds - frameInterval) * FRAME_SMOOTHING;
+        }
+
+        // 校正中は次の点滅を予約しておく
+        if (calibrating) {
+            int64_t next = (int64_t)std::floor((getDisplayTime() - calibrationStart) / CALIBRATION_PERIOD) + 1;
+            if (next != calibrationScheduled) {
+                calibrationScheduled = next;
+                scheduleAtTime(BEAT_ACTION_FLASH, calibrationStart + next * CALIBRATION_PERIOD);
+            }
+        }
+    }
+
+    bool scheduleAtBeat(BeatActionType type, double beat, int value1 = 0, int value2 = 0, int leadFrames = 0) {
+        BeatAction action;
+        action.type = type;
+        action.onBeat = true;
+        action.beat = beat;
+        action.leadFrames = leadFrames;
+        action.value1 = value1;
+        action.value2 = value2;
+        return push(action);
+    }
+
+    bool scheduleAtTime(BeatActionType type, double displayTime, int value1 = 0, int value2 = 0, int leadFrames = 0) {
+        BeatAction action;
+        action.type = type;
+        action.onBeat = false;
+        action.time = displayTime;
+        action.leadFrames = leadFrames;
+        action.value1 = value1;
+        action.value2 = value2;
+        return push(action);
+    }
+
+    // このフレームで実行するアクションを予約順に取り出す（outは呼び出し側の固定長配列）
+    // ビートの基準がない（テンポを見失った）ビート予約は待たずに実行する
+    int collectDue(const TempoEngine& tempo, BeatAction* out, int maxCount) {
+        double halfFrame = compensate ? frameInterval * 0.5 : 0.0;
+        int count = 0;
+        int kept = 0;
+        for (int i = 0; i < pendingCount; i++) {
+            const BeatAction& action = pending[i];
+            double target = action.onBeat ? tempo.getBeatTime(action.beat) : action.time;
+            if (std::isinf(target)) target = frameTime;
+            double leadSeconds = compensate ? action.leadFrames * frameInterval : 0.0;
+
+            if (count < maxCount && target - leadSeconds - halfFrame <= getDisplayTime()) {
+                out[count++] = action;
+            } else {
+                pending[kept++] = action;
+            }
+        }
+        pendingCount = kept;
+        return count;
+    }
+
+    void cancel(BeatActionType type) {
+        int kept = 0;
+        for (int i = 0; i < pendingCount; i++) {
+            if (pending[i].type != type) pending[kept++] = pending[i];
+        }
+        pendingCount = kept;
+    }
+
+    bool hasPending(BeatActionType type) const {
+        for (int i = 0; i < pendingCount; i++) {
+            if (pending[i].type == type) return true;
+        }
+        return false;
+    }
+
+    int getPendingCount() const { return pendingCount; }
+    uint64_t getDroppedCount() const { return dropped; }
+
+    // このフレームの絵が画面に出る予測時刻と、それまでの遅延
+    double getDisplayTime() const { return frameTime + getPresentLatency(); }
+    double getPresentLatency() const { return compensate ? std::max(0.0, frameInterval * PRESENT_FRAMES + displayOffset) : 0.0; }
+    double getFrameInterval() const { return frameInterval; }
+
+    void setDisplayOffset(double seconds) { displayOffset = seconds; }
+    double getDisplayOffset() const { return displayOffset; }
+
+    // === 表示遅延の校正 ===
+    void startCalibration() {
+        calibrating = true;
+        calibrationStart = std::ceil(getDisplayTime() / CALIBRATION_PERIOD) * CALIBRATION_PERIOD;
+        calibrationScheduled = -1;
+        tapCount = 0;
+        tapHead = 0;
+        cancel(BEAT_ACTION_FLASH);
+    }
+
+    // 終了してオフセットに反映する。打鍵が足りなければ反映しない
+    bool finishCalibration() {
+        calibrating = false;
+        cancel(BEAT_ACTION_FLASH);
+        if (tapCount < MIN_CALIBRATION_TAPS) return false;
+        displayOffset += getCalibrationError();
+        return true;
+    }
+
+    bool isCalibrating() const { return calibrating; }
+
+    // 点滅に合わせた打鍵の時刻（MIDIパッドならイベント時刻、キーならフレーム時刻）
+    void addCalibrationTap(double time) {
+        if (!calibrating) return;
+        double error = time - calibrationStart;
+        error -= std::floor(error / CALIBRATION_PERIOD + 0.5) * CALIBRATION_PERIOD;
+        tapErrors[tapHead] = error;
+        tapHead = (tapHead + 1) % TAP_CAPACITY;
+        if (tapCount < TAP_CAPACITY) tapCount++;
+    }
+
+    int getCalibrationTapCount() const { return tapCount; }
+
+    // 打鍵が予定した表示時刻からどれだけ遅れているか（中央値、秒）
+    double getCalibrationError() const {
+        if (tapCount == 0) return 0.0;
+        std::array<double, TAP_CAPACITY> sorted = tapErrors;
+        std::nth_element(sorted.begin(), sorted.begin() + tapCount / 2, sorted.begin() + tapCount);
+        return sorted[tapCount / 2];
+    }
+
+private:
+    static const int TAP_CAPACITY = 16;
+    static constexpr float MAX_FRAME_SECONDS = 0.25f;   // これより長いフレーム（読み込み・一時停止）は平均に入れない
+    static constexpr double FRAME_SMOOTHING = 0.1;
+
+    bool push(const BeatAction& action) {
+        if (pendingCount >= CAPACITY) {
+            dropped++;
+            return false;
+        }
+        pending[pendingCount++] = action;
+        return true;
+    }
+
+    std::array<BeatAction, CAPACITY> pending;
+    int pendingCount = 0;
+    uint64_t dropped = 0;
+
+    double frameTime = 0.0;
+    double frameInterval = 1.0 / 60.0;
+    double displayOffset = 0.0;
+    bool compensate = true;
+
+    bool calibrating = false;
+    double calibrationStart = 0.0;
+    int64_t calibrationScheduled = -1;
+    std::array<double, TAP_CAPACITY> tapErrors;
+    int tapCount = 0;
+    int tapHead = 0;
+};
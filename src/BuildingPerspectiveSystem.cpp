@@ -30,6 +30,10 @@ BuildingPerspectiveSystem::BuildingPerspectiveSystem() {
     ambientLight = 0.7f;
     shadowIntensity = 0.4f;
     
+    globalGrowthRate = 1.0f;
+    spawnCooldown = 0.0f;
+    lastSpawnTime = 0.0f;
+    
     kickIntensity = 0.0f;
     snareIntensity = 0.0f;
     hihatIntensity = 0.0f;
@@ -59,7 +63,7 @@ void BuildingPerspectiveSystem::update(float deltaTime) {
     cameraTarget.z = cameraPosition.z + 100.0f;
     
     // 新しい建物の生成
-    if (ofRandom(1.0f) < buildingSpawnRate * deltaTime) {
+    if (rng.random(1.0f) < buildingSpawnRate * deltaTime) {
         float newDepth = cameraPosition.z + generationDistance;
         generateBuilding(newDepth);
     }
@@ -76,10 +80,10 @@ void BuildingPerspectiveSystem::update(float deltaTime) {
     cleanupDistantBuildings();
     
     // MIDI連動強度の減衰
-    kickIntensity *= 0.92f;
-    snareIntensity *= 0.88f;
-    hihatIntensity *= 0.85f;
-    crashIntensity *= 0.80f;
+    kickIntensity *= frameDecay(0.92f, deltaTime);
+    snareIntensity *= frameDecay(0.88f, deltaTime);
+    hihatIntensity *= frameDecay(0.85f, deltaTime);
+    crashIntensity *= frameDecay(0.80f, deltaTime);
     
     // 成長レベルに基づく環境調整
     buildingSpawnRate = 0.1f + globalGrowthLevel * 0.15f;
@@ -88,10 +92,16 @@ void BuildingPerspectiveSystem::update(float deltaTime) {
     globalGrowthRate = 1.0f + globalGrowthLevel * 2.0f;
     
     // 建物の成長更新
-    float currentTime = ofGetElapsedTimef();
+    float currentTime = SimViewport::getElapsedTimef();
     for (auto& building : buildings) {
         updateBuildingGrowth(building, deltaTime);
     }
+    
+    // ループ中に派生した子建物を追加（ループ中のpush_backは参照を無効にするため）
+    for (auto& child : spawnedBuildings) {
+        buildings.push_back(child);
+    }
+    spawnedBuildings.clear();
 }
 
 void BuildingPerspectiveSystem::draw() {
@@ -101,7 +111,7 @@ void BuildingPerspectiveSystem::draw() {
     ofPushMatrix();
     
     // 画面中央に座標系を移動
-    ofTranslate(ofGetWidth() * 0.5f, ofGetHeight() * 0.6f);
+    ofTranslate(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.6f);
     
     // 一人称視点の揺れを適用
     float bobbingY = sin(walkBobbing) * 3.0f;
@@ -153,24 +163,24 @@ void BuildingPerspectiveSystem::generateBuilding(float depth) {
     building.growthProgress = 0.0f;
     building.age = 0.0f;
     building.parent = nullptr;
-    building.growthRate = ofRandom(0.5f, 1.5f);
-    building.maxHeight = ofRandom(150.0f, 400.0f) + globalGrowthLevel * 200.0f;
-    building.spawnProbability = ofRandom(0.05f, 0.2f);
+    building.growthRate = rng.random(0.5f, 1.5f);
+    building.maxHeight = rng.random(150.0f, 400.0f) + globalGrowthLevel * 200.0f;
+    building.spawnProbability = rng.random(0.05f, 0.2f);
     building.canSpawnChildren = true;
     
     // より広範囲の建物配置
-    float side = ofRandom(1.0f);
+    float side = rng.random(1.0f);
     if (side < 0.5f) {
         // 左側の建物
         building.position.set(
-            ofRandom(-streetWidth * 2.0f, -streetWidth * 0.5f),
+            rng.random(-streetWidth * 2.0f, -streetWidth * 0.5f),
             0,  // 地面レベルに固定
             depth
         );
     } else {
         // 右側の建物
         building.position.set(
-            ofRandom(streetWidth * 0.5f, streetWidth * 2.0f),
+            rng.random(streetWidth * 0.5f, streetWidth * 2.0f),
             0,  // 地面レベルに固定
             depth
         );
@@ -178,14 +188,14 @@ void BuildingPerspectiveSystem::generateBuilding(float depth) {
     
     // 初期サイズ（小さく始まる）
     building.size.set(
-        ofRandom(40, 80),    // 幅を小さく
-        ofRandom(20, 50),    // 高さを低く
-        ofRandom(40, 80)     // 奥行きを小さく
+        rng.random(40, 80),    // 幅を小さく
+        rng.random(20, 50),    // 高さを低く
+        rng.random(40, 80)     // 奥行きを小さく
     );
     
-    building.rotationY = ofRandom(-15, 15);
+    building.rotationY = rng.random(-15, 15);
     building.depth = depth - cameraPosition.z;
-    building.spawnTime = ofGetElapsedTimef();
+    building.spawnTime = SimViewport::getElapsedTimef();
     
     generateBuildingByType(building, building.growthType);
     buildings.push_back(building);
@@ -194,7 +204,7 @@ void BuildingPerspectiveSystem::generateBuilding(float depth) {
 void BuildingPerspectiveSystem::updateCameraMovement(float deltaTime) {
     // MIDI連動によるカメラ効果
     if (crashIntensity > 0.5f) {
-        cameraRotation += ofRandom(-5, 5) * crashIntensity;
+        cameraRotation += rng.random(-5, 5) * crashIntensity;
         cameraSpeed *= (1.0f + crashIntensity * 0.5f);
     }
     
@@ -203,11 +213,11 @@ void BuildingPerspectiveSystem::updateCameraMovement(float deltaTime) {
     }
     
     // カメラの自然な左右移動
-    float lateralMovement = sin(ofGetElapsedTimef() * 0.3f) * 5.0f;
+    float lateralMovement = sin(SimViewport::getElapsedTimef() * 0.3f) * 5.0f;
     cameraPosition.x = ofLerp(cameraPosition.x, lateralMovement, deltaTime * 2.0f);
     
     // 高さの調整
-    float targetHeight = -10.0f + sin(ofGetElapsedTimef() * 0.5f) * 3.0f;
+    float targetHeight = -10.0f + sin(SimViewport::getElapsedTimef() * 0.5f) * 3.0f;
     cameraPosition.y = ofLerp(cameraPosition.y, targetHeight, deltaTime * 3.0f);
 }
 
@@ -384,7 +394,7 @@ void BuildingPerspectiveSystem::drawWindows(const Building& building) {
     
     for (int row = 1; row < windowRows; row++) {
         for (int col = 1; col < windowCols; col++) {
-            if (ofRandom(1.0f) < 0.8f) {  // 80%の確率で窓を描画
+            if (rng.random(1.0f) < 0.8f) {  // 80%の確率で窓を描画
                 
                 // 窓の3D位置を計算
                 float localX = -halfWidth + (col * building.size.x / windowCols);
@@ -406,8 +416,8 @@ void BuildingPerspectiveSystem::drawWindows(const Building& building) {
                 
                 // 時々点滅する窓
                 float brightness = 1.0f;
-                if (ofRandom(1.0f) < 0.1f) {
-                    brightness = 0.3f + 0.7f * sin(ofGetElapsedTimef() * 5.0f + row * col);
+                if (rng.random(1.0f) < 0.1f) {
+                    brightness = 0.3f + 0.7f * sin(SimViewport::getElapsedTimef() * 5.0f + row * col);
                 }
                 
                 ofSetColor(windowColor.r * brightness, windowColor.g * brightness, 
@@ -523,15 +533,15 @@ void BuildingPerspectiveSystem::projectPoint(const ofVec3f& point3D, ofVec2f& po
     
     // 視野角とアスペクト比を考慮した透視投影
     float fov = perspectiveAngle * PI / 180.0f;
-    float aspectRatio = (float)ofGetWidth() / ofGetHeight();
+    float aspectRatio = (float)SimViewport::getWidth() / SimViewport::getHeight();
     
     // 正規化デバイス座標への変換
     float ndcX = relativeX / (relativeZ * tan(fov * 0.5f) * aspectRatio);
     float ndcY = -relativeY / (relativeZ * tan(fov * 0.5f));
     
     // スクリーン座標への変換（座標系は画面中央基準に変更済み）
-    point2D.x = ndcX * ofGetWidth() * 0.5f;
-    point2D.y = ndcY * ofGetHeight() * 0.5f;
+    point2D.x = ndcX * SimViewport::getWidth() * 0.5f;
+    point2D.y = ndcY * SimViewport::getHeight() * 0.5f;
 }
 
 void BuildingPerspectiveSystem::createBuildingGeometry(Building& building) {
@@ -610,11 +620,11 @@ void BuildingPerspectiveSystem::onMidiMessage(ofxMidiMessage& msg) {
         }
         else if (note == 49) {  // CRASH
             crashIntensity = velocity;
-            cameraRotation += ofRandom(-20, 20) * velocity;
+            cameraRotation += rng.random(-20, 20) * velocity;
             
             // 新しい建物を大量生成
             for (int i = 0; i < 5; i++) {
-                float newDepth = cameraPosition.z + ofRandom(100, 400);
+                float newDepth = cameraPosition.z + rng.random(100, 400);
                 generateBuilding(newDepth);
             }
         }
@@ -675,10 +685,10 @@ void BuildingPerspectiveSystem::updateBuildingGrowth(Building& building, float d
         
         // 子建物の派生チェック
         if (building.canSpawnChildren && building.growthLevel >= 2 && 
-            ofRandom(1.0f) < building.spawnProbability && 
-            ofGetElapsedTimef() - lastSpawnTime > spawnCooldown) {
+            rng.random(1.0f) < building.spawnProbability && 
+            SimViewport::getElapsedTimef() - lastSpawnTime > spawnCooldown) {
             spawnChildBuilding(building);
-            lastSpawnTime = ofGetElapsedTimef();
+            lastSpawnTime = SimViewport::getElapsedTimef();
         }
     }
     
@@ -691,8 +701,8 @@ void BuildingPerspectiveSystem::spawnChildBuilding(Building& parent) {
     Building child;
     
     // 親の近くに配置
-    float offsetX = ofRandom(-60.0f, 60.0f);
-    float offsetZ = ofRandom(-40.0f, 40.0f);
+    float offsetX = rng.random(-60.0f, 60.0f);
+    float offsetZ = rng.random(-40.0f, 40.0f);
     
     child.position = parent.position;
     child.position.x += offsetX;
@@ -705,24 +715,22 @@ void BuildingPerspectiveSystem::spawnChildBuilding(Building& parent) {
     child.growthProgress = 0.0f;
     child.age = 0.0f;
     child.parent = &parent;
-    child.growthRate = ofRandom(0.8f, 1.2f);
-    child.maxHeight = parent.maxHeight * ofRandom(0.6f, 1.2f);
+    child.growthRate = rng.random(0.8f, 1.2f);
+    child.maxHeight = parent.maxHeight * rng.random(0.6f, 1.2f);
     child.spawnProbability = parent.spawnProbability * 0.7f;
     
     // 初期サイズ（親より小さめ）
-    float scale = ofRandom(0.6f, 0.9f);
+    float scale = rng.random(0.6f, 0.9f);
     child.size = parent.size * scale;
-    child.size.y = ofRandom(15.0f, 30.0f);  // 低い初期高さ
+    child.size.y = rng.random(15.0f, 30.0f);  // 低い初期高さ
     
-    child.rotationY = ofRandom(-15.0f, 15.0f);
-    child.spawnTime = ofGetElapsedTimef();
+    child.rotationY = rng.random(-15.0f, 15.0f);
+    child.spawnTime = SimViewport::getElapsedTimef();
     
     generateBuildingByType(child, child.growthType);
     
     // 親の子リストに追加
-    parent.children.push_back(&buildings.back());
-    
-    buildings.push_back(child);
+    spawnedBuildings.push_back(child);
 }
 
 void BuildingPerspectiveSystem::growBuilding(Building& building, float deltaTime) {
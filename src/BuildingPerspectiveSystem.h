@@ -68,6 +68,7 @@ struct Building {
 class BuildingPerspectiveSystem : public VisualSystem {
 private:
     std::vector<Building> buildings;
+    std::vector<Building> spawnedBuildings;  // 成長更新中に派生した子建物（ループ後に追加）
     ofVec3f cameraPosition;
     ofVec3f cameraTarget;
     float cameraSpeed;
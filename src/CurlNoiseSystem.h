@@ -6,6 +6,7 @@
 
 struct CurlParticle {
     ofVec2f position;
+    ofVec2f previousPosition;   // 直前のステップ開始時の位置（描画の補間用）
     ofVec2f velocity;
     float age = 0.0f;
     float maxAge = 8.0f;
@@ -15,17 +16,19 @@ struct CurlParticle {
     int trailLength = 20;
     std::deque<ofVec2f> trail;
     
-    CurlParticle(ofVec2f pos = ofVec2f(0, 0)) {
+    CurlParticle(VisualRandom& rng, ofVec2f pos = ofVec2f(0, 0)) {
         position = pos;
+        previousPosition = pos;
         velocity = ofVec2f(0, 0);
         color = ofColor::white;
-        maxAge = ofRandom(5.0f, 12.0f);
-        size = ofRandom(0.3f, 1.5f);
-        energy = ofRandom(0.5f, 1.0f);
-        trailLength = ofRandom(10, 30);
+        maxAge = rng.random(5.0f, 12.0f);
+        size = rng.random(0.3f, 1.5f);
+        energy = rng.random(0.5f, 1.0f);
+        trailLength = rng.random(10, 30);
     }
     
     void update(float deltaTime) {
+        previousPosition = position;
         age += deltaTime;
         position += velocity * deltaTime;
         
@@ -39,10 +42,13 @@ struct CurlParticle {
         energy *= 0.995f;
         
         // Boundary wrapping
-        if (position.x < 0) position.x = ofGetWidth();
-        if (position.x > ofGetWidth()) position.x = 0;
-        if (position.y < 0) position.y = ofGetHeight();
-        if (position.y > ofGetHeight()) position.y = 0;
+        if (position.x < 0) position.x = SimViewport::getWidth();
+        if (position.x > SimViewport::getWidth()) position.x = 0;
+        if (position.y < 0) position.y = SimViewport::getHeight();
+        if (position.y > SimViewport::getHeight()) position.y = 0;
+        if (position.distance(previousPosition) > velocity.length() * deltaTime + 1.0f) {
+            previousPosition = position;  // 折り返した直後は補間しない
+        }
     }
     
     bool isDead() const {
@@ -61,12 +67,12 @@ struct VortexCore {
     float rotation;
     float oscillation;
     
-    VortexCore(ofVec2f pos) {
+    VortexCore(VisualRandom& rng, ofVec2f pos) {
         position = pos;
-        strength = ofRandom(0.5f, 2.0f);
-        radius = ofRandom(50.0f, 150.0f);
+        strength = rng.random(0.5f, 2.0f);
+        radius = rng.random(50.0f, 150.0f);
         rotation = 0.0f;
-        oscillation = ofRandom(0.1f, 0.5f);
+        oscillation = rng.random(0.1f, 0.5f);
     }
     
     void update(float deltaTime) {
@@ -76,9 +82,9 @@ struct VortexCore {
         
         // Keep within bounds
         if (position.x < radius) position.x = radius;
-        if (position.x > ofGetWidth() - radius) position.x = ofGetWidth() - radius;
+        if (position.x > SimViewport::getWidth() - radius) position.x = SimViewport::getWidth() - radius;
         if (position.y < radius) position.y = radius;
-        if (position.y > ofGetHeight() - radius) position.y = ofGetHeight() - radius;
+        if (position.y > SimViewport::getHeight() - radius) position.y = SimViewport::getHeight() - radius;
     }
 };
 
@@ -116,24 +122,27 @@ private:
     float attractorStrength = 0.0f;
     
 public:
+    // 要素はすべて値で持つことを確かめた（PipelinedSystemで状態を丸ごとコピーしてよい）
+    static constexpr bool SNAPSHOT_COPYABLE = true;
+    
     void setup() override {
         // Initialize particles
         for (int i = 0; i < 150; i++) {
-            ofVec2f pos(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
-            particles.push_back(CurlParticle(pos));
+            ofVec2f pos(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
+            particles.push_back(CurlParticle(rng, pos));
         }
         
         // Initialize vortices
         for (int i = 0; i < 3; i++) {
             ofVec2f pos(
-                ofRandom(100, ofGetWidth() - 100),
-                ofRandom(100, ofGetHeight() - 100)
+                rng.random(100, SimViewport::getWidth() - 100),
+                rng.random(100, SimViewport::getHeight() - 100)
             );
-            vortices.push_back(VortexCore(pos));
+            vortices.push_back(VortexCore(rng, pos));
         }
         
         // Initialize impact center
-        impactCenter = ofVec2f(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f);
+        impactCenter = ofVec2f(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f);
         
         // Set initial growth level
         globalGrowthLevel = 0.3f;
@@ -221,16 +230,16 @@ public:
         
         // Spawn new particles
         float spawnRate = particleDensity * (2.0f + globalGrowthLevel * 3.0f);
-        while (particles.size() < 300 && ofRandom(1.0f) < spawnRate * deltaTime) {
+        while (particles.size() < detailCap(300) && rng.random(1.0f) < spawnRate * deltaTime) {
             ofVec2f pos;
             if (impactIntensity > 0.5f) {
-                float angle = ofRandom(TWO_PI);
-                float radius = ofRandom(100.0f);
+                float angle = rng.random(TWO_PI);
+                float radius = rng.random(100.0f);
                 pos = impactCenter + ofVec2f(cos(angle), sin(angle)) * radius;
             } else {
-                pos = ofVec2f(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
+                pos = ofVec2f(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
             }
-            particles.push_back(CurlParticle(pos));
+            particles.push_back(CurlParticle(rng, pos));
         }
         
         // Update effects
@@ -241,19 +250,19 @@ public:
         // Flash effect
         flashTimer += deltaTime;
         flashEffect *= 0.92f;
-        if (flashTimer > 3.0f && ofRandom(1.0f) < 0.015f) {
+        if (flashTimer > 3.0f && rng.random(1.0f) < 0.015f) {
             flashEffect = 1.0f;
             flashTimer = 0.0f;
         }
         
         // Update attractors/repellers
         for (int i = attractors.size() - 1; i >= 0; i--) {
-            if (ofRandom(1.0f) < 0.02f) {
+            if (rng.random(1.0f) < 0.02f) {
                 attractors.erase(attractors.begin() + i);
             }
         }
         for (int i = repellers.size() - 1; i >= 0; i--) {
-            if (ofRandom(1.0f) < 0.02f) {
+            if (rng.random(1.0f) < 0.02f) {
                 repellers.erase(repellers.begin() + i);
             }
         }
@@ -285,10 +294,10 @@ public:
         // Stats
         if (getTimeSinceLastMidi() < 5.0f) {
             ofSetColor(200);
-            ofDrawBitmapString("Curl Noise System", 20, ofGetHeight() - 80);
-            ofDrawBitmapString("Particles: " + ofToString(particles.size()), 20, ofGetHeight() - 60);
-            ofDrawBitmapString("Vortices: " + ofToString(vortices.size()), 20, ofGetHeight() - 40);
-            ofDrawBitmapString("Turbulence: " + ofToString(turbulence, 2), 20, ofGetHeight() - 20);
+            ofDrawBitmapString("Curl Noise System", 20, SimViewport::getHeight() - 80);
+            ofDrawBitmapString("Particles: " + ofToString(particles.size()), 20, SimViewport::getHeight() - 60);
+            ofDrawBitmapString("Vortices: " + ofToString(vortices.size()), 20, SimViewport::getHeight() - 40);
+            ofDrawBitmapString("Turbulence: " + ofToString(turbulence, 2), 20, SimViewport::getHeight() - 20);
         }
     }
     
@@ -301,8 +310,8 @@ public:
             
             // Set impact center
             impactCenter = ofVec2f(
-                ofMap(msg.pitch % 12, 0, 12, 100, ofGetWidth() - 100),
-                ofMap(msg.pitch / 12, 0, 10, 100, ofGetHeight() - 100)
+                ofMap(msg.pitch % 12, 0, 12, 100, SimViewport::getWidth() - 100),
+                ofMap(msg.pitch / 12, 0, 10, 100, SimViewport::getHeight() - 100)
             );
             
             switch(msg.pitch) {
@@ -313,15 +322,15 @@ public:
                     
                     // Add new vortex
                     if (vortices.size() < 6) {
-                        vortices.push_back(VortexCore(impactCenter));
+                        vortices.push_back(VortexCore(rng, impactCenter));
                     }
                     
                     // Particle burst
                     for (int i = 0; i < impactIntensity * 30; i++) {
-                        float angle = ofRandom(TWO_PI);
-                        float speed = ofRandom(50, 150);
+                        float angle = rng.random(TWO_PI);
+                        float speed = rng.random(50, 150);
                         ofVec2f pos = impactCenter;
-                        CurlParticle p(pos);
+                        CurlParticle p(rng, pos);
                         p.velocity = ofVec2f(cos(angle), sin(angle)) * speed;
                         particles.push_back(p);
                     }
@@ -350,10 +359,10 @@ public:
                     vortices.clear();
                     for (int i = 0; i < 4; i++) {
                         ofVec2f pos(
-                            ofRandom(100, ofGetWidth() - 100),
-                            ofRandom(100, ofGetHeight() - 100)
+                            rng.random(100, SimViewport::getWidth() - 100),
+                            rng.random(100, SimViewport::getHeight() - 100)
                         );
-                        VortexCore v(pos);
+                        VortexCore v(rng, pos);
                         v.strength *= 2.0f;
                         vortices.push_back(v);
                     }
@@ -361,8 +370,8 @@ public:
                     // Add repellers
                     for (int i = 0; i < 3; i++) {
                         repellers.push_back(ofVec2f(
-                            ofRandom(ofGetWidth()),
-                            ofRandom(ofGetHeight())
+                            rng.random(SimViewport::getWidth()),
+                            rng.random(SimViewport::getHeight())
                         ));
                     }
                     attractorStrength = 3.0f;
@@ -417,8 +426,8 @@ private:
         ofEnableBlendMode(OF_BLENDMODE_ALPHA);
         
         int step = 30;
-        for (int y = 0; y < ofGetHeight(); y += step) {
-            for (int x = 0; x < ofGetWidth(); x += step) {
+        for (int y = 0; y < SimViewport::getHeight(); y += step) {
+            for (int x = 0; x < SimViewport::getWidth(); x += step) {
                 ofVec2f pos(x, y);
                 ofVec2f curl = calculateCurlNoise(pos);
                 
@@ -470,33 +479,30 @@ private:
             
             // Draw trail
             if (particle.trail.size() > 1) {
-                ofNoFill();
-                ofSetLineWidth(particle.size * 0.5f);
+                float trailWidth = particle.size * 0.5f;
                 
                 for (int i = 0; i < particle.trail.size() - 1; i++) {
                     float trailAlpha = (i / float(particle.trail.size())) * alpha * trailOpacity;
                     
                     if (flashEffect > 0.5f) {
-                        ofSetColor(255, 255, 255, trailAlpha * flashEffect);
+                        lines.addLine(particle.trail[i], particle.trail[i + 1], trailWidth, ofColor(255), trailAlpha * flashEffect);
                     } else {
-                        ofSetColor(particle.color.r, particle.color.g, particle.color.b, trailAlpha);
+                        lines.addLine(particle.trail[i], particle.trail[i + 1], trailWidth, particle.color, trailAlpha);
                     }
-                    
-                    ofDrawLine(particle.trail[i], particle.trail[i + 1]);
                 }
-                ofFill();
             }
             
-            // Draw particle
+            // Draw particle（軌跡の線の上にまとめて描く）
+            float size = particle.size * (1.0f + particle.velocity.length() * 0.01f);
+            ofVec2f position = interpolate(particle.previousPosition, particle.position);
             if (flashEffect > 0.5f) {
-                ofSetColor(255, 255, 255, alpha * flashEffect);
+                sprites.addCircle(position, size, ofColor(255), alpha * flashEffect);
             } else {
-                ofSetColor(particle.color.r, particle.color.g, particle.color.b, alpha);
+                sprites.addCircle(position, size, particle.color, alpha);
             }
-            
-            float size = particle.size * (1.0f + particle.velocity.length() * 0.01f);
-            ofDrawCircle(particle.position, size);
         }
+        lines.draw();
+        sprites.draw();
         
         ofDisableBlendMode();
     }
@@ -543,11 +549,11 @@ private:
             
             for (int wave = 0; wave < 3; wave++) {
                 float phase = waveTime + wave * 0.5f;
-                float radius = fmod(phase * 100, ofGetWidth() * 0.5f);
-                float alpha = (1.0f - radius / (ofGetWidth() * 0.5f)) * 100 * globalGrowthLevel;
+                float radius = fmod(phase * 100, SimViewport::getWidth() * 0.5f);
+                float alpha = (1.0f - radius / (SimViewport::getWidth() * 0.5f)) * 100 * globalGrowthLevel;
                 
                 ofSetColor(200, 220, 255, alpha);
-                ofDrawCircle(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f, radius);
+                ofDrawCircle(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f, radius);
             }
             
             ofFill();
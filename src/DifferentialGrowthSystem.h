@@ -30,35 +30,35 @@ struct UrbanNode {
         LANDMARK
     } type = RESIDENTIAL;
     
-    UrbanNode(ofVec2f pos = ofVec2f(0, 0)) {
+    UrbanNode(VisualRandom& rng, ofVec2f pos = ofVec2f(0, 0)) {
         position = pos;
         previousPosition = pos;
         velocity = ofVec2f(0, 0);
         color = ofColor::white;
-        type = static_cast<NodeType>(ofRandom(5));
+        type = static_cast<NodeType>(rng.random(5));
         
         // タイプに応じた初期特性
         switch(type) {
             case RESIDENTIAL:
-                urbanDensity = ofRandom(0.3f, 0.7f);
-                economicActivity = ofRandom(0.1f, 0.4f);
+                urbanDensity = rng.random(0.3f, 0.7f);
+                economicActivity = rng.random(0.1f, 0.4f);
                 break;
             case COMMERCIAL:
-                urbanDensity = ofRandom(0.5f, 0.8f);
-                economicActivity = ofRandom(0.6f, 0.9f);
+                urbanDensity = rng.random(0.5f, 0.8f);
+                economicActivity = rng.random(0.6f, 0.9f);
                 break;
             case INDUSTRIAL:
-                urbanDensity = ofRandom(0.4f, 0.6f);
-                economicActivity = ofRandom(0.7f, 1.0f);
+                urbanDensity = rng.random(0.4f, 0.6f);
+                economicActivity = rng.random(0.7f, 1.0f);
                 break;
             case TRANSPORT_HUB:
-                connectivity = ofRandom(0.7f, 1.0f);
-                infrastructureLevel = ofRandom(0.6f, 0.9f);
+                connectivity = rng.random(0.7f, 1.0f);
+                infrastructureLevel = rng.random(0.6f, 0.9f);
                 break;
             case LANDMARK:
-                urbanDensity = ofRandom(0.2f, 0.5f);
-                economicActivity = ofRandom(0.3f, 0.6f);
-                size = ofRandom(3.0f, 6.0f);
+                urbanDensity = rng.random(0.2f, 0.5f);
+                economicActivity = rng.random(0.3f, 0.6f);
+                size = rng.random(3.0f, 6.0f);
                 break;
         }
     }
@@ -133,11 +133,11 @@ struct UrbanConnection {
         WALKWAY
     } type = ROAD;
     
-    UrbanConnection(int a, int b, ConnectionType t = ROAD) {
+    UrbanConnection(VisualRandom& rng, int a, int b, ConnectionType t = ROAD) {
         nodeA = a;
         nodeB = b;
         type = t;
-        strength = ofRandom(0.5f, 1.0f);
+        strength = rng.random(0.5f, 1.0f);
         traffic = 0.0f;
         
         switch(type) {
@@ -193,14 +193,14 @@ private:
 public:
     void setup() override {
         // 初期ノードの配置（都市の核）
-        ofVec2f center(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f);
+        ofVec2f center(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f);
         
         // 中心都市核（密度削減）
         for (int i = 0; i < 6; i++) {
             float angle = (i / 6.0f) * TWO_PI;
-            float radius = 50 + ofRandom(-15, 15);  // 初期半径を拡大
+            float radius = 50 + rng.random(-15, 15);  // 初期半径を拡大
             ofVec2f pos = center + ofVec2f(cos(angle), sin(angle)) * radius;
-            nodes.push_back(UrbanNode(pos));
+            nodes.push_back(UrbanNode(rng, pos));
         }
         
         // 初期接続の作成
@@ -321,8 +321,8 @@ public:
                 default:
                     // 音程に基づく開発
                     ofVec2f developmentSite(
-                        ofMap(msg.pitch % 12, 0, 12, 100, ofGetWidth() - 100),
-                        ofMap(msg.pitch / 12, 0, 10, 100, ofGetHeight() - 100)
+                        ofMap(msg.pitch % 12, 0, 12, 100, SimViewport::getWidth() - 100),
+                        ofMap(msg.pitch / 12, 0, 10, 100, SimViewport::getHeight() - 100)
                     );
                     triggerTargetedDevelopment(developmentSite, impactIntensity);
             }
@@ -378,13 +378,13 @@ private:
         // 初期ノード間の接続を作成
         for (int i = 0; i < nodes.size(); i++) {
             int next = (i + 1) % nodes.size();
-            connections.push_back(UrbanConnection(i, next, UrbanConnection::ROAD));
+            connections.push_back(UrbanConnection(rng, i, next, UrbanConnection::ROAD));
             
             // 一部にランダム接続を追加
-            if (ofRandom(1.0f) < 0.3f) {
-                int randomTarget = ofRandom(nodes.size());
+            if (rng.random(1.0f) < 0.3f) {
+                int randomTarget = rng.random(nodes.size());
                 if (randomTarget != i) {
-                    connections.push_back(UrbanConnection(i, randomTarget, UrbanConnection::WALKWAY));
+                    connections.push_back(UrbanConnection(rng, i, randomTarget, UrbanConnection::WALKWAY));
                 }
             }
         }
@@ -396,17 +396,17 @@ private:
         
         // 主要路線の設定
         for (int i = 0; i < 2; i++) {
-            ofVec2f start(ofRandom(100, ofGetWidth()-100), ofRandom(100, ofGetHeight()-100));
-            ofVec2f end(ofRandom(100, ofGetWidth()-100), ofRandom(100, ofGetHeight()-100));
+            ofVec2f start(rng.random(100, SimViewport::getWidth()-100), rng.random(100, SimViewport::getHeight()-100));
+            ofVec2f end(rng.random(100, SimViewport::getWidth()-100), rng.random(100, SimViewport::getHeight()-100));
             
             transitLines[i].addVertex(start.x, start.y);
             
             // 中間点を追加して自然な曲線に
-            int numSegments = 5 + ofRandom(3);
+            int numSegments = 5 + rng.random(3);
             for (int j = 1; j < numSegments; j++) {
                 float t = j / float(numSegments);
                 ofVec2f intermediate = start.getInterpolated(end, t);
-                intermediate += ofVec2f(ofRandom(-50, 50), ofRandom(-50, 50));
+                intermediate += ofVec2f(rng.random(-50, 50), rng.random(-50, 50));
                 transitLines[i].addVertex(intermediate.x, intermediate.y);
             }
             
@@ -415,7 +415,7 @@ private:
         
         // 緑地の初期配置（密度削減）
         for (int i = 0; i < 3; i++) {
-            greenSpaces.push_back(ofVec2f(ofRandom(ofGetWidth()), ofRandom(ofGetHeight())));
+            greenSpaces.push_back(ofVec2f(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight())));
         }
     }
     
@@ -518,30 +518,30 @@ private:
             int next = (i + 1) % nodes.size();
             float distance = nodes[i].position.distance(nodes[next].position);
             
-            if (distance > maxDistance && nodes.size() < 120) {  // 最大ノード数を大幅削減
+            if (distance > maxDistance && nodes.size() < detailCap(120)) {  // 最大ノード数（詳細度でスケール）
                 // 新しいノードを挿入（都市拡張）
                 ofVec2f newPos = (nodes[i].position + nodes[next].position) * 0.5f;
-                newPos += ofVec2f(ofRandom(-8, 8), ofRandom(-8, 8));
+                newPos += ofVec2f(rng.random(-8, 8), rng.random(-8, 8));
                 
-                UrbanNode newNode(newPos);
+                UrbanNode newNode(rng, newPos);
                 
                 // 特性の継承と変異
-                newNode.urbanDensity = (nodes[i].urbanDensity + nodes[next].urbanDensity) * 0.5f + ofRandom(-0.1f, 0.1f);
-                newNode.economicActivity = (nodes[i].economicActivity + nodes[next].economicActivity) * 0.5f + ofRandom(-0.1f, 0.1f);
+                newNode.urbanDensity = (nodes[i].urbanDensity + nodes[next].urbanDensity) * 0.5f + rng.random(-0.1f, 0.1f);
+                newNode.economicActivity = (nodes[i].economicActivity + nodes[next].economicActivity) * 0.5f + rng.random(-0.1f, 0.1f);
                 newNode.infrastructureLevel = (nodes[i].infrastructureLevel + nodes[next].infrastructureLevel) * 0.5f;
                 
                 // 成長に応じてタイプを決定
-                if (globalGrowthLevel > 0.7f && ofRandom(1.0f) < 0.2f) {
+                if (globalGrowthLevel > 0.7f && rng.random(1.0f) < 0.2f) {
                     newNode.type = UrbanNode::LANDMARK;
-                } else if (urbanPressure > 0.6f && ofRandom(1.0f) < 0.3f) {
+                } else if (urbanPressure > 0.6f && rng.random(1.0f) < 0.3f) {
                     newNode.type = UrbanNode::TRANSPORT_HUB;
                 }
                 
                 newNodes.push_back(newNode);
                 
                 // 接続の追加
-                connections.push_back(UrbanConnection(i, nodes.size() + newNodes.size() - 1));
-                connections.push_back(UrbanConnection(nodes.size() + newNodes.size() - 1, next));
+                connections.push_back(UrbanConnection(rng, i, nodes.size() + newNodes.size() - 1));
+                connections.push_back(UrbanConnection(rng, nodes.size() + newNodes.size() - 1, next));
             }
         }
         
@@ -565,19 +565,29 @@ private:
             }
             
             if (shouldRemove) {
-                // 接続の更新
-                for (int k = connections.size() - 1; k >= 0; k--) {
-                    if (connections[k].nodeA == i || connections[k].nodeB == i) {
-                        connections.erase(connections.begin() + k);
-                    } else {
-                        if (connections[k].nodeA > i) connections[k].nodeA--;
-                        if (connections[k].nodeB > i) connections[k].nodeB--;
-                    }
-                }
-                
-                nodes.erase(nodes.begin() + i);
+                removeNode(i);
+            }
+        }
+        
+        // 詳細度が下がったら古いノード（先頭）から減らす
+        std::size_t maxNodes = detailCap(120);
+        while (nodes.size() > maxNodes) {
+            removeNode(0);
+        }
+    }
+    
+    // ノードを除き、接続の番号を詰める
+    void removeNode(int index) {
+        for (int k = connections.size() - 1; k >= 0; k--) {
+            if (connections[k].nodeA == index || connections[k].nodeB == index) {
+                connections.erase(connections.begin() + k);
+            } else {
+                if (connections[k].nodeA > index) connections[k].nodeA--;
+                if (connections[k].nodeB > index) connections[k].nodeB--;
             }
         }
+        
+        nodes.erase(nodes.begin() + index);
     }
     
     void handleConnectionEvolution() {
@@ -595,9 +605,9 @@ private:
         }
         
         // 新しい接続の生成（頻度と密度を削減）
-        if (ofRandom(1.0f) < 0.008f * globalGrowthLevel && connections.size() < nodes.size() * 2) {
-            int nodeA = ofRandom(nodes.size());
-            int nodeB = ofRandom(nodes.size());
+        if (rng.random(1.0f) < 0.008f * globalGrowthLevel && connections.size() < nodes.size() * 2) {
+            int nodeA = rng.random(nodes.size());
+            int nodeB = rng.random(nodes.size());
             
             if (nodeA != nodeB) {
                 float distance = nodes[nodeA].position.distance(nodes[nodeB].position);
@@ -606,11 +616,11 @@ private:
                     UrbanConnection::ConnectionType type = UrbanConnection::ROAD;
                     if (nodes[nodeA].type == UrbanNode::TRANSPORT_HUB || nodes[nodeB].type == UrbanNode::TRANSPORT_HUB) {
                         type = UrbanConnection::RAILWAY;
-                    } else if (globalGrowthLevel > 0.8f && ofRandom(1.0f) < 0.2f) {
+                    } else if (globalGrowthLevel > 0.8f && rng.random(1.0f) < 0.2f) {
                         type = UrbanConnection::DATA_LINE;
                     }
                     
-                    connections.push_back(UrbanConnection(nodeA, nodeB, type));
+                    connections.push_back(UrbanConnection(rng, nodeA, nodeB, type));
                 }
             }
         }
@@ -619,15 +629,15 @@ private:
     void updateUrbanInfrastructure(float deltaTime) {
         // 交通路線の動的更新
         for (auto& line : transitLines) {
-            if (ofRandom(1.0f) < 0.05f * globalGrowthLevel) {
+            if (rng.random(1.0f) < 0.05f * globalGrowthLevel) {
                 // 路線の延長
                 if (line.size() > 0) {
                     ofVec2f lastPoint = line.getVertices().back();
-                    ofVec2f newPoint = lastPoint + ofVec2f(ofRandom(-30, 30), ofRandom(-30, 30));
+                    ofVec2f newPoint = lastPoint + ofVec2f(rng.random(-30, 30), rng.random(-30, 30));
                     
                     // 境界チェック
-                    if (newPoint.x > 50 && newPoint.x < ofGetWidth() - 50 &&
-                        newPoint.y > 50 && newPoint.y < ofGetHeight() - 50) {
+                    if (newPoint.x > 50 && newPoint.x < SimViewport::getWidth() - 50 &&
+                        newPoint.y > 50 && newPoint.y < SimViewport::getHeight() - 50) {
                         line.addVertex(newPoint.x, newPoint.y);
                     }
                 }
@@ -636,13 +646,13 @@ private:
         
         // メガプロジェクトの管理（数を削減）
         if (constructionActivity > 0.7f && megaProjects.size() < 2) {
-            ofVec2f projectSite(ofRandom(100, ofGetWidth()-100), ofRandom(100, ofGetHeight()-100));
+            ofVec2f projectSite(rng.random(100, SimViewport::getWidth()-100), rng.random(100, SimViewport::getHeight()-100));
             megaProjects.push_back(projectSite);
         }
         
         // 緑地の管理（数を削減）
-        if (globalGrowthLevel > 0.5f && ofRandom(1.0f) < 0.005f && greenSpaces.size() < 5) {
-            greenSpaces.push_back(ofVec2f(ofRandom(ofGetWidth()), ofRandom(ofGetHeight())));
+        if (globalGrowthLevel > 0.5f && rng.random(1.0f) < 0.005f && greenSpaces.size() < 5) {
+            greenSpaces.push_back(ofVec2f(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight())));
         }
     }
     
@@ -669,7 +679,7 @@ private:
             isMetropolis = (metropolisLevel > 0.75f && nodes.size() > 50);
             
             if (isMetropolis && metropolisSeeds.size() < 2) {
-                metropolisSeeds.push_back(ofVec2f(ofRandom(ofGetWidth()), ofRandom(ofGetHeight())));
+                metropolisSeeds.push_back(ofVec2f(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight())));
             }
         }
     }
@@ -682,14 +692,14 @@ private:
         flashEffect *= 0.92f; // 減衰
         
         // ランダムフラッシュの発生（稀）
-        if (flashTimer > 3.0f && ofRandom(1.0f) < 0.02f) {
+        if (flashTimer > 3.0f && rng.random(1.0f) < 0.02f) {
             flashEffect = 1.0f;
             flashTimer = 0.0f;
         }
         
         // 影響センターの減衰
         for (int i = impactCenters.size() - 1; i >= 0; i--) {
-            if (ofRandom(1.0f) < 0.05f) {
+            if (rng.random(1.0f) < 0.05f) {
                 impactCenters.erase(impactCenters.begin() + i);
             }
         }
@@ -706,11 +716,11 @@ private:
         
         gradientMesh.addVertex(ofVec3f(0, 0));
         gradientMesh.addColor(bgTop);
-        gradientMesh.addVertex(ofVec3f(ofGetWidth(), 0));
+        gradientMesh.addVertex(ofVec3f(SimViewport::getWidth(), 0));
         gradientMesh.addColor(bgTop);
-        gradientMesh.addVertex(ofVec3f(0, ofGetHeight()));
+        gradientMesh.addVertex(ofVec3f(0, SimViewport::getHeight()));
         gradientMesh.addColor(bgBottom);
-        gradientMesh.addVertex(ofVec3f(ofGetWidth(), ofGetHeight()));
+        gradientMesh.addVertex(ofVec3f(SimViewport::getWidth(), SimViewport::getHeight()));
         gradientMesh.addColor(bgBottom);
         
         gradientMesh.draw();
@@ -741,7 +751,6 @@ private:
                         connColor = ofColor(60, 60, 60);  // ダークグレー（モノトーン）
                 }
                 connColor.a = 80 + conn.strength * 60; // より見えやすいアルファ値
-                ofSetColor(connColor);
                 
                 float lineWidth = 0.5f + conn.strength * 0.5 + globalGrowthLevel * 0.5;
                 if (conn.type == UrbanConnection::RAILWAY) {
@@ -750,11 +759,18 @@ private:
                     lineWidth *= 0.7f;
                 }
                 
-                ofSetLineWidth(lineWidth);
-                ofDrawLine(posA, posB);
-                
+                lines.addLine(posA, posB, lineWidth, connColor);
+            }
+        }
+        lines.draw();
+        
+        // 交通流は接続線の上に重ねる
+        for (auto& conn : connections) {
+            if (conn.nodeA < nodes.size() && conn.nodeB < nodes.size()) {
                 // 交通流の可視化（MIDI連動ウェーブ変形）
                 if (conn.traffic > 0.6f) {
+                    ofVec2f posA = nodes[conn.nodeA].position;
+                    ofVec2f posB = nodes[conn.nodeB].position;
                     ofVec2f mid = (posA + posB) * 0.5f;
                     // 交通流: アクセントカラー
                     ofColor trafficColor = ofColor(80, 140, 160);  // アクセント: ライトシアン
@@ -1004,8 +1020,8 @@ private:
         domeColor.a = 30 * metropolisLevel;
         ofSetColor(domeColor);
         
-        ofVec2f center(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f);
-        float domeRadius = ofGetWidth() * 0.4f * metropolisLevel;
+        ofVec2f center(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f);
+        float domeRadius = SimViewport::getWidth() * 0.4f * metropolisLevel;
         
         ofNoFill();
         ofSetLineWidth(1.5 + metropolisLevel * 1.5);
@@ -1029,7 +1045,7 @@ private:
             // 建物の窓
             if (metropolisLevel > 0.8f) {
                 for (int w = 0; w < buildingHeight / 10; w++) {
-                    if (ofRandom(1.0f) < 0.8f) {
+                    if (rng.random(1.0f) < 0.8f) {
                         ofSetColor(255, 255, 150, 200);
                         ofDrawRectangle(buildingBase.x - 1, buildingBase.y - w * 10 - 8, 2, 4);
                     }
@@ -1043,14 +1059,14 @@ private:
     void drawUrbanStatistics() {
         if (getTimeSinceLastMidi() < 5.0f) {
             ofSetColor(200);
-            ofDrawBitmapString("Differential Growth - Metropolitan Development", 20, ofGetHeight() - 120);
-            ofDrawBitmapString("Urban Nodes: " + ofToString(nodes.size()), 20, ofGetHeight() - 100);
-            ofDrawBitmapString("Connections: " + ofToString(connections.size()), 20, ofGetHeight() - 80);
-            ofDrawBitmapString("Metropolis Level: " + ofToString(metropolisLevel * 100, 1) + "%", 20, ofGetHeight() - 60);
-            ofDrawBitmapString("Urban Complexity: " + ofToString(urbanComplexity * 100, 1) + "%", 20, ofGetHeight() - 40);
+            ofDrawBitmapString("Differential Growth - Metropolitan Development", 20, SimViewport::getHeight() - 120);
+            ofDrawBitmapString("Urban Nodes: " + ofToString(nodes.size()), 20, SimViewport::getHeight() - 100);
+            ofDrawBitmapString("Connections: " + ofToString(connections.size()), 20, SimViewport::getHeight() - 80);
+            ofDrawBitmapString("Metropolis Level: " + ofToString(metropolisLevel * 100, 1) + "%", 20, SimViewport::getHeight() - 60);
+            ofDrawBitmapString("Urban Complexity: " + ofToString(urbanComplexity * 100, 1) + "%", 20, SimViewport::getHeight() - 40);
             if (isMetropolis) {
                 ofSetColor(255, 200, 100);
-                ofDrawBitmapString("METROPOLIS STATUS", 20, ofGetHeight() - 20);
+                ofDrawBitmapString("METROPOLIS STATUS", 20, SimViewport::getHeight() - 20);
             }
         }
     }
@@ -1058,14 +1074,14 @@ private:
     // MIDI反応メソッド
     void triggerMajorUrbanExpansion(float intensity) {
         // 大規模都市拡張（密度削減）
-        ofVec2f expansionCenter(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f);
+        ofVec2f expansionCenter(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f);
         
         for (int i = 0; i < intensity * 3; i++) {
-            float angle = ofRandom(TWO_PI);
-            float radius = 50 + ofRandom(100);
+            float angle = rng.random(TWO_PI);
+            float radius = 50 + rng.random(100);
             ofVec2f newPos = expansionCenter + ofVec2f(cos(angle), sin(angle)) * radius;
             
-            UrbanNode newNode(newPos);
+            UrbanNode newNode(rng, newPos);
             newNode.urbanDensity = intensity * 0.7f;
             newNode.economicActivity = intensity * 0.6f;
             newNode.type = (intensity > 0.8f) ? UrbanNode::LANDMARK : UrbanNode::COMMERCIAL;
@@ -1084,8 +1100,8 @@ private:
         for (int i = 0; i < intensity * 1; i++) {
             ofPolyline newLine;
             
-            ofVec2f start(ofRandom(100, ofGetWidth()-100), ofRandom(100, ofGetHeight()-100));
-            ofVec2f end(ofRandom(100, ofGetWidth()-100), ofRandom(100, ofGetHeight()-100));
+            ofVec2f start(rng.random(100, SimViewport::getWidth()-100), rng.random(100, SimViewport::getHeight()-100));
+            ofVec2f end(rng.random(100, SimViewport::getWidth()-100), rng.random(100, SimViewport::getHeight()-100));
             
             newLine.addVertex(start.x, start.y);
             
@@ -1093,7 +1109,7 @@ private:
             for (int j = 1; j < segments; j++) {
                 float t = j / float(segments);
                 ofVec2f intermediate = start.getInterpolated(end, t);
-                intermediate += ofVec2f(ofRandom(-30, 30), ofRandom(-30, 30));
+                intermediate += ofVec2f(rng.random(-30, 30), rng.random(-30, 30));
                 newLine.addVertex(intermediate.x, intermediate.y);
             }
             
@@ -1103,7 +1119,7 @@ private:
         
         // 新しい交通ハブの追加
         for (int i = 0; i < nodes.size(); i++) {
-            if (ofRandom(1.0f) < intensity * 0.3f && nodes[i].type != UrbanNode::TRANSPORT_HUB) {
+            if (rng.random(1.0f) < intensity * 0.3f && nodes[i].type != UrbanNode::TRANSPORT_HUB) {
                 nodes[i].type = UrbanNode::TRANSPORT_HUB;
                 nodes[i].connectivity = intensity;
                 break;
@@ -1114,7 +1130,7 @@ private:
     void triggerLocalDevelopment(float intensity) {
         // 地域開発
         for (auto& node : nodes) {
-            if (ofRandom(1.0f) < intensity * 0.4f) {
+            if (rng.random(1.0f) < intensity * 0.4f) {
                 node.urbanDensity += intensity * 0.2f;
                 node.economicActivity += intensity * 0.3f;
                 node.infrastructureLevel += intensity * 0.1f;
@@ -1128,11 +1144,11 @@ private:
         // 細かい接続の追加（密度削減）
         if (connections.size() < nodes.size() * 1.5) {
             for (int i = 0; i < intensity * 2; i++) {
-                int nodeA = ofRandom(nodes.size());
-                int nodeB = ofRandom(nodes.size());
+                int nodeA = rng.random(nodes.size());
+                int nodeB = rng.random(nodes.size());
                 
                 if (nodeA != nodeB) {
-                    connections.push_back(UrbanConnection(nodeA, nodeB, UrbanConnection::WALKWAY));
+                    connections.push_back(UrbanConnection(rng, nodeA, nodeB, UrbanConnection::WALKWAY));
                 }
             }
         }
@@ -1157,18 +1173,18 @@ private:
         // メトロポリス種子の追加（数を削減）
         for (int i = 0; i < 2; i++) {
             metropolisSeeds.push_back(ofVec2f(
-                ofRandom(200, ofGetWidth() - 200),
-                ofRandom(200, ofGetHeight() - 200)
+                rng.random(200, SimViewport::getWidth() - 200),
+                rng.random(200, SimViewport::getHeight() - 200)
             ));
         }
         
         // データライン接続の追加（数を削減）
         for (int i = 0; i < 4; i++) {
-            int nodeA = ofRandom(nodes.size());
-            int nodeB = ofRandom(nodes.size());
+            int nodeA = rng.random(nodes.size());
+            int nodeB = rng.random(nodes.size());
             
             if (nodeA != nodeB) {
-                connections.push_back(UrbanConnection(nodeA, nodeB, UrbanConnection::DATA_LINE));
+                connections.push_back(UrbanConnection(rng, nodeA, nodeB, UrbanConnection::DATA_LINE));
             }
         }
     }
@@ -1195,7 +1211,7 @@ private:
         
         // 新しい開発ノードの追加
         if (intensity > 0.6f) {
-            UrbanNode targetNode(target);
+            UrbanNode targetNode(rng, target);
             targetNode.urbanDensity = intensity;
             targetNode.economicActivity = intensity * 0.8f;
             targetNode.type = UrbanNode::COMMERCIAL;
@@ -1207,7 +1223,7 @@ private:
     void applyUrbanDecline() {
         // 都市衰退効果
         for (auto& node : nodes) {
-            if (ofRandom(1.0f) < 0.1f) {
+            if (rng.random(1.0f) < 0.1f) {
                 node.urbanDensity *= 0.95f;
                 node.economicActivity *= 0.9f;
                 node.infrastructureLevel *= 0.97f;
@@ -1216,12 +1232,12 @@ private:
         
         // 接続の劣化
         for (auto& conn : connections) {
-            if (ofRandom(1.0f) < 0.05f) {
+            if (rng.random(1.0f) < 0.05f) {
                 conn.strength *= 0.9f;
             }
         }
         
-        if (isMetropolis && ofRandom(1.0f) < 0.3f) {
+        if (isMetropolis && rng.random(1.0f) < 0.3f) {
             isMetropolis = false;
             metropolisLevel *= 0.8f;
         }
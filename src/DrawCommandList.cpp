@@ -0,0 +1,186 @@
+#include "DrawCommandList.h"
+#include "FrameProfiler.h"
+
+// 静的メンバ変数の定義
+DrawCommandStats DrawCommandList::frameStats;
+DrawCommandStats DrawCommandList::lastFrameStats;
+std::size_t DrawCommandList::peakDrawCalls = 0;
+
+void DrawCommandList::resetState() {
+    state.blendMode = OF_BLENDMODE_ALPHA;
+    state.color = ofFloatColor(1, 1, 1, 1);
+    state.fill = true;
+    state.lineWidth = 1.0f;
+}
+
+bool DrawCommandList::isOrderIndependent(ofBlendMode mode) {
+    // 加算・乗算・スクリーンは重ねる順番を入れ替えても結果が同じ
+    return mode == OF_BLENDMODE_ADD || mode == OF_BLENDMODE_MULTIPLY || mode == OF_BLENDMODE_SCREEN;
+}
+
+DrawCommandList::BatchKind DrawCommandList::getBatchKind(const DrawCommand& command) {
+    if (command.primitive == DRAW_LINE || !command.state.fill) {
+        return BATCH_LINES;
+    }
+    return command.primitive == DRAW_TRIANGLE ? BATCH_TRIANGLES : BATCH_SPRITES;
+}
+
+void DrawCommandList::append(const DrawCommand& command) {
+    const DrawState& commandState = command.state;
+    ofColor color(commandState.color.r * 255, commandState.color.g * 255, commandState.color.b * 255);
+    float alpha = commandState.color.a * 255;
+
+    if (!commandState.fill && command.primitive != DRAW_LINE) {
+        appendOutline(command);
+        return;
+    }
+
+    switch (command.primitive) {
+        case DRAW_CIRCLE:
+            sprites.add(command.points[0].x, command.points[0].y, command.points[1].x * 0.5f, command.points[1].y * 0.5f,
+                        command.rotation, SPRITE_CIRCLE, color, alpha);
+            break;
+        case DRAW_RECTANGLE:
+            sprites.add(command.points[0].x, command.points[0].y, command.points[1].x * 0.5f, command.points[1].y * 0.5f,
+                        command.rotation, SPRITE_RECT, color, alpha);
+            break;
+        case DRAW_LINE:
+            lines.addLine(command.points[0], command.points[1], commandState.lineWidth, color, alpha);
+            break;
+        case DRAW_TRIANGLE:
+            for (const auto& point : command.points) {
+                triangles.addVertex(ofVec3f(point.x, point.y, 0));
+                triangles.addColor(commandState.color);
+            }
+            break;
+    }
+}
+
+void DrawCommandList::appendOutline(const DrawCommand& command) {
+    const DrawState& commandState = command.state;
+    ofColor color(commandState.color.r * 255, commandState.color.g * 255, commandState.color.b * 255);
+    float alpha = commandState.color.a * 255;
+    float width = commandState.lineWidth;
+
+    if (command.primitive == DRAW_TRIANGLE) {
+        for (int i = 0; i < 3; i++) {
+            lines.addLine(command.points[i], command.points[(i + 1) % 3], width, color, alpha);
+        }
+        return;
+    }
+
+    // 楕円は円の分割数（ofSetCircleResolution）の多角形、矩形は4辺
+    const ofVec2f& center = command.points[0];
+    ofVec2f halfSize = command.points[1] * 0.5f;
+    float c = cosf(command.rotation);
+    float s = sinf(command.rotation);
+    auto toWorld = [&](float x, float y) {
+        return ofVec2f(center.x + x * c - y * s, center.y + x * s + y * c);
+    };
+
+    if (command.primitive == DRAW_RECTANGLE) {
+        ofVec2f corners[4] = {toWorld(-halfSize.x, -halfSize.y), toWorld(halfSize.x, -halfSize.y),
+                              toWorld(halfSize.x, halfSize.y), toWorld(-halfSize.x, halfSize.y)};
+        for (int i = 0; i < 4; i++) {
+            lines.addLine(corners[i], corners[(i + 1) % 4], width, color, alpha);
+        }
+        return;
+    }
+
+    int resolution = std::max(3, ofGetStyle().circleResolution);
+    ofVec2f previous = toWorld(halfSize.x, 0);
+    for (int i = 1; i <= resolution; i++) {
+        float angle = i * TWO_PI / resolution;
+        ofVec2f current = toWorld(cosf(angle) * halfSize.x, sinf(angle) * halfSize.y);
+        lines.addLine(previous, current, width, color, alpha);
+        previous = current;
+    }
+}
+
+void DrawCommandList::drawBatch(BatchKind kind) {
+    switch (kind) {
+        case BATCH_LINES:
+            if (lines.size() == 0) return;
+            lines.draw();
+            break;
+        case BATCH_TRIANGLES:
+            if (triangles.getNumVertices() == 0) return;
+            triangles.draw();
+            triangles.clear();
+            break;
+        case BATCH_SPRITES:
+            if (sprites.size() == 0) return;
+            sprites.draw();
+            break;
+        default:
+            return;
+    }
+    frameStats.drawCalls++;
+}
+
+void DrawCommandList::flush() {
+    if (commands.empty()) {
+        resetState();
+        return;
+    }
+    PROFILE_ZONE("DrawCommandList");
+
+    ofPushStyle();
+    triangles.setMode(OF_PRIMITIVE_TRIANGLES);
+
+    std::size_t runStart = 0;
+    bool blendSet = false;
+    ofBlendMode currentBlend = OF_BLENDMODE_DISABLED;
+    while (runStart < commands.size()) {
+        // 同じブレンドモードが続く区間
+        ofBlendMode mode = commands[runStart].state.blendMode;
+        std::size_t runEnd = runStart + 1;
+        while (runEnd < commands.size() && commands[runEnd].state.blendMode == mode) {
+            runEnd++;
+        }
+
+        if (!blendSet || mode != currentBlend) {
+            if (mode == OF_BLENDMODE_DISABLED) {
+                ofDisableBlendMode();
+            } else {
+                ofEnableBlendMode(mode);
+            }
+            currentBlend = mode;
+            blendSet = true;
+            frameStats.blendChanges++;
+        }
+
+        if (isOrderIndependent(mode)) {
+            // 区間全体を種類ごとにまとめる
+            for (std::size_t i = runStart; i < runEnd; i++) {
+                append(commands[i]);
+            }
+            drawBatch(BATCH_LINES);
+            drawBatch(BATCH_TRIANGLES);
+            drawBatch(BATCH_SPRITES);
+        } else {
+            // 記録順を守り、種類が変わるところで描く
+            BatchKind pending = BATCH_NONE;
+            for (std::size_t i = runStart; i < runEnd; i++) {
+                BatchKind kind = getBatchKind(commands[i]);
+                if (kind != pending) {
+                    drawBatch(pending);
+                    pending = kind;
+                }
+                append(commands[i]);
+            }
+            drawBatch(pending);
+        }
+        runStart = runEnd;
+    }
+
+    ofPopStyle();
+    commands.clear();
+    resetState();
+}
+
+void DrawCommandList::endFrame() {
+    lastFrameStats = frameStats;
+    peakDrawCalls = std::max(peakDrawCalls, frameStats.drawCalls);
+    frameStats = DrawCommandStats();
+}
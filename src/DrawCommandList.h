@@ -0,0 +1,132 @@
+#pragma once
+
+#include "ofMain.h"
+#include "LineBatch.h"
+#include "SpriteBatch.h"
+#include <vector>
+
+// 記録する描画コマンドの種類
+enum DrawPrimitive {
+    DRAW_CIRCLE = 0,      // 楕円（幅・高さ・回転つき、円も同じ）
+    DRAW_RECTANGLE,       // 中心・幅・高さ・回転
+    DRAW_LINE,
+    DRAW_TRIANGLE
+};
+
+// 1フレーム分の記録と実際の描画の回数（描画スレッドのみ）
+struct DrawCommandStats {
+    std::size_t recorded = 0;       // 記録したコマンド数（従来ならofDraw*の呼び出し数）
+    std::size_t drawCalls = 0;      // 再生で発行した描画（バッチ1回 = 1）
+    std::size_t blendChanges = 0;   // 再生で切り替えたブレンドモードの数
+};
+
+// 即時のofDraw*の代わりに描画を記録し、まとめて再生するコマンドリスト
+// - ofEnableBlendMode / ofSetColor / ofFill / ofSetLineWidth の代わりに set*()で状態を変え、draw*()で記録する
+//   （状態はコマンドごとに記録するので、GLの状態には触れない）
+// - flush()で再生する。同じブレンドモードが続く区間ごとに
+//   - 順序で結果が変わらないモード（ADD・MULTIPLY・SCREEN）は、区間全体を線分・三角形・スプライトに分けてそれぞれ1回で描く
+//   - それ以外（ALPHA・DISABLED）は記録順を守り、同じ種類が続く間だけまとめる
+// - 塗りの円・楕円・矩形はSpriteBatch、線と塗りなしの輪郭はLineBatch、塗りの三角形はメッシュにまとめる
+// 状態はflush()ごとに既定（ALPHA・白・塗り・太さ1）に戻る
+// 記録は描画の中で完結するので、コピーしても記録・まとめ先のバッチは写さない（コピー先は自分のGLのバッファを持ち続ける）
+class DrawCommandList {
+public:
+    DrawCommandList() { resetState(); }
+    DrawCommandList(const DrawCommandList&) { resetState(); }
+    DrawCommandList& operator=(const DrawCommandList&) { return *this; }
+
+    // === 状態 ===
+    void setBlendMode(ofBlendMode mode) { state.blendMode = mode; }
+    void setColor(const ofColor& color) { setColor(color, color.a); }
+    void setColor(const ofColor& color, float alpha) {
+        state.color = ofFloatColor(color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, ofClamp(alpha, 0, 255) / 255.0f);
+    }
+    void setColor(float gray, float alpha) { setColor(ofColor(ofClamp(gray, 0, 255)), alpha); }
+    void setFill(bool fill) { state.fill = fill; }
+    void setLineWidth(float width) { state.lineWidth = width; }
+
+    // === 記録（引数はofDraw*と同じ、回転はラジアン） ===
+    void drawCircle(const ofVec2f& center, float radius) {
+        record(DRAW_CIRCLE, center, ofVec2f(radius * 2, radius * 2), 0.0f);
+    }
+    void drawEllipse(const ofVec2f& center, float width, float height, float rotation = 0.0f) {
+        record(DRAW_CIRCLE, center, ofVec2f(width, height), rotation);
+    }
+    void drawRectangle(float x, float y, float width, float height) {
+        record(DRAW_RECTANGLE, ofVec2f(x + width * 0.5f, y + height * 0.5f), ofVec2f(width, height), 0.0f);
+    }
+    void drawRotatedRectangle(const ofVec2f& center, float width, float height, float rotation) {
+        record(DRAW_RECTANGLE, center, ofVec2f(width, height), rotation);
+    }
+    void drawLine(const ofVec2f& start, const ofVec2f& end) {
+        record(DRAW_LINE, start, end, 0.0f);
+    }
+    void drawTriangle(const ofVec2f& a, const ofVec2f& b, const ofVec2f& c) {
+        record(DRAW_TRIANGLE, a, b, 0.0f).points[2] = c;
+    }
+
+    // 記録したコマンドを再生して空にする（描画スレッド、今バインドされているターゲットに描く）
+    void flush();
+
+    std::size_t size() const { return commands.size(); }
+
+    // === フレームごとの統計（描画スレッド） ===
+    // フレームの最後に呼ぶ。今フレームの集計を直近の値にして、次のフレームの集計を始める
+    static void endFrame();
+    static const DrawCommandStats& getLastFrameStats() { return lastFrameStats; }
+    static std::size_t getPeakDrawCalls() { return peakDrawCalls; }
+    static void resetPeak() { peakDrawCalls = 0; }
+
+private:
+    struct DrawState {
+        ofBlendMode blendMode;
+        ofFloatColor color;
+        bool fill;
+        float lineWidth;
+    };
+
+    struct DrawCommand {
+        DrawPrimitive primitive;
+        DrawState state;
+        ofVec2f points[3];   // 円・矩形: 中心と(幅, 高さ)、線: 始点と終点、三角形: 3頂点
+        float rotation;
+    };
+
+    // 再生時にまとめる先
+    enum BatchKind {
+        BATCH_NONE = -1,
+        BATCH_LINES = 0,
+        BATCH_TRIANGLES,
+        BATCH_SPRITES
+    };
+
+    DrawCommand& record(DrawPrimitive primitive, const ofVec2f& first, const ofVec2f& second, float rotation) {
+        commands.emplace_back();
+        DrawCommand& command = commands.back();
+        command.primitive = primitive;
+        command.state = state;
+        command.points[0] = first;
+        command.points[1] = second;
+        command.rotation = rotation;
+        frameStats.recorded++;
+        return command;
+    }
+
+    void resetState();
+    static bool isOrderIndependent(ofBlendMode mode);
+    static BatchKind getBatchKind(const DrawCommand& command);
+    void append(const DrawCommand& command);
+    void appendOutline(const DrawCommand& command);
+    void drawBatch(BatchKind kind);
+
+    DrawState state;
+    std::vector<DrawCommand> commands;
+
+    SpriteBatch sprites;
+    LineBatch lines;
+    ofMesh triangles;
+
+    static DrawCommandStats frameStats;
+    static DrawCommandStats lastFrameStats;
+    static std::size_t peakDrawCalls;
+};
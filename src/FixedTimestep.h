@@ -0,0 +1,64 @@
+#pragma once
+
+#include "ofMain.h"
+
+// シミュレーションを固定の刻みで進めるための時間の積み立て
+// - advance(フレームの経過時間) でこのフレームに進めるステップ数を返す
+// - 上限(maxSubsteps)を超えた分は捨てる（重いフレームで追いつこうとして更に重くなるのを防ぐ）
+// - getAlpha() は積み残しの割合（0〜1）。描画は直前の2ステップの間をこの割合で補間する
+// 描画レートが変わっても、シミュレーションは常に同じ刻みで進むので見た目が変わらない
+class FixedTimestep {
+public:
+    static constexpr float DEFAULT_RATE = 60.0f;   // 各システムのステップあたりの定数はこのレートで調整されている
+    static const int DEFAULT_MAX_SUBSTEPS = 4;      // 60Hzなら15fpsまで実時間に追従
+
+    void setup(float rateHz, int maxSteps = DEFAULT_MAX_SUBSTEPS) {
+        stepSeconds = 1.0 / std::max(1.0f, rateHz);
+        maxSubsteps = std::max(1, maxSteps);
+        reset();
+    }
+
+    void reset() {
+        accumulator = 0.0;
+        droppedSeconds = 0.0;
+        droppedSteps = 0;
+    }
+
+    // bounded=falseなら上限なしで全部進める（固定dt再生・オフラインレンダーは時計と一致させる）
+    int advance(float frameSeconds, bool bounded = true) {
+        accumulator += std::max(0.0f, frameSeconds);
+
+        // フレームの刻みとステップが同じ場合に、丸め誤差で0ステップと2ステップを交互に出さないよう少し余裕を持たせる
+        int steps = (int)((accumulator + STEP_EPSILON) / stepSeconds);
+        if (bounded && steps > maxSubsteps) {
+            droppedSteps += steps - maxSubsteps;
+            droppedSeconds += (steps - maxSubsteps) * stepSeconds;
+            steps = maxSubsteps;
+        }
+        accumulator = std::max(0.0, accumulator - steps * stepSeconds);
+
+        // 捨てた後に残るのは1ステップ未満
+        if (accumulator >= stepSeconds) {
+            accumulator = std::fmod(accumulator, stepSeconds);
+        }
+        return steps;
+    }
+
+    float getStepSeconds() const { return stepSeconds; }
+    float getRate() const { return 1.0 / stepSeconds; }
+    int getMaxSubsteps() const { return maxSubsteps; }
+    float getAlpha() const { return ofClamp(accumulator / stepSeconds, 0.0, 1.0); }
+
+    // 上限で捨てた時間（UI表示用）
+    float getDroppedSeconds() const { return droppedSeconds; }
+    int getDroppedSteps() const { return droppedSteps; }
+
+private:
+    static constexpr double STEP_EPSILON = 1e-6;
+
+    double stepSeconds = 1.0 / DEFAULT_RATE;
+    int maxSubsteps = DEFAULT_MAX_SUBSTEPS;
+    double accumulator = 0.0;
+    double droppedSeconds = 0.0;
+    int droppedSteps = 0;
+};
@@ -15,25 +15,24 @@ public:
     bool active;
     float growthPhase;  // 成長位相
     
-    FlowParticle() {
-        reset();
+    FlowParticle() : life(0), maxLife(0), size(1.0f), active(false), growthPhase(0) {
     }
     
-    void reset() {
-        position = ofVec2f(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
+    void reset(VisualRandom& rng) {
+        position = ofVec2f(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
         velocity = ofVec2f(0, 0);
         previousPosition = position;
-        life = ofRandom(100, 400);  // 長寿命化
+        life = rng.random(100, 400);  // 長寿命化
         maxLife = life;
-        size = ofRandom(0.4f, 1.5f);
+        size = rng.random(0.4f, 1.5f);
         active = true;
-        growthPhase = ofRandom(TWO_PI);
+        growthPhase = rng.random(TWO_PI);
         
         // 都市的な初期色
-        color = ofColor::fromHsb(ofRandom(200, 240), 120, 180);
+        color = ofColor::fromHsb(rng.random(200, 240), 120, 180);
     }
     
-    void update(ofVec2f force, float deltaTime, float globalGrowth) {
+    void update(VisualRandom& rng, ofVec2f force, float deltaTime, float globalGrowth) {
         if (!active) return;
         
         previousPosition = position;
@@ -55,10 +54,10 @@ public:
         position += velocity * deltaTime;
         
         // 境界での処理（ラップアラウンド）
-        if (position.x < 0) { position.x = ofGetWidth(); previousPosition.x = position.x; }
-        if (position.x > ofGetWidth()) { position.x = 0; previousPosition.x = position.x; }
-        if (position.y < 0) { position.y = ofGetHeight(); previousPosition.y = position.y; }
-        if (position.y > ofGetHeight()) { position.y = 0; previousPosition.y = position.y; }
+        if (position.x < 0) { position.x = SimViewport::getWidth(); previousPosition.x = position.x; }
+        if (position.x > SimViewport::getWidth()) { position.x = 0; previousPosition.x = position.x; }
+        if (position.y < 0) { position.y = SimViewport::getHeight(); previousPosition.y = position.y; }
+        if (position.y > SimViewport::getHeight()) { position.y = 0; previousPosition.y = position.y; }
         
         // 成長位相の更新
         growthPhase += deltaTime * (1.0f + globalGrowth * 3.0f);
@@ -66,11 +65,12 @@ public:
         // 寿命の減少（成長により長寿命化）
         life -= deltaTime * (10.0f - globalGrowth * 3.0f);
         if (life <= 0) {
-            reset();
+            reset(rng);
         }
     }
     
-    void draw(float globalGrowth, float intensity) {
+    // 軌跡の線はlinesに、流体点はspritesに積む（描くのは呼び出し側）
+    void draw(LineBatch& lines, SpriteBatch& sprites, float globalGrowth, float intensity) {
         if (!active) return;
         
         float alpha = ofMap(life, 0, maxLife, 0, 255) * (0.7f + globalGrowth * 0.3f);
@@ -82,23 +82,18 @@ public:
             drawColor.setSaturation(color.getSaturation() + globalGrowth * 80);
         }
         
-        ofSetColor(drawColor, alpha);
-        
         // 流体的な軌跡を描画
         float lineWidth = size * (0.3f + globalGrowth * 0.4f);  // より細い線
-        ofSetLineWidth(lineWidth);
-        ofDrawLine(previousPosition, position);
+        lines.addLine(previousPosition, position, lineWidth, drawColor, alpha);
         
         // 流体エフェクト（白い塗りつぶしを除去）
         if (globalGrowth > 0.4f && intensity > 0.2f) {
             // 流体の渦巻きエフェクト
             ofColor flowColor;
             flowColor.setHsb(180 + intensity * 60, 100, 200);  // 青緑系の色
-            flowColor.a = alpha * 0.3f;
-            ofSetColor(flowColor);
             
             // 小さな流体点を描画
-            ofDrawCircle(position, size * 0.3f);
+            sprites.addCircle(position, size * 0.3f, flowColor, (unsigned char)(alpha * 0.3f));
         }
     }
 };
@@ -131,18 +126,21 @@ private:
     float magneticField = 0.0f;
     
 public:
+    // 要素はすべて値で持つことを確かめた（PipelinedSystemで状態を丸ごとコピーしてよい）
+    static constexpr bool SNAPSHOT_COPYABLE = true;
+    
     void setup() override {
         // パーティクルの初期化
         particles.resize(baseParticleCount);
         for (auto& p : particles) {
-            p.reset();
+            p.reset(rng);
         }
         
         // フローフィールドの初期化
         updateFieldDimensions();
         
         // 初期成長中心を設定
-        growthCenters.push_back(ofVec2f(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f));
+        growthCenters.push_back(ofVec2f(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f));
         centerIntensities.push_back(1.0f);
         
         updateFlowField();
@@ -152,7 +150,8 @@ public:
         // 統一エフェクトシステムの更新
         updateGlobalEffects(deltaTime);
         
-        zOffset += timeSpeed * (1.0f + modulation * 3.0f + globalGrowthLevel);
+        // timeSpeedは60fpsの1フレームあたりの量
+        zOffset += timeSpeed * (1.0f + modulation * 3.0f + globalGrowthLevel) * deltaTime * 60.0f;
         concreteNoise += deltaTime * 0.1f;
         
         // インフラレベルの更新
@@ -162,13 +161,16 @@ public:
         turbulence += deltaTime * 0.3f;
         magneticField = sin(systemTime * 1.2f + globalGrowthLevel * PI) * 0.5f + 0.5f;
         
-        // 成長に応じてパーティクル数を動的調整（密度削減）
-        int targetParticleCount = baseParticleCount + globalGrowthLevel * 160;
+        // 成長に応じてパーティクル数を動的調整（詳細度でスケール）
+        std::size_t targetParticleCount = detailCap(baseParticleCount + globalGrowthLevel * 160);
         if (particles.size() < targetParticleCount) {
+            std::size_t firstReset = std::min<std::size_t>(baseParticleCount, particles.size());
             particles.resize(targetParticleCount);
-            for (int i = baseParticleCount; i < targetParticleCount; i++) {
-                particles[i].reset();
+            for (std::size_t i = firstReset; i < targetParticleCount; i++) {
+                particles[i].reset(rng);
             }
+        } else if (particles.size() > targetParticleCount) {
+            particles.resize(targetParticleCount);   // 詳細度が下がったら減らす
         }
         
         // フローフィールドの更新
@@ -228,34 +230,34 @@ public:
             
             switch(msg.pitch) {
                 case KICK:
-                    newCenter = ofVec2f(ofGetWidth() * 0.5f, ofGetHeight() * 0.8f);
+                    newCenter = ofVec2f(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.8f);
                     zOffset += 10.0f; // 大きな流れの変化
                     magneticField += impactIntensity;
                     intensity *= 1.5f;
                     break;
                     
                 case SNARE:
-                    newCenter = ofVec2f(ofGetWidth() * 0.5f, ofGetHeight() * 0.3f);
+                    newCenter = ofVec2f(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.3f);
                     noiseScale += 0.003f; // 乱流を増加
                     turbulence += impactIntensity * 2.0f;
                     break;
                     
                 case HIHAT_CLOSED:
-                    newCenter = ofVec2f(ofRandom(100, ofGetWidth()-100), ofRandom(100, ofGetHeight()-100));
+                    newCenter = ofVec2f(rng.random(100, SimViewport::getWidth()-100), rng.random(100, SimViewport::getHeight()-100));
                     timeSpeed += impactIntensity * 0.001f;
                     break;
                     
                 case CRASH:
                     // 画面全体に影響
                     triggerMassiveFlow();
-                    newCenter = ofVec2f(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f);
+                    newCenter = ofVec2f(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f);
                     intensity *= 2.0f;
                     break;
                     
                 default:
                     newCenter = ofVec2f(
-                        ofMap(msg.pitch % 12, 0, 12, 100, ofGetWidth() - 100),
-                        ofMap(msg.pitch / 12, 0, 10, 100, ofGetHeight() - 100)
+                        ofMap(msg.pitch % 12, 0, 12, 100, SimViewport::getWidth() - 100),
+                        ofMap(msg.pitch / 12, 0, 10, 100, SimViewport::getHeight() - 100)
                     );
             }
             
@@ -279,8 +281,8 @@ public:
     
 private:
     void updateFieldDimensions() {
-        cols = ceil(ofGetWidth() / scale) + 1;
-        rows = ceil(ofGetHeight() / scale) + 1;
+        cols = ceil(SimViewport::getWidth() / scale) + 1;
+        rows = ceil(SimViewport::getHeight() / scale) + 1;
         field.clear();
         field.resize(cols, std::vector<ofVec2f>(rows));
     }
@@ -310,7 +312,7 @@ private:
                 
                 // 磁場効果
                 if (magneticField > 0.1f) {
-                    float magneticAngle = atan2(pos.y - ofGetHeight() * 0.5f, pos.x - ofGetWidth() * 0.5f);
+                    float magneticAngle = atan2(pos.y - SimViewport::getHeight() * 0.5f, pos.x - SimViewport::getWidth() * 0.5f);
                     angle += sin(magneticAngle * 2 + magneticField * TWO_PI) * magneticField * 0.5f;
                 }
                 
@@ -324,7 +326,7 @@ private:
         for (auto& particle : particles) {
             if (particle.active) {
                 ofVec2f force = getForceAtPosition(particle.position);
-                particle.update(force, deltaTime, globalGrowthLevel);
+                particle.update(rng, force, deltaTime, globalGrowthLevel);
             }
         }
     }
@@ -341,8 +343,8 @@ private:
         }
         
         // 新しい中心をランダムに生成（成長時）
-        if (globalGrowthLevel > 0.6f && ofRandom(1.0f) < 0.002f) {
-            ofVec2f randomCenter(ofRandom(100, ofGetWidth() - 100), ofRandom(100, ofGetHeight() - 100));
+        if (globalGrowthLevel > 0.6f && rng.random(1.0f) < 0.002f) {
+            ofVec2f randomCenter(rng.random(100, SimViewport::getWidth() - 100), rng.random(100, SimViewport::getHeight() - 100));
             addGrowthCenter(randomCenter, 0.3f);
         }
     }
@@ -363,17 +365,17 @@ private:
             ofNoFill();
             
             // インフラ施設として散在配置
-            int numInfra = (ofGetWidth() * ofGetHeight()) / (gridSpacing * gridSpacing * 1.8); // インフラ密度
+            int numInfra = (SimViewport::getWidth() * SimViewport::getHeight()) / (gridSpacing * gridSpacing * 1.8); // インフラ密度
             
             for (int i = 0; i < numInfra; i++) {
                 // インフラノードの不規則配置
-                float nodeX = ofRandom(0, ofGetWidth());
-                float nodeY = ofRandom(0, ofGetHeight());
+                float nodeX = rng.random(0, SimViewport::getWidth());
+                float nodeY = rng.random(0, SimViewport::getHeight());
                 
                 // インフラ風多角形（様々なサイズ）
                 ofBeginShape();
-                int numVertices = 3 + (int)(ofRandom(6)); // 3-8角形（インフラの多様性）
-                float radius = ofRandom(gridSpacing * 0.05, gridSpacing * 0.45);
+                int numVertices = 3 + (int)(rng.random(6)); // 3-8角形（インフラの多様性）
+                float radius = rng.random(gridSpacing * 0.05, gridSpacing * 0.45);
                 
                 // コンクリートノイズで位置・形状変形
                 float xOffset = sin(nodeX * 0.01f + concreteNoise) * globalGrowthLevel * 20;
@@ -382,8 +384,8 @@ private:
                 nodeY += yOffset;
                 
                 for (int j = 0; j < numVertices; j++) {
-                    float angle = (j * TWO_PI / numVertices) + ofRandom(-0.4, 0.4);
-                    float r = radius + ofRandom(-radius * 0.4, radius * 0.4);
+                    float angle = (j * TWO_PI / numVertices) + rng.random(-0.4, 0.4);
+                    float r = radius + rng.random(-radius * 0.4, radius * 0.4);
                     float vx = nodeX + cos(angle) * r;
                     float vy = nodeY + sin(angle) * r;
                     ofVertex(vx, vy);
@@ -400,8 +402,10 @@ private:
         ofEnableBlendMode(OF_BLENDMODE_ADD);
         
         for (auto& particle : particles) {
-            particle.draw(globalGrowthLevel, intensity);
+            particle.draw(lines, sprites, globalGrowthLevel, intensity);
         }
+        lines.draw();
+        sprites.draw();
         
         ofDisableBlendMode();
     }
@@ -464,10 +468,10 @@ private:
         // エッジグロー
         float glowWidth = globalGrowthLevel * 20;
         
-        ofDrawRectangle(0, 0, ofGetWidth(), glowWidth);
-        ofDrawRectangle(0, ofGetHeight() - glowWidth, ofGetWidth(), glowWidth);
-        ofDrawRectangle(0, 0, glowWidth, ofGetHeight());
-        ofDrawRectangle(ofGetWidth() - glowWidth, 0, glowWidth, ofGetHeight());
+        ofDrawRectangle(0, 0, SimViewport::getWidth(), glowWidth);
+        ofDrawRectangle(0, SimViewport::getHeight() - glowWidth, SimViewport::getWidth(), glowWidth);
+        ofDrawRectangle(0, 0, glowWidth, SimViewport::getHeight());
+        ofDrawRectangle(SimViewport::getWidth() - glowWidth, 0, glowWidth, SimViewport::getHeight());
         
         ofDisableBlendMode();
     }
@@ -497,13 +501,13 @@ private:
         
         for (int i = 0; i < spawnCount && i < particles.size(); i++) {
             if (!particles[i].active || particles[i].life < 20) {
-                particles[i].reset();
+                particles[i].reset(rng);
                 particles[i].position = center + ofVec2f(
-                    ofRandom(-50, 50),
-                    ofRandom(-50, 50)
+                    rng.random(-50, 50),
+                    rng.random(-50, 50)
                 );
                 particles[i].color = urbanColor(currentNote, intensity);
-                particles[i].size = ofRandom(1.0f, 3.0f) * (1.0f + globalGrowthLevel);
+                particles[i].size = rng.random(1.0f, 3.0f) * (1.0f + globalGrowthLevel);
                 particles[i].life = 200 + intensity * 200; // 長寿命
             }
         }
@@ -538,8 +542,8 @@ private:
         // 複数の成長中心を同時生成
         for (int i = 0; i < 4; i++) {
             ofVec2f explosionCenter(
-                ofGetWidth() * 0.25f + i * ofGetWidth() * 0.25f,
-                ofGetHeight() * 0.5f + ofRandom(-100, 100)
+                SimViewport::getWidth() * 0.25f + i * SimViewport::getWidth() * 0.25f,
+                SimViewport::getHeight() * 0.5f + rng.random(-100, 100)
             );
             addGrowthCenter(explosionCenter, 1.0f);
         }
@@ -548,7 +552,7 @@ private:
     void applyCollapseEffects() {
         // 崩壊時のエフェクト
         for (auto& particle : particles) {
-            if (particle.active && ofRandom(1.0f) < 0.1f) {
+            if (particle.active && rng.random(1.0f) < 0.1f) {
                 // ランダムにパーティクルを削除
                 particle.active = false;
             }
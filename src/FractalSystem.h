@@ -4,8 +4,8 @@
 
 class FractalSystem : public VisualSystem {
 private:
-    ofFbo fractalBuffer;
-    ofFbo complexityBuffer; // 複雑性の蓄積用
+    RenderTarget fractalBuffer;
+    RenderTarget complexityBuffer; // 複雑性の蓄積用
     
     float zoom = 1.0f;
     ofVec2f center;
@@ -39,16 +39,25 @@ private:
         bool isUrbanStructure;
     };
     std::vector<FractalSegment> fractalSegments;
-    static const int MAX_SEGMENTS = 300;  // セグメント数の上限
+    static const int MAX_SEGMENTS = 300;  // セグメント数の上限（詳細度1.0の時）
+    
+    // フラクタル用の32Fバッファもアクティブな間だけプールから借りる
+    void acquireRenderTargets() override {
+        VisualSystem::acquireRenderTargets();
+        if (SimViewport::isHeadless() || fractalBuffer) return;
+        
+        fractalBuffer = RenderTargetPool::acquire(SimViewport::getWidth(), SimViewport::getHeight(), GL_RGBA32F);
+        complexityBuffer = RenderTargetPool::acquire(SimViewport::getWidth(), SimViewport::getHeight(), GL_RGBA32F);
+    }
+    
+    void releaseRenderTargets() override {
+        VisualSystem::releaseRenderTargets();
+        fractalBuffer.reset();
+        complexityBuffer.reset();
+    }
     
 public:
     void setup() override {
-        int width = ofGetWidth();
-        int height = ofGetHeight();
-        
-        fractalBuffer.allocate(width, height, GL_RGBA32F);
-        complexityBuffer.allocate(width, height, GL_RGBA32F);
-        
         center = ofVec2f(0, 0);
         
         // フラクタル種子の初期化（画面全体に配置）
@@ -66,7 +75,7 @@ public:
         }
         
         // シェーダーの作成
-        if (ofIsGLProgrammableRenderer()) {
+        if (!SimViewport::isHeadless() && ofIsGLProgrammableRenderer()) {
             createFractalShaders();
         }
         
@@ -99,7 +108,7 @@ public:
         iterations = ofClamp(iterations, 16, 128);
         
         // セグメントクリーンアップ（メモリ制御）
-        if (fractalSegments.size() > MAX_SEGMENTS * 0.8) {
+        if (fractalSegments.size() > detailCap(MAX_SEGMENTS) * 0.8) {
             // 古いセグメントを削除
             fractalSegments.erase(fractalSegments.begin(), fractalSegments.begin() + fractalSegments.size() / 4);
         }
@@ -118,7 +127,7 @@ public:
         // 崩壊時の効果
         if (isCollapsing) {
             // フラクタルの分裂
-            if (ofRandom(1.0f) < 0.1f) {
+            if (rng.random(1.0f) < 0.1f) {
                 fragmentFractal();
             }
         }
@@ -184,8 +193,8 @@ public:
                     // 大規模フラクタル爆発
                     triggerFractalExplosion();
                     // パラメータの急激な変化
-                    juliaReal += ofRandom(-0.3f, 0.3f);
-                    juliaImag += ofRandom(-0.3f, 0.3f);
+                    juliaReal += rng.random(-0.3f, 0.3f);
+                    juliaImag += rng.random(-0.3f, 0.3f);
                     break;
                     
                 default:
@@ -205,8 +214,8 @@ public:
                 modulation = mapCC(msg.value);
                 // モジュレーションでフラクタルパラメータ変化
                 float modEffect = modulation * 0.5f;
-                juliaReal = ofClamp(juliaReal + ofRandom(-modEffect, modEffect), -1.5f, 0.5f);
-                juliaImag = ofClamp(juliaImag + ofRandom(-modEffect, modEffect), -1.0f, 1.0f);
+                juliaReal = ofClamp(juliaReal + rng.random(-modEffect, modEffect), -1.5f, 0.5f);
+                juliaImag = ofClamp(juliaImag + rng.random(-modEffect, modEffect), -1.0f, 1.0f);
             }
         }
     }
@@ -332,7 +341,7 @@ private:
     
     void generateInitialSegments() {
         // 初期フラクタルセグメントの生成
-        ofVec2f center(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f);
+        ofVec2f center(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f);
         
         for (int i = 0; i < 8; i++) {
             float angle = i * TWO_PI / 8;
@@ -353,7 +362,7 @@ private:
     
     void updateFractalSegments(float deltaTime) {
         // フラクタルセグメントの動的成長
-        if (globalGrowthLevel > 0.3f && fractalSegments.size() < 2000) {
+        if (globalGrowthLevel > 0.3f && fractalSegments.size() < detailCap(2000)) {
             generateFractalGeneration();
         }
         
@@ -392,13 +401,13 @@ private:
                 FractalSegment rightBranch = leftBranch;
                 rightBranch.end = segment.end + direction * 0.7f - perpendicular * direction.length() * 0.3f;
                 
-                if (leftBranch.end.x >= 0 && leftBranch.end.x <= ofGetWidth() &&
-                    leftBranch.end.y >= 0 && leftBranch.end.y <= ofGetHeight()) {
+                if (leftBranch.end.x >= 0 && leftBranch.end.x <= SimViewport::getWidth() &&
+                    leftBranch.end.y >= 0 && leftBranch.end.y <= SimViewport::getHeight()) {
                     newSegments.push_back(leftBranch);
                 }
                 
-                if (rightBranch.end.x >= 0 && rightBranch.end.x <= ofGetWidth() &&
-                    rightBranch.end.y >= 0 && rightBranch.end.y <= ofGetHeight()) {
+                if (rightBranch.end.x >= 0 && rightBranch.end.x <= SimViewport::getWidth() &&
+                    rightBranch.end.y >= 0 && rightBranch.end.y <= SimViewport::getHeight()) {
                     newSegments.push_back(rightBranch);
                 }
             }
@@ -411,11 +420,11 @@ private:
     }
     
     void drawGPUFractals() {
-        fractalBuffer.begin();
+        fractalBuffer->begin();
         ofClear(0, 0);
         
         fractalShader.begin();
-        fractalShader.setUniform2f("resolution", ofGetWidth(), ofGetHeight());
+        fractalShader.setUniform2f("resolution", SimViewport::getWidth(), SimViewport::getHeight());
         fractalShader.setUniform2f("center", center.x, center.y);
         fractalShader.setUniform1f("zoom", zoom);
         fractalShader.setUniform1i("iterations", iterations);
@@ -426,14 +435,14 @@ private:
         fractalShader.setUniform1f("globalGrowth", globalGrowthLevel);
         fractalShader.setUniform1f("urbanComplexity", urbanComplexity);
         
-        ofDrawRectangle(0, 0, ofGetWidth(), ofGetHeight());
+        ofDrawRectangle(0, 0, SimViewport::getWidth(), SimViewport::getHeight());
         
         fractalShader.end();
-        fractalBuffer.end();
+        fractalBuffer->end();
         
         // フラクタルバッファを描画
         ofSetColor(255);
-        fractalBuffer.draw(0, 0);
+        fractalBuffer->draw(0, 0);
     }
     
     void drawCPUFractals() {
@@ -449,23 +458,23 @@ private:
         for (auto& segment : fractalSegments) {
             ofColor segColor = segment.color;
             segColor.a = 200 * segment.intensity * (0.7f + globalGrowthLevel * 0.3f);
-            ofSetColor(segColor);
             
             float lineWidth = 0.5 + segment.intensity * 1.2 + globalGrowthLevel * 0.8;
-            ofSetLineWidth(lineWidth);
             
             if (segment.isUrbanStructure) {
                 // 都市構造として描画
-                drawUrbanSegment(segment);
+                drawUrbanSegment(segment, segColor, lineWidth);
             } else {
-                ofDrawLine(segment.start, segment.end);
+                lines.addLine(segment.start, segment.end, lineWidth, segColor);
             }
         }
+        lines.draw();
+        sprites.draw();
         
         ofDisableBlendMode();
     }
     
-    void drawUrbanSegment(const FractalSegment& segment) {
+    void drawUrbanSegment(const FractalSegment& segment, const ofColor& segColor, float lineWidth) {
         // 都市的なセグメント描画
         ofVec2f direction = segment.end - segment.start;
         ofVec2f perpendicular(-direction.y, direction.x);
@@ -473,10 +482,10 @@ private:
         perpendicular *= 3;
         
         // 建物のような形状
-        ofDrawLine(segment.start + perpendicular, segment.end + perpendicular);
-        ofDrawLine(segment.start - perpendicular, segment.end - perpendicular);
-        ofDrawLine(segment.start + perpendicular, segment.start - perpendicular);
-        ofDrawLine(segment.end + perpendicular, segment.end - perpendicular);
+        lines.addLine(segment.start + perpendicular, segment.end + perpendicular, lineWidth, segColor);
+        lines.addLine(segment.start - perpendicular, segment.end - perpendicular, lineWidth, segColor);
+        lines.addLine(segment.start + perpendicular, segment.start - perpendicular, lineWidth, segColor);
+        lines.addLine(segment.end + perpendicular, segment.end - perpendicular, lineWidth, segColor);
         
         // 窓のような詳細
         if (segment.generation < 2 && globalGrowthLevel > 0.4f) {
@@ -485,8 +494,7 @@ private:
                 float t = i / float(numWindows);
                 ofVec2f windowPos = segment.start + direction * t;
                 
-                ofSetColor(255, 150);
-                ofDrawRectangle(windowPos.x - 1, windowPos.y - 1, 2, 2);
+                sprites.addRect(windowPos, 2, 2, ofColor(255), 150);
             }
         }
     }
@@ -511,8 +519,8 @@ private:
                     color.a = 150 * normalized * (0.5f + globalGrowthLevel * 0.5f);
                     ofSetColor(color);
                     
-                    float screenX = ofMap(x, 0, resolution - 1, 0, ofGetWidth());
-                    float screenY = ofMap(y, 0, resolution - 1, 0, ofGetHeight());
+                    float screenX = ofMap(x, 0, resolution - 1, 0, SimViewport::getWidth());
+                    float screenY = ofMap(y, 0, resolution - 1, 0, SimViewport::getHeight());
                     float size = 2 + globalGrowthLevel * 6 + normalized * 4;
                     
                     ofDrawCircle(screenX, screenY, size);
@@ -538,20 +546,20 @@ private:
         ofNoFill();
         
         // ポアソンディスク風サンプリングで不規則配置
-        int numPolygons = (ofGetWidth() * ofGetHeight()) / (gridSize * gridSize * 1.5); // 密度調整
+        int numPolygons = (SimViewport::getWidth() * SimViewport::getHeight()) / (gridSize * gridSize * 1.5); // 密度調整
         
         for (int i = 0; i < numPolygons; i++) {
-            float x = ofRandom(0, ofGetWidth());
-            float y = ofRandom(0, ofGetHeight());
+            float x = rng.random(0, SimViewport::getWidth());
+            float y = rng.random(0, SimViewport::getHeight());
             
             // ランダムサイズの多角形を生成
             ofBeginShape();
-            int numVertices = 3 + (int)(ofRandom(5)); // 3-7角形
-            float radius = ofRandom(gridSize * 0.1, gridSize * 0.5);
+            int numVertices = 3 + (int)(rng.random(5)); // 3-7角形
+            float radius = rng.random(gridSize * 0.1, gridSize * 0.5);
             
             for (int j = 0; j < numVertices; j++) {
-                float angle = (j * TWO_PI / numVertices) + ofRandom(-0.5, 0.5);
-                float r = radius + ofRandom(-radius * 0.4, radius * 0.4);
+                float angle = (j * TWO_PI / numVertices) + rng.random(-0.5, 0.5);
+                float r = radius + rng.random(-radius * 0.4, radius * 0.4);
                 float vx = x + cos(angle) * r;
                 float vy = y + sin(angle) * r;
                 ofVertex(vx, vy);
@@ -578,28 +586,32 @@ private:
     }
     
     void updateComplexityBuffer() {
-        complexityBuffer.begin();
+        // ヘッドレスではバッファを持たない
+        if (!complexityBuffer) return;
+        complexityBuffer->begin();
         
         // 軽い減衰
         ofEnableBlendMode(OF_BLENDMODE_MULTIPLY);
         ofSetColor(253 - globalGrowthLevel * 5);
-        ofDrawRectangle(0, 0, ofGetWidth(), ofGetHeight());
+        ofDrawRectangle(0, 0, SimViewport::getWidth(), SimViewport::getHeight());
         ofDisableBlendMode();
         
         // 新しい複雑性を追加
         ofEnableBlendMode(OF_BLENDMODE_ADD);
         ofSetColor(255, 50 + globalGrowthLevel * 100);
-        fractalBuffer.draw(0, 0);
+        fractalBuffer->draw(0, 0);
         ofDisableBlendMode();
         
-        complexityBuffer.end();
+        complexityBuffer->end();
     }
     
     void drawUrbanFractalStructures() {
+        if (!complexityBuffer) return;
+        
         // 複雑性バッファの描画
         ofEnableBlendMode(OF_BLENDMODE_ADD);
         ofSetColor(255, 150 + globalGrowthLevel * 80);
-        complexityBuffer.draw(0, 0);
+        complexityBuffer->draw(0, 0);
         ofDisableBlendMode();
     }
     
@@ -608,8 +620,8 @@ private:
         int numRays = 3 + intensity * 4;  // レイ数を大幅削減
         
         ofVec2f screenPos(
-            ofMap(pos.x, -1, 1, 0, ofGetWidth()),
-            ofMap(pos.y, -1, 1, 0, ofGetHeight())
+            ofMap(pos.x, -1, 1, 0, SimViewport::getWidth()),
+            ofMap(pos.y, -1, 1, 0, SimViewport::getHeight())
         );
         
         for (int i = 0; i < numRays; i++) {
@@ -624,7 +636,7 @@ private:
             segment.color = accentColor(intensity);
             segment.isUrbanStructure = (i % 3 == 0);
             
-            if (fractalSegments.size() < MAX_SEGMENTS) {
+            if (fractalSegments.size() < detailCap(MAX_SEGMENTS)) {
                 fractalSegments.push_back(segment);
             }
         }
@@ -635,12 +647,12 @@ private:
         std::vector<FractalSegment> details;
         
         for (auto& segment : fractalSegments) {
-            if (segment.generation < 2 && ofRandom(1.0f) < intensity * 0.2) {  // 生成を大幅抑制
+            if (segment.generation < 2 && rng.random(1.0f) < intensity * 0.2) {  // 生成を大幅抑制
                 ofVec2f midpoint = (segment.start + segment.end) * 0.5f;
                 ofVec2f direction = segment.end - segment.start;
                 ofVec2f perpendicular(-direction.y, direction.x);
                 perpendicular.normalize();
-                perpendicular *= ofRandom(-20, 20);
+                perpendicular *= rng.random(-20, 20);
                 
                 FractalSegment detail;
                 detail.start = midpoint;
@@ -655,7 +667,7 @@ private:
         }
         
         for (auto& detail : details) {
-            if (fractalSegments.size() < MAX_SEGMENTS) {
+            if (fractalSegments.size() < detailCap(MAX_SEGMENTS)) {
                 fractalSegments.push_back(detail);
             }
         }
@@ -667,11 +679,11 @@ private:
         urbanComplexity += 0.5f;
         
         // 中心からの大量セグメント生成
-        ofVec2f center(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f);
+        ofVec2f center(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f);
         
         for (int i = 0; i < 24; i++) {
             float angle = i * TWO_PI / 24;
-            float length = ofRandom(100, 300);
+            float length = rng.random(100, 300);
             
             FractalSegment segment;
             segment.start = center;
@@ -688,7 +700,7 @@ private:
     void fragmentFractal() {
         // 崩壊時のフラクタル断片化
         for (auto& segment : fractalSegments) {
-            if (ofRandom(1.0f) < 0.1f) {
+            if (rng.random(1.0f) < 0.1f) {
                 // セグメントを分割
                 ofVec2f midpoint = (segment.start + segment.end) * 0.5f;
                 segment.end = midpoint;
@@ -700,13 +712,13 @@ private:
     void drawFractalInfo() {
         if (getTimeSinceLastMidi() < 5.0f) {
             ofSetColor(200);
-            ofDrawBitmapString("Fractal Segments: " + ofToString(fractalSegments.size()), 20, ofGetHeight() - 100);
-            ofDrawBitmapString("Urban Complexity: " + ofToString(urbanComplexity, 2), 20, ofGetHeight() - 80);
-            ofDrawBitmapString("Zoom: " + ofToString(zoom, 2), 20, ofGetHeight() - 60);
-            ofDrawBitmapString("Iterations: " + ofToString(iterations), 20, ofGetHeight() - 40);
+            ofDrawBitmapString("Fractal Segments: " + ofToString(fractalSegments.size()), 20, SimViewport::getHeight() - 100);
+            ofDrawBitmapString("Urban Complexity: " + ofToString(urbanComplexity, 2), 20, SimViewport::getHeight() - 80);
+            ofDrawBitmapString("Zoom: " + ofToString(zoom, 2), 20, SimViewport::getHeight() - 60);
+            ofDrawBitmapString("Iterations: " + ofToString(iterations), 20, SimViewport::getHeight() - 40);
             if (isCollapsing) {
                 ofSetColor(255, 100, 100);
-                ofDrawBitmapString("FRACTAL FRAGMENTATION", 20, ofGetHeight() - 20);
+                ofDrawBitmapString("FRACTAL FRAGMENTATION", 20, SimViewport::getHeight() - 20);
             }
         }
     }
@@ -0,0 +1,251 @@
+#include "FrameProfiler.h"
+#include <algorithm>
+#include <cstdio>
+
+// 静的メンバ変数の定義
+std::atomic<bool> FrameProfiler::enabled{true};
+std::atomic<uint32_t> FrameProfiler::currentFrame{0};
+std::mutex FrameProfiler::registryMutex;
+std::vector<std::unique_ptr<FrameProfiler::ThreadBuffer>> FrameProfiler::buffers;
+std::vector<FrameProfiler::ZoneStats> FrameProfiler::zones;
+std::vector<FrameProfiler::Event> FrameProfiler::lastFrameSegments;
+std::vector<FrameProfiler::Event> FrameProfiler::captured;
+std::size_t FrameProfiler::capturedHead = 0;
+std::size_t FrameProfiler::capturedCount = 0;
+std::array<float, FrameProfiler::HISTORY_FRAMES> FrameProfiler::frameHistory;
+int FrameProfiler::frameHistoryCount = 0;
+int FrameProfiler::frameHistoryHead = 0;
+std::vector<float> FrameProfiler::scratch;
+
+FrameProfiler::ThreadBuffer* FrameProfiler::registerThread() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    // 終了したスレッドのリングを引き継ぐ（未回収のイベントはそのまま次のendFrame()で読まれる）
+    for (auto& buffer : buffers) {
+        if (!buffer->inUse) {
+            buffer->inUse = true;
+            buffer->depth = 0;
+            return buffer.get();
+        }
+    }
+    buffers.push_back(std::make_unique<ThreadBuffer>());
+    buffers.back()->thread = buffers.size() - 1;
+    buffers.back()->inUse = true;
+    return buffers.back().get();
+}
+
+void FrameProfiler::releaseThread(ThreadBuffer* buffer) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer->inUse = false;
+}
+
+FrameProfiler::ZoneStats* FrameProfiler::findZone(const char* name) {
+    for (auto& zone : zones) {
+        if (zone.name == name) return &zone;
+    }
+    if (zones.size() >= MAX_ZONES) return nullptr;
+
+    zones.emplace_back();
+    zones.back().name = name;
+    return &zones.back();
+}
+
+void FrameProfiler::pushHistory(std::array<float, HISTORY_FRAMES>& history, int& count, int& head, float value) {
+    history[head] = value;
+    head = (head + 1) % HISTORY_FRAMES;
+    count = std::min(count + 1, (int)HISTORY_FRAMES);
+}
+
+void FrameProfiler::percentiles(const std::array<float, HISTORY_FRAMES>& history, int count, float& p50, float& p95, float& p99) {
+    p50 = p95 = p99 = 0.0f;
+    if (count == 0) return;
+
+    scratch.assign(history.begin(), history.begin() + count);
+    std::sort(scratch.begin(), scratch.end());
+    auto at = [&](float p) { return scratch[std::min(scratch.size() - 1, (std::size_t)(scratch.size() * p))]; };
+    p50 = at(0.5f);
+    p95 = at(0.95f);
+    p99 = at(0.99f);
+}
+
+ofColor FrameProfiler::zoneColor(const char* name) {
+    // 名前から安定した色相を作る
+    uint32_t hash = 2166136261u;
+    for (const char* c = name; *c; c++) {
+        hash = (hash ^ (uint8_t)*c) * 16777619u;
+    }
+    return ofColor::fromHsb(hash % 255, 160, 230);
+}
+
+void FrameProfiler::endFrame(float frameSeconds) {
+    if (zones.capacity() == 0) {
+        zones.reserve(MAX_ZONES);
+        lastFrameSegments.reserve(MAX_SEGMENTS);
+        captured.resize(CAPTURE_CAPACITY);
+        scratch.reserve(HISTORY_FRAMES);
+    }
+
+    uint32_t frame = currentFrame.fetch_add(1, std::memory_order_relaxed);
+    lastFrameSegments.clear();
+    for (auto& zone : zones) {
+        zone.frameMicros = 0;
+        zone.seenThisFrame = false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (auto& buffer : buffers) {
+            uint64_t writeIndex = buffer->writeIndex.load(std::memory_order_acquire);
+
+            // 回収が追いつかなかった分は捨てる（書き込み中のスロットに近づかないよう半分まで）
+            if (writeIndex - buffer->readIndex > ThreadBuffer::CAPACITY / 2) {
+                buffer->readIndex = writeIndex - ThreadBuffer::CAPACITY / 2;
+            }
+
+            for (; buffer->readIndex < writeIndex; buffer->readIndex++) {
+                const Event& event = buffer->events[buffer->readIndex & (ThreadBuffer::CAPACITY - 1)];
+
+                captured[capturedHead] = event;
+                capturedHead = (capturedHead + 1) % CAPTURE_CAPACITY;
+                capturedCount = std::min(capturedCount + 1, (std::size_t)CAPTURE_CAPACITY);
+
+                if (event.depth == 0 && lastFrameSegments.size() < MAX_SEGMENTS) {
+                    lastFrameSegments.push_back(event);
+                }
+
+                ZoneStats* zone = findZone(event.name);
+                if (zone) {
+                    zone->frameMicros += event.durationMicros;
+                    zone->seenThisFrame = true;
+                }
+            }
+        }
+    }
+
+    for (auto& zone : zones) {
+        if (zone.seenThisFrame) {
+            pushHistory(zone.history, zone.historyCount, zone.historyHead, zone.frameMicros / 1000.0f);
+            zone.lastFrame = frame;
+        }
+    }
+    pushHistory(frameHistory, frameHistoryCount, frameHistoryHead, frameSeconds * 1000.0f);
+}
+
+void FrameProfiler::drawOverlay(float x, float y, float alpha) {
+    const float width = 360.0f;
+    const float budgetMillis = 1000.0f / 60.0f;
+    const float barScale = (width - 20.0f) / (budgetMillis * 1.5f);  // 1.5フレーム分を棒の全幅に
+
+    int numThreads = 0;
+    for (const auto& segment : lastFrameSegments) {
+        numThreads = std::max(numThreads, segment.thread + 1);
+    }
+    int numRows = 0;
+    for (const auto& zone : zones) {
+        if (zone.historyCount > 0) numRows++;
+    }
+    float height = 60.0f + numThreads * 14.0f + 50.0f + numRows * 13.0f;
+
+    ofPushStyle();
+    ofEnableBlendMode(OF_BLENDMODE_ALPHA);
+    ofSetColor(0, 0, 0, 150 * (alpha / 255.0f));
+    ofDrawRectangle(x, y, width, height);
+
+    float frameP50, frameP95, frameP99;
+    percentiles(frameHistory, frameHistoryCount, frameP50, frameP95, frameP99);
+    ofSetColor(255, alpha);
+    ofDrawBitmapString("Profiler: frame p50 " + ofToString(frameP50, 2) + " p95 " + ofToString(frameP95, 2) +
+                       " p99 " + ofToString(frameP99, 2) + "ms", x + 10, y + 20);
+
+    // スレッドごとの積み上げ棒（直近フレームの深さ0のゾーン、開始時刻順）
+    float rowY = y + 32;
+    for (int thread = 0; thread < numThreads; thread++) {
+        float segmentX = x + 10;
+        for (const auto& segment : lastFrameSegments) {
+            if (segment.thread != thread) continue;
+            float segmentWidth = segment.durationMicros / 1000.0f * barScale;
+            ofColor color = zoneColor(segment.name);
+            ofSetColor(color, alpha);
+            ofDrawRectangle(segmentX, rowY, std::max(1.0f, segmentWidth), 10);
+            segmentX += segmentWidth;
+        }
+        rowY += 14;
+    }
+
+    // フレーム予算の目盛り
+    ofSetColor(255, 80, 80, alpha);
+    float budgetX = x + 10 + budgetMillis * barScale;
+    ofDrawLine(budgetX, y + 30, budgetX, rowY);
+
+    // フレーム時間のヒストグラム（1ms刻み、33ms以上は最後のビン）
+    const int numBins = 34;
+    int bins[numBins] = {0};
+    int maxBin = 1;
+    for (int i = 0; i < frameHistoryCount; i++) {
+        int bin = std::min(numBins - 1, (int)frameHistory[i]);
+        maxBin = std::max(maxBin, ++bins[bin]);
+    }
+    float histogramY = rowY + 40;
+    float binWidth = (width - 20.0f) / numBins;
+    for (int i = 0; i < numBins; i++) {
+        float binHeight = 36.0f * bins[i] / maxBin;
+        ofSetColor(i <= (int)budgetMillis ? ofColor(100, 255, 100) : ofColor(255, 150, 80), alpha);
+        ofDrawRectangle(x + 10 + i * binWidth, histogramY - binHeight, binWidth - 1, binHeight);
+    }
+
+    // ゾーンごとの分位点（直近HISTORY_FRAMESフレームのうち、そのゾーンがあったフレーム）
+    float textY = histogramY + 14;
+    for (const auto& zone : zones) {
+        if (zone.historyCount == 0) continue;
+        float p50, p95, p99;
+        percentiles(zone.history, zone.historyCount, p50, p95, p99);
+        ofSetColor(zoneColor(zone.name), alpha);
+        ofDrawRectangle(x + 10, textY - 8, 8, 8);
+        ofSetColor(255, alpha);
+        ofDrawBitmapString(ofToString(zone.name) + " " + ofToString(p50, 2) + "/" + ofToString(p95, 2) + "/" + ofToString(p99, 2), x + 22, textY);
+        textY += 13;
+    }
+
+    ofDisableBlendMode();
+    ofPopStyle();
+}
+
+bool FrameProfiler::dumpCsv(const string& path) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        cout << "Profiler: failed to open " << path << endl;
+        return false;
+    }
+
+    fprintf(file, "frame,thread,depth,zone,start_us,duration_us\n");
+    std::size_t first = (capturedHead + CAPTURE_CAPACITY - capturedCount) % CAPTURE_CAPACITY;
+    for (std::size_t i = 0; i < capturedCount; i++) {
+        const Event& event = captured[(first + i) % CAPTURE_CAPACITY];
+        fprintf(file, "%u,%u,%u,%s,%llu,%u\n", event.frame, event.thread, event.depth, event.name,
+                (unsigned long long)event.startMicros, event.durationMicros);
+    }
+    fclose(file);
+    cout << "Profiler: wrote " << capturedCount << " events to " << path << endl;
+    return true;
+}
+
+bool FrameProfiler::dumpTrace(const string& path) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        cout << "Profiler: failed to open " << path << endl;
+        return false;
+    }
+
+    // chrome://tracing / Perfetto で開ける完了イベント（ph:X）の列
+    fprintf(file, "{\"traceEvents\":[\n");
+    std::size_t first = (capturedHead + CAPTURE_CAPACITY - capturedCount) % CAPTURE_CAPACITY;
+    for (std::size_t i = 0; i < capturedCount; i++) {
+        const Event& event = captured[(first + i) % CAPTURE_CAPACITY];
+        fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%u,\"pid\":0,\"tid\":%u,\"args\":{\"frame\":%u}}\n",
+                i == 0 ? "" : ",", event.name, (unsigned long long)event.startMicros, event.durationMicros,
+                event.thread, event.frame);
+    }
+    fprintf(file, "]}\n");
+    fclose(file);
+    cout << "Profiler: wrote trace to " << path << endl;
+    return true;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "ofMain.h"
+#include "MidiEventQueue.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// フレームのどこに時間がかかっているかを測るスコープ付きタイマー
+// - PROFILE_ZONE(名前) でスコープの開始〜終了を記録（入れ子可、名前は静的な文字列）
+// - 記録はスレッドごとの固定長リングに書くだけ（ホットパスで確保・ロックなし）
+// - 描画スレッドがendFrame()でリングを回収し、フレームの内訳とゾーンごとの分位点を集計する
+// MIDIVIS_NO_PROFILER を定義するとPROFILE_ZONEは何も生成しない
+#ifndef MIDIVIS_NO_PROFILER
+#define PROFILE_ZONE_CONCAT_INNER(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) FrameProfiler::Zone PROFILE_ZONE_CONCAT(profileZone, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name)
+#endif
+
+class FrameProfiler {
+public:
+    struct Event {
+        const char* name;
+        uint64_t startMicros;      // midiNowMicros基準
+        uint32_t durationMicros;
+        uint32_t frame;
+        uint16_t thread;
+        uint16_t depth;
+    };
+
+private:
+    // スレッドごとのリング（書き手はそのスレッドだけ、読み手は描画スレッドだけ）
+    struct ThreadBuffer {
+        static const std::size_t CAPACITY = 8192;  // 2のべき乗
+        std::array<Event, CAPACITY> events;
+        std::atomic<uint64_t> writeIndex{0};
+        uint64_t readIndex = 0;
+        uint16_t thread = 0;
+        uint16_t depth = 0;
+        bool inUse = false;   // スレッドが使用中（registryMutexで守る）
+
+        void push(const Event& event) {
+            uint64_t index = writeIndex.load(std::memory_order_relaxed);
+            events[index & (CAPACITY - 1)] = event;
+            writeIndex.store(index + 1, std::memory_order_release);
+        }
+    };
+
+public:
+    class Zone {
+    public:
+        explicit Zone(const char* zoneName) : name(zoneName) {
+            if (!enabled.load(std::memory_order_relaxed)) return;
+            buffer = getThreadBuffer();
+            depth = buffer->depth++;
+            startMicros = midiNowMicros();
+        }
+
+        ~Zone() {
+            if (!buffer) return;
+            uint64_t endMicros = midiNowMicros();
+            buffer->depth--;
+            buffer->push({name, startMicros, (uint32_t)(endMicros - startMicros),
+                          currentFrame.load(std::memory_order_relaxed), buffer->thread, depth});
+        }
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* name;
+        ThreadBuffer* buffer = nullptr;
+        uint64_t startMicros = 0;
+        uint16_t depth = 0;
+    };
+
+    static void setEnabled(bool enable) { enabled = enable; }
+    static bool isEnabled() { return enabled; }
+
+    // 描画スレッドでフレームの最後に呼ぶ。各スレッドのリングを回収して集計
+    static void endFrame(float frameSeconds);
+
+    // 直近のフレームの内訳（スレッドごとの積み上げ棒）・フレーム時間のヒストグラム・ゾーンごとの分位点
+    static void drawOverlay(float x, float y, float alpha);
+
+    // 保持しているイベントを書き出す（CSV / Chromeのトレース形式JSON）
+    static bool dumpCsv(const string& path);
+    static bool dumpTrace(const string& path);
+
+    static const int HISTORY_FRAMES = 600;   // 分位点の対象（60fpsで10秒）
+
+private:
+    static const std::size_t MAX_ZONES = 64;
+    static const std::size_t MAX_SEGMENTS = 128;
+    static const std::size_t CAPTURE_CAPACITY = 65536;
+
+    // ゾーン名ごとの集計（名前はポインタで識別）
+    struct ZoneStats {
+        const char* name = nullptr;
+        uint64_t frameMicros = 0;                  // 今フレームの合計
+        bool seenThisFrame = false;
+        std::array<float, HISTORY_FRAMES> history; // フレームごとの合計（ms）
+        int historyCount = 0;
+        int historyHead = 0;
+        uint32_t lastFrame = 0;
+    };
+
+    // スレッドの終了時にリングを空きに戻す（使い捨てのスレッドが増えてもリングと表示の行は増え続けない）
+    struct ThreadSlot {
+        ThreadBuffer* buffer = nullptr;
+        ~ThreadSlot() {
+            if (buffer) releaseThread(buffer);
+        }
+    };
+
+    // 初回だけ登録（空きのリングを再利用するか確保、ロックあり）、以降はスレッドローカルのポインタを返すだけ
+    static ThreadBuffer* getThreadBuffer() {
+        thread_local ThreadSlot slot;
+        if (!slot.buffer) {
+            slot.buffer = registerThread();
+        }
+        return slot.buffer;
+    }
+    static ThreadBuffer* registerThread();
+    static void releaseThread(ThreadBuffer* buffer);
+    static ZoneStats* findZone(const char* name);
+    static void pushHistory(std::array<float, HISTORY_FRAMES>& history, int& count, int& head, float value);
+    static void percentiles(const std::array<float, HISTORY_FRAMES>& history, int count, float& p50, float& p95, float& p99);
+    static ofColor zoneColor(const char* name);
+
+    static std::atomic<bool> enabled;
+    static std::atomic<uint32_t> currentFrame;
+
+    static std::mutex registryMutex;   // スレッドの初回登録・終了と回収時のみ
+    static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+    // 以下は描画スレッドのみ
+    static std::vector<ZoneStats> zones;
+    static std::vector<Event> lastFrameSegments;   // 直近フレームの深さ0のゾーン
+    static std::vector<Event> captured;            // ダンプ用（古いものから上書き）
+    static std::size_t capturedHead;
+    static std::size_t capturedCount;
+    static std::array<float, HISTORY_FRAMES> frameHistory;
+    static int frameHistoryCount;
+    static int frameHistoryHead;
+    static std::vector<float> scratch;
+};
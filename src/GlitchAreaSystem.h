@@ -2,8 +2,21 @@
 
 #include "ofMain.h"
 #include "ofxPostGlitch.h"
+#include "AsyncLog.h"
+#include "DrawCommandList.h"
+#include "FrameProfiler.h"
+#include "RenderTargetPool.h"
+#include "SimViewport.h"
+#include "VisualRandom.h"
 #include <vector>
 
+// グリッチ合成用ターゲットの内部フォーマット
+enum GlitchTargetFormat {
+    GLITCH_FORMAT_RGBA8 = 0,
+    GLITCH_FORMAT_RGBA16F,
+    GLITCH_FORMAT_RGBA32F
+};
+
 enum GlitchAreaShape {
     CIRCLE = 0,
     ELLIPSE,
@@ -44,6 +57,8 @@ struct TrailPoint {
 
 class GlitchArea {
 public:
+    VisualRandom rng;  // エリア専用の乱数（他のメンバより先に初期化する）
+    
     ofVec2f position;
     ofVec2f targetPosition;
     ofVec2f startPosition;
@@ -82,32 +97,32 @@ public:
     float trailMaxAge;
     int maxTrailPoints;
     
-    GlitchArea(float x, float y, float w, float h, float life, int type, GlitchAreaShape s = CIRCLE, MovementPattern mp = STATIC) 
-        : position(x, y), targetPosition(x, y), startPosition(x, y), 
+    GlitchArea(uint64_t seed, float x, float y, float w, float h, float life, int type, GlitchAreaShape s = CIRCLE, MovementPattern mp = STATIC) 
+        : rng(seed), position(x, y), targetPosition(x, y), startPosition(x, y), 
           width(w), height(h), rotation(0), lifetime(life), maxLifetime(life), 
           glitchType(type), intensity(1.0), shape(s), movementPattern(mp),
-          movementSpeed(ofRandom(40, 120)), baseMovementSpeed(ofRandom(40, 120)),
-          targetMovementSpeed(ofRandom(120, 300)), speedTransitionTime(0), speedTransitionDuration(ofRandom(2.0, 5.0)),
-          easingProgress(0), orbitRadius(ofRandom(50, 150)), orbitAngle(0), nextTargetTime(ofRandom(0.5, 2.0)),
-          accelerationPhase(0), pauseTimer(0), pauseDuration(ofRandom(0.3, 1.5)), isPaused(false), intensityMultiplier(1.0),
+          movementSpeed(rng.random(40, 120)), baseMovementSpeed(rng.random(40, 120)),
+          targetMovementSpeed(rng.random(120, 300)), speedTransitionTime(0), speedTransitionDuration(rng.random(2.0, 5.0)),
+          easingProgress(0), orbitRadius(rng.random(50, 150)), orbitAngle(0), nextTargetTime(rng.random(0.5, 2.0)),
+          accelerationPhase(0), pauseTimer(0), pauseDuration(rng.random(0.3, 1.5)), isPaused(false), intensityMultiplier(1.0),
           trailInterval(0.05f), lastTrailTime(0), trailMaxAge(3.0f), maxTrailPoints(60) {
         
         // 初期移動方向
-        movementDirection = ofVec2f(ofRandom(-1, 1), ofRandom(-1, 1)).getNormalized();
+        movementDirection = ofVec2f(rng.random(-1, 1), rng.random(-1, 1)).getNormalized();
         
         // 形状別のサイズ調整
         if (shape == ELLIPSE) {
-            height = h * ofRandom(0.3, 0.8); // 楕円の縦横比
+            height = h * rng.random(0.3, 0.8); // 楕円の縦横比
         } else if (shape == RECTANGLE || shape == DIAMOND) {
-            width = w * ofRandom(0.7, 1.3);
-            height = h * ofRandom(0.7, 1.3);
+            width = w * rng.random(0.7, 1.3);
+            height = h * rng.random(0.7, 1.3);
         }
         
-        rotation = ofRandom(0, 360);
+        rotation = rng.random(0, 360);
         
         // 初期トレイルポイントを追加
         trail.push_back(TrailPoint(position, trailMaxAge));
-        lastTrailTime = ofGetElapsedTimef();
+        lastTrailTime = SimViewport::getElapsedTimef();
     }
     
     void update(float dt, int screenWidth, int screenHeight) {
@@ -169,7 +184,7 @@ public:
             case ZIGZAG:
                 // ジグザグ移動
                 position.x += movementDirection.x * movementSpeed * dt;
-                position.y += sin(ofGetElapsedTimef() * 3) * 50 * dt;
+                position.y += sin(SimViewport::getElapsedTimef() * 3) * 50 * dt;
                 
                 if (position.x < 0 || position.x > screenWidth) {
                     movementDirection.x *= -1;
@@ -182,10 +197,10 @@ public:
                 if (nextTargetTime <= 0) {
                     // 新しいターゲット設定
                     startPosition = position;
-                    targetPosition.x = ofRandom(width, screenWidth - width);
-                    targetPosition.y = ofRandom(height, screenHeight - height);
+                    targetPosition.x = rng.random(width, screenWidth - width);
+                    targetPosition.y = rng.random(height, screenHeight - height);
                     easingProgress = 0;
-                    nextTargetTime = ofRandom(1.0, 3.0);
+                    nextTargetTime = rng.random(1.0, 3.0);
                 }
                 
                 // イージング移動（easeInOutCubic）
@@ -216,12 +231,12 @@ public:
                     triggerSpeedBurst(); // 急加速
                     
                     // 反転時に縦方向の動きも微調整
-                    if (ofRandom(1.0) < 0.4) { // 40%の確率で縦方向も反転
+                    if (rng.random(1.0) < 0.4) { // 40%の確率で縦方向も反転
                         movementDirection.y *= -1;
                     }
                     
                     // 50%の確率で一時停止
-                    if (ofRandom(1.0) < 0.5) {
+                    if (rng.random(1.0) < 0.5) {
                         triggerPause();
                     }
                 }
@@ -232,7 +247,7 @@ public:
                     position.y = ofClamp(position.y, height/2, screenHeight - height/2);
                     
                     // 縦反転時も効果的な変化
-                    if (ofRandom(1.0) < 0.3) {
+                    if (rng.random(1.0) < 0.3) {
                         triggerSpeedBurst();
                     }
                 }
@@ -246,7 +261,7 @@ public:
     }
     
     void updateTrail(float dt, ofVec2f oldPosition) {
-        float currentTime = ofGetElapsedTimef();
+        float currentTime = SimViewport::getElapsedTimef();
         
         // 位置が変わった場合のみ新しいトレイルポイントを追加
         float distance = position.distance(oldPosition);
@@ -314,8 +329,8 @@ public:
         }
         
         // ランダムな緩急変化
-        if (ofRandom(1.0) < 0.005 * dt * 60) { // 60FPSで約0.3%/秒の確率
-            if (ofRandom(1.0) < 0.6) {
+        if (rng.random(1.0) < 0.005 * dt * 60) { // 60FPSで約0.3%/秒の確率
+            if (rng.random(1.0) < 0.6) {
                 triggerSpeedBurst();
             } else {
                 triggerPause();
@@ -327,29 +342,29 @@ public:
         baseMovementSpeed = movementSpeed;
         
         // より極端な速度変化
-        if (ofRandom(1.0) < 0.4) {
+        if (rng.random(1.0) < 0.4) {
             // 高速モード
-            targetMovementSpeed = ofRandom(120, 300);
-        } else if (ofRandom(1.0) < 0.3) {
+            targetMovementSpeed = rng.random(120, 300);
+        } else if (rng.random(1.0) < 0.3) {
             // 低速モード
-            targetMovementSpeed = ofRandom(10, 40);
+            targetMovementSpeed = rng.random(10, 40);
         } else {
             // 中速モード
-            targetMovementSpeed = ofRandom(50, 100);
+            targetMovementSpeed = rng.random(50, 100);
         }
         
         speedTransitionTime = 0;
-        speedTransitionDuration = ofRandom(2.0, 5.0); // より長い遷移時間
+        speedTransitionDuration = rng.random(2.0, 5.0); // より長い遷移時間
     }
     
     void triggerSpeedBurst() {
-        accelerationPhase = ofRandom(0.5, 1.5); // 0.5-1.5秒の急加速
-        intensityMultiplier = ofRandom(2.0, 4.0); // 2-4倍速
+        accelerationPhase = rng.random(0.5, 1.5); // 0.5-1.5秒の急加速
+        intensityMultiplier = rng.random(2.0, 4.0); // 2-4倍速
     }
     
     void triggerPause() {
         isPaused = true;
-        pauseTimer = ofRandom(0.3, 1.5); // 0.3-1.5秒の停止
+        pauseTimer = rng.random(0.3, 1.5); // 0.3-1.5秒の停止
     }
     
     bool isDead() const {
@@ -364,9 +379,15 @@ public:
 class GlitchAreaSystem {
 private:
     std::vector<GlitchArea> areas;
+    VisualRandom rng;  // エリア生成用の乱数
     ofxPostGlitch postGlitch;
-    ofFbo glitchFbo;
-    ofFbo areaMaskFbo;
+    RenderTarget glitchFbo;    // エリアごとのエフェクト生成用（ofxPostGlitchの対象）
+    RenderTarget outputFbo;    // 合成結果（毎フレーム使い回す）
+    RenderTarget trailMaskFbo; // トレイルのマスク（アルファ）とトレイル部分のグリッチ（色）
+    DrawCommandList trailCommands;  // トレイルの形の記録
+    GlitchTargetFormat targetFormat = GLITCH_FORMAT_RGBA32F;
+    bool skipIdleCopy = true;  // エリアがない時は入力をそのまま返す（コピーなし）
+    float detailBudget = 1.0f; // 同時エリア数の倍率（QualityGovernorが調整）
     int width, height;
     bool isInitialized;
     bool lightweightMode = false;  // 軽量モードを無効化（グリッチ効果優先）
@@ -389,37 +410,57 @@ private:
 public:
     GlitchAreaSystem() : isInitialized(false) {}
     
+    // 乱数ストリームの初期化（VisualSystem::seedRandomと同じ規則）
+    void seedRandom(uint64_t stream) { rng.seed(VisualRandom::deriveSeed(stream)); }
+    
     void setup(int w, int h) {
         width = w;
         height = h;
         
-        // FBO初期化（高品質：32ビットFloatRGBA）
-        ofFbo::Settings settings;
-        settings.width = width;
-        settings.height = height;
-        settings.internalformat = GL_RGBA32F_ARB;  // 高品質な32F_ARBを復活
-        settings.useDepth = true;  // 深度バッファを有効化
-        settings.useStencil = true;  // ステンシルバッファも有効化
-        
-        glitchFbo.allocate(settings);
-        areaMaskFbo.allocate(width, height, GL_RGBA32F_ARB);  // 高品質化
+        // 合成用ターゲットはプールから借りて保持し続ける（フレームごとの確保をしない）
+        glitchFbo = RenderTargetPool::acquire(width, height, getInternalFormat(), true);
+        outputFbo = RenderTargetPool::acquire(width, height, getInternalFormat());
+        trailMaskFbo = RenderTargetPool::acquire(width, height, getInternalFormat());
         
         // ofxPostGlitch設定
-        postGlitch.setup(&glitchFbo);
+        postGlitch.setup(glitchFbo.get());
         
         isInitialized = true;
     }
     
+    // 合成用ターゲットのフォーマット（既定は32F。8bitにするとVRAMと帯域が1/4）
+    void setTargetFormat(GlitchTargetFormat format) {
+        if (format == targetFormat) return;
+        targetFormat = format;
+        if (isInitialized) {
+            setup(width, height);
+        }
+    }
+    
+    GlitchTargetFormat getTargetFormat() const { return targetFormat; }
+    
+    int getInternalFormat() const {
+        switch (targetFormat) {
+            case GLITCH_FORMAT_RGBA8: return GL_RGBA8;
+            case GLITCH_FORMAT_RGBA16F: return GL_RGBA16F_ARB;
+            default: return GL_RGBA32F_ARB;
+        }
+    }
+    
+    void setSkipIdleCopy(bool skip) { skipIdleCopy = skip; }
+    
+    void setDetailBudget(float budget) { detailBudget = budget; }
+    float getDetailBudget() const { return detailBudget; }
+    
     void triggerGlitch(int numAreas = 1) {
         if (!isInitialized) return;
         
-        // 軽量モード：非常に厳格な制限
-        int maxTotalAreas = lightweightMode ? 1 : 2; // 軽量モードでは1個のみ
+        int maxTotalAreas = getMaxAreas();
         int currentAreas = areas.size();
         
         if (currentAreas >= maxTotalAreas) {
             // 既に最大数に達している場合は何もしない
-            cout << "GlitchArea limit reached: " << currentAreas << "/" << maxTotalAreas << endl;
+            MVLOG_DEBUG(LOG_CATEGORY_GLITCH, "GlitchArea limit reached: %d/%d", currentAreas, maxTotalAreas);
             return;
         }
         
@@ -427,8 +468,8 @@ public:
         int actualNumAreas = lightweightMode ? 1 : ofClamp(numAreas, 1, maxTotalAreas - currentAreas);
         
         for (int i = 0; i < actualNumAreas; i++) {
-            float x = ofRandom(width * 0.2, width * 0.8);
-            float y = ofRandom(height * 0.2, height * 0.8);
+            float x = rng.random(width * 0.2, width * 0.8);
+            float y = rng.random(height * 0.2, height * 0.8);
             
             // 軽量モード：小さめのエリア、短い持続時間
             float w, h, lifetime;
@@ -437,42 +478,42 @@ public:
             MovementPattern movement;
             
             if (lightweightMode) {
-                w = ofRandom(150, 350); // 元のサイズを維持
-                h = ofRandom(150, 350); // 元のサイズを維持
-                lifetime = ofRandom(8.0, 15.0); // 元の持続時間を維持
-                glitchType = (int)ofRandom(NUM_GLITCH_TYPES); // 全10種類を使用
+                w = rng.random(150, 350); // 元のサイズを維持
+                h = rng.random(150, 350); // 元のサイズを維持
+                lifetime = rng.random(8.0, 15.0); // 元の持続時間を維持
+                glitchType = (int)rng.random(NUM_GLITCH_TYPES); // 全10種類を使用
                 shape = CIRCLE; // 単純な円のみ（要望通り）
                 
                 // サーチライト風の動きを重み付けして選択（移動を復活）
-                if (ofRandom(1.0) < 0.7) {
+                if (rng.random(1.0) < 0.7) {
                     movement = SPOTLIGHT_SCAN;
-                } else if (ofRandom(1.0) < 0.2) {
+                } else if (rng.random(1.0) < 0.2) {
                     movement = RANDOM_WALK;
-                } else if (ofRandom(1.0) < 0.1) {
+                } else if (rng.random(1.0) < 0.1) {
                     movement = LINEAR_SWEEP;
                 } else {
                     movement = STATIC;
                 }
             } else {
-                w = ofRandom(150, 350);
-                h = ofRandom(150, 350);
-                lifetime = ofRandom(8.0, 15.0);
-                glitchType = (int)ofRandom(NUM_GLITCH_TYPES);
+                w = rng.random(150, 350);
+                h = rng.random(150, 350);
+                lifetime = rng.random(8.0, 15.0);
+                glitchType = (int)rng.random(NUM_GLITCH_TYPES);
                 shape = CIRCLE; // 全モードで円形に統一
                 
                 // サーチライト風の動きを重み付けして選択
-                if (ofRandom(1.0) < 0.7) {
+                if (rng.random(1.0) < 0.7) {
                     movement = SPOTLIGHT_SCAN;
-                } else if (ofRandom(1.0) < 0.2) {
+                } else if (rng.random(1.0) < 0.2) {
                     movement = RANDOM_WALK;
-                } else if (ofRandom(1.0) < 0.1) {
+                } else if (rng.random(1.0) < 0.1) {
                     movement = LINEAR_SWEEP;
                 } else {
                     movement = STATIC;
                 }
             }
             
-            areas.emplace_back(x, y, w, h, lifetime, glitchType, shape, movement);
+            areas.emplace_back(rng.nextUInt64(), x, y, w, h, lifetime, glitchType, shape, movement);
         }
     }
     
@@ -491,24 +532,32 @@ public:
         }
     }
     
-    void applyGlitch(ofFbo& inputFbo, ofFbo& outputFbo) {
-        if (!isInitialized || areas.empty()) {
+    // グリッチを合成した結果を返す（入力そのもの、または内部の出力ターゲット）
+    const ofFbo& applyGlitch(const ofFbo& inputFbo) {
+        PROFILE_ZONE("applyGlitch");
+        if (!isInitialized) {
+            return inputFbo;
+        }
+        if (areas.empty()) {
+            if (skipIdleCopy) {
+                return inputFbo;
+            }
             // グリッチエリアがない場合は入力をそのまま出力にコピー
-            outputFbo.begin();
+            outputFbo->begin();
             ofClear(0, 0, 0, 0);
             inputFbo.draw(0, 0);
-            outputFbo.end();
-            return;
+            outputFbo->end();
+            return *outputFbo;
         }
         
         // 安全性チェック: FBOの有効性を確認
-        if (!inputFbo.isAllocated() || !outputFbo.isAllocated() || !glitchFbo.isAllocated()) {
-            cout << "Warning: FBO not properly allocated" << endl;
-            return;
+        if (!inputFbo.isAllocated() || !outputFbo->isAllocated() || !glitchFbo->isAllocated()) {
+            MVLOG_WARN(LOG_CATEGORY_GLITCH, "FBO not properly allocated");
+            return inputFbo;
         }
         
         // 最終結果を出力FBOに描画
-        outputFbo.begin();
+        outputFbo->begin();
         ofClear(0, 0, 0, 0);
         
         // オリジナル画像を描画
@@ -518,10 +567,10 @@ public:
         for (const auto& area : areas) {
             try {
                 // 入力をグリッチFBOにコピー
-                glitchFbo.begin();
+                glitchFbo->begin();
                 ofClear(0, 0, 0, 0);
                 inputFbo.draw(0, 0);
-                glitchFbo.end();
+                glitchFbo->end();
                 
                 // このエリア用のグリッチエフェクトを設定
                 applyGlitchToArea(area);
@@ -535,16 +584,17 @@ public:
                 // グリッチエリアを円形マスクで描画
                 drawGlitchArea(area);
             } catch (const std::exception& e) {
-                cout << "Error in glitch processing: " << e.what() << endl;
+                MVLOG_ERROR(LOG_CATEGORY_GLITCH, "Glitch processing failed: %s", e.what());
                 // エラーが発生した場合はそのエリアをスキップ
                 continue;
             } catch (...) {
-                cout << "Unknown error in glitch processing" << endl;
+                MVLOG_ERROR(LOG_CATEGORY_GLITCH, "Glitch processing failed: unknown error");
                 continue;
             }
         }
         
-        outputFbo.end();
+        outputFbo->end();
+        return *outputFbo;
     }
     
     bool hasActiveGlitch() const {
@@ -555,6 +605,11 @@ public:
         return areas.size();
     }
     
+    // 同時に出せるエリアの上限（詳細度に比例、既定2。軽量モードでは1個のみ）
+    int getMaxAreas() const {
+        return lightweightMode ? 1 : std::max(1, (int)roundf(2 * detailBudget));
+    }
+    
 private:
     void applyGlitchToArea(const GlitchArea& area) {
         // グリッチエフェクトの設定をリセット
@@ -636,7 +691,7 @@ private:
                 float texH = area.height;
                 
                 // 円形マスクで描画（簡易版）
-                glitchFbo.getTexture().drawSubsection(
+                glitchFbo->getTexture().drawSubsection(
                     -radius, -radius, texW, texH,
                     texX, texY, texW, texH
                 );
@@ -645,7 +700,7 @@ private:
                 ofPopMatrix();
                 ofDisableBlendMode();
             } catch (...) {
-                cout << "Error in lightweight glitch draw" << endl;
+                MVLOG_ERROR(LOG_CATEGORY_GLITCH, "Lightweight glitch draw failed");
             }
             
             ofPopStyle();
@@ -726,17 +781,17 @@ private:
         // グリッチFBOを描画（エリア内のみ）
         ofEnableBlendMode(OF_BLENDMODE_ALPHA);
         ofSetColor(255, 255 * area.getIntensity());
-        glitchFbo.draw(0, 0);
+        glitchFbo->draw(0, 0);
         
             // ステンシルテストを無効化
             glDisable(GL_STENCIL_TEST);
             
         } catch (const std::exception& e) {
-            cout << "Error in drawGlitchArea: " << e.what() << endl;
+            MVLOG_ERROR(LOG_CATEGORY_GLITCH, "drawGlitchArea failed: %s", e.what());
             // エラー時は必ずステンシルテストを無効化
             glDisable(GL_STENCIL_TEST);
         } catch (...) {
-            cout << "Unknown error in drawGlitchArea" << endl;
+            MVLOG_ERROR(LOG_CATEGORY_GLITCH, "drawGlitchArea failed: unknown error");
             glDisable(GL_STENCIL_TEST);
         }
         
@@ -748,36 +803,37 @@ private:
     void drawTrail(const GlitchArea& area) {
         if (area.trail.empty()) return;
         
-        // 軽量モード：簡易トレイル描画（円形のみ、ステンシルなし）
+        // 軽量モード：簡易トレイル描画（円形のみ、マスクなし）
         if (lightweightMode) {
-            try {
-                // 最新の5ポイントのみ描画（軽量化）
-                int startIdx = area.trail.size() > 5 ? area.trail.size() - 5 : 0;
+            // 最新の5ポイントのみ描画（軽量化）
+            int startIdx = area.trail.size() > 5 ? area.trail.size() - 5 : 0;
+            
+            trailCommands.setBlendMode(OF_BLENDMODE_ALPHA);
+            for (int i = startIdx; i < area.trail.size(); i++) {
+                const TrailPoint& point = area.trail[i];
+                if (point.intensity <= 0) continue;
                 
-                for (int i = startIdx; i < area.trail.size(); i++) {
-                    const TrailPoint& point = area.trail[i];
-                    if (point.intensity <= 0) continue;
-                    
-                    float trailAlpha = point.intensity * area.getIntensity() * 0.2f; // より薄く
-                    float trailSize = area.width * (0.3f + point.intensity * 0.7f);
-                    
-                    // 単純な円で描画
-                    ofSetColor(255, 255 * trailAlpha);
-                    ofDrawCircle(point.position.x, point.position.y, trailSize / 2);
-                }
-            } catch (...) {
-                cout << "Error in lightweight trail" << endl;
+                float trailAlpha = point.intensity * area.getIntensity() * 0.2f; // より薄く
+                float trailSize = area.width * (0.3f + point.intensity * 0.7f);
+                
+                // 単純な円で描画
+                trailCommands.setColor(255, 255 * trailAlpha);
+                trailCommands.drawCircle(point.position, trailSize / 2);
             }
-            
-            ofDisableBlendMode();
-            ofPopStyle();
+            trailCommands.flush();
             return;
         }
         
         ofPushStyle();
-        ofEnableBlendMode(OF_BLENDMODE_ALPHA);
         
-        // トレイルポイントを古いものから新しいものへ描画
+        // トレイルの形（現在のエリアと同じ形状）を、点ごとの不透明度でマスクのアルファに重ねる
+        // SCREENはアルファを 1-(1-a)(1-b) で重ねるので順序に依らず、全点を1回で描ける
+        // （従来の「点ごとにステンシルを作ってグリッチFBOを不透明度付きで重ねる」と同じ結果で、全画面の描画は点の数によらず2回）
+        trailMaskFbo->begin();
+        ofClear(0, 0, 0, 0);
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_TRUE);
+        
+        trailCommands.setBlendMode(OF_BLENDMODE_SCREEN);
         for (int i = 0; i < area.trail.size(); i++) {
             const TrailPoint& point = area.trail[i];
             
@@ -786,91 +842,56 @@ private:
             // トレイルの透明度とサイズを調整
             float trailAlpha = point.intensity * area.getIntensity() * 0.3f; // 薄めに
             float trailSize = area.width * (0.3f + point.intensity * 0.7f); // サイズもフェード
+            float trailHeight = area.height * (0.3f + point.intensity * 0.7f);
+            float rotation = ofDegToRad(area.rotation * point.intensity); // 回転もフェード
+            trailCommands.setColor(255, 255 * trailAlpha);
             
-            try {
-                // ステンシルバッファを使用してトレイル形状を描画
-                glEnable(GL_STENCIL_TEST);
-                glClearStencil(0);
-                glClear(GL_STENCIL_BUFFER_BIT);
-            
-            // ステンシルバッファにトレイル形状を描画
-            glStencilFunc(GL_ALWAYS, 1, 0xFF);
-            glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
-            glStencilMask(0xFF);
-            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
-            
-            ofFill();
+            // 形の頂点（点の位置を中心に回転）
+            auto corner = [&](float x, float y) {
+                return point.position + ofVec2f(x, y).getRotatedRad(rotation);
+            };
             
-            // 回転とポジション設定
-            ofPushMatrix();
-            ofTranslate(point.position.x, point.position.y);
-            ofRotateDeg(area.rotation * point.intensity); // 回転もフェード
-            
-            // 形状に応じたトレイル描画（現在のエリアと同じ形状）
             switch (area.shape) {
-                case CIRCLE:
-                    ofDrawCircle(0, 0, trailSize / 2);
-                    break;
-                    
                 case ELLIPSE:
-                    ofDrawEllipse(0, 0, trailSize, area.height * (0.3f + point.intensity * 0.7f));
+                    trailCommands.drawEllipse(point.position, trailSize, trailHeight, rotation);
                     break;
                     
                 case RECTANGLE:
-                    ofDrawRectangle(-trailSize/2, -(area.height * (0.3f + point.intensity * 0.7f))/2, 
-                                  trailSize, area.height * (0.3f + point.intensity * 0.7f));
+                    trailCommands.drawRotatedRectangle(point.position, trailSize, trailHeight, rotation);
                     break;
                     
                 case DIAMOND: {
-                    float trailHeight = area.height * (0.3f + point.intensity * 0.7f);
-                    ofPath diamond;
-                    diamond.moveTo(0, -trailHeight/2);
-                    diamond.lineTo(trailSize/2, 0);
-                    diamond.lineTo(0, trailHeight/2);
-                    diamond.lineTo(-trailSize/2, 0);
-                    diamond.close();
-                    diamond.draw();
+                    ofVec2f top = corner(0, -trailHeight/2);
+                    ofVec2f bottom = corner(0, trailHeight/2);
+                    trailCommands.drawTriangle(top, corner(trailSize/2, 0), bottom);
+                    trailCommands.drawTriangle(top, bottom, corner(-trailSize/2, 0));
                     break;
                 }
                 
-                case TRIANGLE: {
-                    float trailHeight = area.height * (0.3f + point.intensity * 0.7f);
-                    ofPath triangle;
-                    triangle.moveTo(0, -trailHeight/2);
-                    triangle.lineTo(trailSize/2, trailHeight/2);
-                    triangle.lineTo(-trailSize/2, trailHeight/2);
-                    triangle.close();
-                    triangle.draw();
+                case TRIANGLE:
+                    trailCommands.drawTriangle(corner(0, -trailHeight/2), corner(trailSize/2, trailHeight/2),
+                                               corner(-trailSize/2, trailHeight/2));
                     break;
-                }
-                
-                case NUM_SHAPES:
-                    ofDrawCircle(0, 0, trailSize / 2);
+                    
+                default:
+                    trailCommands.drawCircle(point.position, trailSize / 2);
                     break;
             }
-            
-            ofPopMatrix();
-            
-            // ステンシルテストを設定してグリッチFBOを描画
-            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-            glStencilFunc(GL_EQUAL, 1, 0xFF);
-            glStencilMask(0x00);
-            
-            // グリッチFBOを描画（トレイル部分のみ）
-            ofSetColor(255, 255 * trailAlpha);
-            glitchFbo.draw(0, 0);
-            
-                // ステンシルテストを無効化
-                glDisable(GL_STENCIL_TEST);
-                
-            } catch (const std::exception& e) {
-                cout << "Error in drawTrail: " << e.what() << endl;
-                glDisable(GL_STENCIL_TEST);
-            } catch (...) {
-                cout << "Unknown error in drawTrail" << endl;
-                glDisable(GL_STENCIL_TEST);
-            }
         }
+        trailCommands.flush();
+        
+        // マスクの色にグリッチFBOを写す（アルファはマスクのまま）
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_FALSE);
+        ofDisableBlendMode();
+        ofSetColor(255);
+        glitchFbo->draw(0, 0);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        trailMaskFbo->end();
+        
+        // マスクのアルファでグリッチをトレイル部分だけ重ねる
+        ofEnableBlendMode(OF_BLENDMODE_ALPHA);
+        ofSetColor(255);
+        trailMaskFbo->draw(0, 0);
         
         ofDisableBlendMode();
         ofPopStyle();
@@ -0,0 +1,454 @@
+#include "HeadlessBenchApp.h"
+#include "PostEffects.h"
+#include <iomanip>
+
+// === スクリプトMIDIストリーム ===
+void ScriptedMidiStream::collect(float startTime, float endTime, std::vector<ofxMidiMessage>& out) const {
+    float stepDuration = 60.0f / bpm / 4.0f;  // 16分音符
+    int firstStep = (int)ceil(startTime / stepDuration);
+    
+    for (int step = firstStep; step * stepDuration < endTime; step++) {
+        // 前ステップのノートオフ
+        if (step > 0) {
+            out.push_back(makeNote(MIDI_NOTE_OFF, 36, 0));
+            out.push_back(makeNote(MIDI_NOTE_OFF, 42, 0));
+        }
+        
+        // ベロシティに揺らぎを持たせる（決定的）
+        int accent = (step * 37) % 27;
+        
+        if (step % 128 == 0) {
+            out.push_back(makeNote(MIDI_NOTE_ON, 49, 127));                 // クラッシュ
+        }
+        if (step % 4 == 0) {
+            out.push_back(makeNote(MIDI_NOTE_ON, 36, 100 + accent));        // キック
+        }
+        if (step % 8 == 4) {
+            out.push_back(makeNote(MIDI_NOTE_ON, 38, 90 + accent));         // スネア
+        }
+        if (step % 2 == 0) {
+            out.push_back(makeNote(MIDI_NOTE_ON, 42, 60 + accent));         // ハイハット
+        }
+        int barStep = step % 64;
+        if (barStep >= 56 && barStep % 2 == 0) {
+            static const int toms[] = {48, 47, 45, 45};
+            out.push_back(makeNote(MIDI_NOTE_ON, toms[(barStep - 56) / 2], 110));  // タムフィル
+        }
+        if (step % 4 == 0) {
+            float beat = step / 4.0f;
+            out.push_back(makeControl(1, (int)(64 + 63 * sin(beat * 0.25f))));  // モジュレーション
+        }
+    }
+}
+
+ofxMidiMessage ScriptedMidiStream::makeNote(MidiStatus status, int pitch, int velocity) {
+    ofxMidiMessage msg;
+    msg.status = status;
+    msg.channel = 10;
+    msg.pitch = pitch;
+    msg.velocity = velocity;
+    return msg;
+}
+
+ofxMidiMessage ScriptedMidiStream::makeControl(int control, int value) {
+    ofxMidiMessage msg;
+    msg.status = MIDI_CONTROL_CHANGE;
+    msg.channel = 1;
+    msg.control = control;
+    msg.value = value;
+    return msg;
+}
+
+// === ヘッドレスベンチ ===
+HeadlessBenchApp::HeadlessBenchApp(int argc, char* argv[]) {
+    parseArguments(argc, argv);
+}
+
+void HeadlessBenchApp::parseArguments(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        
+        if (arg == "--frames" && hasValue) {
+            numFrames = std::max(1, ofToInt(argv[++i]));
+        } else if (arg == "--dt" && hasValue) {
+            fixedDeltaTime = ofToFloat(argv[++i]);
+        } else if (arg == "--width" && hasValue) {
+            viewportWidth = ofToInt(argv[++i]);
+        } else if (arg == "--height" && hasValue) {
+            viewportHeight = ofToInt(argv[++i]);
+        } else if (arg == "--bpm" && hasValue) {
+            midiStream.bpm = ofToFloat(argv[++i]);
+        } else if (arg == "--play" && hasValue) {
+            sessionPlayer.load(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            uint64_t seed = 0;
+            if (VisualRandom::parseSeed(argv[++i], seed)) {
+                VisualRandom::setGlobalSeed(seed);
+            } else {
+                cout << "Invalid --seed value: " << argv[i] << " (expected an unsigned integer)" << endl;
+            }
+        } else if (arg == "--system" && hasValue) {
+            systemFilter = ofToLower(argv[++i]);
+        } else if (arg == "--detail" && hasValue) {
+            detailBudget = ofClamp(ofToFloat(argv[++i]), QualityGovernor::MIN_BUDGET, QualityGovernor::MAX_BUDGET);
+        } else if (arg == "--raster") {
+            rasterEnabled = true;
+        } else if (arg == "--render" && hasValue) {
+            renderDirectory = argv[++i];
+            rasterEnabled = true;
+        } else if (arg == "--golden" && hasValue) {
+            goldenDirectory = argv[++i];
+            rasterEnabled = true;
+        } else if (arg == "--tolerance" && hasValue) {
+            goldenTolerance = ofClamp(ofToInt(argv[++i]), 0, 255);
+        } else if (arg == "--gl") {
+            glEnabled = true;
+        } else {
+            cout << "Unknown argument: " << arg << endl;
+            cout << "Usage: midiVisualizer_headless [--frames N] [--dt SEC] [--width W] [--height H] [--bpm BPM] [--play FILE] [--seed N] [--system NAME] [--detail X]"
+                 << " [--raster] [--render DIR] [--golden DIR] [--tolerance N] [--gl]" << endl;
+        }
+    }
+    
+    if (fixedDeltaTime <= 0.0f) {
+        fixedDeltaTime = 1.0f / 60.0f;
+    }
+    if (numFrames <= 0) {
+        numFrames = sessionPlayer.hasEvents() ? (int)(sessionPlayer.getDurationMicros() / 1000000.0f / fixedDeltaTime) + 1 : 600;
+    }
+}
+
+void HeadlessBenchApp::setup() {
+    cout << "=== HEADLESS BENCH ===" << endl;
+    cout << "Frames: " << numFrames << ", dt: " << fixedDeltaTime << "s, viewport: "
+         << viewportWidth << "x" << viewportHeight
+         << (sessionPlayer.hasEvents() ? ", session: " + ofToString(sessionPlayer.getEventCount()) + " events" : ", bpm: " + ofToString(midiStream.bpm))
+         << ", seed: " << VisualRandom::getGlobalSeed() << ", detail: " << detailBudget << endl;
+    
+    if (rasterEnabled) {
+        softwareRenderer = std::make_shared<SoftwareRenderer>();
+        if (!renderDirectory.empty()) {
+            ofDirectory::createDirectory(renderDirectory, false, true);
+        }
+    }
+    
+    // ofAppと同じ登録表（実験システムも含む）
+    const auto& systems = SystemRegistry::all();
+    std::vector<SystemTiming> timings;
+    for (std::size_t i = 0; i < systems.size(); i++) {
+        const auto& entry = systems[i];
+        if (!systemFilter.empty() && ofToLower(entry.id).find(systemFilter) == string::npos) {
+            continue;
+        }
+        // 乱数ストリームはofAppと同じ登録番号
+        timings.push_back(runSystem(entry, i));
+    }
+    
+    if (!goldenDirectory.empty() && !comparePostEffects()) {
+        goldenFailures++;
+    }
+    
+    printReport(timings);
+    ofExit(goldenFailures > 0 ? 1 : 0);
+}
+
+void HeadlessBenchApp::update() {
+}
+
+void HeadlessBenchApp::draw() {
+}
+
+HeadlessBenchApp::SystemTiming HeadlessBenchApp::runSystem(const SystemDescriptor& entry, uint64_t randomStream) {
+    SystemTiming timing;
+    timing.name = entry.id;
+    
+    // 仮想時計をリセットしてシステムごとに同条件で実行
+    SimViewport::setHeadless(viewportWidth, viewportHeight);
+    VisualSystem::setGlobalMonochromeMode(entry.monochrome);
+    
+    uint64_t setupStart = ofGetElapsedTimeMicros();
+    std::unique_ptr<VisualSystem> system = entry.create(false);
+    system->seedRandom(randomStream);
+    system->setDetailBudget(detailBudget);
+    system->setup();
+    system->setActive(true);
+    timing.setupMillis = (ofGetElapsedTimeMicros() - setupStart) / 1000.0;
+    
+    std::vector<double> frameMillis;
+    frameMillis.reserve(numFrames);
+    std::vector<double> drawMillis;
+    if (softwareRenderer) {
+        softwareRenderer->allocate(viewportWidth, viewportHeight);
+        softwareRenderer->getRasterizer().resetTotalStats();
+    }
+    std::vector<ofxMidiMessage> events;
+    std::vector<MidiEvent> sessionEvents;
+    
+    if (sessionPlayer.hasEvents()) {
+        sessionPlayer.start(PLAYBACK_FIXED_STEP, fixedDeltaTime);
+    }
+    
+    for (int frame = 0; frame < numFrames; frame++) {
+        float frameStart = frame * fixedDeltaTime;
+        
+        // このフレームに入るMIDIイベントを先に流す（ofApp::updateと同じ順序）
+        events.clear();
+        if (sessionPlayer.hasEvents()) {
+            // ログ再生: ビジュアルシステムに届くのはドラムポートのみ（Push2はグリッチ用）
+            sessionEvents.clear();
+            sessionPlayer.poll(sessionEvents);
+            for (const auto& event : sessionEvents) {
+                if (event.port != MIDI_PORT_DRUMS) continue;
+                events.emplace_back();
+                event.toMessage(events.back());
+            }
+        } else {
+            midiStream.collect(frameStart, frameStart + fixedDeltaTime, events);
+        }
+        for (auto& msg : events) {
+            system->onMidiMessage(msg);
+        }
+        timing.midiEvents += events.size();
+        
+        uint64_t updateStart = ofGetElapsedTimeMicros();
+        system->update(fixedDeltaTime);
+        frameMillis.push_back((ofGetElapsedTimeMicros() - updateStart) / 1000.0);
+        
+        // マスター・トレイルの累積がGPUと同じになるよう毎フレーム描く
+        if (softwareRenderer) {
+            drawSoftware(*system, drawMillis);
+        }
+        
+        SimViewport::advance(fixedDeltaTime);
+    }
+    
+    timing.frames = frameMillis.size();
+    timing.randomFingerprint = system->getRandomFingerprint();
+    for (double ms : frameMillis) {
+        timing.totalMillis += ms;
+        timing.maxMillis = std::max(timing.maxMillis, ms);
+    }
+    timing.meanMillis = timing.totalMillis / std::max(1, timing.frames);
+    
+    std::vector<double> sorted = frameMillis;
+    std::sort(sorted.begin(), sorted.end());
+    if (!sorted.empty()) {
+        timing.p95Millis = sorted[std::min(sorted.size() - 1, (size_t)(sorted.size() * 0.95))];
+    }
+    
+    if (softwareRenderer && !drawMillis.empty()) {
+        for (double ms : drawMillis) {
+            timing.drawMeanMillis += ms;
+            timing.drawMaxMillis = std::max(timing.drawMaxMillis, ms);
+        }
+        timing.drawMeanMillis /= drawMillis.size();
+        const RasterStats& rasterStats = softwareRenderer->getRasterizer().getTotalStats();
+        timing.rasterMillis = rasterStats.millis;
+        timing.primitivesPerFrame = (double)rasterStats.primitives / drawMillis.size();
+        
+        if (!renderDirectory.empty()) {
+            writeFinalFrame(timing);
+        }
+        if (!goldenDirectory.empty() && !compareGolden(timing)) {
+            goldenFailures++;
+        }
+    }
+    
+    return timing;
+}
+
+void HeadlessBenchApp::drawSoftware(VisualSystem& system, std::vector<double>& drawMillis) {
+    uint64_t drawStart = ofGetElapsedTimeMicros();
+    
+    // ofAppの画面と同じく黒でクリアしてから描く（GLのレンダラーはこの間だけ差し替える）
+    std::shared_ptr<ofBaseRenderer> previousRenderer = ofGetCurrentRenderer();
+    ofSetCurrentRenderer(softwareRenderer);
+    softwareRenderer->setupGraphicDefaults();
+    softwareRenderer->setupScreen();
+    softwareRenderer->clear(0, 0, 0, 255);
+    system.render();
+    softwareRenderer->finishRender();
+    ofSetCurrentRenderer(previousRenderer);
+    
+    drawMillis.push_back((ofGetElapsedTimeMicros() - drawStart) / 1000.0);
+}
+
+void HeadlessBenchApp::writeFinalFrame(const SystemTiming& timing) {
+    ofPixels pixels;
+    softwareRenderer->getScreenPixels(pixels);
+    ofSaveImage(pixels, ofFilePath::join(renderDirectory, timing.name + ".png"));
+}
+
+bool HeadlessBenchApp::compareGolden(SystemTiming& timing) {
+    ofPixels expected;
+    string path = ofFilePath::join(goldenDirectory, timing.name + ".png");
+    if (!ofLoadImage(expected, path)) {
+        timing.golden = "missing";
+        return false;
+    }
+    
+    ofPixels actual;
+    softwareRenderer->getScreenPixels(actual);
+    expected.setImageType(OF_IMAGE_COLOR_ALPHA);
+    if (expected.getWidth() != actual.getWidth() || expected.getHeight() != actual.getHeight()) {
+        timing.golden = "size " + ofToString(expected.getWidth()) + "x" + ofToString(expected.getHeight());
+        return false;
+    }
+    
+    // 許容差を超えるチャンネルがあるピクセルを数える
+    int maxDifference = 0;
+    std::size_t differingPixels = 0;
+    const unsigned char* a = actual.getData();
+    const unsigned char* b = expected.getData();
+    std::size_t numPixels = actual.getWidth() * actual.getHeight();
+    for (std::size_t i = 0; i < numPixels; i++) {
+        bool differs = false;
+        for (int c = 0; c < 4; c++) {
+            int difference = std::abs((int)a[i * 4 + c] - (int)b[i * 4 + c]);
+            maxDifference = std::max(maxDifference, difference);
+            differs = differs || difference > goldenTolerance;
+        }
+        if (differs) differingPixels++;
+    }
+    
+    timing.golden = (differingPixels == 0 ? "ok" : "FAIL " + ofToString(differingPixels) + "px") + " (max " + ofToString(maxDifference) + ")";
+    return differingPixels == 0;
+}
+
+// 全画面エフェクトのシェーダー（トレイルの更新・合成）とCPUの参照実装を同じ入力・同じパラメータで比べる
+// 入力はシステムのターゲットと同じ8ビットに丸めた決定的な模様、パラメータは各効果を単独・全部入りで
+bool HeadlessBenchApp::comparePostEffects() {
+    if (!glEnabled) {
+        postEffectsGolden = "skipped (no GL, pass --gl)";
+        return true;
+    }
+    if (!PostEffects::isAvailable()) {
+        postEffectsGolden = "FAIL shader unavailable";
+        return false;
+    }
+    
+    const int width = 256;
+    const int height = 144;
+    ofFloatPixels master, trail;
+    master.allocate(width, height, OF_PIXELS_RGBA);
+    trail.allocate(width, height, OF_PIXELS_RGBA);
+    auto quantize = [](float value) { return roundf(ofClamp(value, 0.0f, 1.0f) * 255.0f) / 255.0f; };
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            // 縁の双線形補間も確かめられるよう、なめらかな変化と8ピクセルの市松を重ねる
+            float checker = ((x / 8 + y / 8) % 2) ? 1.0f : 0.0f;
+            master.setColor(x, y, ofFloatColor(quantize((float)x / width), quantize(0.5f + 0.5f * sinf(y * 0.15f)),
+                                               quantize(checker), quantize(0.25f + 0.75f * checker)));
+            trail.setColor(x, y, ofFloatColor(quantize((float)y / height), quantize(1.0f - checker * 0.6f),
+                                              quantize(0.5f + 0.5f * cosf(x * 0.11f)), quantize((float)(x + y) / (width + height))));
+        }
+    }
+    
+    std::vector<PostEffectParams> cases(5);
+    for (auto& params : cases) {
+        params.width = width;
+        params.height = height;
+        params.trailFade = 244 / 255.0f;   // ofSetColorの値と同じく1/255単位
+        params.trailGain = 150 / 255.0f;
+        params.trailMix = 190 / 255.0f;
+    }
+    cases[1].offset.set(3.5f, -2.25f);
+    cases[1].scale = 1.08f;
+    cases[2].aberration = 4.0f;
+    cases[2].vignette = 0.4f;
+    cases[3].boostColor = ofFloatColor(1.0f, 0.5f, 0.2f, 0.3f);
+    cases[3].glowColor = ofFloatColor(0.2f, 0.6f, 1.0f, 0.5f);
+    cases[3].glowThickness = 6.0f;
+    cases[4] = cases[1];
+    cases[4].aberration = cases[2].aberration;
+    cases[4].vignette = cases[2].vignette;
+    cases[4].boostColor = cases[3].boostColor;
+    cases[4].glowColor = cases[3].glowColor;
+    cases[4].glowThickness = cases[3].glowThickness;
+    
+    ofFbo masterFbo, trailFbo, targetFbo;
+    masterFbo.allocate(width, height, GL_RGBA);
+    trailFbo.allocate(width, height, GL_RGBA);
+    targetFbo.allocate(width, height, GL_RGBA);
+    
+    float tolerance = goldenTolerance / 255.0f;
+    float maxDifference = 0.0f;
+    std::size_t differingPixels = 0;
+    auto compare = [&](const ofFloatPixels& actual, const ofFloatPixels& expected) {
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                ofFloatColor a = actual.getColor(x, y);
+                ofFloatColor b = expected.getColor(x, y);
+                float difference = std::max(std::max(std::abs(a.r - b.r), std::abs(a.g - b.g)), std::max(std::abs(a.b - b.b), std::abs(a.a - b.a)));
+                maxDifference = std::max(maxDifference, difference);
+                if (difference > tolerance) differingPixels++;
+            }
+        }
+    };
+    
+    ofFloatPixels expectedTrail, expectedComposite, actual;
+    for (const auto& params : cases) {
+        masterFbo.getTexture().loadData(master);
+        trailFbo.getTexture().loadData(trail);
+        
+        PostEffects::updateTrail(trailFbo, masterFbo, params);
+        PostEffects::referenceTrail(trail, master, params, expectedTrail);
+        trailFbo.readToPixels(actual);
+        compare(actual, expectedTrail);
+        
+        // 合成は更新後のトレイルを読む（GPU側のトレイルを8ビットに丸めたものを参照実装にも渡す）
+        targetFbo.begin();
+        ofClear(0, 0, 0, 255);
+        PostEffects::composite(masterFbo, trailFbo, params);
+        targetFbo.end();
+        PostEffects::referenceComposite(master, actual, params, expectedComposite);
+        targetFbo.readToPixels(actual);
+        compare(actual, expectedComposite);
+    }
+    
+    postEffectsGolden = (differingPixels == 0 ? "ok" : "FAIL " + ofToString(differingPixels) + "px") +
+                        " (" + ofToString(cases.size()) + " cases, max " + ofToString((int)roundf(maxDifference * 255.0f)) + ")";
+    return differingPixels == 0;
+}
+
+void HeadlessBenchApp::printReport(const std::vector<SystemTiming>& timings) {
+    cout << "=== UPDATE TIMINGS (ms) ===" << endl;
+    cout << std::left << std::setw(22) << "System" << std::right
+         << std::setw(8) << "frames" << std::setw(8) << "midi"
+         << std::setw(10) << "setup" << std::setw(10) << "mean"
+         << std::setw(10) << "p95" << std::setw(10) << "max"
+         << std::setw(12) << "total" << "  rng" << endl;
+    
+    double grandTotal = 0.0;
+    for (const auto& t : timings) {
+        cout << std::left << std::setw(22) << t.name << std::right << std::fixed << std::setprecision(3)
+             << std::setw(8) << t.frames << std::setw(8) << t.midiEvents
+             << std::setw(10) << t.setupMillis << std::setw(10) << t.meanMillis
+             << std::setw(10) << t.p95Millis << std::setw(10) << t.maxMillis
+             << std::setw(12) << t.totalMillis
+             << "  " << std::hex << std::setw(16) << std::setfill('0') << t.randomFingerprint
+             << std::dec << std::setfill(' ') << endl;
+        grandTotal += t.totalMillis;
+    }
+    cout << "Total update time: " << grandTotal << "ms" << endl;
+    cout << "===========================" << endl;
+    
+    if (!softwareRenderer) return;
+    
+    cout << "=== SOFTWARE RASTER (ms) ===" << endl;
+    cout << std::left << std::setw(22) << "System" << std::right
+         << std::setw(10) << "draw" << std::setw(10) << "max"
+         << std::setw(12) << "rasterTotal" << std::setw(12) << "prims/f" << "  golden" << endl;
+    for (const auto& t : timings) {
+        cout << std::left << std::setw(22) << t.name << std::right << std::fixed << std::setprecision(3)
+             << std::setw(10) << t.drawMeanMillis << std::setw(10) << t.drawMaxMillis
+             << std::setw(12) << t.rasterMillis << std::setw(12) << std::setprecision(1) << t.primitivesPerFrame
+             << "  " << (t.golden.empty() ? "-" : t.golden) << endl;
+    }
+    if (!goldenDirectory.empty()) {
+        cout << "Post effects (shader vs reference): " << postEffectsGolden << endl;
+        cout << "Golden mismatches: " << goldenFailures << " (tolerance " << goldenTolerance << ")" << endl;
+    }
+    cout << "============================" << endl;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "ofMain.h"
+#include <sstream>  // ofxMidiのコンパイルエラー対策
+#include "ofxMidi.h"
+#include "SimViewport.h"
+#include "MidiSession.h"
+#include "QualityGovernor.h"
+#include "SoftwareRenderer.h"
+#include "VisualSystem.h"
+#include "SystemRegistry.h"
+#include <memory>
+
+// スクリプト化されたドラムパターン（16分音符グリッド、決定的）
+// キック4つ打ち・2,4拍スネア・8分ハイハット・4小節ごとのタムフィル・8小節ごとのクラッシュ、CC1のスイープ
+class ScriptedMidiStream {
+public:
+    float bpm = 120.0f;
+    
+    // [startTime, endTime) に発生するイベントを時刻順に out に追加
+    void collect(float startTime, float endTime, std::vector<ofxMidiMessage>& out) const;
+    
+private:
+    static ofxMidiMessage makeNote(MidiStatus status, int pitch, int velocity);
+    static ofxMidiMessage makeControl(int control, int value);
+};
+
+// ウィンドウ・GLなしで各ビジュアルシステムのシミュレーションだけを固定dtで回すベンチマーク
+// --raster指定時はdraw()もSoftwareRendererで毎フレーム描き、最後のフレームを書き出し・ゴールデン画像と比較できる
+// --gl指定時は非表示のウィンドウでGLを使え、--goldenで全画面エフェクトのシェーダーとCPUの参照実装も比べる
+class HeadlessBenchApp : public ofBaseApp {
+public:
+    HeadlessBenchApp(int argc, char* argv[]);
+    
+    void setup();
+    void update();
+    void draw();
+    
+private:
+    struct SystemTiming {
+        std::string name;
+        int frames = 0;
+        int midiEvents = 0;
+        double setupMillis = 0.0;
+        double totalMillis = 0.0;
+        double meanMillis = 0.0;
+        double p95Millis = 0.0;
+        double maxMillis = 0.0;
+        uint64_t randomFingerprint = 0;  // 同じシードなら実行ごとに一致する
+        
+        // ソフトウェアレンダラーでの描画（--raster時のみ）
+        double drawMeanMillis = 0.0;
+        double drawMaxMillis = 0.0;
+        double rasterMillis = 0.0;       // うちラスタライズ（flush）の合計
+        double primitivesPerFrame = 0.0;
+        std::string golden;              // ゴールデン画像との比較結果（比較しなければ空）
+    };
+    
+    void parseArguments(int argc, char* argv[]);
+    SystemTiming runSystem(const SystemDescriptor& entry, uint64_t randomStream);
+    void printReport(const std::vector<SystemTiming>& timings);
+    void drawSoftware(VisualSystem& system, std::vector<double>& drawMillis);
+    void writeFinalFrame(const SystemTiming& timing);
+    bool compareGolden(SystemTiming& timing);
+    bool comparePostEffects();
+    
+    ScriptedMidiStream midiStream;
+    MidiSessionPlayer sessionPlayer;   // --play 指定時はスクリプトの代わりにログを流す
+    
+    // 実行パラメータ（コマンドライン引数で上書き可能）
+    int numFrames = 0;                 // 0ならログの長さ、ログなしなら600
+    float fixedDeltaTime = 1.0f / 60.0f;
+    int viewportWidth = 1920;
+    int viewportHeight = 1080;
+    std::string systemFilter;   // 空なら全システム
+    float detailBudget = 1.0f;  // 全システム共通の詳細度（--detail）
+    
+    // ソフトウェアレンダラー（--raster / --render DIR / --golden DIR）
+    bool rasterEnabled = false;
+    std::string renderDirectory;   // 最後のフレームを<システム名>.pngで書き出す
+    std::string goldenDirectory;   // 最後のフレームを<システム名>.pngと比べる
+    int goldenTolerance = 2;       // 1チャンネルあたりの許容差（0〜255）
+    int goldenFailures = 0;
+    bool glEnabled = false;        // 非表示のウィンドウでGLのコンテキストがある（--gl、main()が見る）
+    std::string postEffectsGolden; // シェーダーと参照実装の比較結果（比較しなければ空）
+    std::shared_ptr<SoftwareRenderer> softwareRenderer;
+};
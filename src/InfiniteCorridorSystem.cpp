@@ -4,7 +4,7 @@ InfiniteCorridorSystem::InfiniteCorridorSystem() {
     corridorDepth = 0.0f;
     walkingSpeed = 30.0f;
     perspectiveShift = 0.0f;
-    vanishingPoint.set(ofGetWidth() * 0.5f, ofGetHeight() * 0.4f);
+    vanishingPoint.set(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.4f);
     ambientIntensity = 60.0f;
     corridorWidth = 800.0f;
     corridorHeight = 600.0f;
@@ -38,18 +38,18 @@ void InfiniteCorridorSystem::setup() {
     for (int i = 0; i < 3; i++) {
         WalkingFigure figure;
         figure.position.set(
-            vanishingPoint.x + ofRandom(-50, 50),
-            vanishingPoint.y + ofRandom(100, 200)
+            vanishingPoint.x + rng.random(-50, 50),
+            vanishingPoint.y + rng.random(100, 200)
         );
-        figure.walkSpeed = ofRandom(20.0f, 40.0f);
-        figure.walkCycle = ofRandom(0, TWO_PI);
-        figure.scale = ofRandom(0.8f, 1.2f);
+        figure.walkSpeed = rng.random(20.0f, 40.0f);
+        figure.walkCycle = rng.random(0, TWO_PI);
+        figure.scale = rng.random(0.8f, 1.2f);
         figures.push_back(figure);
     }
 }
 
 void InfiniteCorridorSystem::update(float deltaTime) {
-    float currentTime = ofGetElapsedTimef();
+    float currentTime = SimViewport::getElapsedTimef();
     
     // 全体的なアニメーション
     walkCycleTime += deltaTime * 2.0f;
@@ -63,8 +63,8 @@ void InfiniteCorridorSystem::update(float deltaTime) {
     }
     
     // 消失点の微妙な揺れ
-    vanishingPoint.x = ofGetWidth() * 0.5f + sin(perspectiveOscillation) * 20.0f * globalGrowthLevel;
-    vanishingPoint.y = ofGetHeight() * 0.4f + cos(perspectiveOscillation * 0.7f) * 10.0f * globalGrowthLevel;
+    vanishingPoint.x = SimViewport::getWidth() * 0.5f + sin(perspectiveOscillation) * 20.0f * globalGrowthLevel;
+    vanishingPoint.y = SimViewport::getHeight() * 0.4f + cos(perspectiveOscillation * 0.7f) * 10.0f * globalGrowthLevel;
     
     // 回廊セグメントの更新
     for (auto& segment : corridorSegments) {
@@ -86,13 +86,13 @@ void InfiniteCorridorSystem::update(float deltaTime) {
     }
     
     // MIDI連動強度の減衰
-    kickIntensity *= 0.95f;
-    snareIntensity *= 0.92f;
-    hihatIntensity *= 0.9f;
-    crashIntensity *= 0.88f;
+    kickIntensity *= frameDecay(0.95f, deltaTime);
+    snareIntensity *= frameDecay(0.92f, deltaTime);
+    hihatIntensity *= frameDecay(0.9f, deltaTime);
+    crashIntensity *= frameDecay(0.88f, deltaTime);
     
     // 新しい人物の生成（低確率）
-    if (ofRandom(1.0f) < 0.005f * globalGrowthLevel) {
+    if (rng.random(1.0f) < 0.005f * globalGrowthLevel) {
         createNewFigure();
     }
     
@@ -104,7 +104,7 @@ void InfiniteCorridorSystem::draw() {
     
     // 背景
     ofSetColor(darkGray.r * 0.8f, darkGray.g * 0.8f, darkGray.b * 0.8f);
-    ofDrawRectangle(0, 0, ofGetWidth(), ofGetHeight());
+    ofDrawRectangle(0, 0, SimViewport::getWidth(), SimViewport::getHeight());
     
     // 回廊の描画
     drawCorridor();
@@ -285,10 +285,10 @@ void InfiniteCorridorSystem::updateFigureWalk(WalkingFigure& figure, float delta
     figure.scale = 1.0f + depthFactor * 0.3f;
     
     // 画面端での消失・再生成
-    if (figure.position.y > ofGetHeight() + 50) {
+    if (figure.position.y > SimViewport::getHeight() + 50) {
         figure.position.y = vanishingPoint.y - 50;
-        figure.position.x = vanishingPoint.x + ofRandom(-30, 30);
-        figure.walkSpeed = ofRandom(20.0f, 40.0f);
+        figure.position.x = vanishingPoint.x + rng.random(-30, 30);
+        figure.walkSpeed = rng.random(20.0f, 40.0f);
     }
     
     // 前進
@@ -300,12 +300,12 @@ void InfiniteCorridorSystem::createNewFigure() {
     
     WalkingFigure newFigure;
     newFigure.position.set(
-        vanishingPoint.x + ofRandom(-40, 40),
-        vanishingPoint.y + ofRandom(-30, 0)
+        vanishingPoint.x + rng.random(-40, 40),
+        vanishingPoint.y + rng.random(-30, 0)
     );
-    newFigure.walkSpeed = ofRandom(15.0f, 35.0f);
-    newFigure.walkCycle = ofRandom(0, TWO_PI);
-    newFigure.scale = ofRandom(0.6f, 1.0f);
+    newFigure.walkSpeed = rng.random(15.0f, 35.0f);
+    newFigure.walkCycle = rng.random(0, TWO_PI);
+    newFigure.scale = rng.random(0.6f, 1.0f);
     newFigure.fadeAlpha = 255.0f;
     
     figures.push_back(newFigure);
@@ -333,7 +333,7 @@ void InfiniteCorridorSystem::onMidiMessage(ofxMidiMessage& msg) {
         if (note == 36) {  // KICK
             kickIntensity = velocity;
             // キックで新しい人物を生成
-            if (ofRandom(1.0f) < 0.7f) {
+            if (rng.random(1.0f) < 0.7f) {
                 createNewFigure();
             }
         }
@@ -350,8 +350,8 @@ void InfiniteCorridorSystem::onMidiMessage(ofxMidiMessage& msg) {
         else if (note == 49) {  // CRASH
             crashIntensity = velocity;
             // クラッシュで劇的な遠近感の変化
-            vanishingPoint.x += ofRandom(-100, 100) * velocity;
-            vanishingPoint.y += ofRandom(-50, 50) * velocity;
+            vanishingPoint.x += rng.random(-100, 100) * velocity;
+            vanishingPoint.y += rng.random(-50, 50) * velocity;
         }
     }
 }
@@ -23,7 +23,7 @@ struct UrbanStructure {
     float length;
     ofVec2f anchor;
     
-    UrbanStructure(ofVec2f pos, ofVec2f dir, float s, string t, int gen) :
+    UrbanStructure(VisualRandom& rng, ofVec2f pos, ofVec2f dir, float s, string t, int gen) :
         position(pos), direction(dir), size(s), type(t), generation(gen) {
         age = 0.0f;
         isConnected = false;
@@ -31,9 +31,9 @@ struct UrbanStructure {
         color = ofColor::white;
         
         // 振り子・線分パーツの初期化
-        pendulumAngle = ofRandom(-PI/3, PI/3);
-        angularVelocity = ofRandom(-0.5f, 0.5f);
-        length = s * (1.5f + ofRandom(1.0f));
+        pendulumAngle = rng.random(-PI/3, PI/3);
+        angularVelocity = rng.random(-0.5f, 0.5f);
+        length = s * (1.5f + rng.random(1.0f));
         anchor = pos;
     }
     
@@ -144,9 +144,9 @@ private:
 public:
     void setup() override {
         // 初期建設サイトの設定（スペーシング拡大）
-        constructionSites.push_back(ofVec2f(ofGetWidth() * 0.5f, ofGetHeight() * 0.8f));
-        constructionSites.push_back(ofVec2f(ofGetWidth() * 0.25f, ofGetHeight() * 0.5f));
-        constructionSites.push_back(ofVec2f(ofGetWidth() * 0.75f, ofGetHeight() * 0.5f));
+        constructionSites.push_back(ofVec2f(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.8f));
+        constructionSites.push_back(ofVec2f(SimViewport::getWidth() * 0.25f, SimViewport::getHeight() * 0.5f));
+        constructionSites.push_back(ofVec2f(SimViewport::getWidth() * 0.75f, SimViewport::getHeight() * 0.5f));
         
         // 初期青写真の生成
         generateInitialBlueprints();
@@ -160,15 +160,15 @@ public:
         scaffoldLines.resize(3);
         cranePositions.resize(2);
         for (int i = 0; i < 2; i++) {
-            cranePositions[i] = ofVec2f(ofRandom(100, ofGetWidth()-100), ofRandom(50, 200));
+            cranePositions[i] = ofVec2f(rng.random(100, SimViewport::getWidth()-100), rng.random(50, 200));
         }
         
         // 成長ベクターの初期化
         for (int i = 0; i < 6; i++) {
             GrowthVector gv;
-            gv.position = ofVec2f(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
-            gv.direction = ofVec2f(cos(ofRandom(TWO_PI)), sin(ofRandom(TWO_PI)));
-            gv.intensity = ofRandom(0.3f, 0.8f);
+            gv.position = ofVec2f(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
+            gv.direction = ofVec2f(cos(rng.random(TWO_PI)), sin(rng.random(TWO_PI)));
+            gv.intensity = rng.random(0.3f, 0.8f);
             gv.age = 0.0f;
             gv.color = urbanColor(i * 30, 0.6f);
             growthVectors.push_back(gv);
@@ -193,7 +193,8 @@ public:
         updateStructures(deltaTime);
         
         // プロシージャル建設（密度制限を緩和、生成タイミングを早める）
-        if (constructionProgress > 0.2f && structures.size() < 250) {
+        std::size_t maxStructures = detailCap(250);
+        if (constructionProgress > 0.2f && structures.size() < maxStructures) {
             proceduralConstruction();
         }
         
@@ -204,6 +205,11 @@ public:
             }
         }
         
+        // 詳細度が下がったら古い構造物（先頭）から減らす
+        if (structures.size() > maxStructures) {
+            structures.erase(structures.begin(), structures.begin() + (structures.size() - maxStructures));
+        }
+        
         // 建設強度の減衰
         constructionIntensity *= 0.98f;
         
@@ -286,14 +292,14 @@ public:
                     // 基礎工事・重機作業
                     currentBuildingType = INFRASTRUCTURE;
                     triggerFoundationWork(impactIntensity * 2.0f);
-                    triggerConstructionWave(ofVec2f(ofGetWidth() * 0.5f, ofGetHeight() * 0.8f), impactIntensity);
+                    triggerConstructionWave(ofVec2f(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.8f), impactIntensity);
                     break;
                     
                 case SNARE:
                     // 骨組み・鉄骨工事
                     currentBuildingType = COMMERCIAL;
                     triggerFramework(impactIntensity * 1.5f);
-                    addGrowthVector(ofVec2f(ofRandom(ofGetWidth()), ofRandom(ofGetHeight())), impactIntensity);
+                    addGrowthVector(ofVec2f(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight())), impactIntensity);
                     break;
                     
                 case HIHAT_CLOSED:
@@ -311,8 +317,8 @@ public:
                 default:
                     // 音程に基づく構造配置
                     ofVec2f buildingPos(
-                        ofMap(msg.pitch % 12, 0, 12, 100, ofGetWidth() - 100),
-                        ofMap(msg.pitch / 12, 0, 10, ofGetHeight() * 0.8f, ofGetHeight() * 0.3f)
+                        ofMap(msg.pitch % 12, 0, 12, 100, SimViewport::getWidth() - 100),
+                        ofMap(msg.pitch / 12, 0, 10, SimViewport::getHeight() * 0.8f, SimViewport::getHeight() * 0.3f)
                     );
                     createStructuralElement(buildingPos, impactIntensity);
             }
@@ -350,17 +356,17 @@ private:
             ofNoFill();
             
             // 建設ゾーンとして不規則配置
-            int numSites = (ofGetWidth() * ofGetHeight()) / (gridSize * gridSize * 2); // 建設現場密度
+            int numSites = (SimViewport::getWidth() * SimViewport::getHeight()) / (gridSize * gridSize * 2); // 建設現場密度
             
             for (int i = 0; i < numSites; i++) {
                 // クラスター化された建設現場配置
-                float clusterX = ofRandom(0, ofGetWidth());
-                float clusterY = ofRandom(0, ofGetHeight());
+                float clusterX = rng.random(0, SimViewport::getWidth());
+                float clusterY = rng.random(0, SimViewport::getHeight());
                 
                 // 建設現場風ランダム多角形
                 ofBeginShape();
-                int numVertices = 3 + (int)(ofRandom(5)); // 3-7角形（建設現場の不規則性）
-                float radius = ofRandom(gridSize * 0.1, gridSize * 0.4);
+                int numVertices = 3 + (int)(rng.random(5)); // 3-7角形（建設現場の不規則性）
+                float radius = rng.random(gridSize * 0.1, gridSize * 0.4);
                 
                 // 建設ノイズで位置変形
                 float noiseOffset = sin(clusterX * 0.01f + constructionNoise) * urbanPlanning * 15;
@@ -368,8 +374,8 @@ private:
                 clusterY += cos(clusterY * 0.01f + constructionNoise) * urbanPlanning * 10;
                 
                 for (int j = 0; j < numVertices; j++) {
-                    float angle = (j * TWO_PI / numVertices) + ofRandom(-0.6, 0.6);
-                    float r = radius + ofRandom(-radius * 0.5, radius * 0.5);
+                    float angle = (j * TWO_PI / numVertices) + rng.random(-0.6, 0.6);
+                    float r = radius + rng.random(-radius * 0.5, radius * 0.5);
                     float vx = clusterX + cos(angle) * r;
                     float vy = clusterY + sin(angle) * r;
                     ofVertex(vx, vy);
@@ -392,17 +398,16 @@ private:
             ofSetColor(structColor);
             
             float lineWidth = structure.size * (0.6f + globalGrowthLevel * 0.3f);
-            ofSetLineWidth(lineWidth);
             
-            // 構造タイプに応じた描画
+            // 構造タイプに応じた描画（線分はlinesに積み、塗りはその場で描く）
             if (structure.type == "foundation") {
                 drawFoundationElement(structure);
             } else if (structure.type == "pillar") {
-                drawPillarElement(structure);
+                drawPillarElement(structure, structColor, lineWidth);
             } else if (structure.type == "beam") {
-                drawBeamElement(structure);
+                drawBeamElement(structure, structColor, lineWidth);
             } else if (structure.type == "detail") {
-                drawDetailElement(structure);
+                drawDetailElement(structure, structColor);
             } else if (structure.type == "pendulum") {
                 drawPendulumElement(structure);
             } else if (structure.type == "lever") {
@@ -413,19 +418,18 @@ private:
             if (structure.isConnected && structure.stability > 0.5f) {
                 ofColor connectionColor = urbanColor(currentNote + 15, structure.stability);
                 connectionColor.a = 120;
-                ofSetColor(connectionColor);
-                ofSetLineWidth(lineWidth * 0.3f);
                 
                 // 有機的な放射状線分
                 int numLines = 3 + structure.stability * 4;
                 for (int i = 0; i < numLines; i++) {
                     float angle = (i * TWO_PI / numLines) + ofNoise(structure.position.x * 0.01f, structure.position.y * 0.01f, systemTime * 0.1f) * TWO_PI;
-                    float length = lineWidth * (2 + ofRandom(3));
+                    float length = lineWidth * (2 + rng.random(3));
                     ofVec2f endPos = structure.position + ofVec2f(cos(angle), sin(angle)) * length;
-                    ofDrawLine(structure.position, endPos);
+                    lines.addLine(structure.position, endPos, lineWidth * 0.3f, connectionColor);
                 }
             }
         }
+        lines.draw();
         
         ofDisableBlendMode();
     }
@@ -473,7 +477,7 @@ private:
     
     void drawConstructionMachinery() {
         if (globalGrowthLevel > 0.5f) {
-            ofEnableBlendMode(OF_BLENDMODE_ADD);
+            commands.setBlendMode(OF_BLENDMODE_ADD);
             
             // クレーンの描画
             for (int i = 0; i < cranePositions.size(); i++) {
@@ -481,50 +485,50 @@ private:
                 
                 ofColor craneColor = accentColor(0.7f);
                 craneColor.a = 180;
-                ofSetColor(craneColor);
+                commands.setColor(craneColor);
                 
                 float craneHeight = 150 + globalGrowthLevel * 100;
                 float armLength = 100 + globalGrowthLevel * 50;
                 
                 // クレーンタワー
-                ofSetLineWidth(1.5 + globalGrowthLevel * 0.8);
-                ofDrawLine(cranePos, cranePos + ofVec2f(0, -craneHeight));
+                commands.setLineWidth(1.5 + globalGrowthLevel * 0.8);
+                commands.drawLine(cranePos, cranePos + ofVec2f(0, -craneHeight));
                 
                 // クレーンアーム
                 float armAngle = systemTime * (0.5f + i * 0.3f) + i * PI;
                 ofVec2f armEnd = cranePos + ofVec2f(-craneHeight * 0.3f, -craneHeight) + 
                                 ofVec2f(cos(armAngle), sin(armAngle)) * armLength;
                 
-                ofDrawLine(cranePos + ofVec2f(0, -craneHeight), armEnd);
+                commands.drawLine(cranePos + ofVec2f(0, -craneHeight), armEnd);
                 
                 // ケーブル
-                ofSetLineWidth(1);
+                commands.setLineWidth(1);
                 ofVec2f hookPos = armEnd + ofVec2f(0, 50 + sin(systemTime * 2 + i) * 20);
-                ofDrawLine(armEnd, hookPos);
+                commands.drawLine(armEnd, hookPos);
                 
                 // フック（十字マーク）
-                ofSetLineWidth(2);
-                ofDrawLine(hookPos - ofVec2f(3, 0), hookPos + ofVec2f(3, 0));
-                ofDrawLine(hookPos - ofVec2f(0, 3), hookPos + ofVec2f(0, 3));
+                commands.setLineWidth(2);
+                commands.drawLine(hookPos - ofVec2f(3, 0), hookPos + ofVec2f(3, 0));
+                commands.drawLine(hookPos - ofVec2f(0, 3), hookPos + ofVec2f(0, 3));
                 
                 // 作業エリアの照明（放射状線分）
                 if (constructionIntensity > 0.4f) {
                     ofColor lightColor = ofColor::yellow;
                     lightColor.a = 80 * constructionIntensity;
-                    ofSetColor(lightColor);
-                    ofSetLineWidth(1);
+                    commands.setColor(lightColor);
+                    commands.setLineWidth(1);
                     
                     // 照明を放射状線分で表現
                     for (int j = 0; j < 8; j++) {
                         float angle = j * TWO_PI / 8;
                         float length = 15 * constructionIntensity;
                         ofVec2f endPos = hookPos + ofVec2f(cos(angle), sin(angle)) * length;
-                        ofDrawLine(hookPos, endPos);
+                        commands.drawLine(hookPos, endPos);
                     }
                 }
             }
             
-            ofDisableBlendMode();
+            commands.flush();
         }
     }
     
@@ -534,17 +538,17 @@ private:
         // 溶接火花（線分ベース）
         if (constructionIntensity > 0.6f) {
             for (int i = 0; i < 6; i++) {
-                ofVec2f sparkPos(ofRandom(ofGetWidth()), ofRandom(ofGetHeight() * 0.7f, ofGetHeight()));
+                ofVec2f sparkPos(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight() * 0.7f, SimViewport::getHeight()));
                 
-                ofColor sparkColor = ofColor::fromHsb(ofRandom(20, 60), 200, 180);
-                sparkColor.a = ofRandom(80, 200) * constructionIntensity;
+                ofColor sparkColor = ofColor::fromHsb(rng.random(20, 60), 200, 180);
+                sparkColor.a = rng.random(80, 200) * constructionIntensity;
                 ofSetColor(sparkColor);
-                ofSetLineWidth(ofRandom(0.5, 1.5));
+                ofSetLineWidth(rng.random(0.5, 1.5));
                 
                 // 線分状の火花
                 for (int j = 0; j < 3; j++) {
-                    float angle = ofRandom(TWO_PI);
-                    float length = ofRandom(3, 8);
+                    float angle = rng.random(TWO_PI);
+                    float length = rng.random(3, 8);
                     ofVec2f endPos = sparkPos + ofVec2f(cos(angle), sin(angle)) * length;
                     ofDrawLine(sparkPos, endPos);
                 }
@@ -553,7 +557,7 @@ private:
         
         // 建設煙塵（有機的な線分群）
         for (int i = 0; i < 4; i++) {
-            ofVec2f dustPos(ofRandom(ofGetWidth()), ofRandom(ofGetHeight() * 0.8f, ofGetHeight()));
+            ofVec2f dustPos(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight() * 0.8f, SimViewport::getHeight()));
             
             ofColor dustColor = urbanColor(currentNote, 0.3f);
             dustColor.a = 30 * constructionIntensity;
@@ -561,12 +565,12 @@ private:
             ofSetLineWidth(0.3f + globalGrowthLevel * 0.2f);
             
             // 煙のような有機的線分
-            int numStrokes = 4 + ofRandom(4);
+            int numStrokes = 4 + rng.random(4);
             for (int j = 0; j < numStrokes; j++) {
-                float angle = ofRandom(-PI/4, PI/4);  // 上向きの煙
-                float length = ofRandom(8, 20) * (1.0f + globalGrowthLevel * 0.5f);
+                float angle = rng.random(-PI/4, PI/4);  // 上向きの煙
+                float length = rng.random(8, 20) * (1.0f + globalGrowthLevel * 0.5f);
                 ofVec2f endPos = dustPos + ofVec2f(sin(angle), -cos(angle)) * length;
-                endPos += ofVec2f(ofRandom(-5, 5), ofRandom(-3, 3));  // ランダム性追加
+                endPos += ofVec2f(rng.random(-5, 5), rng.random(-3, 3));  // ランダム性追加
                 ofDrawLine(dustPos, endPos);
             }
         }
@@ -656,13 +660,13 @@ private:
             ofColor infoColor = urbanColor(currentNote, 0.5f);
             infoColor.a = 150;
             ofSetColor(infoColor);
-            ofDrawBitmapString("L-System Construction - Urban Development", 20, ofGetHeight() - 100);
-            ofDrawBitmapString("Construction Progress: " + ofToString(constructionProgress * 100, 1) + "%", 20, ofGetHeight() - 80);
-            ofDrawBitmapString("Architectural Complexity: " + ofToString(architecturalComplexity * 100, 1) + "%", 20, ofGetHeight() - 60);
-            ofDrawBitmapString("Structures: " + ofToString(structures.size()), 20, ofGetHeight() - 40);
+            ofDrawBitmapString("L-System Construction - Urban Development", 20, SimViewport::getHeight() - 100);
+            ofDrawBitmapString("Construction Progress: " + ofToString(constructionProgress * 100, 1) + "%", 20, SimViewport::getHeight() - 80);
+            ofDrawBitmapString("Architectural Complexity: " + ofToString(architecturalComplexity * 100, 1) + "%", 20, SimViewport::getHeight() - 60);
+            ofDrawBitmapString("Structures: " + ofToString(structures.size()), 20, SimViewport::getHeight() - 40);
             if (isCollapsing) {
                 ofSetColor(255, 100, 100);
-                ofDrawBitmapString("STRUCTURAL FAILURE", 20, ofGetHeight() - 20);
+                ofDrawBitmapString("STRUCTURAL FAILURE", 20, SimViewport::getHeight() - 20);
             }
         }
     }
@@ -674,9 +678,9 @@ private:
         ofDrawRectangle(structure.position.x - width/2, structure.position.y - height/2, width, height);
     }
     
-    void drawPillarElement(const UrbanStructure& structure) {
+    void drawPillarElement(const UrbanStructure& structure, const ofColor& color, float lineWidth) {
         ofVec2f top = structure.position + structure.direction * structure.size;
-        ofDrawLine(structure.position, top);
+        lines.addLine(structure.position, top, lineWidth, color);
         
         // 柱の装飾（白い円を十字マークに変更）
         int segments = 3 + structure.generation;
@@ -684,41 +688,41 @@ private:
             float t = i / float(segments);
             ofVec2f segmentPos = structure.position + structure.direction * structure.size * t;
             float crossSize = structure.size * 0.08f;
-            ofDrawLine(segmentPos - ofVec2f(crossSize, 0), segmentPos + ofVec2f(crossSize, 0));
-            ofDrawLine(segmentPos - ofVec2f(0, crossSize), segmentPos + ofVec2f(0, crossSize));
+            lines.addLine(segmentPos - ofVec2f(crossSize, 0), segmentPos + ofVec2f(crossSize, 0), lineWidth, color);
+            lines.addLine(segmentPos - ofVec2f(0, crossSize), segmentPos + ofVec2f(0, crossSize), lineWidth, color);
         }
     }
     
-    void drawBeamElement(const UrbanStructure& structure) {
+    void drawBeamElement(const UrbanStructure& structure, const ofColor& color, float lineWidth) {
         ofVec2f end = structure.position + structure.direction * structure.size;
         
         // メインビーム
-        ofDrawLine(structure.position, end);
+        lines.addLine(structure.position, end, lineWidth, color);
         
         // 支持構造
         ofVec2f perpendicular(-structure.direction.y, structure.direction.x);
         perpendicular.normalize();
         perpendicular *= structure.size * 0.1f;
         
-        ofDrawLine(structure.position + perpendicular, structure.position - perpendicular);
-        ofDrawLine(end + perpendicular, end - perpendicular);
+        lines.addLine(structure.position + perpendicular, structure.position - perpendicular, lineWidth, color);
+        lines.addLine(end + perpendicular, end - perpendicular, lineWidth, color);
     }
     
-    void drawDetailElement(const UrbanStructure& structure) {
+    void drawDetailElement(const UrbanStructure& structure, const ofColor& color) {
         // 装飾的詳細（白い円を除去）
         float detailSize = structure.size * 0.5f;
         
         // 十字マークで装飾要素を表現
-        ofSetLineWidth(1.0f + structure.stability);
-        ofDrawLine(structure.position - ofVec2f(detailSize, 0), structure.position + ofVec2f(detailSize, 0));
-        ofDrawLine(structure.position - ofVec2f(0, detailSize), structure.position + ofVec2f(0, detailSize));
+        float lineWidth = 1.0f + structure.stability;
+        lines.addLine(structure.position - ofVec2f(detailSize, 0), structure.position + ofVec2f(detailSize, 0), lineWidth, color);
+        lines.addLine(structure.position - ofVec2f(0, detailSize), structure.position + ofVec2f(0, detailSize), lineWidth, color);
         
         if (structure.stability > 0.7f) {
             // 高品質詳細（放射状線分）
             for (int i = 0; i < 8; i++) {
                 float angle = (i / 8.0f) * TWO_PI;
                 ofVec2f detailPoint = structure.position + ofVec2f(cos(angle), sin(angle)) * detailSize;
-                ofDrawLine(structure.position, detailPoint);
+                lines.addLine(structure.position, detailPoint, lineWidth, color);
             }
         }
     }
@@ -749,15 +753,15 @@ private:
         if (structures.size() < 20 && globalGrowthLevel > 0.2f) {
             // 緊急建設
             for (int i = 0; i < 5; i++) {
-                ofVec2f emergencyPos(ofRandom(100, ofGetWidth()-100), 
-                                    ofRandom(100, ofGetHeight()-100));
+                ofVec2f emergencyPos(rng.random(100, SimViewport::getWidth()-100), 
+                                    rng.random(100, SimViewport::getHeight()-100));
                 createStructuralElement(emergencyPos, 0.5f + globalGrowthLevel * 0.5f);
             }
         }
     }
     
     void createFoundation(ofVec2f position) {
-        UrbanStructure foundation(position, ofVec2f(0, -1), 20, "foundation", 0);
+        UrbanStructure foundation(rng, position, ofVec2f(0, -1), 20, "foundation", 0);
         foundation.color = urbanColor(currentNote, 0.8f);
         foundation.isConnected = true;
         structures.push_back(foundation);
@@ -766,7 +770,7 @@ private:
     void createStructuralElement(ofVec2f position, float intensity) {
         // より多様な大きめの線分・振り子パーツ
         string elementType;
-        float random = ofRandom(1.0f);
+        float random = rng.random(1.0f);
         if (random < 0.3f) {
             elementType = "pendulum";
         } else if (random < 0.6f) {
@@ -779,17 +783,17 @@ private:
             elementType = "detail";
         }
         
-        ofVec2f direction = ofVec2f(cos(ofRandom(TWO_PI)), sin(ofRandom(TWO_PI)));
+        ofVec2f direction = ofVec2f(cos(rng.random(TWO_PI)), sin(rng.random(TWO_PI)));
         float size = 30 + intensity * 80; // より大きなサイズ
-        int generation = ofRandom(4);
+        int generation = rng.random(4);
         
-        UrbanStructure element(position, direction, size, elementType, generation);
+        UrbanStructure element(rng, position, direction, size, elementType, generation);
         element.color = urbanColor(currentNote + generation * 15, intensity);
         
         // 振り子・線分用の特別な設定
         if (elementType == "pendulum" || elementType == "lever") {
             element.anchor = position;
-            element.length = size * (2.0f + ofRandom(1.0f));
+            element.length = size * (2.0f + rng.random(1.0f));
             element.position = element.anchor + ofVec2f(sin(element.pendulumAngle), cos(element.pendulumAngle)) * element.length;
         }
         
@@ -798,24 +802,24 @@ private:
     
     void proceduralConstruction() {
         // 建物生成確率を大幅に増加（0.02f→0.15f）
-        if (ofRandom(1.0f) < 0.15f * globalGrowthLevel) {
+        if (rng.random(1.0f) < 0.15f * globalGrowthLevel) {
             // 新しい構造要素の自動生成
-            ofVec2f newPos(ofRandom(100, ofGetWidth()-100), ofRandom(100, ofGetHeight()-100));
+            ofVec2f newPos(rng.random(100, SimViewport::getWidth()-100), rng.random(100, SimViewport::getHeight()-100));
             createStructuralElement(newPos, globalGrowthLevel);
         }
         
         // さらに、既存の建物周辺に追加の建物を生成（都市的な成長）
-        if (structures.size() > 10 && ofRandom(1.0f) < 0.1f * globalGrowthLevel) {
+        if (structures.size() > 10 && rng.random(1.0f) < 0.1f * globalGrowthLevel) {
             // 既存建物の近くに新しい建物を配置
-            int randomIndex = ofRandom(structures.size());
+            int randomIndex = rng.random(structures.size());
             auto& existingStructure = structures[randomIndex];
             
             ofVec2f nearbyPos = existingStructure.position + 
-                ofVec2f(ofRandom(-50, 50), ofRandom(-50, 50));
+                ofVec2f(rng.random(-50, 50), rng.random(-50, 50));
             
             // 画面境界内に制限
-            nearbyPos.x = ofClamp(nearbyPos.x, 100, ofGetWidth()-100);
-            nearbyPos.y = ofClamp(nearbyPos.y, 100, ofGetHeight()-100);
+            nearbyPos.x = ofClamp(nearbyPos.x, 100, SimViewport::getWidth()-100);
+            nearbyPos.y = ofClamp(nearbyPos.y, 100, SimViewport::getHeight()-100);
             
             createStructuralElement(nearbyPos, globalGrowthLevel * 0.8f);
         }
@@ -823,14 +827,14 @@ private:
     
     void triggerFoundationWork(float intensity) {
         for (auto& site : constructionSites) {
-            createFoundation(site + ofVec2f(ofRandom(-30, 30), ofRandom(-30, 30)));
+            createFoundation(site + ofVec2f(rng.random(-30, 30), rng.random(-30, 30)));
         }
     }
     
     void triggerFramework(float intensity) {
         // 骨組み作業
         for (int i = 0; i < intensity * 5; i++) {
-            ofVec2f pos(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
+            ofVec2f pos(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
             createStructuralElement(pos, intensity);
         }
     }
@@ -838,8 +842,8 @@ private:
     void triggerDetailWork(float intensity) {
         // 既存構造への詳細追加
         for (auto& structure : structures) {
-            if (structure.type == "pillar" && ofRandom(1.0f) < intensity) {
-                ofVec2f detailPos = structure.position + ofVec2f(ofRandom(-10, 10), ofRandom(-10, 10));
+            if (structure.type == "pillar" && rng.random(1.0f) < intensity) {
+                ofVec2f detailPos = structure.position + ofVec2f(rng.random(-10, 10), rng.random(-10, 10));
                 createStructuralElement(detailPos, intensity * 0.5f);
             }
         }
@@ -847,7 +851,7 @@ private:
     
     void triggerMassiveConstruction() {
         // 大規模建設
-        ofVec2f center(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f);
+        ofVec2f center(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f);
         
         for (int i = 0; i < 20; i++) {
             float angle = (i / 20.0f) * TWO_PI;
@@ -857,7 +861,7 @@ private:
         }
         
         // 新しい建設サイトの追加
-        constructionSites.push_back(center + ofVec2f(ofRandom(-100, 100), ofRandom(-100, 100)));
+        constructionSites.push_back(center + ofVec2f(rng.random(-100, 100), rng.random(-100, 100)));
         if (constructionSites.size() > 6) {
             constructionSites.erase(constructionSites.begin());
         }
@@ -866,7 +870,7 @@ private:
     void applyStructuralFailure() {
         // 崩壊時の構造破綻
         for (auto& structure : structures) {
-            if (ofRandom(1.0f) < 0.05f) {
+            if (rng.random(1.0f) < 0.05f) {
                 structure.stability *= 0.9f;
                 structure.color = urbanColor(currentNote - 30, 0.2f);
             }
@@ -898,7 +902,7 @@ private:
             
             // 境界チェック
             if (cranePositions[i].x < 50) cranePositions[i].x = 50;
-            if (cranePositions[i].x > ofGetWidth() - 50) cranePositions[i].x = ofGetWidth() - 50;
+            if (cranePositions[i].x > SimViewport::getWidth() - 50) cranePositions[i].x = SimViewport::getWidth() - 50;
         }
     }
     
@@ -906,21 +910,21 @@ private:
         // 建築青写真の生成
         for (int type = 0; type < 3; type++) {
             BluePrint bp;
-            bp.origin = ofVec2f(ofRandom(200, ofGetWidth()-200), ofRandom(200, ofGetHeight()-200));
-            bp.scale = ofRandom(0.5f, 2.0f);
+            bp.origin = ofVec2f(rng.random(200, SimViewport::getWidth()-200), rng.random(200, SimViewport::getHeight()-200));
+            bp.scale = rng.random(0.5f, 2.0f);
             bp.type = static_cast<BuildingType>(type);
             
             // ノードの生成
             int numNodes = 8 + type * 4;
             for (int i = 0; i < numNodes; i++) {
-                bp.nodes.push_back(ofVec2f(ofRandom(-50, 50), ofRandom(-50, 50)));
+                bp.nodes.push_back(ofVec2f(rng.random(-50, 50), rng.random(-50, 50)));
             }
             
             // 接続の生成
             for (int i = 0; i < numNodes - 1; i++) {
                 bp.connections.push_back(std::make_pair(i, i + 1));
-                if (i > 0 && ofRandom(1.0f) < 0.3f) {
-                    bp.connections.push_back(std::make_pair(i, ofRandom(i)));
+                if (i > 0 && rng.random(1.0f) < 0.3f) {
+                    bp.connections.push_back(std::make_pair(i, rng.random(i)));
                 }
             }
             
@@ -937,18 +941,16 @@ private:
         ofDrawCircle(structure.anchor.x, structure.anchor.y, 3 + structure.size * 0.05f);
         
         // 振り子の線
-        ofSetLineWidth(2 + structure.size * 0.03f);
-        ofDrawLine(structure.anchor, structure.position);
+        lines.addLine(structure.anchor, structure.position, 2 + structure.size * 0.03f, anchorColor);
         
         // 振り子の重り（大きめの線分十字）
         ofColor weightColor = structure.color;
         weightColor.setBrightness(ofClamp(weightColor.getBrightness() * 0.9f, 40, 150));
-        ofSetColor(weightColor);
-        ofSetLineWidth(3 + structure.size * 0.04f);
+        float weightWidth = 3 + structure.size * 0.04f;
         
         float crossSize = 8 + structure.size * 0.1f;
-        ofDrawLine(structure.position - ofVec2f(crossSize, 0), structure.position + ofVec2f(crossSize, 0));
-        ofDrawLine(structure.position - ofVec2f(0, crossSize), structure.position + ofVec2f(0, crossSize));
+        lines.addLine(structure.position - ofVec2f(crossSize, 0), structure.position + ofVec2f(crossSize, 0), weightWidth, weightColor);
+        lines.addLine(structure.position - ofVec2f(0, crossSize), structure.position + ofVec2f(0, crossSize), weightWidth, weightColor);
     }
     
     void drawLeverElement(const UrbanStructure& structure) {
@@ -964,7 +966,6 @@ private:
                       structure.anchor.x + fulcrumSize * 0.8f, structure.anchor.y + fulcrumSize * 0.5f);
         
         // レバーアーム（両側に伸びる線分）
-        ofSetLineWidth(3 + structure.size * 0.04f);
         ofColor leverColor = structure.color;
         leverColor.setBrightness(ofClamp(leverColor.getBrightness() * 0.8f, 30, 130));
         ofSetColor(leverColor);
@@ -973,10 +974,9 @@ private:
         ofVec2f end1 = structure.anchor + leverDirection * structure.length;
         ofVec2f end2 = structure.anchor - leverDirection * structure.length * 0.7f;
         
-        ofDrawLine(end1, end2);
+        lines.addLine(end1, end2, 3 + structure.size * 0.04f, leverColor);
         
         // 端点の重り
-        ofSetLineWidth(2);
         float endSize = 6 + structure.size * 0.08f;
         ofDrawCircle(end1.x, end1.y, endSize);
         ofDrawCircle(end2.x, end2.y, endSize * 0.7f);
@@ -1018,13 +1018,13 @@ private:
         // 画面下部の繊維束
         for (int i = 0; i < 25; i++) {
             Fiber fiber;
-            fiber.startPos = ofVec2f(ofRandom(-50, ofGetWidth() + 50), ofGetHeight() * (0.75f + ofRandom(0.2f)));
-            fiber.endPos = ofVec2f(ofRandom(-50, ofGetWidth() + 50), ofGetHeight() * (0.85f + ofRandom(0.15f)));
-            fiber.velocity = ofVec2f(ofRandom(-0.5f, 0.5f), ofRandom(-0.2f, 0.2f));
-            fiber.thickness = ofRandom(0.5f, 2.5f);
+            fiber.startPos = ofVec2f(rng.random(-50, SimViewport::getWidth() + 50), SimViewport::getHeight() * (0.75f + rng.random(0.2f)));
+            fiber.endPos = ofVec2f(rng.random(-50, SimViewport::getWidth() + 50), SimViewport::getHeight() * (0.85f + rng.random(0.15f)));
+            fiber.velocity = ofVec2f(rng.random(-0.5f, 0.5f), rng.random(-0.2f, 0.2f));
+            fiber.thickness = rng.random(0.5f, 2.5f);
             fiber.age = 0.0f;
             fiber.color = urbanColor(i * 12, 0.6f);
-            fiber.phase = ofRandom(TWO_PI);
+            fiber.phase = rng.random(TWO_PI);
             fibers.push_back(fiber);
         }
     }
@@ -1039,22 +1039,22 @@ private:
             fiber.endPos += fiber.velocity * deltaTime * 10.0f;
             
             // 速度のランダム変化
-            fiber.velocity += ofVec2f(ofRandom(-0.1f, 0.1f), ofRandom(-0.05f, 0.05f)) * deltaTime;
+            fiber.velocity += ofVec2f(rng.random(-0.1f, 0.1f), rng.random(-0.05f, 0.05f)) * deltaTime;
             fiber.velocity *= 0.98f; // 抵抗
             
             // 境界での循環
             if (fiber.startPos.x < -100) {
-                fiber.startPos.x = ofGetWidth() + 100;
-                fiber.endPos.x = ofGetWidth() + 100;
-            } else if (fiber.startPos.x > ofGetWidth() + 100) {
+                fiber.startPos.x = SimViewport::getWidth() + 100;
+                fiber.endPos.x = SimViewport::getWidth() + 100;
+            } else if (fiber.startPos.x > SimViewport::getWidth() + 100) {
                 fiber.startPos.x = -100;
                 fiber.endPos.x = -100;
             }
             
             // 垂直方向の境界
-            if (fiber.startPos.y < ofGetHeight() * 0.7f) {
+            if (fiber.startPos.y < SimViewport::getHeight() * 0.7f) {
                 fiber.velocity.y = abs(fiber.velocity.y);
-            } else if (fiber.startPos.y > ofGetHeight()) {
+            } else if (fiber.startPos.y > SimViewport::getHeight()) {
                 fiber.velocity.y = -abs(fiber.velocity.y);
             }
             
@@ -1069,17 +1069,17 @@ private:
             gv.position += gv.direction * gv.intensity * deltaTime * 20.0f;
             
             // 境界での反射
-            if (gv.position.x < 0 || gv.position.x > ofGetWidth()) {
+            if (gv.position.x < 0 || gv.position.x > SimViewport::getWidth()) {
                 gv.direction.x *= -1;
-                gv.position.x = ofClamp(gv.position.x, 0, ofGetWidth());
+                gv.position.x = ofClamp(gv.position.x, 0, SimViewport::getWidth());
             }
-            if (gv.position.y < 0 || gv.position.y > ofGetHeight()) {
+            if (gv.position.y < 0 || gv.position.y > SimViewport::getHeight()) {
                 gv.direction.y *= -1;
-                gv.position.y = ofClamp(gv.position.y, 0, ofGetHeight());
+                gv.position.y = ofClamp(gv.position.y, 0, SimViewport::getHeight());
             }
             
             // 方向のランダム変化
-            gv.direction += ofVec2f(ofRandom(-0.1f, 0.1f), ofRandom(-0.1f, 0.1f)) * deltaTime;
+            gv.direction += ofVec2f(rng.random(-0.1f, 0.1f), rng.random(-0.1f, 0.1f)) * deltaTime;
             gv.direction.normalize();
             
             // 色の更新
@@ -1156,7 +1156,7 @@ private:
         if (growthVectors.size() < 12) {
             GrowthVector gv;
             gv.position = position;
-            gv.direction = ofVec2f(cos(ofRandom(TWO_PI)), sin(ofRandom(TWO_PI)));
+            gv.direction = ofVec2f(cos(rng.random(TWO_PI)), sin(rng.random(TWO_PI)));
             gv.intensity = intensity;
             gv.age = 0.0f;
             gv.color = urbanColor(position.x * 0.1f, intensity);
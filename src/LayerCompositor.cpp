@@ -0,0 +1,177 @@
+#include "LayerCompositor.h"
+#include "AsyncLog.h"
+#include "FrameProfiler.h"
+
+void LayerCompositor::setup() {
+    if (!ofIsGLProgrammableRenderer()) {
+        MVLOG_INFO(LOG_CATEGORY_RENDER, "Layer compositor: fixed-function fallback");
+        return;
+    }
+
+    // FBOのテクスチャの種類（ARBなら座標はピクセル単位）に合わせる
+    string sampler = ofGetUsingArbTex() ? "sampler2DRect" : "sampler2D";
+
+    string vertexShader = R"(
+        #version 150
+        uniform mat4 modelViewProjectionMatrix;
+        in vec4 position;
+        in vec2 texcoord;
+        out vec2 texCoordVarying;
+
+        void main() {
+            texCoordVarying = texcoord;
+            gl_Position = modelViewProjectionMatrix * position;
+        }
+    )";
+
+    string fragmentShader = R"(
+        #version 150
+        #define SAMPLER )" + sampler + R"(
+        uniform SAMPLER layer0;
+        uniform SAMPLER layer1;
+        uniform SAMPLER layer2;
+        uniform SAMPLER layer3;
+        uniform int layerCount;
+        uniform float opacity[4];
+        uniform int blendMode[4];
+        in vec2 texCoordVarying;
+        out vec4 outputColor;
+
+        vec3 blendLayer(vec3 base, vec3 layer, int mode, float amount) {
+            vec3 blended = layer;
+            if (mode == 1) {
+                blended = base + layer;
+            } else if (mode == 2) {
+                blended = 1.0 - (1.0 - base) * (1.0 - layer);
+            } else if (mode == 3) {
+                blended = base * layer;
+            }
+            return mix(base, blended, amount);
+        }
+
+        void main() {
+            vec3 color = blendLayer(vec3(0.0), texture(layer0, texCoordVarying).rgb, blendMode[0], opacity[0]);
+            if (layerCount > 1) color = blendLayer(color, texture(layer1, texCoordVarying).rgb, blendMode[1], opacity[1]);
+            if (layerCount > 2) color = blendLayer(color, texture(layer2, texCoordVarying).rgb, blendMode[2], opacity[2]);
+            if (layerCount > 3) color = blendLayer(color, texture(layer3, texCoordVarying).rgb, blendMode[3], opacity[3]);
+            outputColor = vec4(color, 1.0);
+        }
+    )";
+
+    compositeShader.setupShaderFromSource(GL_VERTEX_SHADER, vertexShader);
+    compositeShader.setupShaderFromSource(GL_FRAGMENT_SHADER, fragmentShader);
+    compositeShader.bindDefaults();
+    compositeShader.linkProgram();
+    MVLOG_INFO(LOG_CATEGORY_RENDER, "Layer compositor: %s", compositeShader.isLoaded() ? "single-pass shader" : "shader failed, fixed-function fallback");
+}
+
+void LayerCompositor::begin(int width, int height) {
+    layerCount = 0;
+    frameWidth = width;
+    frameHeight = height;
+}
+
+bool LayerCompositor::beginLayer(float opacity, LayerBlendMode mode) {
+    if (layerCount >= MAX_LAYERS) {
+        return false;
+    }
+
+    Layer& layer = layers[layerCount++];
+    if (!layer.target || layer.target->getWidth() != frameWidth || layer.target->getHeight() != frameHeight) {
+        layer.target = RenderTargetPool::acquire(frameWidth, frameHeight, GL_RGBA);
+    }
+    layer.opacity = ofClamp(opacity, 0.0f, 1.0f);
+    layer.mode = mode;
+
+    // システムは不透明な黒の上に描く前提（glitchOutputFboと同じ）
+    layer.target->begin();
+    ofClear(0, 0, 0, 255);
+    return true;
+}
+
+void LayerCompositor::endLayer() {
+    Layer& layer = layers[layerCount - 1];
+    if (!compositeShader.isLoaded()) {
+        // 順に重ねる近似ではテクスチャのアルファも掛かるので、描いた後のアルファを1に戻しておく
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_TRUE);
+        ofPushStyle();
+        ofSetColor(255);
+        ofDrawRectangle(0, 0, frameWidth, frameHeight);
+        ofPopStyle();
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    }
+    layer.target->end();
+}
+
+void LayerCompositor::composite() {
+    PROFILE_ZONE("composite Layers");
+    if (layerCount > 0) {
+        if (compositeShader.isLoaded()) {
+            compositeWithShader();
+        } else {
+            compositeFallback();
+        }
+    }
+
+    // このフレームで使わなかったターゲットを返す
+    for (int i = layerCount; i < MAX_LAYERS; i++) {
+        layers[i].target.reset();
+    }
+}
+
+void LayerCompositor::releaseTargets() {
+    for (auto& layer : layers) {
+        layer.target.reset();
+    }
+    layerCount = 0;
+}
+
+void LayerCompositor::compositeWithShader() {
+    static const char* const LAYER_UNIFORMS[MAX_LAYERS] = {"layer0", "layer1", "layer2", "layer3"};
+    float opacities[MAX_LAYERS] = {0.0f};
+    int modes[MAX_LAYERS] = {0};
+    for (int i = 0; i < layerCount; i++) {
+        opacities[i] = layers[i].opacity;
+        modes[i] = layers[i].mode;
+    }
+
+    ofPushStyle();
+    ofDisableBlendMode();
+    ofSetColor(255);
+    compositeShader.begin();
+    // 使わないレイヤーのサンプラーも有効なテクスチャを指しておく
+    for (int i = 0; i < MAX_LAYERS; i++) {
+        const Layer& layer = layers[i < layerCount ? i : 0];
+        compositeShader.setUniformTexture(LAYER_UNIFORMS[i], layer.target->getTexture(), i + 1);
+    }
+    compositeShader.setUniform1i("layerCount", layerCount);
+    compositeShader.setUniform1fv("opacity", opacities, MAX_LAYERS);
+    compositeShader.setUniform1iv("blendMode", modes, MAX_LAYERS);
+    // 全画面の矩形（テクスチャ座標は1枚目のレイヤーのもの、全レイヤー同じサイズ）
+    layers[0].target->draw(0, 0);
+    compositeShader.end();
+    ofPopStyle();
+}
+
+void LayerCompositor::compositeFallback() {
+    ofPushStyle();
+    for (int i = 0; i < layerCount; i++) {
+        const Layer& layer = layers[i];
+        if (i == 0 && layer.mode == LAYER_BLEND_ALPHA) {
+            // 一番下は黒との混合なので、不透明度をそのまま明るさにする
+            ofDisableBlendMode();
+            ofSetColor(255 * layer.opacity);
+        } else {
+            switch (layer.mode) {
+                case LAYER_BLEND_ADD: ofEnableBlendMode(OF_BLENDMODE_ADD); break;
+                case LAYER_BLEND_SCREEN: ofEnableBlendMode(OF_BLENDMODE_SCREEN); break;
+                case LAYER_BLEND_MULTIPLY: ofEnableBlendMode(OF_BLENDMODE_MULTIPLY); break;
+                default: ofEnableBlendMode(OF_BLENDMODE_ALPHA); break;
+            }
+            ofSetColor(255, 255 * layer.opacity);
+        }
+        layer.target->draw(0, 0);
+    }
+    ofDisableBlendMode();
+    ofPopStyle();
+}
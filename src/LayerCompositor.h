@@ -0,0 +1,59 @@
+#pragma once
+
+#include "ofMain.h"
+#include "RenderTargetPool.h"
+#include <array>
+
+// レイヤーの合成モード
+enum LayerBlendMode {
+    LAYER_BLEND_ALPHA = 0,    // 不透明度で下のレイヤーと混ぜる（クロスフェード）
+    LAYER_BLEND_ADD,
+    LAYER_BLEND_SCREEN,
+    LAYER_BLEND_MULTIPLY
+};
+
+// 複数のビジュアルシステムを重ねるオフスクリーンのコンポジタ
+// - レイヤーごとにプールから借りたターゲットへ1フレーム1回だけ描き（システムのエフェクトの連鎖はそのターゲットの中で完結する）、
+//   最後に全レイヤーを不透明度・合成モード付きで1パスで合成する
+// - レイヤーは不透明な黒の上に描くので、合成はRGBだけを見る（入れ子のFBOで崩れたアルファに左右されない）
+// - プログラマブルレンダラーでなければ、レイヤーを順に重ねる描画で近似する（SCREEN・MULTIPLYは不透明度を反映しない）
+// ターゲットは使っている間だけ借りておき、使うレイヤーが減ったら返す
+class LayerCompositor {
+public:
+    static const int MAX_LAYERS = 4;
+
+    // GLコンテキストのある描画スレッドで呼ぶ
+    void setup();
+
+    // 合成するフレームの開始（レイヤーは描いた順に下から重なる）
+    void begin(int width, int height);
+
+    // レイヤーのターゲットに切り替えて黒でクリアする。満杯ならfalse（描かない）
+    bool beginLayer(float opacity, LayerBlendMode mode = LAYER_BLEND_ALPHA);
+    void endLayer();
+
+    // 今バインドされているターゲットに合成する。使わなかったターゲットはプールに返す
+    void composite();
+
+    // すべてのターゲットを返す（合成しないフレーム・リサイズ時）
+    void releaseTargets();
+
+    int getLayerCount() const { return layerCount; }
+    bool isShaderComposite() const { return compositeShader.isLoaded(); }
+
+private:
+    struct Layer {
+        RenderTarget target;
+        float opacity = 1.0f;
+        LayerBlendMode mode = LAYER_BLEND_ALPHA;
+    };
+
+    void compositeWithShader();
+    void compositeFallback();
+
+    std::array<Layer, MAX_LAYERS> layers;
+    int layerCount = 0;
+    int frameWidth = 0;
+    int frameHeight = 0;
+    ofShader compositeShader;
+};
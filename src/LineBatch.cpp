@@ -0,0 +1,92 @@
+#include "LineBatch.h"
+#include "FrameProfiler.h"
+#include "SoftwareRenderer.h"
+#include <cstddef>
+
+// 太さ1ピクセル未満は1ピクセルにして、その分だけ薄くする
+static void applyMinimumWidth(float& width, ofFloatColor& color) {
+    if (width < 1.0f) {
+        color.a *= std::max(width, 0.0f);
+        width = 1.0f;
+    }
+}
+
+static LineVertex makeVertex(const ofVec2f& position, const ofFloatColor& color) {
+    LineVertex vertex;
+    vertex.x = position.x;
+    vertex.y = position.y;
+    vertex.r = color.r;
+    vertex.g = color.g;
+    vertex.b = color.b;
+    vertex.a = color.a;
+    return vertex;
+}
+
+std::size_t LineBatch::tessellate(const std::vector<LineSegment>& segments, std::vector<LineVertex>& vertices) {
+    std::size_t first = vertices.size();
+    vertices.reserve(first + segments.size() * 6);
+
+    for (const auto& segment : segments) {
+        ofVec2f direction = segment.end - segment.start;
+        float length = direction.length();
+        if (length < 1e-6f) continue;
+
+        float startWidth = segment.startWidth;
+        float endWidth = segment.endWidth;
+        ofFloatColor startColor = segment.startColor;
+        ofFloatColor endColor = segment.endColor;
+        applyMinimumWidth(startWidth, startColor);
+        applyMinimumWidth(endWidth, endColor);
+
+        // 線分に垂直な単位ベクトル
+        ofVec2f normal(-direction.y / length, direction.x / length);
+        ofVec2f startOffset = normal * (startWidth * 0.5f);
+        ofVec2f endOffset = normal * (endWidth * 0.5f);
+
+        LineVertex startLeft = makeVertex(segment.start + startOffset, startColor);
+        LineVertex startRight = makeVertex(segment.start - startOffset, startColor);
+        LineVertex endLeft = makeVertex(segment.end + endOffset, endColor);
+        LineVertex endRight = makeVertex(segment.end - endOffset, endColor);
+
+        vertices.push_back(startLeft);
+        vertices.push_back(startRight);
+        vertices.push_back(endLeft);
+        vertices.push_back(startRight);
+        vertices.push_back(endRight);
+        vertices.push_back(endLeft);
+    }
+    return vertices.size() - first;
+}
+
+void LineBatch::draw() {
+    if (segments.empty()) return;
+    PROFILE_ZONE("LineBatch");
+
+    // ヘッドレスのソフトウェアレンダラーにはバッファを使わずに直接描く
+    if (SoftwareRenderer* software = SoftwareRenderer::getCurrent()) {
+        software->drawLineSegments(segments);
+        segments.clear();
+        return;
+    }
+
+    vertices.clear();
+    tessellate(segments, vertices);
+    segments.clear();
+    if (vertices.empty()) return;
+
+    if (!vboConfigured) {
+        vboConfigured = true;
+        buffer.allocate();
+        int stride = sizeof(LineVertex);
+        vbo.setVertexBuffer(buffer, 2, stride, offsetof(LineVertex, x));
+        vbo.setColorBuffer(buffer, stride, offsetof(LineVertex, r));
+    }
+    // 毎回確保し直す（GL_STREAM_DRAWの作り直しで、GPUが前のフレームの内容を読み終えるのを待たない）
+    buffer.setData(vertices.size() * sizeof(LineVertex), vertices.data(), GL_STREAM_DRAW);
+
+    // 色は頂点の色だけを使う
+    ofPushStyle();
+    ofSetColor(255);
+    vbo.draw(GL_TRIANGLES, 0, vertices.size());
+    ofPopStyle();
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "ofMain.h"
+#include <iterator>
+#include <vector>
+
+// 線分1本（端点ごとの太さ・色、色は0〜1）
+struct LineSegment {
+    ofVec2f start;
+    ofVec2f end;
+    float startWidth = 1.0f;
+    float endWidth = 1.0f;
+    ofFloatColor startColor = ofFloatColor(1, 1, 1, 1);
+    ofFloatColor endColor = ofFloatColor(1, 1, 1, 1);
+};
+
+// 展開した頂点（位置と色、三角形リスト）
+struct LineVertex {
+    float x, y;
+    float r, g, b, a;
+};
+
+// 線分をまとめて描くバッチ
+// - add*()は端点の位置・太さ・色をCPU側の配列に積むだけ（GLに触れないので、どのスレッドで積んでもよい）
+// - draw()は線分を太さ分の四角形（三角形2つ）に展開して1つのバッファにアップロードし、今のブレンドモードで1回で描いて空にする
+//   ofSetLineWidthの切り替えがないので、線分ごとに太さが違ってもドローコールは分かれない
+// - 太さ1ピクセル未満の線分は太さ1にしてアルファを太さの割合だけ下げる（GL_LINESの細い線と同じ見え方）
+// 展開（tessellate）はGLを使わないので、GLなしで結果を確かめられる
+// ブレンドモードごとにdraw()を呼ぶ。配列とバッファは作り直さずに使い回す
+// コピーしても中身・バッファは写さない（SpriteBatchと同じく、コピー先は自分のGLのバッファを持ち続ける）
+class LineBatch {
+public:
+    LineBatch() = default;
+    LineBatch(const LineBatch&) {}
+    LineBatch& operator=(const LineBatch&) { return *this; }
+
+    // colorのアルファをそのまま使う（ofSetColor(color)と同じ）
+    void addLine(const ofVec2f& start, const ofVec2f& end, float width, const ofColor& color) {
+        addLine(start, end, width, color, color.a);
+    }
+
+    // colorのアルファは無視して、alpha（0〜255、ofSetColor(color, alpha)と同じ）を使う
+    void addLine(const ofVec2f& start, const ofVec2f& end, float width, const ofColor& color, float alpha) {
+        ofFloatColor lineColor(color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, ofClamp(alpha, 0, 255) / 255.0f);
+        addLine(start, end, width, width, lineColor, lineColor);
+    }
+
+    // 端点ごとに太さと色を指定する
+    void addLine(const ofVec2f& start, const ofVec2f& end, float startWidth, float endWidth,
+                 const ofFloatColor& startColor, const ofFloatColor& endColor) {
+        segments.emplace_back();
+        LineSegment& segment = segments.back();
+        segment.start = start;
+        segment.end = end;
+        segment.startWidth = startWidth;
+        segment.endWidth = endWidth;
+        segment.startColor = startColor;
+        segment.endColor = endColor;
+    }
+
+    // 点を順につないだ折れ線（ofPolyline::draw()と同じく継ぎ目は埋めない）
+    template<typename Points>
+    void addPolyline(const Points& points, float width, const ofColor& color) {
+        auto previous = points.begin();
+        if (previous == points.end()) return;
+        for (auto current = std::next(previous); current != points.end(); ++previous, ++current) {
+            addLine(ofVec2f(previous->x, previous->y), ofVec2f(current->x, current->y), width, color);
+        }
+    }
+
+    // 積んだ線分を今のブレンドモードで描いて空にする（描画スレッド）
+    void draw();
+
+    void clear() { segments.clear(); }
+    std::size_t size() const { return segments.size(); }
+    const std::vector<LineSegment>& getSegments() const { return segments; }
+
+    // 線分を三角形リストに展開してverticesの後ろに足す（1本6頂点、長さ0の線分は飛ばす）。足した頂点数を返す
+    static std::size_t tessellate(const std::vector<LineSegment>& segments, std::vector<LineVertex>& vertices);
+
+private:
+    std::vector<LineSegment> segments;
+    std::vector<LineVertex> vertices;
+    ofBufferObject buffer;
+    ofVbo vbo;
+    bool vboConfigured = false;
+};
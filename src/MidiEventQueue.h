@@ -0,0 +1,199 @@
+#pragma once
+
+#include "ofxMidi.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// MIDI入力ポートの識別子
+enum MidiInputPort : uint8_t {
+    MIDI_PORT_DRUMS = 0,   // IAC ドライバー（ドラム）
+    MIDI_PORT_PUSH2 = 1,   // Push2（グリッチトリガー）
+    NUM_MIDI_PORTS
+};
+
+// 単調増加クロック（マイクロ秒）- MIDIスレッドとメインスレッドで共通に使う
+inline uint64_t midiNowMicros() {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// リングバッファに積むコンパクトなMIDIイベント（POD）
+struct MidiEvent {
+    uint64_t timestampMicros;  // 到着時刻（midiNowMicros基準）
+    uint8_t port;              // MidiInputPort
+    uint8_t status;            // MidiStatus
+    uint8_t channel;           // 1-16（システムメッセージは0）
+    uint8_t data1;             // pitch / control
+    uint8_t data2;             // velocity / value
+    
+    static MidiEvent fromMessage(const ofxMidiMessage& msg, uint8_t port, uint64_t timestampMicros) {
+        MidiEvent event;
+        event.timestampMicros = timestampMicros;
+        event.port = port;
+        event.status = (uint8_t)msg.status;
+        event.channel = (uint8_t)msg.channel;
+        event.data1 = 0;
+        event.data2 = 0;
+        
+        switch (msg.status) {
+            case MIDI_NOTE_ON:
+            case MIDI_NOTE_OFF:
+                event.data1 = (uint8_t)msg.pitch;
+                event.data2 = (uint8_t)msg.velocity;
+                break;
+            case MIDI_CONTROL_CHANGE:
+                event.data1 = (uint8_t)msg.control;
+                event.data2 = (uint8_t)msg.value;
+                break;
+            case MIDI_POLY_AFTERTOUCH:
+                event.data1 = (uint8_t)msg.pitch;
+                event.data2 = (uint8_t)msg.value;
+                break;
+            case MIDI_PROGRAM_CHANGE:
+            case MIDI_AFTERTOUCH:
+                event.data1 = (uint8_t)msg.value;
+                break;
+            case MIDI_PITCH_BEND:
+                event.data1 = (uint8_t)(msg.value & 0x7F);
+                event.data2 = (uint8_t)((msg.value >> 7) & 0x7F);
+                break;
+            default:
+                break;
+        }
+        return event;
+    }
+    
+    void toMessage(ofxMidiMessage& msg) const {
+        msg.status = (MidiStatus)status;
+        msg.channel = channel;
+        msg.pitch = 0;
+        msg.velocity = 0;
+        msg.control = 0;
+        msg.value = 0;
+        
+        switch (msg.status) {
+            case MIDI_NOTE_ON:
+            case MIDI_NOTE_OFF:
+                msg.pitch = data1;
+                msg.velocity = data2;
+                break;
+            case MIDI_CONTROL_CHANGE:
+                msg.control = data1;
+                msg.value = data2;
+                break;
+            case MIDI_POLY_AFTERTOUCH:
+                msg.pitch = data1;
+                msg.value = data2;
+                break;
+            case MIDI_PROGRAM_CHANGE:
+            case MIDI_AFTERTOUCH:
+                msg.value = data1;
+                break;
+            case MIDI_PITCH_BEND:
+                msg.value = data1 | (data2 << 7);
+                break;
+            default:
+                break;
+        }
+    }
+};
+
+// 単一プロデューサ／単一コンシューマのロックフリーリングバッファ
+// プロデューサ: RtMidiのコールバックスレッド、コンシューマ: ofApp::update()
+template<typename T, std::size_t Capacity>
+class SpscRingBuffer {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    bool push(const T& item) {
+        std::size_t head = writeIndex.load(std::memory_order_relaxed);
+        std::size_t tail = readIndex.load(std::memory_order_acquire);
+        if (head - tail >= Capacity) {
+            return false;  // 満杯
+        }
+        buffer[head & (Capacity - 1)] = item;
+        writeIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    
+    bool pop(T& item) {
+        std::size_t tail = readIndex.load(std::memory_order_relaxed);
+        std::size_t head = writeIndex.load(std::memory_order_acquire);
+        if (tail == head) {
+            return false;  // 空
+        }
+        item = buffer[tail & (Capacity - 1)];
+        readIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    
+    std::size_t size() const {
+        return writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire);
+    }
+    
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    std::array<T, Capacity> buffer;
+    alignas(64) std::atomic<std::size_t> writeIndex{0};
+    alignas(64) std::atomic<std::size_t> readIndex{0};
+};
+
+// 入力ポートごとのMIDIイベントキュー（統計付き）
+class MidiEventQueue {
+public:
+    static const std::size_t CAPACITY = 1024;
+    
+    // MIDIスレッドから呼ぶ（ロック・確保なし）。arrivalMicrosはリスナーのコールバックで押した到着時刻
+    void push(const ofxMidiMessage& msg, uint8_t port, uint64_t arrivalMicros) {
+        if (!events.push(MidiEvent::fromMessage(msg, port, arrivalMicros))) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    
+    // メインスレッドから呼ぶ
+    bool pop(MidiEvent& event) {
+        return events.pop(event);
+    }
+    
+    // ディスパッチ時に呼んでレイテンシ統計を更新する（メインスレッド）
+    void recordDispatch(const MidiEvent& event, uint64_t dispatchMicros) {
+        uint64_t latency = dispatchMicros > event.timestampMicros ? dispatchMicros - event.timestampMicros : 0;
+        if (latency > worstLatencyMicros) {
+            worstLatencyMicros = latency;
+        }
+        dispatchedCount++;
+    }
+    
+    // ドレイン直前の深さを記録（メインスレッド）
+    void recordDepth(std::size_t depth) {
+        lastDepth = depth;
+        if (depth > maxDepth) {
+            maxDepth = depth;
+        }
+    }
+    
+    std::size_t size() const { return events.size(); }
+    std::size_t getLastDepth() const { return lastDepth; }
+    std::size_t getMaxDepth() const { return maxDepth; }
+    uint64_t getDroppedCount() const { return droppedCount.load(std::memory_order_relaxed); }
+    uint64_t getDispatchedCount() const { return dispatchedCount; }
+    uint64_t getWorstLatencyMicros() const { return worstLatencyMicros; }
+    
+    void resetStats() {
+        maxDepth = 0;
+        worstLatencyMicros = 0;
+    }
+
+private:
+    SpscRingBuffer<MidiEvent, CAPACITY> events;
+    std::atomic<uint64_t> droppedCount{0};
+    
+    // 以下はメインスレッドのみが触る
+    std::size_t lastDepth = 0;
+    std::size_t maxDepth = 0;
+    uint64_t dispatchedCount = 0;
+    uint64_t worstLatencyMicros = 0;
+};
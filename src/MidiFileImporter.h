@@ -0,0 +1,290 @@
+#pragma once
+
+#include "MidiEventQueue.h"
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Standard MIDI File（Type 0/1）の読み込み
+// ファイルを一度だけ読み込み、トラックを2パスで走査する
+//   1パス目: イベント数の集計とテンポマップの収集
+//   2パス目: 全トラックを絶対ティック順にk-wayマージし、テンポマップでマイクロ秒に変換
+// 出力は事前確保した時刻順の配列で、イベントごとの確保は発生しない
+class MidiFileImporter {
+public:
+    // ノートオン/オフ・CC・プログラムチェンジ・アフタータッチ・ピッチベンドを
+    // 指定ポートのイベントとして out に書き出す（時刻はファイル先頭からのマイクロ秒）
+    // endMicrosには曲の終わり（最も遅いEnd of Track、なければ最後のイベント）の時刻を返す
+    static bool load(const std::string& filePath, std::vector<MidiEvent>& out, uint8_t port = MIDI_PORT_DRUMS, uint64_t* endMicros = nullptr) {
+        std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            cout << "SMF: failed to open " << filePath << endl;
+            return false;
+        }
+        
+        std::vector<uint8_t> data(file.tellg());
+        file.seekg(0);
+        file.read((char*)data.data(), data.size());
+        
+        // ヘッダチャンク
+        if (data.size() < 14 || !matchTag(data.data(), "MThd")) {
+            cout << "SMF: not a MIDI file: " << filePath << endl;
+            return false;
+        }
+        uint32_t headerLength = readUInt32(&data[4]);
+        uint16_t format = readUInt16(&data[8]);
+        uint16_t numTracks = readUInt16(&data[10]);
+        uint16_t division = readUInt16(&data[12]);
+        if (format > 1) {
+            cout << "SMF: format " << format << " is not supported (Type 0/1 only)" << endl;
+            return false;
+        }
+        
+        // トラックチャンクの位置を収集
+        std::vector<TrackReader> tracks;
+        tracks.reserve(numTracks);
+        std::size_t offset = 8 + headerLength;
+        while (offset + 8 <= data.size() && tracks.size() < numTracks) {
+            uint32_t length = readUInt32(&data[offset + 4]);
+            const uint8_t* begin = &data[offset + 8];
+            const uint8_t* end = begin + std::min<std::size_t>(length, data.size() - offset - 8);
+            if (matchTag(&data[offset], "MTrk")) {
+                tracks.push_back(TrackReader(begin, end));
+            }
+            offset += 8 + length;
+        }
+        
+        // 1パス目: イベント数とテンポマップ
+        std::vector<TempoChange> tempoMap;
+        std::size_t eventCount = 0;
+        uint64_t endTick = 0;
+        for (auto track : tracks) {
+            TrackEvent event;
+            while (track.next(event)) {
+                if (event.isTempo) {
+                    tempoMap.push_back({event.tick, event.tempoMicrosPerQuarter});
+                } else if (event.isChannel) {
+                    eventCount++;
+                }
+            }
+            endTick = std::max(endTick, track.getTick());
+        }
+        std::stable_sort(tempoMap.begin(), tempoMap.end(),
+                         [](const TempoChange& a, const TempoChange& b) { return a.tick < b.tick; });
+        
+        // 2パス目: ティック順マージ + マイクロ秒変換
+        out.clear();
+        out.reserve(eventCount);
+        
+        TickConverter converter(division, tempoMap);
+        std::vector<TrackEvent> pending(tracks.size());
+        std::vector<bool> hasPending(tracks.size());
+        for (std::size_t i = 0; i < tracks.size(); i++) {
+            hasPending[i] = tracks[i].nextChannelEvent(pending[i]);
+        }
+        
+        while (true) {
+            // 最小ティックのトラック（同ティックならトラック番号順）
+            int selected = -1;
+            for (std::size_t i = 0; i < tracks.size(); i++) {
+                if (hasPending[i] && (selected < 0 || pending[i].tick < pending[selected].tick)) {
+                    selected = i;
+                }
+            }
+            if (selected < 0) break;
+            
+            const TrackEvent& event = pending[selected];
+            MidiEvent midiEvent;
+            midiEvent.timestampMicros = converter.toMicros(event.tick);
+            midiEvent.port = port;
+            midiEvent.status = event.status;
+            midiEvent.channel = event.channel;
+            midiEvent.data1 = event.data1;
+            midiEvent.data2 = event.data2;
+            out.push_back(midiEvent);
+            
+            hasPending[selected] = tracks[selected].nextChannelEvent(pending[selected]);
+        }
+        
+        // 曲の終わり（変換は単調増加の問い合わせなので最後に）
+        uint64_t songEndMicros = converter.toMicros(endTick);
+        if (!out.empty()) {
+            songEndMicros = std::max(songEndMicros, out.back().timestampMicros);
+        }
+        if (endMicros) {
+            *endMicros = songEndMicros;
+        }
+        
+        float initialBpm = tempoMap.empty() ? 120.0f : 60000000.0f / tempoMap.front().microsPerQuarter;
+        cout << "SMF: type " << format << ", " << tracks.size() << " tracks, " << out.size() << " events, "
+             << tempoMap.size() << " tempo changes (initial " << ofToString(initialBpm, 1) << " BPM), "
+             << songEndMicros / 1000000.0f << "s" << endl;
+        return true;
+    }
+
+private:
+    struct TempoChange {
+        uint64_t tick;
+        uint32_t microsPerQuarter;
+    };
+    
+    struct TrackEvent {
+        uint64_t tick = 0;
+        bool isChannel = false;
+        bool isTempo = false;
+        uint8_t status = 0;      // MidiStatus（チャンネル部分を除く）
+        uint8_t channel = 0;     // 1-16
+        uint8_t data1 = 0;
+        uint8_t data2 = 0;
+        uint32_t tempoMicrosPerQuarter = 0;
+    };
+    
+    // トラックチャンクを先頭から順に読む（ランニングステータス対応）
+    class TrackReader {
+    public:
+        TrackReader(const uint8_t* begin, const uint8_t* end) : cursor(begin), end(end) {}
+        
+        bool next(TrackEvent& event) {
+            if (cursor >= end) return false;
+            
+            tick += readVarLen();
+            event.tick = tick;
+            event.isChannel = false;
+            event.isTempo = false;
+            if (cursor >= end) return false;
+            
+            uint8_t status = *cursor;
+            if (status < 0x80) {
+                // ランニングステータス
+                if (runningStatus == 0) return false;
+                status = runningStatus;
+            } else {
+                cursor++;
+            }
+            
+            if (status == 0xFF) {
+                // メタイベント
+                if (cursor >= end) return false;
+                uint8_t type = *cursor++;
+                uint32_t length = readVarLen();
+                if (type == 0x51 && length == 3 && cursor + 3 <= end) {
+                    event.isTempo = true;
+                    event.tempoMicrosPerQuarter = (cursor[0] << 16) | (cursor[1] << 8) | cursor[2];
+                } else if (type == 0x2F) {
+                    cursor = end;  // End of Track
+                    return false;
+                }
+                cursor += std::min<std::size_t>(length, end - cursor);
+                runningStatus = 0;  // メタイベントはランニングステータスを解除
+                return true;
+            }
+            if (status == 0xF0 || status == 0xF7) {
+                // SysEx（読み飛ばし）
+                uint32_t length = readVarLen();
+                cursor += std::min<std::size_t>(length, end - cursor);
+                runningStatus = 0;
+                return true;
+            }
+            if (status >= 0xF0) {
+                return false;  // ファイル中に現れないはずのシステムメッセージ
+            }
+            
+            runningStatus = status;
+            uint8_t type = status & 0xF0;
+            int numData = (type == 0xC0 || type == 0xD0) ? 1 : 2;
+            if (cursor + numData > end) return false;
+            
+            event.data1 = cursor[0] & 0x7F;
+            event.data2 = numData == 2 ? (cursor[1] & 0x7F) : 0;
+            cursor += numData;
+            
+            event.isChannel = true;
+            event.channel = (status & 0x0F) + 1;
+            event.status = type;
+            // ベロシティ0のノートオンはノートオフとして扱う
+            if (type == MIDI_NOTE_ON && event.data2 == 0) {
+                event.status = MIDI_NOTE_OFF;
+            }
+            return true;
+        }
+        
+        // 読んだところまでの絶対ティック（最後まで読めばEnd of Trackの位置）
+        uint64_t getTick() const { return tick; }
+        
+        // 次のチャンネルイベントまで進める
+        bool nextChannelEvent(TrackEvent& event) {
+            while (next(event)) {
+                if (event.isChannel) return true;
+            }
+            return false;
+        }
+    
+    private:
+        uint32_t readVarLen() {
+            uint32_t value = 0;
+            for (int i = 0; i < 4 && cursor < end; i++) {
+                uint8_t byte = *cursor++;
+                value = (value << 7) | (byte & 0x7F);
+                if (!(byte & 0x80)) break;
+            }
+            return value;
+        }
+        
+        const uint8_t* cursor;
+        const uint8_t* end;
+        uint64_t tick = 0;
+        uint8_t runningStatus = 0;
+    };
+    
+    // テンポマップに沿ってティックをマイクロ秒に変換（単調増加の問い合わせ前提）
+    class TickConverter {
+    public:
+        TickConverter(uint16_t division, const std::vector<TempoChange>& tempoMap) : tempoMap(tempoMap) {
+            if (division & 0x8000) {
+                // SMPTE: -fps × ticks/frame（テンポに依存しない）
+                int fps = -(int8_t)(division >> 8);
+                int ticksPerFrame = division & 0xFF;
+                smpteMicrosPerTick = 1000000.0 / (std::max(1, fps) * std::max(1, ticksPerFrame));
+            } else {
+                ticksPerQuarter = std::max<uint16_t>(1, division);
+            }
+        }
+        
+        uint64_t toMicros(uint64_t tick) {
+            if (smpteMicrosPerTick > 0.0) {
+                return (uint64_t)(tick * smpteMicrosPerTick);
+            }
+            
+            // 現在のテンポ区間を進める
+            while (nextTempo < tempoMap.size() && tempoMap[nextTempo].tick <= tick) {
+                segmentMicros += (double)(tempoMap[nextTempo].tick - segmentTick) * microsPerQuarter / ticksPerQuarter;
+                segmentTick = tempoMap[nextTempo].tick;
+                microsPerQuarter = tempoMap[nextTempo].microsPerQuarter;
+                nextTempo++;
+            }
+            return (uint64_t)(segmentMicros + (double)(tick - segmentTick) * microsPerQuarter / ticksPerQuarter);
+        }
+    
+    private:
+        const std::vector<TempoChange>& tempoMap;
+        std::size_t nextTempo = 0;
+        uint64_t segmentTick = 0;
+        double segmentMicros = 0.0;
+        uint32_t microsPerQuarter = 500000;  // 既定120BPM
+        uint16_t ticksPerQuarter = 480;
+        double smpteMicrosPerTick = 0.0;
+    };
+    
+    static bool matchTag(const uint8_t* bytes, const char* tag) {
+        return std::equal(bytes, bytes + 4, (const uint8_t*)tag);
+    }
+    
+    static uint16_t readUInt16(const uint8_t* bytes) {
+        return (bytes[0] << 8) | bytes[1];
+    }
+    
+    static uint32_t readUInt32(const uint8_t* bytes) {
+        return ((uint32_t)bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+    }
+};
@@ -0,0 +1,172 @@
+#include "MidiLatencyTracker.h"
+#include <algorithm>
+
+// 段階の番号（windowPercentiles用）
+enum LatencyStage {
+    STAGE_QUEUE = 0,
+    STAGE_SIMULATION,
+    STAGE_RENDER,
+    STAGE_TOTAL,
+    NUM_STAGES
+};
+
+static const char* const STAGE_NAMES[NUM_STAGES] = {"queue", "simulation", "render", "total"};
+static const ofColor STAGE_COLORS[NUM_STAGES] = {ofColor(100, 180, 255), ofColor(255, 200, 80), ofColor(120, 255, 120), ofColor(255)};
+
+static float stageMillis(const MidiLatencyTracker::Sample& sample, int stage) {
+    switch (stage) {
+        case STAGE_QUEUE: return (sample.dispatchMicros - sample.arrivalMicros) / 1000.0f;
+        case STAGE_SIMULATION: return (sample.simulatedMicros - sample.dispatchMicros) / 1000.0f;
+        case STAGE_RENDER: return (sample.presentedMicros - sample.simulatedMicros) / 1000.0f;
+        default: return (sample.presentedMicros - sample.arrivalMicros) / 1000.0f;
+    }
+}
+
+void MidiLatencyTracker::beginFrame(uint64_t nowMicros) {
+    // 前フレーム（frame）で描いた状態が、今の入れ替えで画面に出た
+    int kept = 0;
+    for (int i = 0; i < pendingCount; i++) {
+        Pending& entry = pending[i];
+        if (entry.state == PENDING_SIMULATED && entry.sample.frame <= frame) {
+            entry.sample.presentedMicros = nowMicros;
+            complete(entry.sample);
+        } else {
+            pending[kept++] = entry;
+        }
+    }
+    pendingCount = kept;
+    frame++;
+}
+
+void MidiLatencyTracker::addDispatch(const MidiEvent& event, uint64_t dispatchMicros) {
+    if (pendingCount >= PENDING_CAPACITY) {
+        dropped++;
+        return;
+    }
+    Pending& entry = pending[pendingCount++];
+    entry.sample = Sample();
+    entry.sample.arrivalMicros = std::min(event.timestampMicros, dispatchMicros);
+    entry.sample.dispatchMicros = dispatchMicros;
+    entry.sample.frame = frame;
+    entry.sample.port = event.port;
+    entry.sample.status = event.status;
+    entry.sample.data1 = event.data1;
+    entry.state = PENDING_DISPATCHED;
+}
+
+void MidiLatencyTracker::endUpdate(uint64_t nowMicros, bool deferred) {
+    for (int i = 0; i < pendingCount; i++) {
+        Pending& entry = pending[i];
+        if (entry.state != PENDING_DISPATCHED) continue;
+        if (deferred) {
+            // ワーカーがこのフレームの描画中に更新し、次のフレームで描かれる
+            entry.state = PENDING_WORKER;
+            entry.sample.frame = frame + 1;
+        } else {
+            entry.state = PENDING_SIMULATED;
+            entry.sample.simulatedMicros = nowMicros;
+        }
+    }
+}
+
+void MidiLatencyTracker::onPublished(uint64_t nowMicros) {
+    for (int i = 0; i < pendingCount; i++) {
+        Pending& entry = pending[i];
+        if (entry.state != PENDING_WORKER) continue;
+        entry.state = PENDING_SIMULATED;
+        entry.sample.simulatedMicros = nowMicros;
+    }
+}
+
+void MidiLatencyTracker::complete(const Sample& sample) {
+    history[historyHead] = sample;
+    historyHead = (historyHead + 1) % HISTORY_CAPACITY;
+    if (historyCount < HISTORY_CAPACITY) historyCount++;
+}
+
+void MidiLatencyTracker::windowPercentiles(int stage, float& p50, float& p95, float& worst) const {
+    std::array<float, WINDOW> values;
+    std::size_t count = windowCount();
+    for (std::size_t i = 0; i < count; i++) {
+        values[i] = stageMillis(history[(historyHead + HISTORY_CAPACITY - 1 - i) % HISTORY_CAPACITY], stage);
+    }
+    if (count == 0) {
+        p50 = p95 = worst = 0.0f;
+        return;
+    }
+    std::sort(values.begin(), values.begin() + count);
+    p50 = values[count / 2];
+    p95 = values[std::min(count - 1, count * 95 / 100)];
+    worst = values[count - 1];
+}
+
+void MidiLatencyTracker::drawOverlay(float x, float y, float alpha) const {
+    const float width = 360.0f;
+    const float height = 150.0f;
+    std::size_t count = windowCount();
+
+    ofPushStyle();
+    ofEnableBlendMode(OF_BLENDMODE_ALPHA);
+    ofSetColor(0, 0, 0, 150 * (alpha / 255.0f));
+    ofDrawRectangle(x, y, width, height);
+
+    ofSetColor(255, alpha);
+    ofDrawBitmapString("MIDI-to-photon: " + ofToString(count) + " msgs (p50/p95/max ms)", x + 10, y + 20);
+
+    // 全体のヒストグラム（2ms刻み）
+    int bins[NUM_BINS] = {0};
+    int maxBin = 1;
+    for (std::size_t i = 0; i < count; i++) {
+        float total = stageMillis(history[(historyHead + HISTORY_CAPACITY - 1 - i) % HISTORY_CAPACITY], STAGE_TOTAL);
+        int bin = std::min(NUM_BINS - 1, (int)(total / 2.0f));
+        maxBin = std::max(maxBin, ++bins[bin]);
+    }
+    float histogramY = y + 68;
+    float binWidth = (width - 20.0f) / NUM_BINS;
+    for (int i = 0; i < NUM_BINS; i++) {
+        float binHeight = 36.0f * bins[i] / maxBin;
+        ofSetColor(i * 2.0f < 2000.0f / 60.0f ? ofColor(100, 255, 100) : ofColor(255, 150, 80), alpha);  // 60Hzの2フレーム以内は緑
+        ofDrawRectangle(x + 10 + i * binWidth, histogramY - binHeight, binWidth - 1, binHeight);
+    }
+    ofSetColor(150, alpha);
+    ofDrawBitmapString("0", x + 10, histogramY + 11);
+    ofDrawBitmapString("50+", x + width - 34, histogramY + 11);
+
+    // 段階ごとの分位点
+    float textY = histogramY + 28;
+    for (int stage = 0; stage < NUM_STAGES; stage++) {
+        float p50, p95, worst;
+        windowPercentiles(stage, p50, p95, worst);
+        ofSetColor(STAGE_COLORS[stage], alpha);
+        ofDrawRectangle(x + 10, textY - 8, 8, 8);
+        ofSetColor(255, alpha);
+        ofDrawBitmapString(string(STAGE_NAMES[stage]) + " " + ofToString(p50, 2) + "/" + ofToString(p95, 2) + "/" + ofToString(worst, 2), x + 22, textY);
+        textY += 13;
+    }
+
+    ofDisableBlendMode();
+    ofPopStyle();
+}
+
+bool MidiLatencyTracker::dumpCsv(const string& path) const {
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        cout << "Latency: failed to open " << path << endl;
+        return false;
+    }
+
+    fprintf(file, "frame,port,status,data1,arrival_us,queue_us,simulation_us,render_us,total_us\n");
+    std::size_t first = (historyHead + HISTORY_CAPACITY - historyCount) % HISTORY_CAPACITY;
+    for (std::size_t i = 0; i < historyCount; i++) {
+        const Sample& sample = history[(first + i) % HISTORY_CAPACITY];
+        fprintf(file, "%llu,%u,%u,%u,%llu,%llu,%llu,%llu,%llu\n", (unsigned long long)sample.frame, sample.port, sample.status, sample.data1,
+                (unsigned long long)sample.arrivalMicros,
+                (unsigned long long)(sample.dispatchMicros - sample.arrivalMicros),
+                (unsigned long long)(sample.simulatedMicros - sample.dispatchMicros),
+                (unsigned long long)(sample.presentedMicros - sample.simulatedMicros),
+                (unsigned long long)(sample.presentedMicros - sample.arrivalMicros));
+    }
+    fclose(file);
+    cout << "Latency: wrote " << historyCount << " messages to " << path << endl;
+    return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ofMain.h"
+#include "MidiEventQueue.h"
+#include <array>
+
+// MIDIが届いてから画面に出るまで（MIDI-to-photon）のレイテンシ計測
+// - 到着: リスナーのコールバック（MIDIスレッド）で押したスタンプ
+// - キュー: フレーム頭でシステムに渡すまで
+// - シミュレーション: そのメッセージを反映した状態ができるまで（直列更新ならupdate()の終わり、
+//   ワーカーで回すシステムなら次フレーム頭の結果の公開）
+// - 描画: その状態を描いたフレームのバッファの入れ替えまで（入れ替えの戻り = 次のupdate()の頭）
+// すべて描画スレッドから呼ぶ。記録は固定長のリングで、確保しない
+class MidiLatencyTracker {
+public:
+    struct Sample {
+        uint64_t arrivalMicros = 0;
+        uint64_t dispatchMicros = 0;
+        uint64_t simulatedMicros = 0;
+        uint64_t presentedMicros = 0;
+        uint64_t frame = 0;          // 初めて反映したフレーム
+        uint8_t port = 0;
+        uint8_t status = 0;
+        uint8_t data1 = 0;
+    };
+
+    static const int NUM_BINS = 26;                    // 2ms刻み、50ms以上は最後のビン
+    static const std::size_t HISTORY_CAPACITY = 4096;  // CSVに書き出す分
+    static const std::size_t WINDOW = 512;             // ヒストグラム・分位点は直近この数
+
+    // update()の最初に呼ぶ。前フレームのバッファ入れ替えが終わった時刻
+    void beginFrame(uint64_t nowMicros);
+    // フレーム頭でシステムに渡したメッセージ（ライブ入力のみ）
+    void addDispatch(const MidiEvent& event, uint64_t dispatchMicros);
+    // update()の終わりに呼ぶ。deferredなら、反映した状態はワーカーが次フレームまでに作る
+    void endUpdate(uint64_t nowMicros, bool deferred);
+    // ワーカーの結果を描画側に公開した時刻
+    void onPublished(uint64_t nowMicros);
+
+    void drawOverlay(float x, float y, float alpha) const;
+    bool dumpCsv(const string& path) const;
+
+    std::size_t getSampleCount() const { return historyCount; }
+    uint64_t getDroppedCount() const { return dropped; }
+
+private:
+    enum PendingState : uint8_t {
+        PENDING_DISPATCHED,   // このフレームのupdate()待ち
+        PENDING_WORKER,       // ワーカーの結果の公開待ち
+        PENDING_SIMULATED     // バッファの入れ替え待ち
+    };
+
+    struct Pending {
+        Sample sample;
+        PendingState state;
+    };
+
+    static const int PENDING_CAPACITY = 256;
+
+    void complete(const Sample& sample);
+    std::size_t windowCount() const { return historyCount < WINDOW ? historyCount : WINDOW; }
+    void windowPercentiles(int stage, float& p50, float& p95, float& worst) const;
+
+    std::array<Pending, PENDING_CAPACITY> pending;
+    int pendingCount = 0;
+    uint64_t frame = 0;
+    uint64_t dropped = 0;
+
+    std::array<Sample, HISTORY_CAPACITY> history;
+    std::size_t historyHead = 0;
+    std::size_t historyCount = 0;
+};
@@ -0,0 +1,229 @@
+#pragma once
+
+#include "MidiEventQueue.h"
+#include "MidiFileImporter.h"
+#include "SimViewport.h"
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// MIDIセッションログ（.mvlog）
+// ヘッダ: "MVLG" + version(uint16) + reserved(uint16)
+// レコード(9バイト): 前イベントからの経過マイクロ秒(uint32 LE) + port, status, channel, data1, data2
+static const char MIDI_SESSION_MAGIC[4] = {'M', 'V', 'L', 'G'};
+static const uint16_t MIDI_SESSION_VERSION = 1;
+static const std::size_t MIDI_SESSION_HEADER_SIZE = 8;
+static const std::size_t MIDI_SESSION_RECORD_SIZE = 9;
+
+// 受信したMIDIイベントを到着時刻付きでバイナリログに書き出す（メインスレッド）
+class MidiSessionRecorder {
+public:
+    bool start(const std::string& filePath) {
+        stop();
+        
+        file.open(filePath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            cout << "MIDI recorder: failed to open " << filePath << endl;
+            return false;
+        }
+        
+        uint8_t header[MIDI_SESSION_HEADER_SIZE] = {
+            (uint8_t)MIDI_SESSION_MAGIC[0], (uint8_t)MIDI_SESSION_MAGIC[1],
+            (uint8_t)MIDI_SESSION_MAGIC[2], (uint8_t)MIDI_SESSION_MAGIC[3],
+            (uint8_t)(MIDI_SESSION_VERSION & 0xFF), (uint8_t)(MIDI_SESSION_VERSION >> 8), 0, 0
+        };
+        file.write((const char*)header, sizeof(header));
+        
+        path = filePath;
+        startMicros = midiNowMicros();
+        lastMicros = startMicros;
+        eventCount = 0;
+        return true;
+    }
+    
+    // イベントのタイムスタンプ（midiNowMicros基準）をそのまま使う
+    void record(const MidiEvent& event) {
+        if (!file.is_open()) return;
+        
+        uint64_t timestamp = std::max(event.timestampMicros, lastMicros);
+        // 71分以上の無音は切り詰める
+        uint32_t delta = (uint32_t)std::min<uint64_t>(timestamp - lastMicros, UINT32_MAX);
+        lastMicros = timestamp;
+        
+        uint8_t bytes[MIDI_SESSION_RECORD_SIZE] = {
+            (uint8_t)(delta & 0xFF), (uint8_t)((delta >> 8) & 0xFF),
+            (uint8_t)((delta >> 16) & 0xFF), (uint8_t)((delta >> 24) & 0xFF),
+            event.port, event.status, event.channel, event.data1, event.data2
+        };
+        file.write((const char*)bytes, sizeof(bytes));
+        eventCount++;
+    }
+    
+    void stop() {
+        if (file.is_open()) {
+            file.close();
+            cout << "MIDI recorder: " << eventCount << " events, "
+                 << (lastMicros - startMicros) / 1000000.0f << "s -> " << path << endl;
+        }
+    }
+    
+    bool isRecording() const { return file.is_open(); }
+    std::size_t getEventCount() const { return eventCount; }
+    const std::string& getPath() const { return path; }
+    
+private:
+    std::ofstream file;
+    std::string path;
+    uint64_t startMicros = 0;
+    uint64_t lastMicros = 0;
+    std::size_t eventCount = 0;
+};
+
+// 再生モード
+enum MidiPlaybackMode {
+    PLAYBACK_REALTIME,      // 実時間で再生
+    PLAYBACK_FIXED_STEP     // 1フレーム=固定dtで可能な限り高速に再生
+};
+
+// 時刻順のイベント列を入力経路に流し込むプレイヤー
+// イベントのタイムスタンプはセッション先頭からの相対マイクロ秒
+class MidiSessionPlayer {
+public:
+    // 拡張子で判別してセッションログ（.mvlog）かStandard MIDI File（.mid）を読み込む
+    bool load(const std::string& filePath) {
+        string ext = ofToLower(ofFilePath::getFileExt(filePath));
+        if (ext == "mid" || ext == "midi" || ext == "smf") {
+            std::vector<MidiEvent> imported;
+            uint64_t songEndMicros = 0;
+            if (!MidiFileImporter::load(filePath, imported, MIDI_PORT_DRUMS, &songEndMicros)) {
+                return false;
+            }
+            // テンポマップ上の時刻を保つため先頭の無音は詰めない
+            setEvents(std::move(imported), false, songEndMicros);
+            return true;
+        }
+        return loadSessionLog(filePath);
+    }
+    
+    bool loadSessionLog(const std::string& filePath) {
+        std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            cout << "MIDI player: failed to open " << filePath << endl;
+            return false;
+        }
+        
+        std::size_t fileSize = file.tellg();
+        file.seekg(0);
+        
+        uint8_t header[MIDI_SESSION_HEADER_SIZE];
+        if (fileSize < sizeof(header) || !file.read((char*)header, sizeof(header)) ||
+            !std::equal(header, header + 4, (const uint8_t*)MIDI_SESSION_MAGIC)) {
+            cout << "MIDI player: not a session log: " << filePath << endl;
+            return false;
+        }
+        uint16_t version = header[4] | (header[5] << 8);
+        if (version != MIDI_SESSION_VERSION) {
+            cout << "MIDI player: unsupported log version " << version << endl;
+            return false;
+        }
+        
+        std::vector<MidiEvent> loaded;
+        loaded.reserve((fileSize - sizeof(header)) / MIDI_SESSION_RECORD_SIZE);
+        
+        uint64_t timestamp = 0;
+        uint8_t record[MIDI_SESSION_RECORD_SIZE];
+        while (file.read((char*)record, sizeof(record))) {
+            uint32_t delta = record[0] | (record[1] << 8) | (record[2] << 16) | ((uint32_t)record[3] << 24);
+            timestamp += delta;
+            
+            MidiEvent event;
+            event.timestampMicros = timestamp;
+            event.port = record[4];
+            event.status = record[5];
+            event.channel = record[6];
+            event.data1 = record[7];
+            event.data2 = record[8];
+            loaded.push_back(event);
+        }
+        
+        setEvents(std::move(loaded));
+        cout << "MIDI player: loaded " << events.size() << " events, "
+             << getDurationMicros() / 1000000.0f << "s from " << filePath << endl;
+        return true;
+    }
+    
+    // 時刻順に並んだイベント列を設定（既定では先頭イベントを0に揃える）
+    // songEndMicrosは曲の終わり（SMFのEnd of Track）、最後のイベントより前なら最後のイベントまで
+    void setEvents(std::vector<MidiEvent>&& sortedEvents, bool trimLeadingSilence = true, uint64_t songEndMicros = 0) {
+        stop();
+        events = std::move(sortedEvents);
+        if (trimLeadingSilence && !events.empty()) {
+            uint64_t origin = events.front().timestampMicros;
+            for (auto& event : events) {
+                event.timestampMicros -= origin;
+            }
+        }
+        endMicros = std::max(songEndMicros, events.empty() ? 0 : events.back().timestampMicros);
+        cursor = 0;
+        positionMicros = 0;
+    }
+    
+    void start(MidiPlaybackMode playbackMode, float deltaTime = 1.0f / 60.0f) {
+        mode = playbackMode;
+        fixedDeltaTime = deltaTime;
+        playing = !events.empty();
+        seek(0);
+    }
+    
+    void stop() {
+        playing = false;
+    }
+    
+    // 再生位置の移動（二分探索）
+    void seek(uint64_t micros) {
+        positionMicros = micros;
+        cursor = std::lower_bound(events.begin(), events.end(), micros,
+                                  [](const MidiEvent& e, uint64_t t) { return e.timestampMicros < t; }) - events.begin();
+        wallStartMicros = midiNowMicros() - micros;
+    }
+    
+    // 1フレーム分進め、その間に発生したイベントを out に追加
+    void poll(std::vector<MidiEvent>& out) {
+        if (!playing) return;
+        
+        if (mode == PLAYBACK_FIXED_STEP) {
+            // 仮想時計（SimViewport::advance）と同じ整数の刻みで進め、イベントとフレームの時刻をずらさない
+            positionMicros += SimViewport::toStepMicros(fixedDeltaTime);
+        } else {
+            positionMicros = midiNowMicros() - wallStartMicros;
+        }
+        
+        while (cursor < events.size() && events[cursor].timestampMicros <= positionMicros) {
+            out.push_back(events[cursor++]);
+        }
+    }
+    
+    bool isPlaying() const { return playing; }
+    // 最後のイベントを流した後も、曲の終わり＋余韻（減衰・トレイル・クロスフェード）まで再生を続ける
+    bool isFinished() const { return playing && cursor >= events.size() && positionMicros >= endMicros + tailMicros; }
+    void setTail(float seconds) { tailMicros = (uint64_t)std::llround(std::max(0.0f, seconds) * 1000000.0); }
+    bool isFixedStep() const { return mode == PLAYBACK_FIXED_STEP; }
+    bool hasEvents() const { return !events.empty(); }
+    float getFixedDeltaTime() const { return fixedDeltaTime; }
+    uint64_t getPositionMicros() const { return positionMicros; }
+    uint64_t getDurationMicros() const { return endMicros; }
+    std::size_t getEventCount() const { return events.size(); }
+    float getProgress() const { return events.empty() ? 0.0f : (float)cursor / events.size(); }
+    
+private:
+    std::vector<MidiEvent> events;
+    std::size_t cursor = 0;
+    uint64_t positionMicros = 0;
+    uint64_t wallStartMicros = 0;
+    uint64_t endMicros = 0;          // 曲の終わり
+    uint64_t tailMicros = 0;         // 曲の終わりから再生を続ける長さ
+    MidiPlaybackMode mode = PLAYBACK_REALTIME;
+    float fixedDeltaTime = 1.0f / 60.0f;
+    bool playing = false;
+};
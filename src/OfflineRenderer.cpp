@@ -0,0 +1,263 @@
+#include "OfflineRenderer.h"
+#include "MidiEventQueue.h"
+#include <algorithm>
+#include <cstring>
+
+OfflineRenderer::~OfflineRenderer() {
+    stop();
+}
+
+bool OfflineRenderer::start(const string& path, int w, int h, float frameDeltaTime) {
+    stop();
+    
+    outputPath = path;
+    width = w;
+    height = h;
+    frameBytes = (std::size_t)width * height * 4;
+    format = ofToLower(ofFilePath::getFileExt(path)) == "y4m" ? RENDER_FORMAT_Y4M : RENDER_FORMAT_PNG;
+    
+    if (format == RENDER_FORMAT_Y4M) {
+        y4mFile = fopen(path.c_str(), "wb");
+        if (!y4mFile) {
+            cout << "Offline render: failed to open " << path << endl;
+            return false;
+        }
+        
+        // フレームレートはdtから（整数fpsでなければマイクロ秒の分数で表す）
+        int fps = (int)roundf(1.0f / frameDeltaTime);
+        string rate = fabsf(fps * frameDeltaTime - 1.0f) < 1e-4f
+            ? ofToString(fps) + ":1"
+            : "1000000:" + ofToString((int)roundf(frameDeltaTime * 1000000.0f));
+        string header = "YUV4MPEG2 W" + ofToString(width) + " H" + ofToString(height) + " F" + rate + " Ip A1:1 C420jpeg\n";
+        fwrite(header.data(), 1, header.size(), y4mFile);
+    } else {
+        ofDirectory::createDirectory(path, false, true);
+    }
+    
+    for (int i = 0; i < NUM_PBOS; i++) {
+        pbos[i].allocate(frameBytes, GL_STREAM_READ);
+        pboPending[i] = false;
+        pboFrameIndex[i] = 0;
+    }
+    
+    capturedFrames = 0;
+    writtenFrames = 0;
+    stallCount = 0;
+    stopping = false;
+    
+    // Y4Mは順序を保つため1本、PNGはエンコードが重いのでコア数に応じて並列化
+    int numWorkers = 1;
+    if (format == RENDER_FORMAT_PNG) {
+        numWorkers = ofClamp((int)std::thread::hardware_concurrency() - 1, 1, 4);
+    }
+    for (int i = 0; i < numWorkers; i++) {
+        workers.emplace_back(&OfflineRenderer::writerLoop, this);
+    }
+    
+    active = true;
+    startMicros = midiNowMicros();
+    cout << "Offline render: " << width << "x" << height << " -> " << path
+         << (format == RENDER_FORMAT_Y4M ? " (y4m)" : " (png, " + ofToString(numWorkers) + " workers)") << endl;
+    return true;
+}
+
+bool OfflineRenderer::capture(const ofFbo& fbo) {
+    if (!active) return false;
+    
+    // PBOとフレームは開始時のサイズで確保しているので、ウィンドウのリサイズなどでずれたら読まない
+    if ((int)fbo.getWidth() != width || (int)fbo.getHeight() != height) {
+        cout << "Offline render: frame size changed to " << fbo.getWidth() << "x" << fbo.getHeight()
+             << " (started at " << width << "x" << height << "), stopping" << endl;
+        return false;
+    }
+    
+    // 同じスロットのリードバックはNUM_PBOSフレーム前に発行済み（GPU側は完了している想定）
+    int slot = capturedFrames % NUM_PBOS;
+    if (pboPending[slot]) {
+        collect(slot);
+    }
+    
+    // OFはFBOへ上下反転して描画するため、読み出した行はそのまま上から順になる
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo.getId());
+    pbos[slot].bind(GL_PIXEL_PACK_BUFFER);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    pbos[slot].unbind(GL_PIXEL_PACK_BUFFER);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    
+    pboPending[slot] = true;
+    pboFrameIndex[slot] = capturedFrames++;
+    return true;
+}
+
+void OfflineRenderer::stop() {
+    if (!active) return;
+    
+    // 残っているリードバックを古い順に回収
+    for (uint64_t i = 0; i < NUM_PBOS; i++) {
+        int slot = (capturedFrames + i) % NUM_PBOS;
+        if (pboPending[slot]) {
+            collect(slot);
+        }
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    queueCondition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    
+    if (y4mFile) {
+        fclose(y4mFile);
+        y4mFile = nullptr;
+    }
+    
+    float wallSeconds = (midiNowMicros() - startMicros) / 1000000.0f;
+    cout << "Offline render: " << writtenFrames << " frames in " << ofToString(wallSeconds, 2) << "s ("
+         << ofToString(writtenFrames / std::max(wallSeconds, 0.001f), 1) << " fps), "
+         << stallCount << " stalls, " << allocatedFrames << " pooled frames -> " << outputPath << endl;
+    
+    // プールは次回の開始時に作り直す（解像度が変わり得るため）
+    freeFrames.clear();
+    queuedFrames.clear();
+    frames.clear();
+    allocatedFrames = 0;
+    active = false;
+}
+
+void OfflineRenderer::collect(int slot) {
+    Frame* frame = acquireFrame();
+    
+    const uint8_t* pixels = pbos[slot].map<uint8_t>(GL_READ_ONLY);
+    if (pixels) {
+        memcpy(frame->rgba.data(), pixels, frameBytes);
+    }
+    pbos[slot].unmap();
+    pboPending[slot] = false;
+    frame->index = pboFrameIndex[slot];
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queuedFrames.push_back(frame);
+    }
+    queueCondition.notify_one();
+}
+
+OfflineRenderer::Frame* OfflineRenderer::acquireFrame() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (freeFrames.empty() && allocatedFrames < MAX_POOLED_FRAMES) {
+        allocatedFrames++;
+        lock.unlock();
+        
+        auto frame = std::make_unique<Frame>();
+        frame->rgba.resize(frameBytes);
+        Frame* result = frame.get();
+        
+        lock.lock();
+        frames.push_back(std::move(frame));
+        return result;
+    }
+    
+    // プールが尽きた = 書き出しが追いついていない（ここだけは描画側が待つ）
+    if (freeFrames.empty()) {
+        stallCount++;
+        freeCondition.wait(lock, [this] { return !freeFrames.empty(); });
+    }
+    Frame* frame = freeFrames.back();
+    freeFrames.pop_back();
+    return frame;
+}
+
+void OfflineRenderer::writerLoop() {
+    // ワーカーごとの作業バッファ（ループ中は再確保しない）
+    std::vector<uint8_t> yuv;
+    ofPixels pixels;
+    
+    while (true) {
+        Frame* frame = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            queueCondition.wait(lock, [this] { return stopping || !queuedFrames.empty(); });
+            if (queuedFrames.empty()) return;
+            frame = queuedFrames.front();
+            queuedFrames.pop_front();
+        }
+        
+        if (format == RENDER_FORMAT_Y4M) {
+            writeY4mFrame(*frame, yuv);
+        } else {
+            writePngFrame(*frame, pixels);
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            freeFrames.push_back(frame);
+            writtenFrames++;
+        }
+        freeCondition.notify_one();
+    }
+}
+
+void OfflineRenderer::writeY4mFrame(const Frame& frame, std::vector<uint8_t>& yuv) {
+    int chromaWidth = (width + 1) / 2;
+    int chromaHeight = (height + 1) / 2;
+    std::size_t lumaSize = (std::size_t)width * height;
+    std::size_t chromaSize = (std::size_t)chromaWidth * chromaHeight;
+    yuv.resize(lumaSize + chromaSize * 2);
+    
+    uint8_t* planeY = yuv.data();
+    uint8_t* planeU = planeY + lumaSize;
+    uint8_t* planeV = planeU + chromaSize;
+    const uint8_t* rgba = frame.rgba.data();
+    
+    // BT.709 リミテッドレンジ（係数は256倍の整数）
+    for (std::size_t i = 0; i < lumaSize; i++) {
+        int r = rgba[i * 4], g = rgba[i * 4 + 1], b = rgba[i * 4 + 2];
+        planeY[i] = (uint8_t)(((47 * r + 157 * g + 16 * b + 128) >> 8) + 16);
+    }
+    
+    // 色差は2x2ブロックの平均から
+    for (int cy = 0; cy < chromaHeight; cy++) {
+        int y0 = cy * 2;
+        int y1 = std::min(y0 + 1, height - 1);
+        for (int cx = 0; cx < chromaWidth; cx++) {
+            int x0 = cx * 2;
+            int x1 = std::min(x0 + 1, width - 1);
+            const uint8_t* p00 = rgba + ((std::size_t)y0 * width + x0) * 4;
+            const uint8_t* p01 = rgba + ((std::size_t)y0 * width + x1) * 4;
+            const uint8_t* p10 = rgba + ((std::size_t)y1 * width + x0) * 4;
+            const uint8_t* p11 = rgba + ((std::size_t)y1 * width + x1) * 4;
+            int r = (p00[0] + p01[0] + p10[0] + p11[0] + 2) >> 2;
+            int g = (p00[1] + p01[1] + p10[1] + p11[1] + 2) >> 2;
+            int b = (p00[2] + p01[2] + p10[2] + p11[2] + 2) >> 2;
+            
+            std::size_t c = (std::size_t)cy * chromaWidth + cx;
+            planeU[c] = (uint8_t)(((-26 * r - 87 * g + 112 * b + 128) >> 8) + 128);
+            planeV[c] = (uint8_t)(((112 * r - 102 * g - 10 * b + 128) >> 8) + 128);
+        }
+    }
+    
+    fwrite("FRAME\n", 1, 6, y4mFile);
+    fwrite(yuv.data(), 1, yuv.size(), y4mFile);
+}
+
+void OfflineRenderer::writePngFrame(const Frame& frame, ofPixels& pixels) {
+    if (pixels.getWidth() != width || pixels.getHeight() != height) {
+        pixels.allocate(width, height, OF_PIXELS_RGB);
+    }
+    
+    // アルファは常に不透明なのでRGBに詰めて書く
+    const uint8_t* src = frame.rgba.data();
+    uint8_t* dst = pixels.getData();
+    std::size_t numPixels = (std::size_t)width * height;
+    for (std::size_t i = 0; i < numPixels; i++) {
+        dst[i * 3] = src[i * 4];
+        dst[i * 3 + 1] = src[i * 4 + 1];
+        dst[i * 3 + 2] = src[i * 4 + 2];
+    }
+    
+    ofSaveImage(pixels, ofFilePath::join(outputPath, "frame_" + ofToString(frame.index, 6, '0') + ".png"));
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "ofMain.h"
+#include <array>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 書き出し形式
+enum OfflineRenderFormat {
+    RENDER_FORMAT_Y4M,   // 1ファイルのYUV4MPEG2（4:2:0、BT.709リミテッド）
+    RENDER_FORMAT_PNG    // 連番PNG（frame_000000.png ...）
+};
+
+// 合成済みフレームを連番で書き出すオフラインレンダラー
+// 描画スレッド: FBO → PBOリングへ非同期リードバック（数フレーム遅れてマップ）
+// ワーカースレッド: 色変換・エンコード・ディスク書き込み
+// フレームバッファはプールから使い回し、プールが尽きた時だけ描画側が待つ
+class OfflineRenderer {
+public:
+    ~OfflineRenderer();
+    
+    // 出力先が .y4m ならY4M、それ以外はPNG連番のディレクトリとして扱う
+    bool start(const string& outputPath, int width, int height, float frameDeltaTime);
+    
+    // 毎フレーム、合成済みのFBOを渡す（描画スレッド）。開始時とサイズが違えば書き出さずにfalse
+    bool capture(const ofFbo& fbo);
+    
+    // 未回収のリードバックを回収し、書き出し完了まで待つ
+    void stop();
+    
+    bool isActive() const { return active; }
+    uint64_t getCapturedFrames() const { return capturedFrames; }
+
+private:
+    static const int NUM_PBOS = 3;                  // リードバックの遅延フレーム数
+    static const std::size_t MAX_POOLED_FRAMES = 16;
+    
+    struct Frame {
+        std::vector<uint8_t> rgba;
+        uint64_t index = 0;
+    };
+    
+    void collect(int slot);
+    Frame* acquireFrame();
+    void writerLoop();
+    void writeY4mFrame(const Frame& frame, std::vector<uint8_t>& yuv);
+    void writePngFrame(const Frame& frame, ofPixels& pixels);
+    
+    bool active = false;
+    OfflineRenderFormat format = RENDER_FORMAT_Y4M;
+    string outputPath;
+    int width = 0;
+    int height = 0;
+    std::size_t frameBytes = 0;
+    uint64_t capturedFrames = 0;
+    uint64_t startMicros = 0;
+    
+    // PBOリング（描画スレッドのみ）
+    std::array<ofBufferObject, NUM_PBOS> pbos;
+    std::array<bool, NUM_PBOS> pboPending{};
+    std::array<uint64_t, NUM_PBOS> pboFrameIndex{};
+    
+    // フレームプールと書き出しキュー（mutexで保護）
+    std::vector<std::unique_ptr<Frame>> frames;
+    std::deque<Frame*> freeFrames;
+    std::deque<Frame*> queuedFrames;
+    std::size_t allocatedFrames = 0;
+    uint64_t writtenFrames = 0;
+    uint64_t stallCount = 0;
+    bool stopping = false;
+    std::mutex mutex;
+    std::condition_variable queueCondition;
+    std::condition_variable freeCondition;
+    std::vector<std::thread> workers;
+    
+    FILE* y4mFile = nullptr;  // Y4Mはワーカー1本で順番に書く
+};
@@ -6,6 +6,7 @@
 class Particle {
 public:
     ofVec2f position;
+    ofVec2f previousPosition;   // 直前のステップ開始時の位置（描画の補間用）
     ofVec2f velocity;
     ofVec2f acceleration;
     float life;
@@ -15,15 +16,16 @@ public:
     float mass;
     bool isUrbanElement; // 都市要素かどうか
     
-    Particle(ofVec2f pos, ofVec2f vel, float lifespan, ofColor col, bool urban = false) {
+    Particle(VisualRandom& rng, ofVec2f pos, ofVec2f vel, float lifespan, ofColor col, bool urban = false) {
         position = pos;
+        previousPosition = pos;
         velocity = vel;
         acceleration = ofVec2f(0, 0);
         life = lifespan;
         maxLife = lifespan;
         color = col;
-        size = ofRandom(0.5, 4);
-        mass = ofRandom(0.5f, 2.0f);
+        size = rng.random(0.5, 4);
+        mass = rng.random(0.5f, 2.0f);
         isUrbanElement = urban;
     }
     
@@ -32,6 +34,7 @@ public:
     }
     
     void update(float deltaTime, float globalGrowth) {
+        previousPosition = position;
         velocity += acceleration * deltaTime;
         
         // 空気抵抗
@@ -54,7 +57,9 @@ public:
         return life <= 0;
     }
     
-    void draw(float globalGrowth, float impactIntensity) {
+    // interpolationは直前のステップからの補間の割合（スプライトはspritesに積むだけで、描くのは呼び出し側）
+    void draw(SpriteBatch& sprites, float globalGrowth, float impactIntensity, float interpolation) {
+        ofVec2f drawPosition = previousPosition + (position - previousPosition) * interpolation;
         float alpha = ofMap(life, 0, maxLife, 0, 255);
         alpha *= (0.7f + globalGrowth * 0.3f); // 成長で明るく
         
@@ -66,36 +71,31 @@ public:
             drawColor.setBrightness(drawColor.getBrightness() * (1.0f + impactIntensity * 0.5f));
         }
         
-        ofSetColor(drawColor, alpha);
-        
         float drawSize = size * (life / maxLife);
         
         // 成長レベルに応じたエフェクト
         if (globalGrowth > 0.5f) {
             // 高成長時はグローエフェクト
-            ofSetColor(drawColor, alpha * 0.3f);
-            ofDrawCircle(position, drawSize * 1.3);
-            ofSetColor(drawColor, alpha);
+            sprites.addCircle(drawPosition, drawSize * 1.3f, drawColor, alpha * 0.3f);
         }
         
         if (isUrbanElement) {
             // 都市要素は矩形で描画
-            ofDrawRectangle(position.x - drawSize/2, position.y - drawSize/2, drawSize, drawSize);
+            sprites.addRect(drawPosition, drawSize, drawSize, drawColor, alpha);
             
             // 建物の窓のような効果
             if (drawSize > 4) {
-                ofSetColor(255, alpha * 0.8f);
                 float windowSize = drawSize * 0.15f;
                 for (int i = 0; i < 3; i++) {
                     for (int j = 0; j < 3; j++) {
-                        float x = position.x - drawSize/2 + (i + 0.5f) * drawSize/3;
-                        float y = position.y - drawSize/2 + (j + 0.5f) * drawSize/3;
-                        ofDrawRectangle(x - windowSize/2, y - windowSize/2, windowSize, windowSize);
+                        float x = drawPosition.x - drawSize/2 + (i + 0.5f) * drawSize/3;
+                        float y = drawPosition.y - drawSize/2 + (j + 0.5f) * drawSize/3;
+                        sprites.addRect(ofVec2f(x, y), windowSize, windowSize, ofColor(255), alpha * 0.8f);
                     }
                 }
             }
         } else {
-            ofDrawCircle(position, drawSize);
+            sprites.addCircle(drawPosition, drawSize, drawColor, alpha);
         }
     }
 };
@@ -122,14 +122,17 @@ private:
     bool massExplosionActive = false;
     
 public:
+    // 要素はすべて値で持つことを確かめた（PipelinedSystemで状態を丸ごとコピーしてよい）
+    static constexpr bool SNAPSHOT_COPYABLE = true;
+    
     void setup() override {
         gravity = ofVec2f(0, 80);
         wind = ofVec2f(0, 0);
         
         // 初期アトラクターを画面全体に配置（間隔を拡大）
-        attractors.push_back(ofVec2f(ofGetWidth() * 0.15f, ofGetHeight() * 0.25f));
-        attractors.push_back(ofVec2f(ofGetWidth() * 0.85f, ofGetHeight() * 0.25f));
-        attractors.push_back(ofVec2f(ofGetWidth() * 0.5f, ofGetHeight() * 0.75f));
+        attractors.push_back(ofVec2f(SimViewport::getWidth() * 0.15f, SimViewport::getHeight() * 0.25f));
+        attractors.push_back(ofVec2f(SimViewport::getWidth() * 0.85f, SimViewport::getHeight() * 0.25f));
+        attractors.push_back(ofVec2f(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.75f));
         
         for (int i = 0; i < attractors.size(); i++) {
             attractorStrengths.push_back(baseAttractorStrength);
@@ -138,8 +141,8 @@ public:
         // 都市スポーン地点（密度を削減）
         for (int i = 0; i < 4; i++) {
             urbanSpawnPoints.push_back(ofVec2f(
-                ofRandom(50, ofGetWidth() - 50),
-                ofRandom(50, ofGetHeight() - 50)
+                rng.random(50, SimViewport::getWidth() - 50),
+                rng.random(50, SimViewport::getHeight() - 50)
             ));
         }
     }
@@ -192,13 +195,13 @@ public:
             }
             
             // 境界反発（画面全体を活用）
-            if (it->position.x < 0 || it->position.x > ofGetWidth()) {
+            if (it->position.x < 0 || it->position.x > SimViewport::getWidth()) {
                 it->velocity.x *= -0.8f;
-                it->position.x = ofClamp(it->position.x, 0, ofGetWidth());
+                it->position.x = ofClamp(it->position.x, 0, SimViewport::getWidth());
             }
-            if (it->position.y < 0 || it->position.y > ofGetHeight()) {
+            if (it->position.y < 0 || it->position.y > SimViewport::getHeight()) {
                 it->velocity.y *= -0.8f;
-                it->position.y = ofClamp(it->position.y, 0, ofGetHeight());
+                it->position.y = ofClamp(it->position.y, 0, SimViewport::getHeight());
             }
             
             it->update(deltaTime, globalGrowthLevel);
@@ -210,8 +213,8 @@ public:
             }
         }
         
-        // パーティクル数制限（成長に応じて増加、大幅削減）
-        int maxParticles = 250 + globalGrowthLevel * 350;
+        // パーティクル数制限（成長に応じて増加、詳細度でスケール）
+        std::size_t maxParticles = detailCap(250 + globalGrowthLevel * 350);
         while (particles.size() > maxParticles) {
             particles.pop_back();
         }
@@ -234,6 +237,9 @@ public:
         // 都市構造の描画
         drawUrbanStructures();
         
+        // アトラクターと都市構造はどちらも加算なので、まとめて再生する
+        commands.flush();
+        
         endMasterBuffer();
         
         // 全画面エフェクトの描画
@@ -254,7 +260,7 @@ public:
             switch(msg.pitch) {
                 case KICK:
                     // 中央から大爆発
-                    triggerExplosion(ofVec2f(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f), 
+                    triggerExplosion(ofVec2f(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f), 
                                    impactIntensity * 200, true);
                     // アトラクター強化
                     for (auto& strength : attractorStrengths) {
@@ -265,15 +271,15 @@ public:
                 case SNARE:
                     // 画面四隅から爆発
                     triggerExplosion(ofVec2f(0, 0), impactIntensity * 100, false);
-                    triggerExplosion(ofVec2f(ofGetWidth(), 0), impactIntensity * 100, false);
-                    triggerExplosion(ofVec2f(0, ofGetHeight()), impactIntensity * 100, false);
-                    triggerExplosion(ofVec2f(ofGetWidth(), ofGetHeight()), impactIntensity * 100, false);
+                    triggerExplosion(ofVec2f(SimViewport::getWidth(), 0), impactIntensity * 100, false);
+                    triggerExplosion(ofVec2f(0, SimViewport::getHeight()), impactIntensity * 100, false);
+                    triggerExplosion(ofVec2f(SimViewport::getWidth(), SimViewport::getHeight()), impactIntensity * 100, false);
                     break;
                     
                 case HIHAT_CLOSED:
                     // 細かいスパーク
                     for (int i = 0; i < 3; i++) {
-                        ofVec2f pos(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
+                        ofVec2f pos(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
                         triggerExplosion(pos, impactIntensity * 30, false);
                     }
                     break;
@@ -291,8 +297,8 @@ public:
                 default:
                     // 音程に基づく位置での爆発
                     ofVec2f pos(
-                        ofMap(msg.pitch % 12, 0, 12, 0, ofGetWidth()),
-                        ofMap(msg.pitch / 12, 0, 10, 0, ofGetHeight())
+                        ofMap(msg.pitch % 12, 0, 12, 0, SimViewport::getWidth()),
+                        ofMap(msg.pitch / 12, 0, 10, 0, SimViewport::getHeight())
                     );
                     triggerExplosion(pos, impactIntensity * 80, false);
             }
@@ -302,10 +308,10 @@ public:
                 modulation = mapCC(msg.value);
                 // モジュレーションでアトラクター移動
                 for (int i = 0; i < attractors.size(); i++) {
-                    attractors[i].x += ofRandom(-modulation * 50, modulation * 50);
-                    attractors[i].y += ofRandom(-modulation * 50, modulation * 50);
-                    attractors[i].x = ofClamp(attractors[i].x, 0, ofGetWidth());
-                    attractors[i].y = ofClamp(attractors[i].y, 0, ofGetHeight());
+                    attractors[i].x += rng.random(-modulation * 50, modulation * 50);
+                    attractors[i].y += rng.random(-modulation * 50, modulation * 50);
+                    attractors[i].x = ofClamp(attractors[i].x, 0, SimViewport::getWidth());
+                    attractors[i].y = ofClamp(attractors[i].y, 0, SimViewport::getHeight());
                 }
             }
         }
@@ -320,26 +326,26 @@ private:
             ofColor color;
             bool isUrban = false;
             
-            if (ofRandom(1.0f) < urbanParticleChance + globalGrowthLevel * 0.3f) {
+            if (rng.random(1.0f) < urbanParticleChance + globalGrowthLevel * 0.3f) {
                 // 都市パーティクル
-                spawnPos = urbanSpawnPoints[ofRandom(urbanSpawnPoints.size())];
-                spawnPos += ofVec2f(ofRandom(-30, 30), ofRandom(-30, 30));
+                spawnPos = urbanSpawnPoints[rng.random(urbanSpawnPoints.size())];
+                spawnPos += ofVec2f(rng.random(-30, 30), rng.random(-30, 30));
                 color = urbanColor(currentNote, 0.8f + globalGrowthLevel * 0.2f);
                 isUrban = true;
             } else {
                 // 通常パーティクル
-                spawnPos = ofVec2f(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
+                spawnPos = ofVec2f(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
                 color = accentColor(impactIntensity + globalGrowthLevel * 0.5f);
             }
             
             ofVec2f velocity(
-                ofRandom(-50, 50) * (1.0f + impactIntensity),
-                ofRandom(-80, 20) * (1.0f + impactIntensity)
+                rng.random(-50, 50) * (1.0f + impactIntensity),
+                rng.random(-80, 20) * (1.0f + impactIntensity)
             );
             
-            float lifespan = ofRandom(2, 8) * (1.0f + globalGrowthLevel);
+            float lifespan = rng.random(2, 8) * (1.0f + globalGrowthLevel);
             
-            particles.push_back(Particle(spawnPos, velocity, lifespan, color, isUrban));
+            particles.push_back(Particle(rng, spawnPos, velocity, lifespan, color, isUrban));
         }
     }
     
@@ -348,17 +354,17 @@ private:
         int explosionCount = 5 + impactIntensity * 10;
         
         for (int i = 0; i < explosionCount; i++) {
-            ofVec2f center(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f);
-            center += ofVec2f(ofRandom(-100, 100), ofRandom(-100, 100));
+            ofVec2f center(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f);
+            center += ofVec2f(rng.random(-100, 100), rng.random(-100, 100));
             
-            float angle = ofRandom(TWO_PI);
-            float speed = ofRandom(100, 400);
+            float angle = rng.random(TWO_PI);
+            float speed = rng.random(100, 400);
             ofVec2f velocity(cos(angle) * speed, sin(angle) * speed);
             
             ofColor explosionColor = accentColor(1.0f);
             explosionColor.setBrightness(255);
             
-            particles.push_back(Particle(center, velocity, ofRandom(1, 4), explosionColor, false));
+            particles.push_back(Particle(rng, center, velocity, rng.random(1, 4), explosionColor, false));
         }
     }
     
@@ -366,15 +372,15 @@ private:
         int numParticles = force / 8 + 4;
         
         for (int i = 0; i < numParticles; i++) {
-            float angle = ofRandom(TWO_PI);
-            float speed = ofRandom(force * 0.5f, force);
+            float angle = rng.random(TWO_PI);
+            float speed = rng.random(force * 0.5f, force);
             ofVec2f velocity(cos(angle) * speed, sin(angle) * speed);
             
             ofColor explosionColor = isUrban ? 
                 urbanColor(currentNote, 1.0f) : 
                 accentColor(impactIntensity);
             
-            particles.push_back(Particle(center, velocity, ofRandom(1, 5), explosionColor, isUrban));
+            particles.push_back(Particle(rng, center, velocity, rng.random(1, 5), explosionColor, isUrban));
         }
     }
     
@@ -385,7 +391,7 @@ private:
             float angle = systemTime * 0.3f + i * TWO_PI / attractors.size();
             float radius = 100 + globalGrowthLevel * 150;
             
-            ofVec2f center(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f);
+            ofVec2f center(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f);
             attractors[i] = center + ofVec2f(cos(angle) * radius, sin(angle) * radius);
             
             // 強度の減衰
@@ -400,76 +406,73 @@ private:
         ofEnableBlendMode(OF_BLENDMODE_ADD);
         
         for (auto& particle : particles) {
-            particle.draw(globalGrowthLevel, impactIntensity);
+            particle.draw(sprites, globalGrowthLevel, impactIntensity, renderAlpha);
         }
+        sprites.draw();
         
         ofDisableBlendMode();
     }
     
     void drawAttractors() {
-        ofEnableBlendMode(OF_BLENDMODE_ADD);
+        commands.setBlendMode(OF_BLENDMODE_ADD);
         
         for (int i = 0; i < attractors.size(); i++) {
             float strength = attractorStrengths[i] / baseAttractorStrength;
             
             ofColor attractorColor = accentColor(strength);
             attractorColor.a = 100 + strength * 50;
-            ofSetColor(attractorColor);
+            commands.setColor(attractorColor);
             
             float size = 4 + strength * 6 + globalGrowthLevel * 8;
             
             // 脈動効果
             size += sin(systemTime * 3 + i) * 2;
             
-            ofDrawCircle(attractors[i], size);
+            commands.drawCircle(attractors[i], size);
             
             // リング エフェクト
-            ofNoFill();
-            ofSetLineWidth(0.8 + strength * 0.4);
-            ofDrawCircle(attractors[i], size * 1.5);
-            ofFill();
+            commands.setFill(false);
+            commands.setLineWidth(0.8 + strength * 0.4);
+            commands.drawCircle(attractors[i], size * 1.5);
+            commands.setFill(true);
         }
-        
-        ofDisableBlendMode();
     }
     
     void drawUrbanStructures() {
         // 都市スポーン地点での建造物表現
-        ofEnableBlendMode(OF_BLENDMODE_ADD);
+        commands.setBlendMode(OF_BLENDMODE_ADD);
         
         for (auto& spawnPoint : urbanSpawnPoints) {
             ofColor structureColor = urbanColor(currentNote, globalGrowthLevel);
             structureColor.a = 150 + globalGrowthLevel * 80;
-            ofSetColor(structureColor);
+            commands.setColor(structureColor);
             
             float height = 20 + globalGrowthLevel * 60;
             float width = 8 + globalGrowthLevel * 12;
             
             // 建物のシルエット
-            ofDrawRectangle(spawnPoint.x - width/2, spawnPoint.y - height, width, height);
+            commands.drawRectangle(spawnPoint.x - width/2, spawnPoint.y - height, width, height);
             
             // 建物の明かり
             if (globalGrowthLevel > 0.3f) {
-                ofSetColor(255, 200);
+                commands.setColor(255, 200);
                 for (int i = 0; i < 3; i++) {
                     float lightY = spawnPoint.y - height + (i + 1) * height / 4;
-                    ofDrawRectangle(spawnPoint.x - 2, lightY - 1, 4, 2);
+                    commands.drawRectangle(spawnPoint.x - 2, lightY - 1, 4, 2);
                 }
             }
         }
-        
-        ofDisableBlendMode();
     }
     
     void drawDebugInfo() {
         if (getTimeSinceLastMidi() < 5.0f) { // 最近MIDI入力があった場合のみ表示
             ofSetColor(200);
-            ofDrawBitmapString("Particles: " + ofToString(particles.size()), 20, ofGetHeight() - 80);
-            ofDrawBitmapString("Growth: " + ofToString(globalGrowthLevel * 100, 1) + "%", 20, ofGetHeight() - 60);
-            ofDrawBitmapString("Impact: " + ofToString(impactIntensity, 2), 20, ofGetHeight() - 40);
+            ofDrawBitmapString("Particles: " + ofToString(particles.size()), 20, SimViewport::getHeight() - 80);
+            ofDrawBitmapString("Growth: " + ofToString(globalGrowthLevel * 100, 1) + "%", 20, SimViewport::getHeight() - 60);
+            ofDrawBitmapString("Impact: " + ofToString(impactIntensity, 2), 20, SimViewport::getHeight() - 40);
             if (isCollapsing) {
                 ofSetColor(255, 100, 100);
-                ofDrawBitmapString("URBAN COLLAPSE", 20, ofGetHeight() - 20);
+                ofDrawBitmapString("URBAN COLLAPSE", 20, SimViewport::getHeight() - 20);
             }
         }
     }
@@ -15,14 +15,14 @@ struct PerlinParticle {
     ofColor color;
     float trail = 0.0f;
     
-    PerlinParticle(ofVec2f pos = ofVec2f(0, 0)) {
+    PerlinParticle(VisualRandom& rng, ofVec2f pos = ofVec2f(0, 0)) {
         position = pos;
         previousPosition = pos;
         velocity = ofVec2f(0, 0);
         color = ofColor::white;
-        maxAge = ofRandom(5.0f, 15.0f);
-        speed = ofRandom(0.5f, 2.0f);
-        size = ofRandom(0.5f, 2.0f);
+        maxAge = rng.random(5.0f, 15.0f);
+        speed = rng.random(0.5f, 2.0f);
+        size = rng.random(0.5f, 2.0f);
     }
     
     void update(float deltaTime) {
@@ -31,10 +31,10 @@ struct PerlinParticle {
         position += velocity * deltaTime * speed;
         
         // Wrap around screen edges
-        if (position.x < 0) position.x = ofGetWidth();
-        if (position.x > ofGetWidth()) position.x = 0;
-        if (position.y < 0) position.y = ofGetHeight();
-        if (position.y > ofGetHeight()) position.y = 0;
+        if (position.x < 0) position.x = SimViewport::getWidth();
+        if (position.x > SimViewport::getWidth()) position.x = 0;
+        if (position.y < 0) position.y = SimViewport::getHeight();
+        if (position.y > SimViewport::getHeight()) position.y = 0;
         
         trail = ofClamp(trail + deltaTime * 2.0f, 0.0f, 1.0f);
     }
@@ -150,20 +150,23 @@ private:
     std::vector<Trail> trails;
     
 public:
+    // 要素はすべて値で持つことを確かめた（PipelinedSystemで状態を丸ごとコピーしてよい）
+    static constexpr bool SNAPSHOT_COPYABLE = true;
+    
     void setup() override {
         // Ensure valid dimensions
-        int width = std::max(100, ofGetWidth());
-        int height = std::max(100, ofGetHeight());
+        int width = std::max(100, SimViewport::getWidth());
+        int height = std::max(100, SimViewport::getHeight());
         flowField.setup(width, height);
         
         // Initial particles
         for (int i = 0; i < 100; i++) {
-            ofVec2f pos(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
-            particles.push_back(PerlinParticle(pos));
+            ofVec2f pos(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
+            particles.push_back(PerlinParticle(rng, pos));
         }
         
         // Initialize impact center
-        impactCenter = ofVec2f(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f);
+        impactCenter = ofVec2f(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f);
         
         // Set initial growth level
         globalGrowthLevel = 0.3f;
@@ -174,8 +177,8 @@ public:
         
         // Ensure flow field is initialized
         if (flowField.cols == 0 || flowField.rows == 0) {
-            int width = std::max(100, ofGetWidth());
-            int height = std::max(100, ofGetHeight());
+            int width = std::max(100, SimViewport::getWidth());
+            int height = std::max(100, SimViewport::getHeight());
             flowField.setup(width, height);
         }
         
@@ -191,7 +194,7 @@ public:
             
             // Add spiral force
             if (spiralEffect > 0.1f) {
-                ofVec2f center(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f);
+                ofVec2f center(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f);
                 ofVec2f toCenter = center - particle.position;
                 float dist = toCenter.length();
                 if (dist > 0) {
@@ -233,18 +236,18 @@ public:
         
         // Add new particles
         float emissionRate = 2.0f + particleEmission * 20.0f + globalGrowthLevel * 5.0f;
-        while (particles.size() < 200 && ofRandom(1.0f) < emissionRate * deltaTime) {
+        while (particles.size() < detailCap(200) && rng.random(1.0f) < emissionRate * deltaTime) {
             ofVec2f pos;
             if (impactIntensity > 0.5f) {
                 // Emit from impact center
-                float angle = ofRandom(TWO_PI);
-                float radius = ofRandom(50.0f);
+                float angle = rng.random(TWO_PI);
+                float radius = rng.random(50.0f);
                 pos = impactCenter + ofVec2f(cos(angle), sin(angle)) * radius;
             } else {
                 // Random position
-                pos = ofVec2f(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
+                pos = ofVec2f(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
             }
-            particles.push_back(PerlinParticle(pos));
+            particles.push_back(PerlinParticle(rng, pos));
         }
         
         // Update effects
@@ -256,7 +259,7 @@ public:
         // Flash effect
         flashTimer += deltaTime;
         flashEffect *= 0.9f;
-        if (flashTimer > 3.0f && ofRandom(1.0f) < 0.01f) {
+        if (flashTimer > 3.0f && rng.random(1.0f) < 0.01f) {
             flashEffect = 1.0f;
             flashTimer = 0.0f;
         }
@@ -293,10 +296,10 @@ public:
         // Stats
         if (getTimeSinceLastMidi() < 5.0f) {
             ofSetColor(200);
-            ofDrawBitmapString("Perlin Flow System", 20, ofGetHeight() - 80);
-            ofDrawBitmapString("Particles: " + ofToString(particles.size()), 20, ofGetHeight() - 60);
-            ofDrawBitmapString("Field Strength: " + ofToString(fieldStrength, 2), 20, ofGetHeight() - 40);
-            ofDrawBitmapString("Turbulence: " + ofToString(fieldTurbulence, 2), 20, ofGetHeight() - 20);
+            ofDrawBitmapString("Perlin Flow System", 20, SimViewport::getHeight() - 80);
+            ofDrawBitmapString("Particles: " + ofToString(particles.size()), 20, SimViewport::getHeight() - 60);
+            ofDrawBitmapString("Field Strength: " + ofToString(fieldStrength, 2), 20, SimViewport::getHeight() - 40);
+            ofDrawBitmapString("Turbulence: " + ofToString(fieldTurbulence, 2), 20, SimViewport::getHeight() - 20);
         }
     }
     
@@ -309,8 +312,8 @@ public:
             
             // Set impact center
             impactCenter = ofVec2f(
-                ofMap(msg.pitch % 12, 0, 12, 100, ofGetWidth() - 100),
-                ofMap(msg.pitch / 12, 0, 10, 100, ofGetHeight() - 100)
+                ofMap(msg.pitch % 12, 0, 12, 100, SimViewport::getWidth() - 100),
+                ofMap(msg.pitch / 12, 0, 10, 100, SimViewport::getHeight() - 100)
             );
             
             switch(msg.pitch) {
@@ -321,10 +324,10 @@ public:
                     
                     // Burst of particles
                     for (int i = 0; i < impactIntensity * 20; i++) {
-                        float angle = ofRandom(TWO_PI);
-                        float radius = ofRandom(100.0f);
+                        float angle = rng.random(TWO_PI);
+                        float radius = rng.random(100.0f);
                         ofVec2f pos = impactCenter + ofVec2f(cos(angle), sin(angle)) * radius;
-                        particles.push_back(PerlinParticle(pos));
+                        particles.push_back(PerlinParticle(rng, pos));
                     }
                     break;
                     
@@ -348,8 +351,8 @@ public:
                     // Clear and respawn particles
                     particles.clear();
                     for (int i = 0; i < 100; i++) {
-                        ofVec2f pos(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
-                        particles.push_back(PerlinParticle(pos));
+                        ofVec2f pos(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
+                        particles.push_back(PerlinParticle(rng, pos));
                     }
                     break;
                     
@@ -422,37 +425,27 @@ private:
         for (auto& particle : particles) {
             float alpha = (1.0f - particle.getLifeRatio() * 0.5f) * 255.0f; // より不透明に
             
-            if (flashEffect > 0.5f) {
-                ofSetColor(255, 255, 255, alpha * flashEffect);
-            } else {
-                ofSetColor(particle.color.r, particle.color.g, particle.color.b, alpha);
-            }
+            ofColor spriteColor = flashEffect > 0.5f ? ofColor(255) : particle.color;
+            float spriteAlpha = flashEffect > 0.5f ? alpha * flashEffect : alpha;
             
             float size = particle.size * (1.0f + particle.velocity.length() * 0.1f);
             
-            // Draw as stretched ellipse in direction of motion
+            // Draw as stretched ellipse in direction of motion（スプライトは軌跡の線の上にまとめて描く）
             if (particle.velocity.length() > 1.0f) {
-                ofPushMatrix();
-                ofTranslate(particle.position.x, particle.position.y);
-                
                 float angle = atan2(particle.velocity.y, particle.velocity.x);
-                ofRotateDeg(ofRadToDeg(angle));
-                
                 float stretch = 1.0f + particle.velocity.length() * 0.2f;
-                ofDrawEllipse(0, 0, size * stretch, size);
-                
-                ofPopMatrix();
+                sprites.addEllipse(particle.position, size * stretch, size, angle, spriteColor, spriteAlpha);
             } else {
-                ofDrawCircle(particle.position, size);
+                sprites.addCircle(particle.position, size, spriteColor, spriteAlpha);
             }
             
             // Motion blur trail
             if (particle.velocity.length() > 3.0f) {
-                ofSetColor(particle.color.r, particle.color.g, particle.color.b, alpha * 0.3f);
-                ofSetLineWidth(size * 0.5f);
-                ofDrawLine(particle.previousPosition, particle.position);
+                lines.addLine(particle.previousPosition, particle.position, size * 0.5f, particle.color, alpha * 0.3f);
             }
         }
+        lines.draw();
+        sprites.draw();
         
         ofDisableBlendMode();
     }
@@ -462,7 +455,7 @@ private:
         
         // Vortex visualization
         if (spiralEffect > 0.5f) {
-            ofVec2f center(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f);
+            ofVec2f center(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f);
             
             ofNoFill();
             ofSetColor(255, 100 * spiralEffect);
@@ -490,13 +483,13 @@ private:
         if (waveEffect > 0.3f) {
             ofSetColor(100, 150, 200, 50 * waveEffect);
             
-            for (int y = 0; y < ofGetHeight(); y += 20) {
+            for (int y = 0; y < SimViewport::getHeight(); y += 20) {
                 ofBeginShape();
-                for (int x = 0; x <= ofGetWidth(); x += 10) {
+                for (int x = 0; x <= SimViewport::getWidth(); x += 10) {
                     float offset = sin(x * 0.01f + systemTime * 2.0f) * 10 * waveEffect;
                     ofVertex(x, y + offset);
                 }
-                for (int x = ofGetWidth(); x >= 0; x -= 10) {
+                for (int x = SimViewport::getWidth(); x >= 0; x -= 10) {
                     float offset = sin(x * 0.01f + systemTime * 2.0f) * 10 * waveEffect;
                     ofVertex(x, y + 20 + offset);
                 }
@@ -508,8 +501,8 @@ private:
         if (globalGrowthLevel > 0.7f) {
             for (int i = 0; i < 3; i++) {
                 float phase = systemTime * 0.5f + i * TWO_PI / 3.0f;
-                float x = ofGetWidth() * 0.5f + cos(phase) * 200;
-                float y = ofGetHeight() * 0.5f + sin(phase) * 200;
+                float x = SimViewport::getWidth() * 0.5f + cos(phase) * 200;
+                float y = SimViewport::getHeight() * 0.5f + sin(phase) * 200;
                 
                 ofSetColor(200, 150, 255, 100 * globalGrowthLevel);
                 float size = 20 + sin(systemTime * 3 + i) * 10;
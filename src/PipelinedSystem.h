@@ -0,0 +1,90 @@
+#pragma once
+
+#include "VisualSystem.h"
+#include <type_traits>
+#include <utility>
+
+// シミュレーションと描画を分離したビジュアルシステム（Tをそのまま包む）
+// - simulation: update()とMIDIはこちらに適用する。レンダーターゲットを持たないのでGLに触れず、ワーカースレッドで回せる
+// - snapshots: 1フレーム分のステップ（update()を何回か）の後のcaptureSnapshot()でsimulationを裏のスナップショットへ
+//   丸ごとコピーし、フレーム境界のpublishSnapshot()で表と入れ替える。draw()は表のスナップショットだけを読む
+// レンダーターゲット（トレイルの累積）とそのクリア状態は常に表のスナップショットが持ち、入れ替え時に付け替える
+// 状態をコピーで複製するため、Tは自分の要素をポインタで指さないコピー可能なシステムに限る（T::SNAPSHOT_COPYABLEで宣言する）
+// update()した後は、ワーカーを使わない場合もcaptureSnapshot()とフレーム境界のpublishSnapshot()を呼ぶこと（呼ばなければ描画が止まる）
+template<class T>
+class PipelinedSystem : public VisualSystem {
+    static_assert(std::is_base_of<VisualSystem, T>::value, "PipelinedSystem: T must be a VisualSystem");
+    static_assert(std::is_copy_assignable<T>::value, "PipelinedSystem: T must be copy-assignable");
+    static_assert(T::SNAPSHOT_COPYABLE, "PipelinedSystem: audit T's members and declare SNAPSHOT_COPYABLE = true");
+
+public:
+    void setup() override {
+        VisualSystem& sim = simulation;
+        sim.rng = rng;
+        sim.detailBudget = detailBudget;
+        simulation.setup();
+
+        snapshots[0] = simulation;
+        snapshots[1] = simulation;
+        rng = sim.rng;
+    }
+
+    // ワーカースレッドから呼んでよい（シミュレーションだけを進め、スナップショットには触れない）
+    void update(float deltaTime) override {
+        VisualSystem& sim = simulation;
+        sim.detailBudget = detailBudget;
+        simulation.update(deltaTime);
+    }
+
+    // ワーカースレッドから呼んでよい。裏はレンダーターゲットを持たないので、そのまま上書きしてよい
+    void captureSnapshot() override {
+        snapshots[back] = simulation;
+        pending = true;
+    }
+
+    void draw() override {
+        VisualSystem& current = snapshots[front];
+        current.renderAlpha = renderAlpha;
+        snapshots[front].render();
+    }
+
+    void onMidiMessage(ofxMidiMessage& msg) override {
+        simulation.onMidiMessage(msg);
+    }
+
+    bool isPipelined() const override { return true; }
+
+    void publishSnapshot() override {
+        if (!pending) return;
+        pending = false;
+
+        VisualSystem& previous = snapshots[front];
+        std::swap(front, back);
+        VisualSystem& current = snapshots[front];
+        std::swap(current.masterBuffer, previous.masterBuffer);
+        std::swap(current.trailBuffer, previous.trailBuffer);
+        std::swap(current.softwareBuffers, previous.softwareBuffers);
+
+        // バッファのクリア済み回数は描画側の状態なので引き継ぐ（成長リセットがあれば次の描画でクリアされる）
+        current.clearedResetCount = previous.clearedResetCount;
+
+        // フィンガープリント用にシミュレーションの乱数状態を写す（ワーカー停止中なので安全）
+        rng = static_cast<VisualSystem&>(simulation).rng;
+    }
+
+protected:
+    void acquireRenderTargets() override {
+        static_cast<VisualSystem&>(snapshots[front]).acquireRenderTargets();
+    }
+
+    void releaseRenderTargets() override {
+        static_cast<VisualSystem&>(snapshots[front]).releaseRenderTargets();
+    }
+
+private:
+    T simulation;
+    T snapshots[2];
+    int front = 0;
+    int back = 1;
+    bool pending = false;         // 裏に未公開のスナップショットがある
+};
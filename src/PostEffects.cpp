@@ -0,0 +1,320 @@
+#include "PostEffects.h"
+#include "AsyncLog.h"
+#include "FrameProfiler.h"
+
+// 静的メンバ変数の定義
+ofShader PostEffects::compositeShader;
+bool PostEffects::shaderTried = false;
+ofMesh PostEffects::quad;
+float PostEffects::quadWidth = 0.0f;
+float PostEffects::quadHeight = 0.0f;
+
+// 色収差の各チャンネルの不透明度（従来の ofSetColor(255, 0, 0, 180) など）
+static const float ABERRATION_ALPHA = 180.0f / 255.0f;
+
+// 合成の式（referenceCompositeと同じ順序・同じ式。texOrigin + q * texScale でOFの座標をテクスチャ座標に直す）
+static const char* const COMPOSITE_BODY = R"(
+uniform SAMPLER masterTex;
+uniform SAMPLER trailTex;
+uniform vec2 resolution;
+uniform vec2 texOrigin;
+uniform vec2 texScale;
+uniform vec2 offset;
+uniform float scale;
+uniform float aberration;
+uniform float trailMix;
+uniform float vignette;
+uniform vec4 boostColor;
+uniform vec4 glowColor;
+uniform float glowThickness;
+IN vec2 screenPos;
+
+bool inside(vec2 q) {
+    return q.x >= 0.0 && q.y >= 0.0 && q.x < resolution.x && q.y < resolution.y;
+}
+
+vec4 sampleMaster(vec2 q) {
+    return inside(q) ? TEX(masterTex, texOrigin + q * texScale) : vec4(0.0);
+}
+
+vec4 sampleTrail(vec2 q) {
+    return inside(q) ? TEX(trailTex, texOrigin + q * texScale) : vec4(0.0);
+}
+
+void main() {
+    vec2 center = resolution * 0.5;
+    vec2 q = center + (screenPos - offset - center) / scale;
+
+    vec4 color = vec4(0.0, 0.0, 0.0, 1.0);
+    if (aberration > 0.0) {
+        vec4 red = sampleMaster(q + vec2(aberration, 0.0));
+        vec4 green = sampleMaster(q);
+        vec4 blue = sampleMaster(q - vec2(aberration, 0.0));
+        color.rgb += vec3(red.r * red.a, green.g * green.a, blue.b * blue.a) * ABERRATION_ALPHA;
+    } else if (inside(q)) {
+        color = sampleMaster(q);
+    }
+
+    vec4 trail = sampleTrail(q);
+    float trailAlpha = trail.a * trailMix;
+    color.rgb += trail.rgb * trailAlpha;
+    color.a += trailAlpha * trailAlpha;
+
+    if (vignette > 0.0) {
+        float radial = min(length(screenPos - center) / length(center), 1.0);
+        color.rgb *= 1.0 - vignette * radial;
+    }
+
+    color.rgb += boostColor.rgb * boostColor.a;
+    color.a += boostColor.a * boostColor.a;
+
+    float edges = 0.0;
+    if (screenPos.y < glowThickness) edges += 1.0;
+    if (screenPos.y >= resolution.y - glowThickness) edges += 1.0;
+    if (screenPos.x < glowThickness) edges += 1.0;
+    if (screenPos.x >= resolution.x - glowThickness) edges += 1.0;
+    color.rgb += glowColor.rgb * glowColor.a * edges;
+    color.a += glowColor.a * glowColor.a * edges;
+
+    OUT_COLOR = clamp(color, 0.0, 1.0);
+}
+)";
+
+bool PostEffects::isAvailable() {
+    if (!shaderTried) {
+        shaderTried = true;
+
+        // レンダラーに合わせてGLSLのバージョンとテクスチャの種類（ARBなら座標はピクセル単位）を選ぶ
+        bool programmable = ofIsGLProgrammableRenderer();
+        bool arb = ofGetUsingArbTex();
+        string vertexShader, fragmentHeader;
+        if (programmable) {
+            vertexShader = R"(
+                #version 150
+                uniform mat4 modelViewProjectionMatrix;
+                in vec4 position;
+                in vec2 texcoord;
+                out vec2 screenPos;
+
+                void main() {
+                    screenPos = texcoord;
+                    gl_Position = modelViewProjectionMatrix * position;
+                }
+            )";
+            fragmentHeader = string("#version 150\n") +
+                             "#define SAMPLER " + (arb ? "sampler2DRect" : "sampler2D") + "\n" +
+                             "#define TEX(s, c) texture(s, c)\n" +
+                             "#define IN in\n" +
+                             "#define OUT_COLOR outputColor\n" +
+                             "out vec4 outputColor;\n";
+        } else {
+            vertexShader = R"(
+                #version 120
+                varying vec2 screenPos;
+
+                void main() {
+                    screenPos = gl_MultiTexCoord0.xy;
+                    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
+                }
+            )";
+            fragmentHeader = string("#version 120\n") +
+                             (arb ? "#extension GL_ARB_texture_rectangle : enable\n" : "") +
+                             "#define SAMPLER " + (arb ? "sampler2DRect" : "sampler2D") + "\n" +
+                             "#define TEX(s, c) " + (arb ? "texture2DRect(s, c)" : "texture2D(s, c)") + "\n" +
+                             "#define IN varying\n" +
+                             "#define OUT_COLOR gl_FragColor\n";
+        }
+        fragmentHeader += "#define ABERRATION_ALPHA " + ofToString(ABERRATION_ALPHA, 8) + "\n";
+
+        compositeShader.setupShaderFromSource(GL_VERTEX_SHADER, vertexShader);
+        compositeShader.setupShaderFromSource(GL_FRAGMENT_SHADER, fragmentHeader + COMPOSITE_BODY);
+        if (programmable) {
+            compositeShader.bindDefaults();
+        }
+        compositeShader.linkProgram();
+        MVLOG_INFO(LOG_CATEGORY_RENDER, "Post effects: %s", compositeShader.isLoaded() ? "fused shader" : "shader failed, using multi-pass effects");
+    }
+    return compositeShader.isLoaded();
+}
+
+void PostEffects::updateTrail(ofFbo& trail, ofFbo& master, const PostEffectParams& params) {
+    PROFILE_ZONE("updateTrail");
+    trail.begin();
+    ofPushStyle();
+
+    // RGB: master * (master.a * trailGain) + trail * trailFade、A: 従来の加算と同じ
+    ofDisableBlendMode();
+    glEnable(GL_BLEND);
+    glBlendColor(params.trailFade, params.trailFade, params.trailFade, 1.0f);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_CONSTANT_COLOR, GL_SRC_ALPHA, GL_ONE);
+    ofSetColor(255, 255, 255, (int)roundf(params.trailGain * 255.0f));
+    master.draw(0, 0);
+    glDisable(GL_BLEND);
+
+    ofPopStyle();
+    trail.end();
+}
+
+void PostEffects::composite(ofFbo& master, ofFbo& trail, const PostEffectParams& params) {
+    PROFILE_ZONE("compositeEffects");
+
+    // 全画面の矩形（テクスチャ座標 = OFの画面座標）、サイズが変わったときだけ作り直す
+    if (quadWidth != params.width || quadHeight != params.height) {
+        quadWidth = params.width;
+        quadHeight = params.height;
+        quad.clear();
+        quad.setMode(OF_PRIMITIVE_TRIANGLE_FAN);
+        quad.addVertex(ofVec3f(0, 0));
+        quad.addVertex(ofVec3f(quadWidth, 0));
+        quad.addVertex(ofVec3f(quadWidth, quadHeight));
+        quad.addVertex(ofVec3f(0, quadHeight));
+        quad.addTexCoord(ofVec2f(0, 0));
+        quad.addTexCoord(ofVec2f(quadWidth, 0));
+        quad.addTexCoord(ofVec2f(quadWidth, quadHeight));
+        quad.addTexCoord(ofVec2f(0, quadHeight));
+    }
+
+    // OFの座標からテクスチャ座標への変換（FBOの上下反転・ARBの有無はテクスチャに任せる）
+    const ofTexture& masterTexture = master.getTexture();
+    auto origin = masterTexture.getCoordFromPoint(0, 0);
+    auto corner = masterTexture.getCoordFromPoint(params.width, params.height);
+
+    ofPushStyle();
+    ofDisableBlendMode();
+    ofSetColor(255);
+    compositeShader.begin();
+    compositeShader.setUniformTexture("masterTex", masterTexture, 1);
+    compositeShader.setUniformTexture("trailTex", trail.getTexture(), 2);
+    compositeShader.setUniform2f("resolution", params.width, params.height);
+    compositeShader.setUniform2f("texOrigin", origin.x, origin.y);
+    compositeShader.setUniform2f("texScale", (corner.x - origin.x) / params.width, (corner.y - origin.y) / params.height);
+    compositeShader.setUniform2f("offset", params.offset.x, params.offset.y);
+    compositeShader.setUniform1f("scale", params.scale);
+    compositeShader.setUniform1f("aberration", params.aberration);
+    compositeShader.setUniform1f("trailMix", params.trailMix);
+    compositeShader.setUniform1f("vignette", params.vignette);
+    compositeShader.setUniform4f("boostColor", params.boostColor.r, params.boostColor.g, params.boostColor.b, params.boostColor.a);
+    compositeShader.setUniform4f("glowColor", params.glowColor.r, params.glowColor.g, params.glowColor.b, params.glowColor.a);
+    compositeShader.setUniform1f("glowThickness", params.glowThickness);
+    quad.draw();
+    compositeShader.end();
+    ofPopStyle();
+}
+
+// === CPUの参照実装 ===
+
+static float clamp01(float value) {
+    return value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+}
+
+// テクスチャのGL_LINEAR・CLAMP_TO_EDGEと同じ双線形補間（qはピクセル座標、画素の中心は+0.5）
+static ofFloatColor sampleBilinear(const ofFloatPixels& pixels, float x, float y) {
+    int width = pixels.getWidth();
+    int height = pixels.getHeight();
+    float u = x - 0.5f;
+    float v = y - 0.5f;
+    int x0 = (int)floorf(u);
+    int y0 = (int)floorf(v);
+    float fx = u - x0;
+    float fy = v - y0;
+
+    auto texel = [&](int tx, int ty) {
+        tx = tx < 0 ? 0 : (tx >= width ? width - 1 : tx);
+        ty = ty < 0 ? 0 : (ty >= height ? height - 1 : ty);
+        return pixels.getColor(tx, ty);
+    };
+    ofFloatColor top = texel(x0, y0) * (1.0f - fx) + texel(x0 + 1, y0) * fx;
+    ofFloatColor bottom = texel(x0, y0 + 1) * (1.0f - fx) + texel(x0 + 1, y0 + 1) * fx;
+    return top * (1.0f - fy) + bottom * fy;
+}
+
+static bool insideFrame(const PostEffectParams& params, float x, float y) {
+    return x >= 0.0f && y >= 0.0f && x < params.width && y < params.height;
+}
+
+static ofFloatColor sampleFrame(const ofFloatPixels& pixels, const PostEffectParams& params, float x, float y) {
+    return insideFrame(params, x, y) ? sampleBilinear(pixels, x, y) : ofFloatColor(0, 0, 0, 0);
+}
+
+void PostEffects::referenceTrail(const ofFloatPixels& trail, const ofFloatPixels& master, const PostEffectParams& params, ofFloatPixels& out) {
+    out.allocate(trail.getWidth(), trail.getHeight(), OF_PIXELS_RGBA);
+    for (std::size_t y = 0; y < trail.getHeight(); y++) {
+        for (std::size_t x = 0; x < trail.getWidth(); x++) {
+            ofFloatColor previous = trail.getColor(x, y);
+            ofFloatColor source = master.getColor(x, y);
+            float sourceAlpha = source.a * params.trailGain;
+            out.setColor(x, y, ofFloatColor(clamp01(source.r * sourceAlpha + previous.r * params.trailFade),
+                                            clamp01(source.g * sourceAlpha + previous.g * params.trailFade),
+                                            clamp01(source.b * sourceAlpha + previous.b * params.trailFade),
+                                            clamp01(sourceAlpha * sourceAlpha + previous.a)));
+        }
+    }
+}
+
+void PostEffects::referenceComposite(const ofFloatPixels& master, const ofFloatPixels& trail, const PostEffectParams& params, ofFloatPixels& out) {
+    out.allocate(master.getWidth(), master.getHeight(), OF_PIXELS_RGBA);
+    float centerX = params.width * 0.5f;
+    float centerY = params.height * 0.5f;
+    float centerLength = sqrtf(centerX * centerX + centerY * centerY);
+
+    for (std::size_t y = 0; y < master.getHeight(); y++) {
+        for (std::size_t x = 0; x < master.getWidth(); x++) {
+            float screenX = x + 0.5f;
+            float screenY = y + 0.5f;
+            float qx = centerX + (screenX - params.offset.x - centerX) / params.scale;
+            float qy = centerY + (screenY - params.offset.y - centerY) / params.scale;
+
+            float r = 0.0f, g = 0.0f, b = 0.0f, a = 1.0f;
+            if (params.aberration > 0.0f) {
+                ofFloatColor red = sampleFrame(master, params, qx + params.aberration, qy);
+                ofFloatColor green = sampleFrame(master, params, qx, qy);
+                ofFloatColor blue = sampleFrame(master, params, qx - params.aberration, qy);
+                r += red.r * red.a * ABERRATION_ALPHA;
+                g += green.g * green.a * ABERRATION_ALPHA;
+                b += blue.b * blue.a * ABERRATION_ALPHA;
+            } else if (insideFrame(params, qx, qy)) {
+                ofFloatColor color = sampleFrame(master, params, qx, qy);
+                r = color.r;
+                g = color.g;
+                b = color.b;
+                a = color.a;
+            }
+
+            ofFloatColor trailColor = sampleFrame(trail, params, qx, qy);
+            float trailAlpha = trailColor.a * params.trailMix;
+            r += trailColor.r * trailAlpha;
+            g += trailColor.g * trailAlpha;
+            b += trailColor.b * trailAlpha;
+            a += trailAlpha * trailAlpha;
+
+            if (params.vignette > 0.0f) {
+                float dx = screenX - centerX;
+                float dy = screenY - centerY;
+                float radial = std::min(sqrtf(dx * dx + dy * dy) / centerLength, 1.0f);
+                float darkness = 1.0f - params.vignette * radial;
+                r *= darkness;
+                g *= darkness;
+                b *= darkness;
+            }
+
+            const ofFloatColor& boost = params.boostColor;
+            r += boost.r * boost.a;
+            g += boost.g * boost.a;
+            b += boost.b * boost.a;
+            a += boost.a * boost.a;
+
+            float edges = 0.0f;
+            if (screenY < params.glowThickness) edges += 1.0f;
+            if (screenY >= params.height - params.glowThickness) edges += 1.0f;
+            if (screenX < params.glowThickness) edges += 1.0f;
+            if (screenX >= params.width - params.glowThickness) edges += 1.0f;
+            const ofFloatColor& glow = params.glowColor;
+            r += glow.r * glow.a * edges;
+            g += glow.g * glow.a * edges;
+            b += glow.b * glow.a * edges;
+            a += glow.a * glow.a * edges;
+
+            out.setColor(x, y, ofFloatColor(clamp01(r), clamp01(g), clamp01(b), clamp01(a)));
+        }
+    }
+}
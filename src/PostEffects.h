@@ -0,0 +1,52 @@
+#pragma once
+
+#include "ofMain.h"
+
+// 全画面エフェクト1フレーム分のパラメータ（VisualSystemが状態から作る、色・不透明度は0〜1）
+// 無効な効果は0（scaleは1）にしておく
+struct PostEffectParams {
+    float width = 0.0f;
+    float height = 0.0f;
+
+    // トレイルの更新: trail = trail * trailFade + master * (master.a * trailGain)
+    float trailFade = 1.0f;
+    float trailGain = 0.0f;
+
+    // 合成（マスターとトレイルは画面振動・歪みの変換を通して読む）
+    ofVec2f offset;                                  // 画面振動（ピクセル）
+    float scale = 1.0f;                              // 歪みの拡大率（画面中心が基準）
+    float aberration = 0.0f;                         // 色収差のずれ（ピクセル）
+    float trailMix = 0.0f;                           // トレイルを足す不透明度
+    float vignette = 0.0f;                           // 画面の角での暗さ
+    ofFloatColor boostColor = ofFloatColor(0, 0, 0, 0);   // 全面に足す色（aが不透明度）
+    ofFloatColor glowColor = ofFloatColor(0, 0, 0, 0);    // 画面端のグロー（aが不透明度）
+    float glowThickness = 0.0f;
+};
+
+// VisualSystem共通の全画面エフェクト
+// - トレイルの更新: マスターを1回描くだけの1パス（前のトレイルの減衰は定数色のブレンド係数で掛ける）
+// - 合成: マスター・トレイル・色収差・ビネット・色の加算・端のグローを1つのシェーダーで1パス
+// 従来のブレンドの連鎖を1ピクセルの式にまとめたもので、途中のクランプだけは最後に1回にしている
+// CPUの参照実装（reference*）はシェーダーと同じ式・同じ順序の計算で、GLなしで結果を確かめられる
+class PostEffects {
+public:
+    // シェーダーが使えるか（初回呼び出しで描画スレッドでコンパイルする）
+    static bool isAvailable();
+
+    // trailを更新する（trailとmasterは同じサイズ）
+    static void updateTrail(ofFbo& trail, ofFbo& master, const PostEffectParams& params);
+
+    // 今バインドされているターゲットの全面を上書きする
+    static void composite(ofFbo& master, ofFbo& trail, const PostEffectParams& params);
+
+    // === CPUの参照実装（RGBA、0〜1、1行目が画面の上端） ===
+    static void referenceTrail(const ofFloatPixels& trail, const ofFloatPixels& master, const PostEffectParams& params, ofFloatPixels& out);
+    static void referenceComposite(const ofFloatPixels& master, const ofFloatPixels& trail, const PostEffectParams& params, ofFloatPixels& out);
+
+private:
+    static ofShader compositeShader;
+    static bool shaderTried;
+    static ofMesh quad;
+    static float quadWidth;
+    static float quadHeight;
+};
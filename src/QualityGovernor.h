@@ -0,0 +1,152 @@
+#pragma once
+
+#include "ofMain.h"
+#include <algorithm>
+#include <vector>
+
+// フレーム時間の予算に合わせて、システムごとの詳細度（密度の上限倍率）を上下させる
+// - 各エントリ（ビジュアルシステム・グリッチ）のupdate/drawコストを計測して平滑化
+// - フレーム負荷が上限を超え続けたら、最もコストの高いアクティブなエントリを下げる
+// - 下限を下回り続けたら、アクティブなエントリをゆっくり上げる
+// 上げ下げで閾値と必要フレーム数を変えてヒステリシスを持たせ、振動を防ぐ
+class QualityGovernor {
+public:
+    static constexpr float MIN_BUDGET = 0.25f;
+    static constexpr float MAX_BUDGET = 4.0f;
+    
+    void setup(std::size_t numEntries, float targetFrameTime = 1.0f / 60.0f) {
+        entries.assign(numEntries, Entry());
+        targetMicros = targetFrameTime * 1000000.0f;
+        load = 0.0f;
+        overFrames = 0;
+        underFrames = 0;
+        cooldownFrames = 0;
+    }
+    
+    // 計測したコストを加算（1フレームに複数回呼んでよい）
+    void addCost(std::size_t entry, uint64_t micros) {
+        if (entry >= entries.size()) return;
+        entries[entry].frameMicros += micros;
+        entries[entry].activeThisFrame = true;
+    }
+    
+    // フレーム末尾で呼ぶ。workMicros = update+drawのCPU時間、framePeriod = 実際のフレーム間隔（秒）
+    // 詳細度を変更したらtrueを返す
+    bool endFrame(uint64_t workMicros, float framePeriod) {
+        for (auto& entry : entries) {
+            if (entry.activeThisFrame) {
+                entry.costMicros = ofLerp(entry.costMicros, entry.frameMicros, COST_SMOOTHING);
+            }
+        }
+        
+        // 垂直同期中はCPU時間しか余裕が見えないため、GPU律速はフレーム間隔の伸びで検出する
+        float frameLoad = workMicros / targetMicros;
+        float periodLoad = framePeriod * 1000000.0f / targetMicros;
+        if (periodLoad > SLOW_FRAME_RATIO) {
+            frameLoad = std::max(frameLoad, periodLoad);
+        }
+        load = ofLerp(load, frameLoad, LOAD_SMOOTHING);
+        
+        bool changed = false;
+        if (!enabled) {
+            overFrames = 0;
+            underFrames = 0;
+        } else if (cooldownFrames > 0) {
+            cooldownFrames--;
+        } else if (load > UPPER_LOAD) {
+            underFrames = 0;
+            if (++overFrames >= FRAMES_TO_DECREASE) {
+                changed = decrease();
+                overFrames = 0;
+            }
+        } else if (load < LOWER_LOAD) {
+            overFrames = 0;
+            if (++underFrames >= FRAMES_TO_INCREASE) {
+                changed = increase();
+                underFrames = 0;
+            }
+        } else {
+            // 不感帯（現在の詳細度を維持）
+            overFrames = 0;
+            underFrames = 0;
+        }
+        
+        for (auto& entry : entries) {
+            entry.frameMicros = 0;
+            entry.activeThisFrame = false;
+        }
+        return changed;
+    }
+    
+    void setEnabled(bool enable) { enabled = enable; }
+    bool isEnabled() const { return enabled; }
+    
+    // 全エントリを固定の詳細度にする（オフラインレンダーなど再現性が必要な時は無効化と併用）
+    void setAllBudgets(float budget) {
+        for (auto& entry : entries) {
+            entry.budget = ofClamp(budget, MIN_BUDGET, MAX_BUDGET);
+        }
+    }
+    
+    float getBudget(std::size_t entry) const { return entry < entries.size() ? entries[entry].budget : 1.0f; }
+    float getCostMillis(std::size_t entry) const { return entry < entries.size() ? entries[entry].costMicros / 1000.0f : 0.0f; }
+    float getLoad() const { return load; }
+
+private:
+    struct Entry {
+        float budget = 1.0f;
+        float costMicros = 0.0f;     // 平滑化したフレームあたりのコスト
+        uint64_t frameMicros = 0;    // 今フレームの累計
+        bool activeThisFrame = false;
+    };
+    
+    static constexpr float UPPER_LOAD = 0.85f;         // これを超え続けたら下げる
+    static constexpr float LOWER_LOAD = 0.6f;          // これを下回り続けたら上げる
+    static constexpr float SLOW_FRAME_RATIO = 1.2f;    // フレーム間隔が予算の1.2倍を超えたら遅延とみなす
+    static constexpr int FRAMES_TO_DECREASE = 10;      // 下げるのは速く
+    static constexpr int FRAMES_TO_INCREASE = 90;      // 上げるのはゆっくり
+    static constexpr int COOLDOWN_FRAMES = 30;         // 変更後、効果が平滑値に出るまで待つ
+    static constexpr float DECREASE_FACTOR = 0.8f;
+    static constexpr float INCREASE_FACTOR = 1.1f;
+    static constexpr float COST_SMOOTHING = 0.1f;
+    static constexpr float LOAD_SMOOTHING = 0.1f;
+    
+    // 最もコストの高いアクティブなエントリを下げる
+    bool decrease() {
+        Entry* heaviest = nullptr;
+        for (auto& entry : entries) {
+            if (entry.activeThisFrame && entry.budget > MIN_BUDGET &&
+                (!heaviest || entry.costMicros > heaviest->costMicros)) {
+                heaviest = &entry;
+            }
+        }
+        if (!heaviest) return false;
+        
+        heaviest->budget = std::max(MIN_BUDGET, heaviest->budget * DECREASE_FACTOR);
+        cooldownFrames = COOLDOWN_FRAMES;
+        return true;
+    }
+    
+    // アクティブなエントリをまとめて上げる
+    bool increase() {
+        bool changed = false;
+        for (auto& entry : entries) {
+            if (entry.activeThisFrame && entry.budget < MAX_BUDGET) {
+                entry.budget = std::min(MAX_BUDGET, entry.budget * INCREASE_FACTOR);
+                changed = true;
+            }
+        }
+        if (changed) {
+            cooldownFrames = COOLDOWN_FRAMES;
+        }
+        return changed;
+    }
+    
+    std::vector<Entry> entries;
+    float targetMicros = 16667.0f;
+    float load = 0.0f;
+    int overFrames = 0;
+    int underFrames = 0;
+    int cooldownFrames = 0;
+    bool enabled = true;
+};
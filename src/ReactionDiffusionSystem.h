@@ -21,15 +21,23 @@ struct UrbanCell {
     
     UrbanCell() {
         position = ofVec2f(0, 0);
-        density = ofRandom(0.1f, 0.3f);
-        activity = ofRandom(0.0f, 0.1f);
+        density = 0.2f;
+        activity = 0.05f;
         infrastructure = 0.0f;
         pollution = 0.0f;
         age = 0.0f;
         color = ofColor::white;
         isActive = true;
-        diffusionRate = ofRandom(0.8f, 1.2f);
-        reactionRate = ofRandom(0.9f, 1.1f);
+        diffusionRate = 1.0f;
+        reactionRate = 1.0f;
+    }
+    
+    // 初期値のばらつき（システムの乱数から）
+    void randomize(VisualRandom& rng) {
+        density = rng.random(0.1f, 0.3f);
+        activity = rng.random(0.0f, 0.1f);
+        diffusionRate = rng.random(0.8f, 1.2f);
+        reactionRate = rng.random(0.9f, 1.1f);
     }
     
     void update(float deltaTime, float globalGrowth) {
@@ -156,20 +164,23 @@ public:
         
         urbanCells.resize(numCells);
         cellPositions.resize(numCells);
+        for (auto& cell : urbanCells) {
+            cell.randomize(rng);
+        }
         
         // ランダムスキャッター配置
         for (int i = 0; i < numCells; i++) {
             // クラスター配置とランダム配置のミックス
-            if (ofRandom(1.0f) < 0.6f) {
+            if (rng.random(1.0f) < 0.6f) {
                 // クラスター配置（60%）
-                ofVec2f clusterCenter = ofVec2f(ofRandom(100, ofGetWidth()-100), ofRandom(100, ofGetHeight()-100));
-                float clusterRadius = ofRandom(30, 80);
-                float angle = ofRandom(TWO_PI);
-                float distance = ofRandom(clusterRadius);
+                ofVec2f clusterCenter = ofVec2f(rng.random(100, SimViewport::getWidth()-100), rng.random(100, SimViewport::getHeight()-100));
+                float clusterRadius = rng.random(30, 80);
+                float angle = rng.random(TWO_PI);
+                float distance = rng.random(clusterRadius);
                 cellPositions[i] = clusterCenter + ofVec2f(cos(angle) * distance, sin(angle) * distance);
             } else {
                 // 完全ランダム配置（40%）
-                cellPositions[i] = ofVec2f(ofRandom(20, ofGetWidth()-20), ofRandom(20, ofGetHeight()-20));
+                cellPositions[i] = ofVec2f(rng.random(20, SimViewport::getWidth()-20), rng.random(20, SimViewport::getHeight()-20));
             }
             
             urbanCells[i].position = cellPositions[i];
@@ -297,8 +308,8 @@ public:
                 default:
                     // 音程に基づく局所的発展
                     ofVec2f developmentCenter(
-                        ofMap(msg.pitch % 12, 0, 12, 50, ofGetWidth() - 50),
-                        ofMap(msg.pitch / 12, 0, 10, 50, ofGetHeight() - 50)
+                        ofMap(msg.pitch % 12, 0, 12, 50, SimViewport::getWidth() - 50),
+                        ofMap(msg.pitch / 12, 0, 10, 50, SimViewport::getHeight() - 50)
                     );
                     triggerLocalDevelopment(developmentCenter, impactIntensity);
             }
@@ -357,14 +368,14 @@ private:
         
         for (int i = 0; i < numSeeds; i++) {
             seedCenters.push_back(ofVec2f(
-                ofRandom(ofGetWidth() * 0.2f, ofGetWidth() * 0.8f),
-                ofRandom(ofGetHeight() * 0.2f, ofGetHeight() * 0.8f)
+                rng.random(SimViewport::getWidth() * 0.2f, SimViewport::getWidth() * 0.8f),
+                rng.random(SimViewport::getHeight() * 0.2f, SimViewport::getHeight() * 0.8f)
             ));
         }
         
         // 各セルを最寄りの核と距離で影響度を計算
         for (int i = 0; i < numCells; i++) {
-            float minDistance = ofGetWidth();
+            float minDistance = SimViewport::getWidth();
             for (auto& seedCenter : seedCenters) {
                 float distance = cellPositions[i].distance(seedCenter);
                 if (distance < minDistance) {
@@ -375,18 +386,18 @@ private:
             // 距離に基づく影響度（不規則分散）
             float influence = ofClamp(1.0f - (minDistance / 120.0f), 0.0f, 1.0f);
             if (influence > 0.2f) {
-                urbanCells[i].density = ofRandom(0.6f, 0.9f) * influence;
-                urbanCells[i].activity = ofRandom(0.4f, 0.7f) * influence;
-                urbanCells[i].infrastructure = ofRandom(0.2f, 0.5f) * influence;
+                urbanCells[i].density = rng.random(0.6f, 0.9f) * influence;
+                urbanCells[i].activity = rng.random(0.4f, 0.7f) * influence;
+                urbanCells[i].infrastructure = rng.random(0.2f, 0.5f) * influence;
             }
         }
     }
     
     void initializeUrbanZones() {
         // 都市ゾーンの配置（スペーシング拡大）
-        urbanZones.push_back(UrbanZone(ofVec2f(ofGetWidth() * 0.25f, ofGetHeight() * 0.25f), 100, RESIDENTIAL));
-        urbanZones.push_back(UrbanZone(ofVec2f(ofGetWidth() * 0.75f, ofGetHeight() * 0.25f), 80, COMMERCIAL));
-        urbanZones.push_back(UrbanZone(ofVec2f(ofGetWidth() * 0.5f, ofGetHeight() * 0.75f), 90, INDUSTRIAL));
+        urbanZones.push_back(UrbanZone(ofVec2f(SimViewport::getWidth() * 0.25f, SimViewport::getHeight() * 0.25f), 100, RESIDENTIAL));
+        urbanZones.push_back(UrbanZone(ofVec2f(SimViewport::getWidth() * 0.75f, SimViewport::getHeight() * 0.25f), 80, COMMERCIAL));
+        urbanZones.push_back(UrbanZone(ofVec2f(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.75f), 90, INDUSTRIAL));
     }
     
     void initializeTransportation() {
@@ -394,19 +405,19 @@ private:
         transportationLines.resize(4);
         
         // 横断道路
-        transportationLines[0].addVertex(0, ofGetHeight() * 0.3f);
-        transportationLines[0].addVertex(ofGetWidth(), ofGetHeight() * 0.3f);
+        transportationLines[0].addVertex(0, SimViewport::getHeight() * 0.3f);
+        transportationLines[0].addVertex(SimViewport::getWidth(), SimViewport::getHeight() * 0.3f);
         
         // 縦断道路
-        transportationLines[1].addVertex(ofGetWidth() * 0.5f, 0);
-        transportationLines[1].addVertex(ofGetWidth() * 0.5f, ofGetHeight());
+        transportationLines[1].addVertex(SimViewport::getWidth() * 0.5f, 0);
+        transportationLines[1].addVertex(SimViewport::getWidth() * 0.5f, SimViewport::getHeight());
         
         // 対角線道路
         transportationLines[2].addVertex(0, 0);
-        transportationLines[2].addVertex(ofGetWidth(), ofGetHeight());
+        transportationLines[2].addVertex(SimViewport::getWidth(), SimViewport::getHeight());
         
-        transportationLines[3].addVertex(ofGetWidth(), 0);
-        transportationLines[3].addVertex(0, ofGetHeight());
+        transportationLines[3].addVertex(SimViewport::getWidth(), 0);
+        transportationLines[3].addVertex(0, SimViewport::getHeight());
     }
     
     void updateUrbanCells(float deltaTime) {
@@ -580,8 +591,8 @@ private:
     void updateAdvancedUrbanEffects(float deltaTime) {
         // 都市の光の更新
         for (int i = 0; i < lightPoints.size(); i++) {
-            if (ofRandom(1.0f) < 0.1f) {
-                lightPoints[i] = ofVec2f(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
+            if (rng.random(1.0f) < 0.1f) {
+                lightPoints[i] = ofVec2f(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
             }
         }
         
@@ -589,8 +600,8 @@ private:
         for (int i = 0; i < smokeSources.size(); i++) {
             // 工業地域の近くに配置
             for (auto& zone : urbanZones) {
-                if (zone.type == INDUSTRIAL && ofRandom(1.0f) < 0.2f) {
-                    smokeSources[i] = zone.center + ofVec2f(ofRandom(-30, 30), ofRandom(-30, 30));
+                if (zone.type == INDUSTRIAL && rng.random(1.0f) < 0.2f) {
+                    smokeSources[i] = zone.center + ofVec2f(rng.random(-30, 30), rng.random(-30, 30));
                 }
             }
         }
@@ -602,8 +613,8 @@ private:
             int numPoints = 8 + globalGrowthLevel * 12;
             for (int j = 0; j < numPoints; j++) {
                 float t = j / float(numPoints - 1);
-                float x = ofLerp(ofRandom(ofGetWidth() * 0.1f), ofRandom(ofGetWidth() * 0.9f), t);
-                float y = ofGetHeight() * 0.5f + sin(t * PI * 2 + systemTime + i) * 50;
+                float x = ofLerp(rng.random(SimViewport::getWidth() * 0.1f), rng.random(SimViewport::getWidth() * 0.9f), t);
+                float y = SimViewport::getHeight() * 0.5f + sin(t * PI * 2 + systemTime + i) * 50;
                 
                 energyFlows[i].addVertex(x, y);
             }
@@ -614,7 +625,7 @@ private:
         // クールな都市背景
         ofColor bgColor = ofColor::fromHsb(210, 50, 20 + globalGrowthLevel * 20);
         ofSetColor(bgColor);
-        ofDrawRectangle(0, 0, ofGetWidth(), ofGetHeight());
+        ofDrawRectangle(0, 0, SimViewport::getWidth(), SimViewport::getHeight());
     }
     
     void drawUrbanCells() {
@@ -632,7 +643,7 @@ private:
                 
                 // 変数サイズの不規則ポリゴンでセルを描画
                 float sizeMultiplier = 0.5f + (cell.density + cell.activity) * 1.2f; // より大きなサイズ変動
-                float variableSize = cellSize * sizeMultiplier * ofRandom(0.7f, 1.4f); // ランダムサイズ変動
+                float variableSize = cellSize * sizeMultiplier * rng.random(0.7f, 1.4f); // ランダムサイズ変動
                 
                 drawVariableCellPolygon(i, cellPositions[i], variableSize);
                 
@@ -643,10 +654,10 @@ private:
                     ofSetColor(markerColor);
                     // 不規則な高密度マーカー
                     for (int j = 0; j < 6; j++) {
-                        float angle = j * PI / 3.0f + ofRandom(-0.3f, 0.3f);
-                        float radius = variableSize * 0.2f + ofRandom(-2, 2);
+                        float angle = j * PI / 3.0f + rng.random(-0.3f, 0.3f);
+                        float radius = variableSize * 0.2f + rng.random(-2, 2);
                         ofVec2f markerPos = cellPositions[i] + ofVec2f(cos(angle) * radius, sin(angle) * radius);
-                        float markerSize = ofRandom(1, 3);
+                        float markerSize = rng.random(1, 3);
                         drawWaveCircle(markerPos, markerSize, cell.density);
                     }
                 }
@@ -777,7 +788,7 @@ private:
             
             for (int i = 0; i < 8; i++) {
                 float offset = i * 10;
-                ofVec2f smokePos = smoke + ofVec2f(ofRandom(-5, 5), -offset + sin(systemTime + i) * 3);
+                ofVec2f smokePos = smoke + ofVec2f(rng.random(-5, 5), -offset + sin(systemTime + i) * 3);
                 float smokeSize = 3 + i;
                 drawWaveCircle(smokePos, smokeSize, globalGrowthLevel);
             }
@@ -829,14 +840,14 @@ private:
     void drawUrbanStatistics() {
         if (getTimeSinceLastMidi() < 5.0f) {
             ofSetColor(200);
-            ofDrawBitmapString("Reaction-Diffusion Urban Simulation", 20, ofGetHeight() - 120);
-            ofDrawBitmapString("Urbanization Level: " + ofToString(totalUrbanization * 100, 1) + "%", 20, ofGetHeight() - 100);
-            ofDrawBitmapString("Infrastructure Density: " + ofToString(infrastructureDensity * 100, 1) + "%", 20, ofGetHeight() - 80);
-            ofDrawBitmapString("Traffic Flow: " + ofToString(trafficFlow * 100, 1) + "%", 20, ofGetHeight() - 60);
-            ofDrawBitmapString("Urban Zones: " + ofToString(urbanZones.size()), 20, ofGetHeight() - 40);
+            ofDrawBitmapString("Reaction-Diffusion Urban Simulation", 20, SimViewport::getHeight() - 120);
+            ofDrawBitmapString("Urbanization Level: " + ofToString(totalUrbanization * 100, 1) + "%", 20, SimViewport::getHeight() - 100);
+            ofDrawBitmapString("Infrastructure Density: " + ofToString(infrastructureDensity * 100, 1) + "%", 20, SimViewport::getHeight() - 80);
+            ofDrawBitmapString("Traffic Flow: " + ofToString(trafficFlow * 100, 1) + "%", 20, SimViewport::getHeight() - 60);
+            ofDrawBitmapString("Urban Zones: " + ofToString(urbanZones.size()), 20, SimViewport::getHeight() - 40);
             if (isMegaCity) {
                 ofSetColor(255, 200, 100);
-                ofDrawBitmapString("MEGACITY STATUS", 20, ofGetHeight() - 20);
+                ofDrawBitmapString("MEGACITY STATUS", 20, SimViewport::getHeight() - 20);
             }
         }
     }
@@ -848,22 +859,22 @@ private:
         
         // ランダムスキャッター方式で人口密度を上げる
         for (int i = 0; i < numAffectedCells; i++) {
-            int randomIndex = ofRandom(numCells);
+            int randomIndex = rng.random(numCells);
             
             // 中央寄りのクラスターエリアを重視
-            ofVec2f center = ofVec2f(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f);
+            ofVec2f center = ofVec2f(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f);
             float distanceFromCenter = cellPositions[randomIndex].distance(center);
-            float centerBias = 1.0f - ofClamp(distanceFromCenter / (ofGetWidth() * 0.4f), 0.0f, 1.0f);
+            float centerBias = 1.0f - ofClamp(distanceFromCenter / (SimViewport::getWidth() * 0.4f), 0.0f, 1.0f);
             
-            if (ofRandom(1.0f) < (0.3f + centerBias * 0.7f)) {
-                urbanCells[randomIndex].density += intensity * ofRandom(0.2f, 0.4f);
+            if (rng.random(1.0f) < (0.3f + centerBias * 0.7f)) {
+                urbanCells[randomIndex].density += intensity * rng.random(0.2f, 0.4f);
                 urbanCells[randomIndex].density = ofClamp(urbanCells[randomIndex].density, 0.0f, 1.0f);
             }
         }
         
         // 新しい住宅ゾーンの追加
-        if (ofRandom(1.0f) < intensity && urbanZones.size() < 8) {
-            ofVec2f newZoneCenter(ofRandom(100, ofGetWidth()-100), ofRandom(100, ofGetHeight()-100));
+        if (rng.random(1.0f) < intensity && urbanZones.size() < 8) {
+            ofVec2f newZoneCenter(rng.random(100, SimViewport::getWidth()-100), rng.random(100, SimViewport::getHeight()-100));
             urbanZones.push_back(UrbanZone(newZoneCenter, 40 + intensity * 30, RESIDENTIAL));
         }
     }
@@ -876,21 +887,21 @@ private:
         std::vector<int> developmentCluster;
         
         for (int i = 0; i < numAffectedCells; i++) {
-            int randomIndex = ofRandom(numCells);
+            int randomIndex = rng.random(numCells);
             
             // 既存の活動的セルの近くを優先
             bool nearActiveCell = false;
             for (int j = 0; j < numCells; j++) {
                 if (urbanCells[j].activity > 0.5f) {
                     float distance = cellPositions[randomIndex].distance(cellPositions[j]);
-                    if (distance < cellSize * 3.0f && ofRandom(1.0f) < 0.7f) {
+                    if (distance < cellSize * 3.0f && rng.random(1.0f) < 0.7f) {
                         nearActiveCell = true;
                         break;
                     }
                 }
             }
             
-            float developmentBoost = nearActiveCell ? intensity * ofRandom(0.5f, 0.7f) : intensity * ofRandom(0.2f, 0.4f);
+            float developmentBoost = nearActiveCell ? intensity * rng.random(0.5f, 0.7f) : intensity * rng.random(0.2f, 0.4f);
             
             urbanCells[randomIndex].activity += developmentBoost;
             urbanCells[randomIndex].infrastructure += developmentBoost * 0.5f;
@@ -899,7 +910,7 @@ private:
         }
         
         // 活動センターの追加
-        activityCenters.push_back(ofVec2f(ofRandom(ofGetWidth()), ofRandom(ofGetHeight())));
+        activityCenters.push_back(ofVec2f(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight())));
         if (activityCenters.size() > 10) {
             activityCenters.erase(activityCenters.begin());
         }
@@ -913,10 +924,10 @@ private:
         }
         
         // 新しい交通路の追加
-        if (ofRandom(1.0f) < intensity * 0.5f && transportationLines.size() < 8) {
+        if (rng.random(1.0f) < intensity * 0.5f && transportationLines.size() < 8) {
             ofPolyline newRoad;
-            newRoad.addVertex(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
-            newRoad.addVertex(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
+            newRoad.addVertex(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
+            newRoad.addVertex(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
             transportationLines.push_back(newRoad);
         }
     }
@@ -927,14 +938,14 @@ private:
         
         // ランダムセルの30%を選択（不規則分散）
         for (int i = 0; i < numCells; i++) {
-            if (ofRandom(1.0f) < 0.35f) {
+            if (rng.random(1.0f) < 0.35f) {
                 transformationCells.push_back(i);
             }
         }
         
         // 変革の不規則伝播
         for (int cellIndex : transformationCells) {
-            float transformationIntensity = ofRandom(0.8f, 1.2f);
+            float transformationIntensity = rng.random(0.8f, 1.2f);
             
             urbanCells[cellIndex].density += 0.2f * transformationIntensity;
             urbanCells[cellIndex].activity += 0.3f * transformationIntensity;
@@ -948,7 +959,7 @@ private:
             for (int j = 0; j < numCells; j++) {
                 if (j != cellIndex) {
                     float distance = cellPositions[cellIndex].distance(cellPositions[j]);
-                    if (distance < cellSize * 2.0f && ofRandom(1.0f) < 0.4f) {
+                    if (distance < cellSize * 2.0f && rng.random(1.0f) < 0.4f) {
                         float rippleEffect = (1.0f - distance / (cellSize * 2.0f)) * 0.5f;
                         urbanCells[j].activity += 0.1f * rippleEffect;
                         urbanCells[j].infrastructure += 0.15f * rippleEffect;
@@ -958,7 +969,7 @@ private:
         }
         
         // メガプロジェクトゾーンの追加
-        ofVec2f megaCenter(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f);
+        ofVec2f megaCenter(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f);
         urbanZones.push_back(UrbanZone(megaCenter, 100, COMMERCIAL));
         
         isMegaCity = true;
@@ -973,13 +984,13 @@ private:
             float distance = cellPositions[i].distance(center);
             
             // 不規則な影響範囲（一様でない）
-            float irregularRadius = baseRadius * ofRandom(0.6f, 1.4f);
+            float irregularRadius = baseRadius * rng.random(0.6f, 1.4f);
             
             if (distance <= irregularRadius) {
                 float influence = (1.0f - distance / irregularRadius) * intensity;
                 
                 // ランダムな発展強度
-                float developmentVariation = ofRandom(0.7f, 1.3f);
+                float developmentVariation = rng.random(0.7f, 1.3f);
                 
                 urbanCells[i].density += influence * 0.2f * developmentVariation;
                 urbanCells[i].activity += influence * 0.3f * developmentVariation;
@@ -995,14 +1006,14 @@ private:
     void applyUrbanDecay() {
         // 都市衰退効果（不規則分散）
         for (int i = 0; i < numCells; i++) {
-            if (ofRandom(1.0f) < 0.12f) {
+            if (rng.random(1.0f) < 0.12f) {
                 // 不規則な衰退パターン
-                float decayIntensity = ofRandom(0.85f, 0.98f);
+                float decayIntensity = rng.random(0.85f, 0.98f);
                 
                 urbanCells[i].density *= decayIntensity;
                 urbanCells[i].activity *= (decayIntensity - 0.05f);
                 urbanCells[i].infrastructure *= (decayIntensity - 0.03f);
-                urbanCells[i].pollution += ofRandom(0.02f, 0.08f);
+                urbanCells[i].pollution += rng.random(0.02f, 0.08f);
             }
         }
         
@@ -1016,8 +1027,8 @@ private:
         
         for (int i = 0; i < numCells; i++) {
             // 変数サイズのポリゴン生成
-            int vertices = 3 + ofRandom(6); // 3-8角形
-            float baseRadius = cellSize * ofRandom(0.5f, 1.5f); // 大きなサイズ変動
+            int vertices = 3 + rng.random(6); // 3-8角形
+            float baseRadius = cellSize * rng.random(0.5f, 1.5f); // 大きなサイズ変動
             cellPolygons[i] = generateUrbanPolygon(vertices, baseRadius);
         }
     }
@@ -1028,7 +1039,7 @@ private:
         buildingPolygons.resize(numBuildings);
         
         for (int i = 0; i < numBuildings; i++) {
-            buildingPolygons[i] = generateUrbanPolygon(4 + ofRandom(4), 50 + ofRandom(40));
+            buildingPolygons[i] = generateUrbanPolygon(4 + rng.random(4), 50 + rng.random(40));
         }
     }
     
@@ -1037,7 +1048,7 @@ private:
         windowPolygons.resize(40); // 複数建物用の窓ポリゴン
         
         for (int i = 0; i < windowPolygons.size(); i++) {
-            windowPolygons[i] = generateUrbanPolygon(3 + ofRandom(2), 3 + ofRandom(5));
+            windowPolygons[i] = generateUrbanPolygon(3 + rng.random(2), 3 + rng.random(5));
         }
     }
     
@@ -1046,10 +1057,10 @@ private:
         
         for (int i = 0; i < vertices; i++) {
             float angle = (i / float(vertices)) * TWO_PI;
-            float radius = baseRadius * (0.7f + ofRandom(0.6f));
+            float radius = baseRadius * (0.7f + rng.random(0.6f));
             
             // 都市的な角張った形状を生成
-            if (ofRandom(1.0f) < 0.3f) {
+            if (rng.random(1.0f) < 0.3f) {
                 radius *= 1.4f; // 時々突出部分を作る
             }
             
@@ -1088,12 +1099,12 @@ private:
         int numBuildings = buildingPolygons.size();
         
         for (int i = 0; i < numBuildings; i++) {
-            float x = (i / float(numBuildings)) * ofGetWidth();
+            float x = (i / float(numBuildings)) * SimViewport::getWidth();
             float height = 50 + ofNoise(i * 0.1f, systemTime * 0.1f) * 150;
-            float width = ofGetWidth() / numBuildings * 0.8f;
+            float width = SimViewport::getWidth() / numBuildings * 0.8f;
             
             ofPushMatrix();
-            ofTranslate(x + width * 0.5f, ofGetHeight() - height * 0.5f);
+            ofTranslate(x + width * 0.5f, SimViewport::getHeight() - height * 0.5f);
             ofScale(width / 100.0f, height / 100.0f);
             
             // 不規則建物ポリゴン描画
@@ -1106,7 +1117,7 @@ private:
             ofPopMatrix();
             
             // 不規則窓ポリゴンの配置
-            drawBuildingWindows(x, ofGetHeight() - height, width, height, i);
+            drawBuildingWindows(x, SimViewport::getHeight() - height, width, height, i);
         }
     }
     
@@ -1119,15 +1130,15 @@ private:
         
         for (int w = 0; w < windowsPerRow; w++) {
             for (int h = 0; h < windowRows; h++) {
-                if (ofRandom(1.0f) < 0.7f) {
+                if (rng.random(1.0f) < 0.7f) {
                     int windowIndex = (buildingIndex * windowsPerRow + w + h) % windowPolygons.size();
                     
-                    float windowX = buildingX + (w / float(windowsPerRow)) * buildingWidth + ofRandom(-5, 5);
-                    float windowY = buildingY + (h / float(windowRows)) * buildingHeight + ofRandom(-3, 3);
+                    float windowX = buildingX + (w / float(windowsPerRow)) * buildingWidth + rng.random(-5, 5);
+                    float windowY = buildingY + (h / float(windowRows)) * buildingHeight + rng.random(-3, 3);
                     
                     ofPushMatrix();
                     ofTranslate(windowX, windowY);
-                    ofScale(0.8f + ofRandom(0.4f), 0.8f + ofRandom(0.4f));
+                    ofScale(0.8f + rng.random(0.4f), 0.8f + rng.random(0.4f));
                     
                     // 不規則窓ポリゴン描画
                     ofBeginShape();
@@ -1145,12 +1156,12 @@ private:
     void drawAtmospherePolygons() {
         // 大気中の不規則形状（汚染物質、雲など）
         for (int i = 0; i < 15; i++) {
-            float x = ofRandom(ofGetWidth());
-            float y = ofRandom(ofGetHeight() * 0.7f);
-            float size = ofRandom(8, 25);
+            float x = rng.random(SimViewport::getWidth());
+            float y = rng.random(SimViewport::getHeight() * 0.7f);
+            float size = rng.random(8, 25);
             
             // 動的な不規則ポリゴン生成
-            std::vector<ofVec2f> atmosphereShape = generateUrbanPolygon(5 + ofRandom(4), size);
+            std::vector<ofVec2f> atmosphereShape = generateUrbanPolygon(5 + rng.random(4), size);
             
             ofPushMatrix();
             ofTranslate(x, y);
@@ -0,0 +1,101 @@
+#include "RenderTargetPool.h"
+#include "AsyncLog.h"
+#include <algorithm>
+
+// 静的メンバ変数の定義
+std::vector<RenderTargetPool::Entry> RenderTargetPool::entries;
+
+RenderTarget RenderTargetPool::acquire(int width, int height, int internalFormat, bool useDepthStencil) {
+    RenderTarget target;
+    for (auto& entry : entries) {
+        if (!entry.isLeased() && entry.width == width && entry.height == height &&
+            entry.internalFormat == internalFormat && entry.useDepthStencil == useDepthStencil) {
+            target = entry.target;
+            break;
+        }
+    }
+    
+    if (!target) {
+        ofFbo::Settings settings;
+        settings.width = width;
+        settings.height = height;
+        settings.internalformat = internalFormat;
+        settings.useDepth = useDepthStencil;
+        settings.useStencil = useDepthStencil;
+        
+        target = std::make_shared<ofFbo>();
+        target->allocate(settings);
+        
+        Entry entry;
+        entry.width = width;
+        entry.height = height;
+        entry.internalFormat = internalFormat;
+        entry.useDepthStencil = useDepthStencil;
+        entry.bytes = (std::size_t)width * height * (bytesPerPixel(internalFormat) + (useDepthStencil ? 4 : 0));
+        entry.target = target;
+        entries.push_back(entry);
+    }
+    
+    // 前の利用者の内容を残さない
+    target->begin();
+    ofClear(0, 0);
+    target->end();
+    return target;
+}
+
+void RenderTargetPool::trim() {
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [](const Entry& entry) { return !entry.isLeased(); }),
+                  entries.end());
+}
+
+void RenderTargetPool::clear() {
+    entries.clear();
+}
+
+std::size_t RenderTargetPool::getNumLeased() {
+    std::size_t count = 0;
+    for (const auto& entry : entries) {
+        if (entry.isLeased()) count++;
+    }
+    return count;
+}
+
+std::size_t RenderTargetPool::getAllocatedBytes() {
+    std::size_t bytes = 0;
+    for (const auto& entry : entries) {
+        bytes += entry.bytes;
+    }
+    return bytes;
+}
+
+std::size_t RenderTargetPool::getLeasedBytes() {
+    std::size_t bytes = 0;
+    for (const auto& entry : entries) {
+        if (entry.isLeased()) bytes += entry.bytes;
+    }
+    return bytes;
+}
+
+void RenderTargetPool::printStats() {
+    MVLOG_INFO(LOG_CATEGORY_RENDER, "Render targets: %zu/%zu leased, %.1f/%.1f MB", getNumLeased(), entries.size(),
+               getLeasedBytes() / (1024.0f * 1024.0f), getAllocatedBytes() / (1024.0f * 1024.0f));
+    for (const auto& entry : entries) {
+        MVLOG_INFO(LOG_CATEGORY_RENDER, "  %dx%d format 0x%x%s %.1f MB%s", entry.width, entry.height, entry.internalFormat,
+                   entry.useDepthStencil ? " +depth/stencil" : "", entry.bytes / (1024.0f * 1024.0f), entry.isLeased() ? " (leased)" : "");
+    }
+}
+
+std::size_t RenderTargetPool::bytesPerPixel(int internalFormat) {
+    switch (internalFormat) {
+        case GL_RGB:
+        case GL_RGB8:
+            return 3;
+        case GL_RGBA16F:
+            return 8;
+        case GL_RGBA32F:
+            return 16;
+        default:
+            return 4;
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "ofMain.h"
+#include <memory>
+#include <vector>
+
+// プールから貸し出されるレンダーターゲット（参照カウント付き）
+// 最後の利用者が手放すとプールの空きに戻る
+typedef std::shared_ptr<ofFbo> RenderTarget;
+
+// サイズ・フォーマットごとにFBOを使い回す共有プール
+// アクティブ（クロスフェード中を含む）なシステムだけがターゲットを保持し、
+// 非アクティブになったら返却する。空きはtrim()で解放する
+class RenderTargetPool {
+public:
+    // 条件に合う空きがあれば再利用、なければ確保する（どちらも透明でクリア済み）
+    static RenderTarget acquire(int width, int height, int internalFormat = GL_RGBA, bool useDepthStencil = false);
+    
+    // 貸し出されていないターゲットを解放（リサイズ後など）
+    static void trim();
+    
+    // 全ターゲットへのプールの参照を外す（終了時、GLコンテキストが有効なうちに呼ぶ）
+    static void clear();
+    
+    static std::size_t getNumTargets() { return entries.size(); }
+    static std::size_t getNumLeased();
+    static std::size_t getAllocatedBytes();
+    static std::size_t getLeasedBytes();
+    static void printStats();
+    
+private:
+    struct Entry {
+        int width;
+        int height;
+        int internalFormat;
+        bool useDepthStencil;
+        std::size_t bytes;
+        RenderTarget target;
+        
+        bool isLeased() const { return target.use_count() > 1; }
+    };
+    
+    static std::size_t bytesPerPixel(int internalFormat);
+    
+    static std::vector<Entry> entries;
+};
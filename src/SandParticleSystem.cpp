@@ -41,12 +41,12 @@ void SandParticleSystem::setup() {
     // 初期砂丘の生成
     for (int i = 0; i < 5; i++) {
         SandDune dune;
-        dune.position.set(ofRandom(ofGetWidth()), ofRandom(ofGetHeight() * 0.7f, ofGetHeight()));
-        dune.width = ofRandom(150, 300);
-        dune.height = ofRandom(30, 80);
-        dune.slope = ofRandom(0.2f, 0.5f);
-        dune.windResistance = ofRandom(0.5f, 0.9f);
-        dune.stability = ofRandom(0.6f, 1.0f);
+        dune.position.set(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight() * 0.7f, SimViewport::getHeight()));
+        dune.width = rng.random(150, 300);
+        dune.height = rng.random(30, 80);
+        dune.slope = rng.random(0.2f, 0.5f);
+        dune.windResistance = rng.random(0.5f, 0.9f);
+        dune.stability = rng.random(0.6f, 1.0f);
         
         // 砂丘プロファイルの生成
         for (int j = 0; j < 20; j++) {
@@ -61,18 +61,18 @@ void SandParticleSystem::setup() {
     // 初期風場の生成
     for (int i = 0; i < 3; i++) {
         WindField field;
-        field.position.set(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
-        field.direction.set(ofRandom(-1, 1), ofRandom(-1, 1));
+        field.position.set(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
+        field.direction.set(rng.random(-1, 1), rng.random(-1, 1));
         field.direction.normalize();
-        field.strength = ofRandom(30, 80);
-        field.turbulence = ofRandom(0.1f, 0.4f);
-        field.radius = ofRandom(150, 300);
+        field.strength = rng.random(30, 80);
+        field.turbulence = rng.random(0.1f, 0.4f);
+        field.radius = rng.random(150, 300);
         windFields.push_back(field);
     }
     
     // 初期粒子の生成
     for (int i = 0; i < 150; i++) {
-        ofVec2f pos(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
+        ofVec2f pos(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
         createSandParticle(pos);
     }
     
@@ -112,20 +112,20 @@ void SandParticleSystem::update(float deltaTime) {
     simulateErosion();
     
     // 既視感パターンの生成
-    if (ofRandom(1.0f) < dejavu_trigger_probability * deltaTime) {
+    if (rng.random(1.0f) < dejavu_trigger_probability * deltaTime) {
         generateDejavuPattern();
     }
     
     // 新しい粒子の生成
-    if (ofRandom(1.0f) < 0.3f * deltaTime) {
-        ofVec2f spawnPos(ofRandom(ofGetWidth()), ofRandom(ofGetHeight() * 0.3f));
-        createSandParticle(spawnPos, ofVec2f(ofRandom(-30, 30), ofRandom(10, 50)));
+    if (rng.random(1.0f) < 0.3f * deltaTime) {
+        ofVec2f spawnPos(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight() * 0.3f));
+        createSandParticle(spawnPos, ofVec2f(rng.random(-30, 30), rng.random(10, 50)));
     }
     
     // パターンの自動生成
-    if (ofRandom(1.0f) < patternSpawnRate * deltaTime) {
-        ofVec2f patternCenter(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
-        int patternType = (int)ofRandom(3);
+    if (rng.random(1.0f) < patternSpawnRate * deltaTime) {
+        ofVec2f patternCenter(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
+        int patternType = (int)rng.random(3);
         
         switch (patternType) {
             case 0: createFractalPattern(patternCenter, patternScale, 3); break;
@@ -135,10 +135,10 @@ void SandParticleSystem::update(float deltaTime) {
     }
     
     // MIDI連動強度の減衰
-    kickIntensity *= 0.88f;
-    snareIntensity *= 0.85f;
-    hihatIntensity *= 0.90f;
-    crashIntensity *= 0.82f;
+    kickIntensity *= frameDecay(0.88f, deltaTime);
+    snareIntensity *= frameDecay(0.85f, deltaTime);
+    hihatIntensity *= frameDecay(0.90f, deltaTime);
+    crashIntensity *= frameDecay(0.82f, deltaTime);
     
     // 成長レベルに基づく環境調整
     dustStormIntensity = globalGrowthLevel * 0.5f;
@@ -175,17 +175,18 @@ void SandParticleSystem::draw() {
 void SandParticleSystem::createSandParticle(ofVec2f position, ofVec2f velocity) {
     SandParticle particle;
     particle.position = position;
+    particle.previousPosition = position;
     particle.velocity = velocity;
     particle.acceleration.set(0, 0);
-    particle.life = ofRandom(3.0f, 8.0f);
+    particle.life = rng.random(3.0f, 8.0f);
     particle.maxLife = particle.life;
-    particle.size = ofRandom(1.0f, 3.0f);
-    particle.mass = ofRandom(0.8f, 1.2f);
+    particle.size = rng.random(1.0f, 3.0f);
+    particle.mass = rng.random(0.8f, 1.2f);
     particle.alpha = 255.0f;
     particle.isActive = true;
     
     // 色のバリエーション
-    int colorChoice = (int)ofRandom(3);
+    int colorChoice = (int)rng.random(3);
     switch (colorChoice) {
         case 0: particle.particleColor = sandDark; break;
         case 1: particle.particleColor = sandMedium; break;
@@ -197,11 +198,11 @@ void SandParticleSystem::createSandParticle(ofVec2f position, ofVec2f velocity)
 
 void SandParticleSystem::createParticleCluster(ofVec2f center, int count, float spread) {
     for (int i = 0; i < count; i++) {
-        float angle = ofRandom(TWO_PI);
-        float distance = ofRandom(0, spread);
+        float angle = rng.random(TWO_PI);
+        float distance = rng.random(0, spread);
         ofVec2f pos = center + ofVec2f(cos(angle) * distance, sin(angle) * distance);
         
-        ofVec2f vel(ofRandom(-20, 20), ofRandom(-30, 10));
+        ofVec2f vel(rng.random(-20, 20), rng.random(-30, 10));
         createSandParticle(pos, vel);
     }
 }
@@ -215,6 +216,7 @@ void SandParticleSystem::updateParticles(float deltaTime) {
             particle.isActive = false;
             continue;
         }
+        particle.previousPosition = particle.position;
         
         // 重力の適用
         particle.acceleration.y += gravityStrength * deltaTime;
@@ -235,8 +237,8 @@ void SandParticleSystem::updateParticles(float deltaTime) {
         particle.acceleration.set(0, 0);
         
         // 地面との衝突
-        if (particle.position.y > ofGetHeight()) {
-            particle.position.y = ofGetHeight();
+        if (particle.position.y > SimViewport::getHeight()) {
+            particle.position.y = SimViewport::getHeight();
             particle.velocity.y *= -0.3f;
             particle.velocity.x *= frictionCoefficient;
         }
@@ -245,8 +247,8 @@ void SandParticleSystem::updateParticles(float deltaTime) {
         if (particle.position.x < 0) {
             particle.position.x = 0;
             particle.velocity.x *= -0.5f;
-        } else if (particle.position.x > ofGetWidth()) {
-            particle.position.x = ofGetWidth();
+        } else if (particle.position.x > SimViewport::getWidth()) {
+            particle.position.x = SimViewport::getWidth();
             particle.velocity.x *= -0.5f;
         }
         
@@ -287,14 +289,14 @@ void SandParticleSystem::updateDunes(float deltaTime) {
         if (dune.stability < 0.3f) {
             // 不安定な砂丘から粒子を放出
             for (int i = 0; i < 5; i++) {
-                ofVec2f emitPos = dune.position + ofVec2f(ofRandom(-dune.width * 0.5f, dune.width * 0.5f), 0);
-                createSandParticle(emitPos, ofVec2f(ofRandom(-50, 50), ofRandom(-30, 0)));
+                ofVec2f emitPos = dune.position + ofVec2f(rng.random(-dune.width * 0.5f, dune.width * 0.5f), 0);
+                createSandParticle(emitPos, ofVec2f(rng.random(-50, 50), rng.random(-30, 0)));
             }
         }
         
         // 砂丘の境界制限
-        dune.position.x = ofClamp(dune.position.x, 50, ofGetWidth() - 50);
-        dune.position.y = ofClamp(dune.position.y, ofGetHeight() * 0.5f, ofGetHeight() - 20);
+        dune.position.x = ofClamp(dune.position.x, 50, SimViewport::getWidth() - 50);
+        dune.position.y = ofClamp(dune.position.y, SimViewport::getHeight() * 0.5f, SimViewport::getHeight() - 20);
     }
 }
 
@@ -302,7 +304,7 @@ void SandParticleSystem::updatePatterns(float deltaTime) {
     for (auto& pattern : patterns) {
         if (!pattern.isActive) continue;
         
-        float age = ofGetElapsedTimef() - pattern.creationTime;
+        float age = SimViewport::getElapsedTimef() - pattern.creationTime;
         if (age > pattern.lifetime) {
             pattern.isActive = false;
             continue;
@@ -328,28 +330,28 @@ void SandParticleSystem::updatePatterns(float deltaTime) {
 void SandParticleSystem::updateWindFields(float deltaTime) {
     for (auto& field : windFields) {
         // 風向きの変化
-        float directionChange = ofNoise(ofGetElapsedTimef() * 0.3f, field.position.x * 0.001f) * 0.2f - 0.1f;
+        float directionChange = ofNoise(SimViewport::getElapsedTimef() * 0.3f, field.position.x * 0.001f) * 0.2f - 0.1f;
         field.direction.rotate(directionChange);
         
         // 風力の変化
-        field.strength += sin(ofGetElapsedTimef() * 0.7f + field.position.y * 0.001f) * 10.0f * deltaTime;
+        field.strength += sin(SimViewport::getElapsedTimef() * 0.7f + field.position.y * 0.001f) * 10.0f * deltaTime;
         field.strength = ofClamp(field.strength, 20.0f, 100.0f);
         
         // 乱流の更新
-        field.turbulence = 0.2f + ofNoise(ofGetElapsedTimef() * 0.5f, field.position.x * 0.002f) * 0.3f;
+        field.turbulence = 0.2f + ofNoise(SimViewport::getElapsedTimef() * 0.5f, field.position.x * 0.002f) * 0.3f;
         
         // 風場の移動
         field.position.x += field.direction.x * 20.0f * deltaTime;
         field.position.y += field.direction.y * 10.0f * deltaTime;
         
         // 境界での反射
-        if (field.position.x < 0 || field.position.x > ofGetWidth()) {
+        if (field.position.x < 0 || field.position.x > SimViewport::getWidth()) {
             field.direction.x *= -1;
-            field.position.x = ofClamp(field.position.x, 0, ofGetWidth());
+            field.position.x = ofClamp(field.position.x, 0, SimViewport::getWidth());
         }
-        if (field.position.y < 0 || field.position.y > ofGetHeight()) {
+        if (field.position.y < 0 || field.position.y > SimViewport::getHeight()) {
             field.direction.y *= -1;
-            field.position.y = ofClamp(field.position.y, 0, ofGetHeight());
+            field.position.y = ofClamp(field.position.y, 0, SimViewport::getHeight());
         }
     }
 }
@@ -365,8 +367,8 @@ void SandParticleSystem::applyWindForce(SandParticle& particle, float deltaTime)
             ofVec2f windForce = field.direction * windEffect;
             
             // 乱流効果
-            float turbulenceX = ofNoise(particle.position.x * 0.01f, ofGetElapsedTimef() * 2.0f) * 2.0f - 1.0f;
-            float turbulenceY = ofNoise(particle.position.y * 0.01f, ofGetElapsedTimef() * 2.0f + 100) * 2.0f - 1.0f;
+            float turbulenceX = ofNoise(particle.position.x * 0.01f, SimViewport::getElapsedTimef() * 2.0f) * 2.0f - 1.0f;
+            float turbulenceY = ofNoise(particle.position.y * 0.01f, SimViewport::getElapsedTimef() * 2.0f + 100) * 2.0f - 1.0f;
             windForce += ofVec2f(turbulenceX, turbulenceY) * field.turbulence * windEffect;
             
             particle.acceleration += windForce * deltaTime;
@@ -411,16 +413,17 @@ void SandParticleSystem::drawParticles() {
     for (const auto& particle : particles) {
         if (!particle.isActive) continue;
         
-        ofSetColor(particle.particleColor.r, particle.particleColor.g, particle.particleColor.b, particle.alpha);
-        ofDrawCircle(particle.position.x, particle.position.y, particle.size);
+        ofVec2f position = interpolate(particle.previousPosition, particle.position);
+        sprites.addCircle(position, particle.size, particle.particleColor, particle.alpha);
         
         // 高速移動時の軌跡エフェクト
         if (particle.velocity.length() > 20.0f) {
-            ofSetColor(particle.particleColor.r, particle.particleColor.g, particle.particleColor.b, particle.alpha * 0.3f);
-            ofVec2f trailEnd = particle.position - particle.velocity.getNormalized() * 10.0f;
-            ofDrawLine(particle.position.x, particle.position.y, trailEnd.x, trailEnd.y);
+            ofVec2f trailEnd = position - particle.velocity.getNormalized() * 10.0f;
+            lines.addLine(position, trailEnd, 2.0f, particle.particleColor, particle.alpha * 0.3f);  // 既視感パターンと同じ太さ
         }
     }
+    lines.draw();
+    sprites.draw();
 }
 
 void SandParticleSystem::drawDunes() {
@@ -479,7 +482,7 @@ void SandParticleSystem::drawPatterns() {
         // 既視感効果のための重複描画
         ofSetColor(pattern.elementColor.r, pattern.elementColor.g, pattern.elementColor.b, pattern.alpha * 0.5f);
         ofPushMatrix();
-        ofTranslate(sin(ofGetElapsedTimef() * 2.0f) * 3.0f, cos(ofGetElapsedTimef() * 1.5f) * 2.0f);
+        ofTranslate(sin(SimViewport::getElapsedTimef() * 2.0f) * 3.0f, cos(SimViewport::getElapsedTimef() * 1.5f) * 2.0f);
         ofScale(0.95f, 0.95f);
         if (pattern.points.size() > 2) {
             ofBeginShape();
@@ -541,17 +544,17 @@ void SandParticleSystem::generateDejavuPattern() {
     if (dejavu_patterns.empty()) return;
     
     PatternElement pattern;
-    pattern.center.set(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
-    pattern.creationTime = ofGetElapsedTimef();
-    pattern.lifetime = ofRandom(4.0f, 8.0f);
-    pattern.scale = ofRandom(0.5f, 1.5f);
-    pattern.rotation = ofRandom(TWO_PI);
-    pattern.elementColor = ofColor(120 + ofRandom(-30, 30), 120 + ofRandom(-30, 30), 120 + ofRandom(-30, 30));
+    pattern.center.set(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
+    pattern.creationTime = SimViewport::getElapsedTimef();
+    pattern.lifetime = rng.random(4.0f, 8.0f);
+    pattern.scale = rng.random(0.5f, 1.5f);
+    pattern.rotation = rng.random(TWO_PI);
+    pattern.elementColor = ofColor(120 + rng.random(-30, 30), 120 + rng.random(-30, 30), 120 + rng.random(-30, 30));
     pattern.alpha = 255.0f;
     pattern.isActive = true;
     
     // 既視感パターンから選択
-    int patternIndex = (int)ofRandom(dejavu_patterns.size());
+    int patternIndex = (int)rng.random(dejavu_patterns.size());
     pattern.points = dejavu_patterns[patternIndex];
     
     patterns.push_back(pattern);
@@ -562,10 +565,10 @@ void SandParticleSystem::createFractalPattern(ofVec2f center, float scale, int d
     
     PatternElement pattern;
     pattern.center = center;
-    pattern.creationTime = ofGetElapsedTimef();
-    pattern.lifetime = ofRandom(5.0f, 10.0f);
+    pattern.creationTime = SimViewport::getElapsedTimef();
+    pattern.lifetime = rng.random(5.0f, 10.0f);
     pattern.scale = 1.0f;
-    pattern.rotation = ofRandom(TWO_PI);
+    pattern.rotation = rng.random(TWO_PI);
     pattern.elementColor = sandLight;
     pattern.alpha = 255.0f;
     pattern.isActive = true;
@@ -591,8 +594,8 @@ void SandParticleSystem::createFractalPattern(ofVec2f center, float scale, int d
 void SandParticleSystem::createSpiraPattern(ofVec2f center, float radius, int arms) {
     PatternElement pattern;
     pattern.center = center;
-    pattern.creationTime = ofGetElapsedTimef();
-    pattern.lifetime = ofRandom(6.0f, 12.0f);
+    pattern.creationTime = SimViewport::getElapsedTimef();
+    pattern.lifetime = rng.random(6.0f, 12.0f);
     pattern.scale = 1.0f;
     pattern.rotation = 0.0f;
     pattern.elementColor = sandMedium;
@@ -616,8 +619,8 @@ void SandParticleSystem::createSpiraPattern(ofVec2f center, float radius, int ar
 void SandParticleSystem::createMandalaPatter(ofVec2f center, float radius, int segments) {
     PatternElement pattern;
     pattern.center = center;
-    pattern.creationTime = ofGetElapsedTimef();
-    pattern.lifetime = ofRandom(8.0f, 15.0f);
+    pattern.creationTime = SimViewport::getElapsedTimef();
+    pattern.lifetime = rng.random(8.0f, 15.0f);
     pattern.scale = 1.0f;
     pattern.rotation = 0.0f;
     pattern.elementColor = sandDark;
@@ -676,7 +679,7 @@ void SandParticleSystem::onMidiMessage(ofxMidiMessage& msg) {
             kickIntensity = velocity;
             
             // 強力な粒子クラスターを生成
-            ofVec2f kickPos(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
+            ofVec2f kickPos(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
             createParticleCluster(kickPos, 30 * velocity, 80.0f * velocity);
         }
         else if (note == 38) {  // SNARE
@@ -689,7 +692,7 @@ void SandParticleSystem::onMidiMessage(ofxMidiMessage& msg) {
             
             // 複数の小さなクラスターを生成
             for (int i = 0; i < 3; i++) {
-                ofVec2f snarePos(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
+                ofVec2f snarePos(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
                 createParticleCluster(snarePos, 15 * velocity, 40.0f * velocity);
             }
         }
@@ -698,8 +701,8 @@ void SandParticleSystem::onMidiMessage(ofxMidiMessage& msg) {
             
             // 細かい粒子を連続生成
             for (int i = 0; i < 10; i++) {
-                ofVec2f hihatPos(ofRandom(ofGetWidth()), ofRandom(ofGetHeight() * 0.5f));
-                createSandParticle(hihatPos, ofVec2f(ofRandom(-20, 20), ofRandom(-10, 10)));
+                ofVec2f hihatPos(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight() * 0.5f));
+                createSandParticle(hihatPos, ofVec2f(rng.random(-20, 20), rng.random(-10, 10)));
             }
         }
         else if (note == 49) {  // CRASH
@@ -721,8 +724,8 @@ void SandParticleSystem::onMidiMessage(ofxMidiMessage& msg) {
             
             // 大量の粒子を生成
             for (int i = 0; i < 50; i++) {
-                ofVec2f crashPos(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
-                createSandParticle(crashPos, ofVec2f(ofRandom(-100, 100), ofRandom(-50, 50)));
+                ofVec2f crashPos(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
+                createSandParticle(crashPos, ofVec2f(rng.random(-100, 100), rng.random(-50, 50)));
             }
         }
     }
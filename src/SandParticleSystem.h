@@ -7,6 +7,7 @@
 
 struct SandParticle {
     ofVec2f position;
+    ofVec2f previousPosition;   // 直前のステップ開始時の位置（描画の補間用）
     ofVec2f velocity;
     ofVec2f acceleration;
     float life;
@@ -17,7 +18,7 @@ struct SandParticle {
     bool isActive;
     ofColor particleColor;
     
-    SandParticle() : position(0, 0), velocity(0, 0), acceleration(0, 0), life(1.0f), maxLife(1.0f), 
+    SandParticle() : position(0, 0), previousPosition(0, 0), velocity(0, 0), acceleration(0, 0), life(1.0f), maxLife(1.0f), 
                     size(1.0f), mass(1.0f), alpha(255.0f), isActive(true), particleColor(120, 120, 120) {}
 };
 
@@ -132,6 +133,9 @@ private:
     void cleanupInactiveElements();
     
 public:
+    // 要素はすべて値で持つことを確かめた（PipelinedSystemで状態を丸ごとコピーしてよい）
+    static constexpr bool SNAPSHOT_COPYABLE = true;
+    
     SandParticleSystem();
     void setup() override;
     void update(float deltaTime) override;
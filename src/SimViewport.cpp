@@ -0,0 +1,9 @@
+#include "SimViewport.h"
+
+// 静的メンバ変数の定義
+bool SimViewport::headless = false;
+bool SimViewport::fixedClock = false;
+int SimViewport::virtualWidth = 1920;
+int SimViewport::virtualHeight = 1080;
+int64_t SimViewport::virtualMicros = 0;
+double SimViewport::wallClockOffset = 0.0;
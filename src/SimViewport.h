@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ofMain.h"
+
+// シミュレーション用のビューポートとクロック
+// 通常はウィンドウのサイズ・経過時間をそのまま返す
+// 固定クロック時は advance() でのみ進む仮想時計を返す（高速リプレイ・ヘッドレス用）
+// 仮想時計は整数のマイクロ秒で、1ステップも整数に丸めて足す（セッションの再生位置と同じ刻みで、長時間でも誤差が溜まらない）
+// ヘッドレス時はさらに仮想サイズを返し、GL資源は確保しない
+class SimViewport {
+public:
+    static int getWidth() { return headless ? virtualWidth : ofGetWidth(); }
+    static int getHeight() { return headless ? virtualHeight : ofGetHeight(); }
+    static float getElapsedTimef() { return (float)getElapsedTime(); }
+    // 同じ時間軸の倍精度版（長時間の実行でもサブミリ秒の差を保つ。テンポ推定用）
+    static double getElapsedTime() { return fixedClock ? virtualMicros / 1000000.0 : ofGetElapsedTimeMicros() / 1000000.0 + wallClockOffset; }
+    static bool isHeadless() { return headless; }
+    static bool isFixedClock() { return fixedClock; }
+    
+    // ヘッドレスモードの開始（ウィンドウ・GLなし、時計は0から）
+    static void setHeadless(int width, int height) {
+        headless = true;
+        fixedClock = true;
+        virtualWidth = width;
+        virtualHeight = height;
+        virtualMicros = 0;
+    }
+    
+    // 固定クロックの切替（切替前後で時刻が連続するようにする）
+    static void setFixedClock(bool enabled) {
+        if (enabled == fixedClock) return;
+        if (enabled) {
+            virtualMicros = std::llround(getElapsedTime() * 1000000.0);
+        } else {
+            wallClockOffset = (virtualMicros - (int64_t)ofGetElapsedTimeMicros()) / 1000000.0;
+        }
+        fixedClock = enabled;
+    }
+    
+    // 固定クロックを指定時刻から開始（オフラインレンダー用、setup前に呼ぶと実行ごとに同じ時刻列になる）
+    static void startFixedClock(double startTime) {
+        fixedClock = true;
+        virtualMicros = std::llround(startTime * 1000000.0);
+    }
+    
+    // 仮想時計を1ステップ進める（固定クロック時のみ有効）
+    static void advance(double deltaTime) {
+        virtualMicros += toStepMicros(deltaTime);
+    }
+    
+    // 固定dtの1ステップのマイクロ秒（MidiSessionPlayerの固定ステップ再生も同じ値で進める）
+    static int64_t toStepMicros(double deltaTime) {
+        return std::llround(deltaTime * 1000000.0);
+    }
+    
+private:
+    static bool headless;
+    static bool fixedClock;
+    static int virtualWidth;
+    static int virtualHeight;
+    static int64_t virtualMicros;
+    static double wallClockOffset;   // 固定クロックを抜けたときの実時間とのずれ（秒）
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "ofMain.h"
+#include "MidiEventQueue.h"
+#include "FrameProfiler.h"
+#include "VisualSystem.h"
+#include "WorkerPool.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 次フレームのシミュレーションを、描画スレッドが今のフレームを描いている間にワーカーで回す
+// 描画スレッド: フレーム頭でwait() → スナップショットを公開 → MIDI適用 → submit()
+// ワーカースレッド: 渡されたシステムのupdate()をステップ数だけ実行し、最後に1回captureSnapshot()する
+//   （描画側は公開済みのスナップショットだけを読む）
+//   プールを渡すと、クロスフェード中の2システムなど複数のジョブを並列に回す
+// ワーカーが動いている間、描画スレッドは投入したシステムに触れない（キー入力などの前にもwait()する）
+class SimulationPipeline {
+public:
+    struct Job {
+        VisualSystem* system = nullptr;
+        std::size_t index = 0;       // ビジュアルシステムの番号（品質ガバナーのエントリ）
+        const char* name = "update"; // プロファイラのゾーン名（静的な文字列）
+        float deltaTime = 0.0f;      // 固定ステップの刻み
+        int steps = 1;               // このフレームに進めるステップ数
+        uint64_t costMicros = 0;     // 実行後に書き込まれる
+    };
+
+    ~SimulationPipeline() { stop(); }
+    
+    // ジョブを実行してコストを書き込む（プールがあれば並列、なければ順に）。返り値は全体の経過時間
+    static uint64_t runJobs(std::vector<Job>& jobs, WorkerPool* pool) {
+        uint64_t runStart = midiNowMicros();
+        auto runJob = [&jobs](std::size_t i) {
+            PROFILE_ZONE(jobs[i].name);
+            uint64_t jobStart = midiNowMicros();
+            for (int step = 0; step < jobs[i].steps; step++) {
+                jobs[i].system->update(jobs[i].deltaTime);
+            }
+            // 追いつきで複数ステップ進めても、状態のコピーはフレームに1回
+            if (jobs[i].steps > 0) {
+                jobs[i].system->captureSnapshot();
+            }
+            jobs[i].costMicros = midiNowMicros() - jobStart;
+        };
+        if (pool) {
+            pool->run(jobs.size(), runJob);
+        } else {
+            for (std::size_t i = 0; i < jobs.size(); i++) {
+                runJob(i);
+            }
+        }
+        return midiNowMicros() - runStart;
+    }
+    
+    void setWorkerPool(WorkerPool* workerPool) { pool = workerPool; }
+
+    void start() {
+        if (worker.joinable()) return;
+        stopping = false;
+        worker = std::thread(&SimulationPipeline::workerLoop, this);
+    }
+
+    void stop() {
+        if (!worker.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeCondition.notify_all();
+        worker.join();
+    }
+
+    // 描画スレッド: 今フレームのジョブを渡して即座に戻る（前のジョブはwait()済みであること）
+    void submit(const std::vector<Job>& newJobs) {
+        if (newJobs.empty()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs = newJobs;
+            busy = true;
+        }
+        wakeCondition.notify_one();
+    }
+
+    // 描画スレッド: 投入済みのジョブが終わるまで待つ。待った時間（マイクロ秒）を返す
+    uint64_t wait() {
+        uint64_t waitStart = midiNowMicros();
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCondition.wait(lock, [this]() { return !busy; });
+        return midiNowMicros() - waitStart;
+    }
+
+    // wait()後に読む。直前に完了したジョブ（コスト付き）
+    const std::vector<Job>& getCompletedJobs() const { return jobs; }
+    uint64_t getCompletedWallMicros() const { return wallMicros; }
+    void clearCompletedJobs() {
+        jobs.clear();
+        wallMicros = 0;
+    }
+
+private:
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wakeCondition.wait(lock, [this]() { return busy || stopping; });
+            if (!busy) break;  // 停止要求（投入済みのジョブは先に終わらせる）
+
+            // ジョブ列は描画スレッドがwait()するまで書き換えられない
+            lock.unlock();
+            uint64_t elapsed = runJobs(jobs, pool);
+            lock.lock();
+            wallMicros = elapsed;
+
+            busy = false;
+            doneCondition.notify_all();
+        }
+    }
+
+    std::vector<Job> jobs;
+    WorkerPool* pool = nullptr;
+    uint64_t wallMicros = 0;
+    bool busy = false;
+    bool stopping = false;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+    std::thread worker;
+};
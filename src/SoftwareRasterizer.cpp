@@ -0,0 +1,499 @@
+#include "SoftwareRasterizer.h"
+#include "FrameProfiler.h"
+#include <thread>
+
+// === 1ピクセル（RGBA）を1本のベクトルで扱う ===
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+
+typedef __m128 Pixel4;
+
+static inline Pixel4 loadPixel(const float* p) { return _mm_loadu_ps(p); }
+static inline void storePixel(float* p, Pixel4 v) { _mm_storeu_ps(p, v); }
+
+// clamp(dst * m + s, 0, 1)
+static inline Pixel4 blendPixel(Pixel4 dst, Pixel4 m, Pixel4 s) {
+    Pixel4 result = _mm_add_ps(_mm_mul_ps(dst, m), s);
+    return _mm_min_ps(_mm_max_ps(result, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+
+typedef float32x4_t Pixel4;
+
+static inline Pixel4 loadPixel(const float* p) { return vld1q_f32(p); }
+static inline void storePixel(float* p, Pixel4 v) { vst1q_f32(p, v); }
+
+static inline Pixel4 blendPixel(Pixel4 dst, Pixel4 m, Pixel4 s) {
+    Pixel4 result = vmlaq_f32(s, dst, m);
+    return vminq_f32(vmaxq_f32(result, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f));
+}
+#else
+struct Pixel4 {
+    float v[4];
+};
+
+static inline Pixel4 loadPixel(const float* p) { return Pixel4{{p[0], p[1], p[2], p[3]}}; }
+static inline void storePixel(float* p, Pixel4 pixel) {
+    for (int i = 0; i < 4; i++) p[i] = pixel.v[i];
+}
+
+static inline Pixel4 blendPixel(Pixel4 dst, Pixel4 m, Pixel4 s) {
+    Pixel4 result;
+    for (int i = 0; i < 4; i++) {
+        result.v[i] = std::min(std::max(dst.v[i] * m.v[i] + s.v[i], 0.0f), 1.0f);
+    }
+    return result;
+}
+#endif
+
+// dst = dst * m + s の係数（OFのブレンド係数の式を並べ替えたもの）
+struct BlendTerms {
+    float m[4];
+    float s[4];
+};
+
+// coverageは形の縁の覆い率（ソースのアルファに掛ける、シェーダーの出力と同じ）
+static void makeBlendTerms(ofBlendMode mode, const float* color, float coverage, BlendTerms& terms) {
+    float r = color[0], g = color[1], b = color[2];
+    float a = color[3] * coverage;
+
+    switch (mode) {
+        case OF_BLENDMODE_ALPHA: {
+            // (SRC_ALPHA, ONE_MINUS_SRC_ALPHA)、アルファは(ONE, ONE_MINUS_SRC_ALPHA)
+            float k = 1.0f - a;
+            float m[4] = {k, k, k, k};
+            float s[4] = {r * a, g * a, b * a, a};
+            std::copy(m, m + 4, terms.m);
+            std::copy(s, s + 4, terms.s);
+            break;
+        }
+        case OF_BLENDMODE_ADD:
+        case OF_BLENDMODE_SUBTRACT: {
+            // (SRC_ALPHA, ONE)、減算は逆向きの減算
+            float sign = mode == OF_BLENDMODE_ADD ? 1.0f : -1.0f;
+            float s[4] = {r * a * sign, g * a * sign, b * a * sign, a * a * sign};
+            std::fill(terms.m, terms.m + 4, 1.0f);
+            std::copy(s, s + 4, terms.s);
+            break;
+        }
+        case OF_BLENDMODE_MULTIPLY: {
+            // (DST_COLOR, ONE_MINUS_SRC_ALPHA)
+            float k = 1.0f - a;
+            float m[4] = {r + k, g + k, b + k, a + k};
+            std::copy(m, m + 4, terms.m);
+            std::fill(terms.s, terms.s + 4, 0.0f);
+            break;
+        }
+        case OF_BLENDMODE_SCREEN: {
+            // (ONE_MINUS_DST_COLOR, ONE)
+            float m[4] = {1.0f - r, 1.0f - g, 1.0f - b, 1.0f - a};
+            float s[4] = {r, g, b, a};
+            std::copy(m, m + 4, terms.m);
+            std::copy(s, s + 4, terms.s);
+            break;
+        }
+        default: {
+            // ブレンドなし: そのまま書く
+            float s[4] = {r, g, b, a};
+            std::fill(terms.m, terms.m + 4, 0.0f);
+            std::copy(s, s + 4, terms.s);
+            break;
+        }
+    }
+}
+
+// 同じ係数でcount個のピクセルを塗る
+static void blendSpan(float* dst, int count, const BlendTerms& terms) {
+    Pixel4 m = loadPixel(terms.m);
+    Pixel4 s = loadPixel(terms.s);
+    for (int i = 0; i < count; i++, dst += 4) {
+        storePixel(dst, blendPixel(loadPixel(dst), m, s));
+    }
+}
+
+static void blendOne(float* dst, const BlendTerms& terms) {
+    storePixel(dst, blendPixel(loadPixel(dst), loadPixel(terms.m), loadPixel(terms.s)));
+}
+
+// 画素の中心（+0.5）がcoordinate以上になる最初のピクセル（[from, to)の範囲は[first(from), first(to))）
+// 画面から大きく外れた座標はintに収まるように丸める
+static inline int firstPixelAt(float coordinate) {
+    return (int)ceilf(ofClamp(coordinate, -1.0e6f, 1.0e6f) - 0.5f);
+}
+
+static inline float smoothStep(float edge0, float edge1, float x) {
+    float t = ofClamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+    return t * t * (3.0f - 2.0f * t);
+}
+
+void SoftwareRasterizer::setTarget(ofFloatPixels& pixels) {
+    if (target == &pixels) return;
+    flush();
+    target = &pixels;
+}
+
+void SoftwareRasterizer::setNumWorkers(int numWorkers) {
+    requestedWorkers = std::max(0, numWorkers);
+    if (workersStarted) {
+        workers.start(requestedWorkers);
+    }
+}
+
+bool SoftwareRasterizer::setBounds(Primitive& primitive, float minX, float minY, float maxX, float maxY) const {
+    if (!target) return false;
+    primitive.minX = std::max(firstPixelAt(minX), 0);
+    primitive.minY = std::max(firstPixelAt(minY), 0);
+    primitive.maxX = std::min(firstPixelAt(maxX), (int)target->getWidth());
+    primitive.maxY = std::min(firstPixelAt(maxY), (int)target->getHeight());
+    return primitive.minX < primitive.maxX && primitive.minY < primitive.maxY;
+}
+
+SoftwareRasterizer::Primitive& SoftwareRasterizer::beginPrimitive(PrimitiveKind kind, const ofFloatColor& color) {
+    primitives.emplace_back();
+    Primitive& primitive = primitives.back();
+    primitive.kind = kind;
+    primitive.blendMode = blendMode;
+    primitive.color[0] = color.r;
+    primitive.color[1] = color.g;
+    primitive.color[2] = color.b;
+    primitive.color[3] = color.a;
+    std::fill(primitive.colorDx, primitive.colorDx + 4, 0.0f);
+    std::fill(primitive.colorDy, primitive.colorDy + 4, 0.0f);
+    primitive.shaded = false;
+    primitive.fillRule = RASTER_FILL_ODD;
+    primitive.firstEdge = edges.size();
+    primitive.numEdges = 0;
+    return primitive;
+}
+
+void SoftwareRasterizer::addEdge(const ofVec2f& from, const ofVec2f& to) {
+    // 水平な辺は画素の中心の行と交わらない
+    if (from.y == to.y) return;
+    Edge edge;
+    bool downward = from.y < to.y;
+    const ofVec2f& top = downward ? from : to;
+    const ofVec2f& bottom = downward ? to : from;
+    edge.x0 = top.x;
+    edge.y0 = top.y;
+    edge.y1 = bottom.y;
+    edge.slope = (bottom.x - top.x) / (bottom.y - top.y);
+    edge.winding = downward ? 1 : -1;
+    edges.push_back(edge);
+}
+
+void SoftwareRasterizer::clear(const ofFloatColor& color) {
+    if (!target) return;
+    ofBlendMode previous = blendMode;
+    blendMode = OF_BLENDMODE_DISABLED;
+    fillRect(0, 0, target->getWidth(), target->getHeight(), color);
+    blendMode = previous;
+}
+
+void SoftwareRasterizer::fillRect(float x, float y, float width, float height, const ofFloatColor& color) {
+    Primitive& primitive = beginPrimitive(PRIMITIVE_RECT, color);
+    float x0 = std::min(x, x + width);
+    float y0 = std::min(y, y + height);
+    if (!setBounds(primitive, x0, y0, x0 + fabsf(width), y0 + fabsf(height))) {
+        primitives.pop_back();
+    }
+}
+
+void SoftwareRasterizer::fillTriangle(const ofVec2f& a, const ofVec2f& b, const ofVec2f& c,
+                                      const ofFloatColor& colorA, const ofFloatColor& colorB, const ofFloatColor& colorC) {
+    float det = (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+    if (fabsf(det) < 1e-8f) return;
+
+    Primitive& primitive = beginPrimitive(PRIMITIVE_POLYGON, colorA);
+    if (!setBounds(primitive, std::min({a.x, b.x, c.x}), std::min({a.y, b.y, c.y}),
+                   std::max({a.x, b.x, c.x}), std::max({a.y, b.y, c.y}))) {
+        primitives.pop_back();
+        return;
+    }
+
+    // 色の平面 color(x, y) = color + colorDx * x + colorDy * y
+    if (colorA != colorB || colorA != colorC) {
+        float ca[4] = {colorA.r, colorA.g, colorA.b, colorA.a};
+        float cb[4] = {colorB.r, colorB.g, colorB.b, colorB.a};
+        float cc[4] = {colorC.r, colorC.g, colorC.b, colorC.a};
+        for (int i = 0; i < 4; i++) {
+            float db = cb[i] - ca[i];
+            float dc = cc[i] - ca[i];
+            primitive.colorDx[i] = (db * (c.y - a.y) - dc * (b.y - a.y)) / det;
+            primitive.colorDy[i] = (dc * (b.x - a.x) - db * (c.x - a.x)) / det;
+            primitive.color[i] = ca[i] - primitive.colorDx[i] * a.x - primitive.colorDy[i] * a.y;
+        }
+        primitive.shaded = true;
+    }
+
+    addEdge(a, b);
+    addEdge(b, c);
+    addEdge(c, a);
+    primitive.numEdges = edges.size() - primitive.firstEdge;
+}
+
+void SoftwareRasterizer::fillPolygon(const std::vector<std::vector<ofVec2f>>& contours, const ofFloatColor& color,
+                                     RasterFillRule rule) {
+    Primitive& primitive = beginPrimitive(PRIMITIVE_POLYGON, color);
+    primitive.fillRule = rule;
+
+    float minX = std::numeric_limits<float>::max();
+    float minY = minX;
+    float maxX = -minX;
+    float maxY = -minX;
+    for (const auto& contour : contours) {
+        for (std::size_t i = 0; i < contour.size(); i++) {
+            const ofVec2f& point = contour[i];
+            minX = std::min(minX, point.x);
+            minY = std::min(minY, point.y);
+            maxX = std::max(maxX, point.x);
+            maxY = std::max(maxY, point.y);
+            addEdge(point, contour[(i + 1) % contour.size()]);
+        }
+    }
+    primitive.numEdges = edges.size() - primitive.firstEdge;
+
+    if (primitive.numEdges < 2 || !setBounds(primitive, minX, minY, maxX, maxY)) {
+        edges.resize(primitive.firstEdge);
+        primitives.pop_back();
+    }
+}
+
+void SoftwareRasterizer::fillEllipse(const ofVec2f& center, const ofVec2f& axisX, const ofVec2f& axisY, const ofFloatColor& color) {
+    float det = axisX.x * axisY.y - axisY.x * axisX.y;
+    if (fabsf(det) < 1e-8f) return;
+
+    Primitive& primitive = beginPrimitive(PRIMITIVE_ELLIPSE, color);
+    float extentX = sqrtf(axisX.x * axisX.x + axisY.x * axisY.x);
+    float extentY = sqrtf(axisX.y * axisX.y + axisY.y * axisY.y);
+    if (!setBounds(primitive, center.x - extentX, center.y - extentY, center.x + extentX, center.y + extentY)) {
+        primitives.pop_back();
+        return;
+    }
+
+    // 画面の位置 → 単位円の座標（半軸を列にした行列の逆）
+    primitive.center[0] = center.x;
+    primitive.center[1] = center.y;
+    primitive.inverse[0] = axisY.y / det;
+    primitive.inverse[1] = -axisY.x / det;
+    primitive.inverse[2] = -axisX.y / det;
+    primitive.inverse[3] = axisX.x / det;
+
+    // シェーダーのfwidth(radius)の近似: 1ピクセルが単位円の座標でどれだけか（短い方の半軸で決まる）
+    float minorAxis = std::min(axisX.length(), axisY.length());
+    primitive.edgeWidth = ofClamp(1.0f / minorAxis, 0.0001f, 1.0f);
+}
+
+void SoftwareRasterizer::fillLines(const std::vector<LineSegment>& segments) {
+    lineVertices.clear();
+    LineBatch::tessellate(segments, lineVertices);
+    for (std::size_t i = 0; i + 2 < lineVertices.size(); i += 3) {
+        const LineVertex* v = &lineVertices[i];
+        fillTriangle(ofVec2f(v[0].x, v[0].y), ofVec2f(v[1].x, v[1].y), ofVec2f(v[2].x, v[2].y),
+                     ofFloatColor(v[0].r, v[0].g, v[0].b, v[0].a),
+                     ofFloatColor(v[1].r, v[1].g, v[1].b, v[1].a),
+                     ofFloatColor(v[2].r, v[2].g, v[2].b, v[2].a));
+    }
+}
+
+void SoftwareRasterizer::flush() {
+    if (primitives.empty() || !target) {
+        primitives.clear();
+        edges.clear();
+        return;
+    }
+    PROFILE_ZONE("SoftwareRasterizer");
+    uint64_t start = ofGetElapsedTimeMicros();
+
+    // タイルへの振り分け（記録順のまま）
+    int width = target->getWidth();
+    int height = target->getHeight();
+    tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    tileBins.resize(tilesX * tilesY);
+    for (auto& bin : tileBins) {
+        bin.clear();
+    }
+
+    RasterStats stats;
+    stats.primitives = primitives.size();
+    for (uint32_t i = 0; i < primitives.size(); i++) {
+        const Primitive& primitive = primitives[i];
+        for (int ty = primitive.minY / TILE_SIZE; ty <= (primitive.maxY - 1) / TILE_SIZE; ty++) {
+            for (int tx = primitive.minX / TILE_SIZE; tx <= (primitive.maxX - 1) / TILE_SIZE; tx++) {
+                tileBins[ty * tilesX + tx].push_back(i);
+                stats.tileEntries++;
+            }
+        }
+    }
+
+    activeTiles.clear();
+    for (std::size_t i = 0; i < tileBins.size(); i++) {
+        if (!tileBins[i].empty()) activeTiles.push_back(i);
+    }
+    stats.activeTiles = activeTiles.size();
+
+    if (!workersStarted) {
+        workersStarted = true;
+        int numWorkers = requestedWorkers >= 0 ? requestedWorkers : (int)std::thread::hardware_concurrency() - 1;
+        workers.start(std::max(0, numWorkers));
+    }
+    workers.run(activeTiles.size(), [this](std::size_t i) {
+        renderTile(activeTiles[i]);
+    });
+
+    primitives.clear();
+    edges.clear();
+    stats.millis = (ofGetElapsedTimeMicros() - start) / 1000.0;
+    lastStats = stats;
+    totalStats.primitives += stats.primitives;
+    totalStats.tileEntries += stats.tileEntries;
+    totalStats.activeTiles += stats.activeTiles;
+    totalStats.millis += stats.millis;
+}
+
+void SoftwareRasterizer::renderTile(std::size_t tileIndex) {
+    int tileMinX = (tileIndex % tilesX) * TILE_SIZE;
+    int tileMinY = (tileIndex / tilesX) * TILE_SIZE;
+    int tileMaxX = std::min(tileMinX + TILE_SIZE, (int)target->getWidth());
+    int tileMaxY = std::min(tileMinY + TILE_SIZE, (int)target->getHeight());
+
+    std::vector<float> crossings;
+    std::vector<int> windings;
+
+    for (uint32_t index : tileBins[tileIndex]) {
+        const Primitive& primitive = primitives[index];
+        int minX = std::max(primitive.minX, tileMinX);
+        int maxX = std::min(primitive.maxX, tileMaxX);
+        int minY = std::max(primitive.minY, tileMinY);
+        int maxY = std::min(primitive.maxY, tileMaxY);
+
+        for (int y = minY; y < maxY; y++) {
+            switch (primitive.kind) {
+                case PRIMITIVE_RECT:
+                    fillSpan(primitive, y, minX, maxX);
+                    break;
+                case PRIMITIVE_POLYGON:
+                    renderPolygonRow(primitive, y, minX, maxX, crossings, windings);
+                    break;
+                case PRIMITIVE_ELLIPSE:
+                    renderEllipseRow(primitive, y, minX, maxX);
+                    break;
+            }
+        }
+    }
+}
+
+void SoftwareRasterizer::renderPolygonRow(const Primitive& primitive, int y, int clipMinX, int clipMaxX,
+                                          std::vector<float>& crossings, std::vector<int>& windings) {
+    // 画素の中心の行と交わる辺のx（左から順）
+    float centerY = y + 0.5f;
+    crossings.clear();
+    windings.clear();
+    for (uint32_t i = primitive.firstEdge; i < primitive.firstEdge + primitive.numEdges; i++) {
+        const Edge& edge = edges[i];
+        if (centerY < edge.y0 || centerY >= edge.y1) continue;
+
+        float x = edge.x0 + (centerY - edge.y0) * edge.slope;
+        std::size_t position = crossings.size();
+        crossings.push_back(x);
+        windings.push_back(edge.winding);
+        while (position > 0 && crossings[position - 1] > x) {
+            std::swap(crossings[position - 1], crossings[position]);
+            std::swap(windings[position - 1], windings[position]);
+            position--;
+        }
+    }
+
+    // 交点の間のうち内側の区間を塗る
+    int winding = 0;
+    for (std::size_t i = 0; i + 1 < crossings.size(); i++) {
+        winding += windings[i];
+        bool inside = primitive.fillRule == RASTER_FILL_ODD ? (i % 2 == 0) : winding != 0;
+        if (!inside) continue;
+
+        int startX = std::max(firstPixelAt(crossings[i]), clipMinX);
+        int endX = std::min(firstPixelAt(crossings[i + 1]), clipMaxX);
+        if (startX < endX) {
+            fillSpan(primitive, y, startX, endX);
+        }
+    }
+}
+
+void SoftwareRasterizer::renderEllipseRow(const Primitive& primitive, int y, int clipMinX, int clipMaxX) {
+    const float* inverse = primitive.inverse;
+    float offsetY = y + 0.5f - primitive.center[1];
+    float rowU = inverse[1] * offsetY;
+    float rowV = inverse[3] * offsetY;
+
+    // 単位円の座標の半径がradius以下になるxの範囲（offsetXの2次式）
+    float quadA = inverse[0] * inverse[0] + inverse[2] * inverse[2];
+    float quadB = 2.0f * (inverse[0] * rowU + inverse[2] * rowV);
+    float quadC = rowU * rowU + rowV * rowV;
+    auto spanAt = [&](float radius, int& startX, int& endX) {
+        float discriminant = quadB * quadB - 4.0f * quadA * (quadC - radius * radius);
+        if (discriminant < 0.0f) return false;
+        float root = sqrtf(discriminant);
+        startX = std::max(firstPixelAt(primitive.center[0] + (-quadB - root) / (2.0f * quadA)), clipMinX);
+        endX = std::min(firstPixelAt(primitive.center[0] + (-quadB + root) / (2.0f * quadA)), clipMaxX);
+        return startX < endX;
+    };
+
+    int outerStart, outerEnd;
+    if (!spanAt(1.0f, outerStart, outerEnd)) return;
+
+    // 縁の幅より内側は覆い率1でまとめて塗る
+    float edgeWidth = primitive.edgeWidth;
+    int innerStart = outerEnd;
+    int innerEnd = outerEnd;
+    if (edgeWidth < 1.0f && spanAt(1.0f - edgeWidth, innerStart, innerEnd)) {
+        fillSpan(primitive, y, innerStart, innerEnd);
+    } else {
+        innerStart = innerEnd = outerEnd;
+    }
+
+    // 縁はSpriteBatchのシェーダーと同じ 1 - smoothstep(1 - edge, 1, radius)
+    float* row = target->getData() + (std::size_t)y * target->getWidth() * 4;
+    BlendTerms terms;
+    for (int x = outerStart; x < outerEnd; x++) {
+        if (x == innerStart) {
+            x = innerEnd - 1;
+            continue;
+        }
+        float offsetX = x + 0.5f - primitive.center[0];
+        float u = inverse[0] * offsetX + rowU;
+        float v = inverse[2] * offsetX + rowV;
+        float coverage = 1.0f - smoothStep(1.0f - edgeWidth, 1.0f, sqrtf(u * u + v * v));
+        if (coverage <= 0.0f) continue;
+        makeBlendTerms(primitive.blendMode, primitive.color, coverage, terms);
+        blendOne(row + x * 4, terms);
+    }
+}
+
+void SoftwareRasterizer::fillSpan(const Primitive& primitive, int y, int startX, int endX) {
+    float* dst = target->getData() + ((std::size_t)y * target->getWidth() + startX) * 4;
+    BlendTerms terms;
+
+    if (!primitive.shaded) {
+        makeBlendTerms(primitive.blendMode, primitive.color, 1.0f, terms);
+        blendSpan(dst, endX - startX, terms);
+        return;
+    }
+
+    // 頂点色の補間: 画素の中心での色から1ピクセルずつ係数を作る
+    float color[4];
+    float centerX = startX + 0.5f;
+    float centerY = y + 0.5f;
+    for (int i = 0; i < 4; i++) {
+        color[i] = primitive.color[i] + primitive.colorDx[i] * centerX + primitive.colorDy[i] * centerY;
+    }
+    for (int x = startX; x < endX; x++, dst += 4) {
+        float clamped[4];
+        for (int i = 0; i < 4; i++) {
+            clamped[i] = ofClamp(color[i], 0.0f, 1.0f);
+            color[i] += primitive.colorDx[i];
+        }
+        makeBlendTerms(primitive.blendMode, clamped, 1.0f, terms);
+        blendOne(dst, terms);
+    }
+}
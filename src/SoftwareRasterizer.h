@@ -0,0 +1,139 @@
+#pragma once
+
+#include "ofMain.h"
+#include "LineBatch.h"
+#include "WorkerPool.h"
+#include <vector>
+
+// 塗りつぶしの規則（ofPolyWindingModeのODDとNONZEROに相当）
+enum RasterFillRule {
+    RASTER_FILL_ODD = 0,
+    RASTER_FILL_NONZERO
+};
+
+// 1回のflush()の統計
+struct RasterStats {
+    std::size_t primitives = 0;     // 記録した図形の数
+    std::size_t tileEntries = 0;    // タイルに振り分けた図形の延べ数
+    std::size_t activeTiles = 0;    // 図形が1つ以上あったタイル
+    double millis = 0.0;            // 振り分けとラスタライズにかかった時間
+};
+
+// GLを使わないラスタライザ（ヘッドレスでの描画・ピクセル比較用）
+// - ターゲットはRGBAのofFloatPixels（0〜1、1行目が画面の上端）。書き込みのたびに0〜1にクランプする（RGBA8のFBOと同じ）
+// - fill*()は画面座標の図形を記録するだけで、flush()でまとめてラスタライズする
+//   画面を64ピクセル角のタイルに分け、タイルごとに記録順に図形を塗る。タイルは別々のピクセルなのでワーカーで並列に処理する
+// - 画素の中心が図形の内側なら塗る（アンチエイリアスなし）。楕円だけはSpriteBatchのシェーダーと同じく縁の約1ピクセルをなめらかにする
+// - ブレンドはOF_BLENDMODE_*と同じブレンド係数の式。どのモードも dst = dst * m + s の形にして、スパンはSIMDで1ピクセル=1ベクトルで塗る
+// 描画スレッド（呼び出し元）からだけ使う
+class SoftwareRasterizer {
+public:
+    static const int TILE_SIZE = 64;
+
+    SoftwareRasterizer() = default;
+    SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+    SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+
+    // 描く先を切り替える（記録済みの図形は前のターゲットに描いてから切り替える）
+    void setTarget(ofFloatPixels& pixels);
+    ofFloatPixels* getTarget() { return target; }
+    int getWidth() const { return target ? target->getWidth() : 0; }
+    int getHeight() const { return target ? target->getHeight() : 0; }
+
+    // ワーカーの数（0なら呼び出し元だけで処理する）。既定はハードウェアスレッド数-1
+    void setNumWorkers(int numWorkers);
+
+    // === 記録（座標は画面のピクセル、色は0〜1） ===
+    void setBlendMode(ofBlendMode mode) { blendMode = mode; }
+    ofBlendMode getBlendMode() const { return blendMode; }
+
+    // ターゲット全体を色で置き換える（ブレンドしない）
+    void clear(const ofFloatColor& color);
+
+    // 軸に平行な矩形
+    void fillRect(float x, float y, float width, float height, const ofFloatColor& color);
+
+    void fillTriangle(const ofVec2f& a, const ofVec2f& b, const ofVec2f& c, const ofFloatColor& color) {
+        fillTriangle(a, b, c, color, color, color);
+    }
+
+    // 頂点ごとの色を線形に補間する
+    void fillTriangle(const ofVec2f& a, const ofVec2f& b, const ofVec2f& c,
+                      const ofFloatColor& colorA, const ofFloatColor& colorB, const ofFloatColor& colorC);
+
+    // 閉じた輪郭の集まり（凹多角形・穴あきも可）
+    void fillPolygon(const std::vector<std::vector<ofVec2f>>& contours, const ofFloatColor& color,
+                     RasterFillRule rule = RASTER_FILL_ODD);
+
+    // 中心と2本の半軸（変換後のベクトル、回転・拡大・せん断を含められる）
+    void fillEllipse(const ofVec2f& center, const ofVec2f& axisX, const ofVec2f& axisY, const ofFloatColor& color);
+
+    // 線分はLineBatch::tessellateと同じ四角形に展開して塗る
+    void fillLines(const std::vector<LineSegment>& segments);
+
+    // 記録した図形をターゲットにラスタライズする
+    void flush();
+
+    const RasterStats& getLastStats() const { return lastStats; }
+    // resetTotalStats()からのflush()の合計（ベンチマーク用）
+    const RasterStats& getTotalStats() const { return totalStats; }
+    void resetTotalStats() { totalStats = RasterStats(); }
+
+private:
+    enum PrimitiveKind {
+        PRIMITIVE_RECT = 0,
+        PRIMITIVE_POLYGON,
+        PRIMITIVE_ELLIPSE
+    };
+
+    // 下向き（y0 < y1）に揃えた辺。windingは元の向き（+1が下向き）
+    struct Edge {
+        float x0, y0, y1;
+        float slope;      // dx/dy
+        int winding;
+    };
+
+    struct Primitive {
+        PrimitiveKind kind;
+        ofBlendMode blendMode;
+        int minX, minY, maxX, maxY;    // 塗る可能性のあるピクセル（max側は含まない）
+        float color[4];                // (0, 0)での色
+        float colorDx[4];              // 色の傾き（頂点色を補間する三角形のみ）
+        float colorDy[4];
+        bool shaded;
+        RasterFillRule fillRule;
+        uint32_t firstEdge, numEdges;  // 多角形の辺（矩形は範囲だけで塗る）
+        float center[2];               // 楕円: 中心と、画面からの逆変換・縁の幅
+        float inverse[4];
+        float edgeWidth;
+    };
+
+    bool setBounds(Primitive& primitive, float minX, float minY, float maxX, float maxY) const;
+    Primitive& beginPrimitive(PrimitiveKind kind, const ofFloatColor& color);
+    void addEdge(const ofVec2f& from, const ofVec2f& to);
+    void renderTile(std::size_t tileIndex);
+    void renderPolygonRow(const Primitive& primitive, int y, int clipMinX, int clipMaxX,
+                          std::vector<float>& crossings, std::vector<int>& windings);
+    void renderEllipseRow(const Primitive& primitive, int y, int clipMinX, int clipMaxX);
+    void fillSpan(const Primitive& primitive, int y, int startX, int endX);
+
+    ofFloatPixels* target = nullptr;
+    ofBlendMode blendMode = OF_BLENDMODE_ALPHA;
+
+    std::vector<Primitive> primitives;
+    std::vector<Edge> edges;
+    std::vector<LineVertex> lineVertices;
+
+    // タイルごとの図形の番号（記録順）
+    int tilesX = 0;
+    int tilesY = 0;
+    std::vector<std::vector<uint32_t>> tileBins;
+    std::vector<std::size_t> activeTiles;
+
+    WorkerPool workers;
+    bool workersStarted = false;
+    int requestedWorkers = -1;
+
+    RasterStats lastStats;
+    RasterStats totalStats;
+};
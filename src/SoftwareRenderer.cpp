@@ -0,0 +1,452 @@
+#include "SoftwareRenderer.h"
+
+// 静的メンバ変数の定義
+const std::string SoftwareRenderer::TYPE = "SoftwareRenderer";
+
+// === 2次元のアフィン変換 ===
+SoftwareRenderer::Affine SoftwareRenderer::Affine::make(float a, float b, float c, float d, float tx, float ty) {
+    Affine affine;
+    affine.a = a;
+    affine.b = b;
+    affine.c = c;
+    affine.d = d;
+    affine.tx = tx;
+    affine.ty = ty;
+    return affine;
+}
+
+SoftwareRenderer::Affine SoftwareRenderer::Affine::operator*(const Affine& other) const {
+    return make(a * other.a + c * other.b, b * other.a + d * other.b,
+                a * other.c + c * other.d, b * other.c + d * other.d,
+                a * other.tx + c * other.ty + tx, b * other.tx + d * other.ty + ty);
+}
+
+SoftwareRenderer::Affine SoftwareRenderer::Affine::fromMat4(const glm::mat4& m) {
+    return make(m[0][0], m[0][1], m[1][0], m[1][1], m[3][0], m[3][1]);
+}
+
+SoftwareRenderer::Affine SoftwareRenderer::Affine::fromArray(const float* m) {
+    return make(m[0], m[1], m[4], m[5], m[12], m[13]);
+}
+
+// === SoftwareRenderer ===
+SoftwareRenderer::SoftwareRenderer()
+: graphics3d(this) {
+    path.setMode(ofPath::POLYLINES);
+    path.setUseShapeColor(false);
+    rasterizer.setTarget(screen);
+}
+
+void SoftwareRenderer::allocate(int width, int height) {
+    rasterizer.flush();
+    screen.allocate(width, height, OF_PIXELS_RGBA);
+    screen.set(0);
+}
+
+SoftwareRenderer* SoftwareRenderer::getCurrent() {
+    return dynamic_cast<SoftwareRenderer*>(ofGetCurrentRenderer().get());
+}
+
+void SoftwareRenderer::beginTarget(ofFloatPixels& pixels, int width, int height) {
+    rasterizer.flush();
+    if (pixels.getWidth() != width || pixels.getHeight() != height || pixels.getNumChannels() != 4) {
+        pixels.allocate(width, height, OF_PIXELS_RGBA);
+        pixels.set(0);
+    }
+    targetStack.push_back(rasterizer.getTarget());
+    rasterizer.setTarget(pixels);
+}
+
+void SoftwareRenderer::endTarget() {
+    if (targetStack.empty()) return;
+    ofFloatPixels* previous = targetStack.back();
+    targetStack.pop_back();
+    rasterizer.setTarget(previous ? *previous : screen);
+}
+
+ofFloatPixels& SoftwareRenderer::getTargetPixels() {
+    rasterizer.flush();
+    return *rasterizer.getTarget();
+}
+
+const ofFloatPixels& SoftwareRenderer::getScreenPixels() {
+    if (rasterizer.getTarget() == &screen) {
+        rasterizer.flush();
+    }
+    return screen;
+}
+
+void SoftwareRenderer::getScreenPixels(ofPixels& pixels) {
+    const ofFloatPixels& source = getScreenPixels();
+    pixels.allocate(source.getWidth(), source.getHeight(), OF_PIXELS_RGBA);
+    const float* src = source.getData();
+    unsigned char* dst = pixels.getData();
+    std::size_t count = source.getWidth() * source.getHeight() * 4;
+    for (std::size_t i = 0; i < count; i++) {
+        dst[i] = (unsigned char)(ofClamp(src[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+}
+
+ofFloatColor SoftwareRenderer::getStyleColor() const {
+    const ofColor& color = currentStyle.color;
+    return ofFloatColor(color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f);
+}
+
+void SoftwareRenderer::syncBlendMode() const {
+    rasterizer.setBlendMode(currentStyle.blendingMode);
+}
+
+// === バッチからの描画 ===
+void SoftwareRenderer::drawLineSegments(const std::vector<LineSegment>& segments) {
+    float widthScale = matrix.getScale();
+    strokeSegments.resize(segments.size());
+    for (std::size_t i = 0; i < segments.size(); i++) {
+        LineSegment& segment = strokeSegments[i];
+        segment = segments[i];
+        segment.start = matrix.apply(segment.start.x, segment.start.y);
+        segment.end = matrix.apply(segment.end.x, segment.end.y);
+        segment.startWidth *= widthScale;
+        segment.endWidth *= widthScale;
+    }
+    syncBlendMode();
+    rasterizer.fillLines(strokeSegments);
+}
+
+void SoftwareRenderer::drawSprite(float x, float y, float halfWidth, float halfHeight, float rotation, bool ellipse,
+                                  const ofFloatColor& color) {
+    syncBlendMode();
+    float c = cosf(rotation);
+    float s = sinf(rotation);
+    if (ellipse) {
+        rasterizer.fillEllipse(matrix.apply(x, y), matrix.applyVector(c * halfWidth, s * halfWidth),
+                               matrix.applyVector(-s * halfHeight, c * halfHeight), color);
+        return;
+    }
+
+    contours.resize(1);
+    std::vector<ofVec2f>& corners = contours[0];
+    corners.clear();
+    static const float CORNERS[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+    for (const auto& corner : CORNERS) {
+        float extentX = corner[0] * halfWidth;
+        float extentY = corner[1] * halfHeight;
+        corners.push_back(matrix.apply(x + extentX * c - extentY * s, y + extentX * s + extentY * c));
+    }
+    rasterizer.fillPolygon(contours, color);
+}
+
+// === 図形 ===
+void SoftwareRenderer::strokeOutline(const std::vector<ofVec2f>& points, bool closed, float width, const ofFloatColor& color) const {
+    if (points.size() < 2) return;
+    float scaledWidth = width * matrix.getScale();
+    std::size_t count = closed ? points.size() : points.size() - 1;
+
+    strokeSegments.clear();
+    for (std::size_t i = 0; i < count; i++) {
+        const ofVec2f& from = points[i];
+        const ofVec2f& to = points[(i + 1) % points.size()];
+        strokeSegments.emplace_back();
+        LineSegment& segment = strokeSegments.back();
+        segment.start = matrix.apply(from.x, from.y);
+        segment.end = matrix.apply(to.x, to.y);
+        segment.startWidth = segment.endWidth = scaledWidth;
+        segment.startColor = segment.endColor = color;
+    }
+    syncBlendMode();
+    rasterizer.fillLines(strokeSegments);
+}
+
+void SoftwareRenderer::fillEllipse(float x, float y, float width, float height, float rotation, const ofFloatColor& color) const {
+    float c = cosf(rotation);
+    float s = sinf(rotation);
+    float halfWidth = width * 0.5f;
+    float halfHeight = height * 0.5f;
+    syncBlendMode();
+    rasterizer.fillEllipse(matrix.apply(x, y), matrix.applyVector(c * halfWidth, s * halfWidth),
+                           matrix.applyVector(-s * halfHeight, c * halfHeight), color);
+}
+
+void SoftwareRenderer::drawLine(float x1, float y1, float z1, float x2, float y2, float z2) const {
+    strokeOutline({ofVec2f(x1, y1), ofVec2f(x2, y2)}, false, currentStyle.lineWidth, getStyleColor());
+}
+
+void SoftwareRenderer::drawRectangle(float x, float y, float z, float w, float h) const {
+    if (currentStyle.rectMode == OF_RECTMODE_CENTER) {
+        x -= w * 0.5f;
+        y -= h * 0.5f;
+    }
+    ofFloatColor color = getStyleColor();
+    std::vector<ofVec2f> corners = {ofVec2f(x, y), ofVec2f(x + w, y), ofVec2f(x + w, y + h), ofVec2f(x, y + h)};
+
+    if (!currentStyle.bFill) {
+        strokeOutline(corners, true, currentStyle.lineWidth, color);
+        return;
+    }
+
+    syncBlendMode();
+    if (matrix.b == 0.0f && matrix.c == 0.0f) {
+        // 回転なし: 軸に平行な矩形のまま塗る（全画面のフェードなど）
+        ofVec2f corner = matrix.apply(x, y);
+        rasterizer.fillRect(corner.x, corner.y, w * matrix.a, h * matrix.d, color);
+        return;
+    }
+    contours.resize(1);
+    contours[0].clear();
+    for (const auto& point : corners) {
+        contours[0].push_back(matrix.apply(point.x, point.y));
+    }
+    rasterizer.fillPolygon(contours, color);
+}
+
+void SoftwareRenderer::drawTriangle(float x1, float y1, float z1, float x2, float y2, float z2, float x3, float y3, float z3) const {
+    ofFloatColor color = getStyleColor();
+    if (!currentStyle.bFill) {
+        strokeOutline({ofVec2f(x1, y1), ofVec2f(x2, y2), ofVec2f(x3, y3)}, true, currentStyle.lineWidth, color);
+        return;
+    }
+    syncBlendMode();
+    rasterizer.fillTriangle(matrix.apply(x1, y1), matrix.apply(x2, y2), matrix.apply(x3, y3), color);
+}
+
+void SoftwareRenderer::drawCircle(float x, float y, float z, float radius) const {
+    drawEllipse(x, y, z, radius * 2, radius * 2);
+}
+
+void SoftwareRenderer::drawEllipse(float x, float y, float z, float width, float height) const {
+    ofFloatColor color = getStyleColor();
+    if (currentStyle.bFill) {
+        fillEllipse(x, y, width, height, 0.0f, color);
+        return;
+    }
+
+    // 輪郭は円の分割数の多角形（GLと同じ）
+    int resolution = std::max(3, currentStyle.circleResolution);
+    std::vector<ofVec2f> points;
+    points.reserve(resolution);
+    for (int i = 0; i < resolution; i++) {
+        float angle = i * TWO_PI / resolution;
+        points.emplace_back(x + cosf(angle) * width * 0.5f, y + sinf(angle) * height * 0.5f);
+    }
+    strokeOutline(points, true, currentStyle.lineWidth, color);
+}
+
+void SoftwareRenderer::draw(const ofPolyline& poly) const {
+    std::vector<ofVec2f> points;
+    points.reserve(poly.size());
+    for (const auto& vertex : poly.getVertices()) {
+        points.emplace_back(vertex.x, vertex.y);
+    }
+    strokeOutline(points, poly.isClosed(), currentStyle.lineWidth, getStyleColor());
+}
+
+void SoftwareRenderer::draw(const ofPath& shape) const {
+    const std::vector<ofPolyline>& outlines = shape.getOutline();
+
+    if (shape.isFilled()) {
+        ofFloatColor color = shape.getUseShapeColor() ? ofFloatColor(shape.getFillColor()) : getStyleColor();
+        contours.resize(outlines.size());
+        for (std::size_t i = 0; i < outlines.size(); i++) {
+            contours[i].clear();
+            for (const auto& vertex : outlines[i].getVertices()) {
+                contours[i].push_back(matrix.apply(vertex.x, vertex.y));
+            }
+        }
+        syncBlendMode();
+        rasterizer.fillPolygon(contours, color, shape.getWindingMode() == OF_POLY_WINDING_ODD ? RASTER_FILL_ODD : RASTER_FILL_NONZERO);
+    }
+
+    if (shape.hasOutline()) {
+        ofFloatColor color = shape.getUseShapeColor() ? ofFloatColor(shape.getStrokeColor()) : getStyleColor();
+        for (const auto& outline : outlines) {
+            std::vector<ofVec2f> points;
+            points.reserve(outline.size());
+            for (const auto& vertex : outline.getVertices()) {
+                points.emplace_back(vertex.x, vertex.y);
+            }
+            strokeOutline(points, outline.isClosed(), shape.getStrokeWidth(), color);
+        }
+    }
+}
+
+void SoftwareRenderer::draw(const ofMesh& vertexData, ofPolyRenderMode renderType, bool useColors, bool useTextures, bool useNormals) const {
+    if (renderType == OF_MESH_POINTS) return;
+
+    bool indexed = vertexData.getNumIndices() > 0 && vertexData.usingIndices();
+    std::size_t count = indexed ? vertexData.getNumIndices() : vertexData.getNumVertices();
+    bool vertexColors = useColors && vertexData.getNumColors() > 0;
+    ofFloatColor styleColor = getStyleColor();
+
+    auto indexAt = [&](std::size_t i) -> std::size_t {
+        return indexed ? vertexData.getIndex(i) : i;
+    };
+    auto positionAt = [&](std::size_t i) {
+        const auto& vertex = vertexData.getVertex(indexAt(i));
+        return matrix.apply(vertex.x, vertex.y);
+    };
+    auto colorAt = [&](std::size_t i) {
+        std::size_t index = indexAt(i);
+        return vertexColors && index < vertexData.getNumColors() ? ofFloatColor(vertexData.getColor(index)) : styleColor;
+    };
+
+    float lineWidth = currentStyle.lineWidth * matrix.getScale();
+    strokeSegments.clear();
+    auto addEdge = [&](std::size_t from, std::size_t to) {
+        strokeSegments.emplace_back();
+        LineSegment& segment = strokeSegments.back();
+        segment.start = positionAt(from);
+        segment.end = positionAt(to);
+        segment.startWidth = segment.endWidth = lineWidth;
+        segment.startColor = colorAt(from);
+        segment.endColor = colorAt(to);
+    };
+    auto addTriangle = [&](std::size_t i0, std::size_t i1, std::size_t i2) {
+        if (renderType == OF_MESH_WIREFRAME) {
+            addEdge(i0, i1);
+            addEdge(i1, i2);
+            addEdge(i2, i0);
+        } else {
+            rasterizer.fillTriangle(positionAt(i0), positionAt(i1), positionAt(i2), colorAt(i0), colorAt(i1), colorAt(i2));
+        }
+    };
+
+    syncBlendMode();
+    switch (vertexData.getMode()) {
+        case OF_PRIMITIVE_TRIANGLES:
+            for (std::size_t i = 0; i + 2 < count; i += 3) addTriangle(i, i + 1, i + 2);
+            break;
+        case OF_PRIMITIVE_TRIANGLE_STRIP:
+            for (std::size_t i = 0; i + 2 < count; i++) addTriangle(i, i + 1, i + 2);
+            break;
+        case OF_PRIMITIVE_TRIANGLE_FAN:
+            for (std::size_t i = 1; i + 1 < count; i++) addTriangle(0, i, i + 1);
+            break;
+        case OF_PRIMITIVE_LINES:
+            for (std::size_t i = 0; i + 1 < count; i += 2) addEdge(i, i + 1);
+            break;
+        case OF_PRIMITIVE_LINE_STRIP:
+            for (std::size_t i = 0; i + 1 < count; i++) addEdge(i, i + 1);
+            break;
+        case OF_PRIMITIVE_LINE_LOOP:
+            for (std::size_t i = 0; i + 1 < count; i++) addEdge(i, i + 1);
+            if (count > 2) addEdge(count - 1, 0);
+            break;
+        default:
+            break;
+    }
+    if (!strokeSegments.empty()) {
+        rasterizer.fillLines(strokeSegments);
+    }
+}
+
+// === ビューと行列 ===
+ofRectangle SoftwareRenderer::getCurrentViewport() const {
+    return ofRectangle(0, 0, rasterizer.getWidth(), rasterizer.getHeight());
+}
+
+ofRectangle SoftwareRenderer::getNativeViewport() const {
+    return getCurrentViewport();
+}
+
+int SoftwareRenderer::getViewportWidth() const {
+    return rasterizer.getWidth();
+}
+
+int SoftwareRenderer::getViewportHeight() const {
+    return rasterizer.getHeight();
+}
+
+void SoftwareRenderer::pushMatrix() {
+    matrixStack.push_back(matrix);
+}
+
+void SoftwareRenderer::popMatrix() {
+    if (matrixStack.empty()) return;
+    matrix = matrixStack.back();
+    matrixStack.pop_back();
+}
+
+glm::mat4 SoftwareRenderer::getCurrentMatrix(ofMatrixMode matrixMode) const {
+    glm::mat4 result(1.0f);
+    if (matrixMode == OF_MATRIX_MODELVIEW) {
+        result[0][0] = matrix.a;
+        result[0][1] = matrix.b;
+        result[1][0] = matrix.c;
+        result[1][1] = matrix.d;
+        result[3][0] = matrix.tx;
+        result[3][1] = matrix.ty;
+    }
+    return result;
+}
+
+void SoftwareRenderer::translate(float x, float y, float z) {
+    matrix = matrix * Affine::make(1, 0, 0, 1, x, y);
+}
+
+void SoftwareRenderer::scale(float xAmnt, float yAmnt, float zAmnt) {
+    matrix = matrix * Affine::make(xAmnt, 0, 0, yAmnt, 0, 0);
+}
+
+void SoftwareRenderer::rotateRad(float radians, float vecX, float vecY, float vecZ) {
+    // Z軸まわりの回転だけを扱う
+    if (fabsf(vecZ) <= std::max(fabsf(vecX), fabsf(vecY))) return;
+    rotateRad(vecZ < 0 ? -radians : radians);
+}
+
+void SoftwareRenderer::rotateRad(float radians) {
+    float c = cosf(radians);
+    float s = sinf(radians);
+    matrix = matrix * Affine::make(c, s, -s, c, 0, 0);
+}
+
+void SoftwareRenderer::setupGraphicDefaults() {
+    setStyle(ofStyle());
+    path.setMode(ofPath::POLYLINES);
+    path.setUseShapeColor(false);
+}
+
+void SoftwareRenderer::setupScreen() {
+    matrix = Affine();
+    matrixStack.clear();
+}
+
+// === スタイル ===
+void SoftwareRenderer::setFillMode(ofFillFlag fill) {
+    // ofBeginShapeのパスも同じ設定にする（ofGLRendererと同じ）
+    currentStyle.bFill = fill == OF_FILLED;
+    path.setFilled(currentStyle.bFill);
+    path.setStrokeWidth(currentStyle.bFill ? 0 : currentStyle.lineWidth);
+}
+
+void SoftwareRenderer::setLineWidth(float lineWidth) {
+    currentStyle.lineWidth = lineWidth;
+    if (!currentStyle.bFill) {
+        path.setStrokeWidth(lineWidth);
+    }
+}
+
+void SoftwareRenderer::background(const ofColor& c) {
+    setBackgroundColor(c);
+    clear(c.r, c.g, c.b, c.a);
+}
+
+void SoftwareRenderer::clear(float r, float g, float b, float a) {
+    rasterizer.clear(ofFloatColor(r / 255.0f, g / 255.0f, b / 255.0f, a / 255.0f));
+}
+
+void SoftwareRenderer::setStyle(const ofStyle& style) {
+    currentStyle = style;
+    setFillMode(style.bFill ? OF_FILLED : OF_OUTLINE);
+    setLineWidth(style.lineWidth);
+    setPolyMode(style.polyMode);
+    setCurveResolution(style.curveResolution);
+}
+
+void SoftwareRenderer::pushStyle() {
+    styleHistory.push_back(currentStyle);
+}
+
+void SoftwareRenderer::popStyle() {
+    if (styleHistory.empty()) return;
+    setStyle(styleHistory.back());
+    styleHistory.pop_back();
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+#include "ofMain.h"
+#include "SoftwareRasterizer.h"
+#include <deque>
+
+// ヘッドレスでFBOの代わりに使うCPUのバッファ（VisualSystemのマスター・トレイル、RGBA・0〜1）
+struct SoftwareBuffers {
+    ofFloatPixels master;
+    ofFloatPixels trail;
+    ofFloatPixels scratch;   // トレイル更新の書き込み先（trailと入れ替える）
+};
+
+// SoftwareRasterizerに描くofBaseRenderer（ofCairoRendererと同じくofSetCurrentRendererで差し替えて使う）
+// GLコンテキストなしで、ビジュアルシステムが実際に使う範囲の描画を画面の代わりのofFloatPixelsに描く
+// - ofDrawCircle / Ellipse / Rectangle / Triangle / Line（塗り・輪郭、線の太さ）
+// - ofBeginShape / ofVertex / ofEndShape（ofPath）、ofPolyline、ofMesh（三角形・ストリップ・ファン・線）
+// - ofEnableBlendMode（ALPHA・ADD・MULTIPLY・SCREEN・SUBTRACT）、ofSetColor、ofFill、ofSetLineWidth、ofSetRectMode、スタイルのpush/pop
+// - ofTranslate / ofRotate* / ofScale（Z軸まわりの2次元の変換のみ）
+// 文字列・画像・3D・テクスチャは描かない（何もしない）
+// SpriteBatchとLineBatchはGLの代わりにgetCurrent()に直接描く
+// 円・楕円はGLの多角形ではなくSpriteBatchと同じ縁のなめらかな楕円で描く
+class SoftwareRenderer : public ofBaseRenderer {
+public:
+    static const std::string TYPE;
+
+    SoftwareRenderer();
+
+    // 画面の大きさを決めて透明な黒でクリアする
+    void allocate(int width, int height);
+
+    // 今のレンダラーがSoftwareRendererならそれを返す（描画スレッド）
+    static SoftwareRenderer* getCurrent();
+
+    // === 描く先（FBOのbegin/endの代わり） ===
+    // pixelsはRGBAで、大きさが違えば確保し直して透明な黒にする。endTarget()で前の描く先に戻る
+    void beginTarget(ofFloatPixels& pixels, int width, int height);
+    void endTarget();
+
+    // 今の描く先に記録済みの図形を描いて、そのピクセルを返す
+    ofFloatPixels& getTargetPixels();
+    // 画面（beginTargetしていないときの描く先）
+    const ofFloatPixels& getScreenPixels();
+    // 画面をRGBA8に変換する（PNGの書き出し・比較用）
+    void getScreenPixels(ofPixels& pixels);
+
+    SoftwareRasterizer& getRasterizer() { return rasterizer; }
+
+    // === バッチからの描画（今の変換・ブレンドモードを使う、色は0〜1） ===
+    void drawLineSegments(const std::vector<LineSegment>& segments);
+    void drawSprite(float x, float y, float halfWidth, float halfHeight, float rotation, bool ellipse, const ofFloatColor& color);
+
+    // === ofBaseRenderer ===
+    const std::string& getType() override { return TYPE; }
+    void startRender() override {}
+    void finishRender() override { rasterizer.flush(); }
+
+    using ofBaseRenderer::draw;
+    void draw(const ofPolyline& poly) const override;
+    void draw(const ofPath& shape) const override;
+    void draw(const ofMesh& vertexData, ofPolyRenderMode renderType, bool useColors, bool useTextures, bool useNormals) const override;
+    void draw(const of3dPrimitive& model, ofPolyRenderMode renderType) const override {}
+    void draw(const ofNode& model) const override {}
+    void draw(const ofImage& image, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const override {}
+    void draw(const ofFloatImage& image, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const override {}
+    void draw(const ofShortImage& image, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const override {}
+    void draw(const ofBaseVideoDraws& video, float x, float y, float w, float h) const override {}
+    ofPath& getPath() override { return path; }
+    bool rendersPathPrimitives() override { return true; }   // ofPath::draw()もdraw(ofPath)で塗る（穴・巻き方向の規則を保つ）
+
+    // ビューと行列
+    void pushView() override {}
+    void popView() override {}
+    void viewport(ofRectangle viewport) override {}
+    void viewport(float x = 0, float y = 0, float width = -1, float height = -1, bool vflip = true) override {}
+    void setupScreenPerspective(float width = -1, float height = -1, float fov = 60, float nearDist = 0, float farDist = 0) override {}
+    void setupScreenOrtho(float width = -1, float height = -1, float nearDist = -1, float farDist = 1) override {}
+    void setOrientation(ofOrientation orientation, bool vFlip) override {}
+    ofRectangle getCurrentViewport() const override;
+    ofRectangle getNativeViewport() const override;
+    int getViewportWidth() const override;
+    int getViewportHeight() const override;
+    bool isVFlipped() const override { return true; }
+    void setCoordHandedness(ofHandednessType handedness) override {}
+    ofHandednessType getCoordHandedness() const override { return OF_LEFT_HANDED; }
+
+    void pushMatrix() override;
+    void popMatrix() override;
+    glm::mat4 getCurrentMatrix(ofMatrixMode matrixMode) const override;
+    glm::mat4 getCurrentOrientationMatrix() const override { return glm::mat4(1.0f); }
+    void translate(float x, float y, float z = 0) override;
+    void translate(const glm::vec3& p) override { translate(p.x, p.y, p.z); }
+    void scale(float xAmnt, float yAmnt, float zAmnt = 1) override;
+    void rotateRad(float radians, float vecX, float vecY, float vecZ) override;
+    void rotateXRad(float radians) override {}
+    void rotateYRad(float radians) override {}
+    void rotateZRad(float radians) override { rotateRad(radians); }
+    void rotateRad(float radians) override;
+    void matrixMode(ofMatrixMode mode) override {}
+    void loadIdentityMatrix() override { matrix = Affine(); }
+    void loadMatrix(const glm::mat4& m) override { matrix = Affine::fromMat4(m); }
+    void loadMatrix(const float* m) override { matrix = Affine::fromArray(m); }
+    void multMatrix(const glm::mat4& m) override { matrix = matrix * Affine::fromMat4(m); }
+    void multMatrix(const float* m) override { matrix = matrix * Affine::fromArray(m); }
+    void loadViewMatrix(const glm::mat4& m) override {}
+    void multViewMatrix(const glm::mat4& m) override {}
+    glm::mat4 getCurrentViewMatrix() const override { return glm::mat4(1.0f); }
+    glm::mat4 getCurrentNormalMatrix() const override { return glm::mat4(1.0f); }
+    void bind(const ofCamera& camera, const ofRectangle& viewport) override {}
+    void unbind(const ofCamera& camera) override {}
+
+    void setupGraphicDefaults() override;
+    // 変換を初期状態に戻す（フレームの始め）
+    void setupScreen() override;
+
+    // スタイル
+    void setRectMode(ofRectMode mode) override { currentStyle.rectMode = mode; }
+    ofRectMode getRectMode() override { return currentStyle.rectMode; }
+    void setFillMode(ofFillFlag fill) override;
+    ofFillFlag getFillMode() override { return currentStyle.bFill ? OF_FILLED : OF_OUTLINE; }
+    void setLineWidth(float lineWidth) override;
+    void setDepthTest(bool depthTest) override {}
+    void setBlendMode(ofBlendMode blendMode) override { currentStyle.blendingMode = blendMode; }
+    void setLineSmoothing(bool smooth) override { currentStyle.smoothing = smooth; }
+    void setCircleResolution(int resolution) override { currentStyle.circleResolution = resolution; }
+    void enableAntiAliasing() override {}
+    void disableAntiAliasing() override {}
+    void setCurveResolution(int resolution) override { currentStyle.curveResolution = resolution; path.setCurveResolution(resolution); }
+    void setPolyMode(ofPolyWindingMode mode) override { currentStyle.polyMode = mode; path.setPolyWindingMode(mode); }
+
+    void setColor(int r, int g, int b) override { setColor(ofColor(r, g, b)); }
+    void setColor(int r, int g, int b, int a) override { setColor(ofColor(r, g, b, a)); }
+    void setColor(const ofColor& color) override { currentStyle.color = color; }
+    void setColor(const ofColor& color, int _a) override { setColor(ofColor(color, _a)); }
+    void setColor(int gray) override { setColor(ofColor(gray)); }
+    void setHexColor(int hexColor) override { setColor(ofColor::fromHex(hexColor)); }
+    void setBitmapTextMode(ofDrawBitmapMode mode) override { currentStyle.drawBitmapMode = mode; }
+
+    ofColor getBackgroundColor() override { return currentStyle.bgColor; }
+    void setBackgroundColor(const ofColor& c) override { currentStyle.bgColor = c; }
+    void background(const ofColor& c) override;
+    void background(float brightness) override { background(ofColor(brightness)); }
+    void background(int hexColor, float _a = 255.0f) override { background(ofColor::fromHex(hexColor, _a)); }
+    void background(int r, int g, int b, int a = 255) override { background(ofColor(r, g, b, a)); }
+    bool getBackgroundAuto() override { return backgroundAuto; }
+    void setBackgroundAuto(bool bManual) override { backgroundAuto = bManual; }
+
+    void clear() override { clear(0, 0, 0, 0); }
+    void clear(float r, float g, float b, float a = 0) override;
+    void clear(float brightness, float a = 0) override { clear(brightness, brightness, brightness, a); }
+    void clearAlpha() override {}
+
+    void setStyle(const ofStyle& style) override;
+    const ofStyle& getStyle() const override { return currentStyle; }
+    void pushStyle() override;
+    void popStyle() override;
+
+    // 図形
+    void drawLine(float x1, float y1, float z1, float x2, float y2, float z2) const override;
+    void drawRectangle(float x, float y, float z, float w, float h) const override;
+    void drawTriangle(float x1, float y1, float z1, float x2, float y2, float z2, float x3, float y3, float z3) const override;
+    void drawCircle(float x, float y, float z, float radius) const override;
+    void drawEllipse(float x, float y, float z, float width, float height) const override;
+    void drawString(std::string text, float x, float y, float z) const override {}
+    void drawString(const ofTrueTypeFont& font, std::string text, float x, float y) const override {}
+
+    const of3dGraphics& get3dGraphics() const override { return graphics3d; }
+    of3dGraphics& get3dGraphics() override { return graphics3d; }
+
+private:
+    // 2次元のアフィン変換 (x, y) → (a x + c y + tx, b x + d y + ty)
+    struct Affine {
+        float a = 1, b = 0, c = 0, d = 1, tx = 0, ty = 0;
+
+        ofVec2f apply(float x, float y) const { return ofVec2f(a * x + c * y + tx, b * x + d * y + ty); }
+        ofVec2f applyVector(float x, float y) const { return ofVec2f(a * x + c * y, b * x + d * y); }
+        // 線の太さに掛ける倍率（面積の拡大率の平方根）
+        float getScale() const { return sqrtf(fabsf(a * d - b * c)); }
+        // otherを先に掛ける（OFの行列スタックと同じ順）
+        Affine operator*(const Affine& other) const;
+
+        static Affine make(float a, float b, float c, float d, float tx, float ty);
+        // 4x4行列（列優先）のXY平面の部分
+        static Affine fromMat4(const glm::mat4& m);
+        static Affine fromArray(const float* m);
+    };
+
+    // 今のスタイルの色（0〜1）
+    ofFloatColor getStyleColor() const;
+    void syncBlendMode() const;
+    void strokeOutline(const std::vector<ofVec2f>& points, bool closed, float width, const ofFloatColor& color) const;
+    void fillEllipse(float x, float y, float width, float height, float rotation, const ofFloatColor& color) const;
+
+    // ofBaseRendererの描画関数はconstなので、記録先は mutable にしておく
+    mutable SoftwareRasterizer rasterizer;
+    mutable std::vector<LineSegment> strokeSegments;
+    mutable std::vector<std::vector<ofVec2f>> contours;
+
+    ofFloatPixels screen;
+    std::vector<ofFloatPixels*> targetStack;   // beginTargetの前の描く先
+
+    ofStyle currentStyle;
+    std::deque<ofStyle> styleHistory;
+    Affine matrix;
+    std::vector<Affine> matrixStack;
+    bool backgroundAuto = true;
+
+    ofPath path;
+    of3dGraphics graphics3d;
+};
@@ -0,0 +1,204 @@
+#include "SpriteBatch.h"
+#include "AsyncLog.h"
+#include "FrameProfiler.h"
+#include "SoftwareRenderer.h"
+#include <cstddef>
+
+// 静的メンバ変数の定義
+ofShader SpriteBatch::shader;
+bool SpriteBatch::shaderTried = false;
+
+// インスタンスごとの属性の場所（0〜3はOFの位置・色・法線・テクスチャ座標）
+static const int BOUNDS_ATTRIBUTE = 4;
+static const int TRANSFORM_ATTRIBUTE = 5;
+static const int COLOR_ATTRIBUTE = 6;
+
+// 円の縁を1ピクセル分だけなめらかに切り抜く（矩形はshapeCoordが0なので全面を塗る）
+static const char* const SPRITE_FRAGMENT_BODY = R"(
+IN vec2 shapeCoord;
+IN vec4 colorVarying;
+
+void main() {
+    float radius = length(shapeCoord);
+    float edge = max(fwidth(radius), 0.0001);
+    float coverage = 1.0 - smoothstep(1.0 - edge, 1.0, radius);
+    if (coverage <= 0.0) discard;
+    OUT_COLOR = vec4(colorVarying.rgb, colorVarying.a * coverage);
+}
+)";
+
+bool SpriteBatch::isShaderAvailable() {
+    if (!shaderTried) {
+        shaderTried = true;
+
+        bool programmable = ofIsGLProgrammableRenderer();
+        string vertexShader, fragmentHeader;
+        if (programmable) {
+            // 単位四角形の角（-1〜1）をインスタンスの中心・大きさ・回転で画面に置く
+            vertexShader = R"(
+                #version 150
+                uniform mat4 modelViewProjectionMatrix;
+                in vec4 position;
+                in vec4 spriteBounds;
+                in vec4 spriteTransform;
+                in vec4 spriteColor;
+                out vec2 shapeCoord;
+                out vec4 colorVarying;
+
+                void main() {
+                    vec2 corner = position.xy;
+                    vec2 extent = corner * spriteBounds.zw;
+                    float c = cos(spriteTransform.x);
+                    float s = sin(spriteTransform.x);
+                    vec2 world = spriteBounds.xy + vec2(extent.x * c - extent.y * s, extent.x * s + extent.y * c);
+                    shapeCoord = spriteTransform.y < 0.5 ? corner : vec2(0.0);
+                    colorVarying = spriteColor;
+                    gl_Position = modelViewProjectionMatrix * vec4(world, 0.0, 1.0);
+                }
+            )";
+            fragmentHeader = "#version 150\n"
+                             "#define IN in\n"
+                             "#define OUT_COLOR outputColor\n"
+                             "out vec4 outputColor;\n";
+        } else {
+            // 頂点はCPUで展開済み
+            vertexShader = R"(
+                #version 120
+                varying vec2 shapeCoord;
+                varying vec4 colorVarying;
+
+                void main() {
+                    shapeCoord = gl_MultiTexCoord0.xy;
+                    colorVarying = gl_Color;
+                    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
+                }
+            )";
+            fragmentHeader = "#version 120\n"
+                             "#define IN varying\n"
+                             "#define OUT_COLOR gl_FragColor\n";
+        }
+
+        shader.setupShaderFromSource(GL_VERTEX_SHADER, vertexShader);
+        shader.setupShaderFromSource(GL_FRAGMENT_SHADER, fragmentHeader + SPRITE_FRAGMENT_BODY);
+        if (programmable) {
+            shader.bindDefaults();
+            shader.bindAttribute(BOUNDS_ATTRIBUTE, "spriteBounds");
+            shader.bindAttribute(TRANSFORM_ATTRIBUTE, "spriteTransform");
+            shader.bindAttribute(COLOR_ATTRIBUTE, "spriteColor");
+        }
+        shader.linkProgram();
+        MVLOG_INFO(LOG_CATEGORY_RENDER, "Sprite batch: %s", !shader.isLoaded() ? "shader failed, drawing one by one" :
+                   (programmable ? "instanced" : "expanded quads"));
+    }
+    return shader.isLoaded();
+}
+
+void SpriteBatch::draw() {
+    if (instances.empty()) return;
+    PROFILE_ZONE("SpriteBatch");
+
+    if (SoftwareRenderer* software = SoftwareRenderer::getCurrent()) {
+        // ヘッドレスのソフトウェアレンダラーにはシェーダーを使わずに直接描く
+        for (const auto& sprite : instances) {
+            software->drawSprite(sprite.x, sprite.y, sprite.halfWidth, sprite.halfHeight, sprite.rotation,
+                                 sprite.shape < 0.5f, ofFloatColor(sprite.r, sprite.g, sprite.b, sprite.a));
+        }
+    } else if (!isShaderAvailable()) {
+        drawImmediate();
+    } else if (ofIsGLProgrammableRenderer()) {
+        drawInstanced();
+    } else {
+        drawExpanded();
+    }
+    instances.clear();
+}
+
+void SpriteBatch::drawInstanced() {
+    if (!vboConfigured) {
+        vboConfigured = true;
+        const float corners[] = {-1, -1, 1, -1, 1, 1, -1, 1};
+        vbo.setVertexData(corners, 2, 4, GL_STATIC_DRAW);
+
+        buffer.allocate();
+        int stride = sizeof(SpriteInstance);
+        vbo.setAttributeBuffer(BOUNDS_ATTRIBUTE, buffer, 4, stride, offsetof(SpriteInstance, x));
+        vbo.setAttributeBuffer(TRANSFORM_ATTRIBUTE, buffer, 4, stride, offsetof(SpriteInstance, rotation));
+        vbo.setAttributeBuffer(COLOR_ATTRIBUTE, buffer, 4, stride, offsetof(SpriteInstance, r));
+        vbo.setAttributeDivisor(BOUNDS_ATTRIBUTE, 1);
+        vbo.setAttributeDivisor(TRANSFORM_ATTRIBUTE, 1);
+        vbo.setAttributeDivisor(COLOR_ATTRIBUTE, 1);
+    }
+
+    // 毎回確保し直す（GL_STREAM_DRAWの作り直しで、GPUが前のフレームの内容を読み終えるのを待たない）
+    buffer.setData(instances.size() * sizeof(SpriteInstance), instances.data(), GL_STREAM_DRAW);
+
+    shader.begin();
+    vbo.drawInstanced(GL_TRIANGLE_FAN, 0, 4, instances.size());
+    shader.end();
+}
+
+void SpriteBatch::drawExpanded() {
+    static const float CORNERS[6][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, -1}, {1, 1}, {-1, 1}};
+
+    vertices.resize(instances.size() * 6);
+    SpriteVertex* vertex = vertices.data();
+    for (const auto& sprite : instances) {
+        float c = cosf(sprite.rotation);
+        float s = sinf(sprite.rotation);
+        bool circle = sprite.shape < 0.5f;
+        for (const auto& corner : CORNERS) {
+            float extentX = corner[0] * sprite.halfWidth;
+            float extentY = corner[1] * sprite.halfHeight;
+            vertex->x = sprite.x + extentX * c - extentY * s;
+            vertex->y = sprite.y + extentX * s + extentY * c;
+            vertex->u = circle ? corner[0] : 0.0f;
+            vertex->v = circle ? corner[1] : 0.0f;
+            vertex->r = sprite.r;
+            vertex->g = sprite.g;
+            vertex->b = sprite.b;
+            vertex->a = sprite.a;
+            vertex++;
+        }
+    }
+
+    if (!vboConfigured) {
+        vboConfigured = true;
+        buffer.allocate();
+        int stride = sizeof(SpriteVertex);
+        vbo.setVertexBuffer(buffer, 2, stride, offsetof(SpriteVertex, x));
+        vbo.setTexCoordBuffer(buffer, stride, offsetof(SpriteVertex, u));
+        vbo.setColorBuffer(buffer, stride, offsetof(SpriteVertex, r));
+    }
+    buffer.setData(vertices.size() * sizeof(SpriteVertex), vertices.data(), GL_STREAM_DRAW);
+
+    shader.begin();
+    vbo.draw(GL_TRIANGLES, 0, vertices.size());
+    shader.end();
+}
+
+void SpriteBatch::drawImmediate() {
+    ofPushStyle();
+    ofFill();
+    for (const auto& sprite : instances) {
+        ofSetColor(ofFloatColor(sprite.r, sprite.g, sprite.b, sprite.a));
+        bool circle = sprite.shape < 0.5f;
+        if (sprite.rotation == 0.0f) {
+            if (circle) {
+                ofDrawEllipse(sprite.x, sprite.y, sprite.halfWidth * 2, sprite.halfHeight * 2);
+            } else {
+                ofDrawRectangle(sprite.x - sprite.halfWidth, sprite.y - sprite.halfHeight, sprite.halfWidth * 2, sprite.halfHeight * 2);
+            }
+        } else {
+            ofPushMatrix();
+            ofTranslate(sprite.x, sprite.y);
+            ofRotateRad(sprite.rotation);
+            if (circle) {
+                ofDrawEllipse(0, 0, sprite.halfWidth * 2, sprite.halfHeight * 2);
+            } else {
+                ofDrawRectangle(-sprite.halfWidth, -sprite.halfHeight, sprite.halfWidth * 2, sprite.halfHeight * 2);
+            }
+            ofPopMatrix();
+        }
+    }
+    ofPopStyle();
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "ofMain.h"
+#include <vector>
+
+// スプライトの形
+enum SpriteShape {
+    SPRITE_CIRCLE = 0,    // 楕円（半幅・半高が同じなら円）
+    SPRITE_RECT
+};
+
+// パーティクルのスプライトをまとめて描くバッチ
+// - add*()は位置・大きさ・回転・色・形をCPU側の配列に積むだけ（GLに触れないので、どのスレッドで積んでもよい）
+// - draw()は積んだ分を1つのバッファにアップロードし、今のブレンドモードで1回のドローコールで描いて空にする
+//   プログラマブルレンダラーでは1枚の四角形をインスタンス描画、そうでなければCPUで四角形に展開して1回で描く
+// - 円はフラグメントシェーダーで縁を切り抜く。シェーダーが使えなければ1つずつofDraw*で描く（従来と同じ）
+// ブレンドモードごとにdraw()を呼ぶ。配列とバッファは作り直さずに使い回す
+// コピーしても中身・バッファは写さない（PipelinedSystemがシステムの状態をワーカーで丸ごとコピーしても、
+// コピー先は自分のGLのバッファを持ち続け、描画スレッド以外で解放・確保しない）
+class SpriteBatch {
+public:
+    SpriteBatch() = default;
+    SpriteBatch(const SpriteBatch&) {}
+    SpriteBatch& operator=(const SpriteBatch&) { return *this; }
+
+    // colorのアルファは無視して、alpha（0〜255、ofSetColor(color, alpha)と同じ）を使う
+    void addCircle(const ofVec2f& center, float radius, const ofColor& color, float alpha) {
+        add(center.x, center.y, radius, radius, 0.0f, SPRITE_CIRCLE, color, alpha);
+    }
+
+    // ofDrawEllipseと同じく幅・高さは直径、回転はラジアン
+    void addEllipse(const ofVec2f& center, float width, float height, float rotation, const ofColor& color, float alpha) {
+        add(center.x, center.y, width * 0.5f, height * 0.5f, rotation, SPRITE_CIRCLE, color, alpha);
+    }
+
+    // 中心と幅・高さで指定する矩形
+    void addRect(const ofVec2f& center, float width, float height, const ofColor& color, float alpha) {
+        add(center.x, center.y, width * 0.5f, height * 0.5f, 0.0f, SPRITE_RECT, color, alpha);
+    }
+
+    void add(float x, float y, float halfWidth, float halfHeight, float rotation, SpriteShape shape, const ofColor& color, float alpha) {
+        instances.emplace_back();
+        SpriteInstance& sprite = instances.back();
+        sprite.x = x;
+        sprite.y = y;
+        sprite.halfWidth = halfWidth;
+        sprite.halfHeight = halfHeight;
+        sprite.rotation = rotation;
+        sprite.shape = shape;
+        sprite.r = color.r / 255.0f;
+        sprite.g = color.g / 255.0f;
+        sprite.b = color.b / 255.0f;
+        sprite.a = ofClamp(alpha, 0, 255) / 255.0f;
+    }
+
+    // 積んだスプライトを今のブレンドモードで描いて空にする（描画スレッド）
+    void draw();
+
+    void clear() { instances.clear(); }
+    std::size_t size() const { return instances.size(); }
+
+private:
+    // 1スプライト分のデータ（インスタンス描画ではこのままバッファに入れる）
+    struct SpriteInstance {
+        float x, y, halfWidth, halfHeight;    // spriteBounds
+        float rotation, shape, unused0, unused1;  // spriteTransform
+        float r, g, b, a;                     // spriteColor
+    };
+
+    // CPUで展開した頂点（プログラマブルでないレンダラー用）
+    struct SpriteVertex {
+        float x, y;
+        float u, v;       // 円の中の位置（-1〜1、矩形は0）
+        float r, g, b, a;
+    };
+
+    static bool isShaderAvailable();
+    void drawInstanced();
+    void drawExpanded();
+    void drawImmediate();
+
+    std::vector<SpriteInstance> instances;
+    std::vector<SpriteVertex> vertices;
+    ofBufferObject buffer;
+    ofVbo vbo;
+    bool vboConfigured = false;
+
+    static ofShader shader;
+    static bool shaderTried;
+};
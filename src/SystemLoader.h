@@ -0,0 +1,146 @@
+#pragma once
+
+#include "ofMain.h"
+#include "AsyncLog.h"
+#include "MidiEventQueue.h"
+#include "SystemRegistry.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// ビジュアルシステムの遅延構築
+// - 起動時は最初に表示するシステムだけを描画スレッドで作り、残りはバックグラウンドのスレッドが再生順に作ってsetup()する
+// - setup()がGLに触れるシステム（シェーダーのコンパイルなど）は、初めて使うときに描画スレッドで作る
+// - 描画スレッドはget()で準備済みのものだけを見る。acquire()は未着手なら自分で作り、ロード中なら完了を待つ
+// 乱数ストリームはシステム番号で決まるので、どの順・どのスレッドで作っても結果は同じ
+class SystemLoader {
+public:
+    ~SystemLoader() { stop(); }
+
+    // count個の枠を用意する（まだ作らない）。pipelinedなら分離できるシステムをPipelinedSystemで包む
+    void setup(std::size_t count, float initialDetailBudget, bool pipelinedSystems) {
+        stop();
+        systems.clear();
+        systems.resize(count);
+        states.reset(new std::atomic<int>[count]);
+        setupMillis.assign(count, 0.0f);
+        for (std::size_t i = 0; i < count; i++) {
+            states[i].store(SLOT_EMPTY, std::memory_order_relaxed);
+        }
+        detailBudget = initialDetailBudget;
+        pipelined = pipelinedSystems;
+    }
+
+    // 残りのシステムをorderの順にバックグラウンドで作る（GLに触れるシステムは飛ばす）
+    void startBackground(const std::vector<int>& order) {
+        stop();
+        stopRequested = false;
+        loadOrder = order;
+        for (std::size_t i = 0; i < systems.size(); i++) {
+            if (std::find(loadOrder.begin(), loadOrder.end(), (int)i) == loadOrder.end()) {
+                loadOrder.push_back(i);
+            }
+        }
+        worker = std::thread([this]() {
+            for (int index : loadOrder) {
+                if (stopRequested) break;
+                if (SystemRegistry::get(index).glSetup) continue;
+                if (claim(index)) {
+                    build(index, true);
+                }
+            }
+        });
+    }
+
+    // バックグラウンドの構築を止める（作りかけの1つは完成させる）
+    void stop() {
+        stopRequested = true;
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    // 描画スレッド: 準備済みならそのシステム、そうでなければnullptr
+    VisualSystem* get(int index) const {
+        if (index < 0 || index >= (int)systems.size()) return nullptr;
+        if (states[index].load(std::memory_order_acquire) != SLOT_READY) return nullptr;
+        return systems[index].get();
+    }
+
+    // 描画スレッド: 必ず準備済みのシステムを返す（未着手ならここで作り、ロード中なら待つ）
+    VisualSystem* acquire(int index) {
+        if (index < 0 || index >= (int)systems.size()) return nullptr;
+        if (claim(index)) {
+            build(index, false);
+        } else if (states[index].load(std::memory_order_acquire) != SLOT_READY) {
+            uint64_t waitStart = midiNowMicros();
+            std::unique_lock<std::mutex> lock(mutex);
+            readyCondition.wait(lock, [this, index]() { return states[index].load(std::memory_order_acquire) == SLOT_READY; });
+            MVLOG_INFO(LOG_CATEGORY_SYSTEM, "Waited %.1fms for %s", (midiNowMicros() - waitStart) / 1000.0f, SystemRegistry::get(index).displayName);
+        }
+        return systems[index].get();
+    }
+
+    bool isReady(int index) const { return get(index) != nullptr; }
+    std::size_t getReadyCount() const {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < systems.size(); i++) {
+            if (states[i].load(std::memory_order_acquire) == SLOT_READY) count++;
+        }
+        return count;
+    }
+    std::size_t size() const { return systems.size(); }
+
+    // 後始末（描画スレッド、バックグラウンドを止めてから）
+    void destroy() {
+        stop();
+        systems.clear();
+        states.reset();
+    }
+
+private:
+    enum SlotState {
+        SLOT_EMPTY,
+        SLOT_LOADING,
+        SLOT_READY
+    };
+
+    bool claim(int index) {
+        int expected = SLOT_EMPTY;
+        return states[index].compare_exchange_strong(expected, SLOT_LOADING, std::memory_order_acq_rel);
+    }
+
+    void build(int index, bool background) {
+        const SystemDescriptor& descriptor = SystemRegistry::get(index);
+        uint64_t start = midiNowMicros();
+
+        std::unique_ptr<VisualSystem> system = descriptor.create(pipelined);
+        system->seedRandom(index);
+        system->setDetailBudget(detailBudget);
+        system->setup();
+        systems[index] = std::move(system);
+        setupMillis[index] = (midiNowMicros() - start) / 1000.0f;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            states[index].store(SLOT_READY, std::memory_order_release);
+        }
+        readyCondition.notify_all();
+        MVLOG_INFO(LOG_CATEGORY_SYSTEM, "%s set up in %.1fms%s", descriptor.displayName, setupMillis[index],
+                   background ? " (background)" : "");
+    }
+
+    std::vector<std::unique_ptr<VisualSystem>> systems;   // 枠ごとに、状態がREADYになってから読む
+    std::unique_ptr<std::atomic<int>[]> states;
+    std::vector<float> setupMillis;
+    float detailBudget = 1.0f;
+    bool pipelined = true;   // --serial-updateではfalse（ワーカーがないのでスナップショットを公開する機会がない）
+
+    std::vector<int> loadOrder;
+    std::thread worker;
+    std::atomic<bool> stopRequested{false};
+    std::mutex mutex;
+    std::condition_variable readyCondition;
+};
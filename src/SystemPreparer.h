@@ -0,0 +1,99 @@
+#pragma once
+
+#include "ofMain.h"
+#include "AsyncLog.h"
+#include "MidiEventQueue.h"
+#include "VisualSystem.h"
+#include <atomic>
+#include <thread>
+
+// 自動切替の数小節前に、次のシステムを準備しておく
+// - ワーカースレッド: 非アクティブなシステムを固定dtで数秒分updateして状態を温める（GLには触れない）
+// - 描画スレッド: 温め終わったらレンダーターゲットをプールから借りておく
+// 準備中のシステムには描画スレッドから触らない（MIDI・詳細度の変更もしない）
+// 固定クロック中（高速再生・オフラインレンダー）は時計の読み取りが競合しないよう同期的に温める
+class SystemPreparer {
+public:
+    ~SystemPreparer() { cancel(); }
+
+    void start(int index, VisualSystem* target, float seconds, float deltaTime) {
+        cancel();
+        systemIndex = index;
+        system = target;
+        ready = false;
+        finished = false;
+        startMicros = midiNowMicros();
+
+        int steps = std::max(0, (int)(seconds / deltaTime));
+        if (SimViewport::isFixedClock()) {
+            system->prewarm(steps, deltaTime);
+            finished = true;
+        } else {
+            worker = std::thread([this, steps, deltaTime]() {
+                system->prewarm(steps, deltaTime);
+                finished = true;
+            });
+        }
+    }
+
+    // 毎フレーム呼ぶ（描画スレッド）。温め終わっていればレンダーターゲットを借りる
+    void poll() {
+        if (systemIndex < 0 || ready || !finished) return;
+        complete();
+    }
+
+    // 指定のシステムへ切り替える直前に呼ぶ。準備済み（または準備中）なら完了まで待ち、
+    // 別のシステムを準備していた場合は借りたターゲットを返して破棄する
+    void claim(int index) {
+        if (systemIndex < 0) return;
+        if (index == systemIndex) {
+            if (!ready) {
+                complete();
+            }
+            systemIndex = -1;
+            system = nullptr;
+            ready = false;
+        } else {
+            cancel();
+        }
+    }
+
+    // 準備を取り消す（ワーカーの終了を待ち、アクティブでなければターゲットを返す）
+    void cancel() {
+        if (worker.joinable()) {
+            worker.join();
+        }
+        if (system && !system->getActive()) {
+            system->discardPreparedTargets();
+        }
+        systemIndex = -1;
+        system = nullptr;
+        ready = false;
+    }
+
+    int getSystemIndex() const { return systemIndex; }
+    bool isPreparing(int index) const { return index == systemIndex && !ready; }
+    bool isReady() const { return ready; }
+    float getLastPrepareMillis() const { return lastPrepareMillis; }
+
+private:
+    void complete() {
+        if (worker.joinable()) {
+            worker.join();
+        }
+        // 温めた状態を公開しておく（パイプライン化したシステムは公開するまで初期状態を描く）
+        system->publishSnapshot();
+        system->prepareRenderTargets();
+        ready = true;
+        lastPrepareMillis = (midiNowMicros() - startMicros) / 1000.0f;
+        MVLOG_INFO(LOG_CATEGORY_SYSTEM, "System %d prepared in %.1fms", systemIndex, lastPrepareMillis);
+    }
+
+    int systemIndex = -1;
+    VisualSystem* system = nullptr;
+    std::thread worker;
+    std::atomic<bool> finished{false};
+    bool ready = false;
+    uint64_t startMicros = 0;
+    float lastPrepareMillis = 0.0f;
+};
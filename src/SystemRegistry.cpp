@@ -0,0 +1,149 @@
+#include "SystemRegistry.h"
+#include "PipelinedSystem.h"
+#include "ParticleSystem.h"
+#include "FractalSystem.h"
+#include "WaveSystem.h"
+#include "FlowFieldSystem.h"
+#include "LSystemSystem.h"
+#include "PerlinFlowSystem.h"
+#include "CurlNoiseSystem.h"
+#include "InfiniteCorridorSystem.h"
+#include "BuildingPerspectiveSystem.h"
+#include "WaterRippleSystem.h"
+#include "SandParticleSystem.h"
+#include "DifferentialGrowthSystem.h"
+#include "ReactionDiffusionSystem.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+// 自分の要素をポインタで指すシステム（分離できない）
+template<class T>
+static std::unique_ptr<VisualSystem> createSystem(bool) {
+    return std::make_unique<T>();
+}
+
+// 粒子系（コピーで状態を複製できる）はワーカーで更新できるよう分離する
+template<class T>
+static std::unique_ptr<VisualSystem> createPipelinable(bool pipelined) {
+    if (pipelined) {
+        return std::make_unique<PipelinedSystem<T>>();
+    }
+    return std::make_unique<T>();
+}
+
+const std::vector<SystemDescriptor>& SystemRegistry::all() {
+    // id, 表示名, updateゾーン, drawゾーン, キー, モノクロ, 実験, GLでsetup, 生成
+    static const std::vector<SystemDescriptor> systems = {
+        {"Particle", "Particles", "update Particles", "draw Particles", "1", false, false, false, createPipelinable<ParticleSystem>},
+        {"Fractal", "Fractals", "update Fractals", "draw Fractals", "2", false, false, true, createSystem<FractalSystem>},
+        {"Wave", "Waves", "update Waves", "draw Waves", "3", false, false, false, createSystem<WaveSystem>},
+        {"FlowField", "Flow Field", "update Flow Field", "draw Flow Field", "4", false, false, false, createPipelinable<FlowFieldSystem>},
+        {"LSystem", "L-System", "update L-System", "draw L-System", "5", false, false, false, createSystem<LSystemSystem>},
+        {"PerlinFlow", "Perlin Flow", "update Perlin Flow", "draw Perlin Flow", "6", false, false, false, createPipelinable<PerlinFlowSystem>},
+        {"CurlNoise", "Curl Noise", "update Curl Noise", "draw Curl Noise", "7", false, false, false, createPipelinable<CurlNoiseSystem>},
+        {"InfiniteCorridor", "Infinite Corridor", "update Infinite Corridor", "draw Infinite Corridor", "8", true, false, false, createSystem<InfiniteCorridorSystem>},
+        {"BuildingPerspective", "Building Perspective", "update Building Perspective", "draw Building Perspective", "9", true, false, false, createSystem<BuildingPerspectiveSystem>},
+        {"WaterRipple", "Water Ripple", "update Water Ripple", "draw Water Ripple", "0", true, false, false, createSystem<WaterRippleSystem>},
+        {"SandParticle", "Sand Particle", "update Sand Particle", "draw Sand Particle", "-_", true, false, false, createPipelinable<SandParticleSystem>},
+        {"DifferentialGrowth", "Differential Growth", "update Differential Growth", "draw Differential Growth", "", false, true, false, createSystem<DifferentialGrowthSystem>},
+        {"ReactionDiffusion", "Reaction Diffusion", "update Reaction Diffusion", "draw Reaction Diffusion", "", false, true, false, createSystem<ReactionDiffusionSystem>},
+    };
+    return systems;
+}
+
+std::size_t SystemRegistry::getLiveCount() {
+    std::size_t count = 0;
+    while (count < all().size() && !all()[count].experimental) {
+        count++;
+    }
+    return count;
+}
+
+// 比較用に英数字だけを小文字で残す（"Flow Field" = "flowfield" = "flow-field"）
+static string normalizeName(const string& name) {
+    string normalized;
+    for (char c : name) {
+        if (isalnum((unsigned char)c)) {
+            normalized += (char)tolower((unsigned char)c);
+        }
+    }
+    return normalized;
+}
+
+int SystemRegistry::find(const string& name, bool liveOnly) {
+    std::size_t count = liveOnly ? getLiveCount() : all().size();
+    string trimmed = ofTrim(name);
+    if (!trimmed.empty() && std::all_of(trimmed.begin(), trimmed.end(), [](char c) { return isdigit((unsigned char)c); })) {
+        int index = ofToInt(trimmed);
+        return index < (int)count ? index : -1;
+    }
+
+    string key = normalizeName(trimmed);
+    for (std::size_t i = 0; i < count; i++) {
+        if (key == normalizeName(all()[i].id) || key == normalizeName(all()[i].displayName)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int SystemRegistry::findByHotkey(int key) {
+    if (key <= 0 || key > 127) return -1;
+    std::size_t count = getLiveCount();
+    for (std::size_t i = 0; i < count; i++) {
+        if (strchr(all()[i].hotkeys, key)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+std::vector<int> SystemRegistry::getDefaultPlaybackOrder() {
+    std::vector<int> color, mono;
+    std::size_t count = getLiveCount();
+    for (std::size_t i = 0; i < count; i++) {
+        (all()[i].monochrome ? mono : color).push_back(i);
+    }
+
+    std::vector<int> order;
+    for (std::size_t i = 0; i < color.size() || i < mono.size(); i++) {
+        if (i < color.size()) order.push_back(color[i]);
+        if (i < mono.size()) order.push_back(mono[i]);
+    }
+    return order;
+}
+
+bool SystemRegistry::loadPlaybackOrder(const string& path, std::vector<int>& order) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    std::vector<int> loaded;
+    string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::size_t comment = line.find('#');
+        if (comment != string::npos) {
+            line = line.substr(0, comment);
+        }
+        if (ofTrim(line).empty()) continue;
+
+        int index = find(line);
+        if (index < 0) {
+            cout << "Playback order: unknown system '" << ofTrim(line) << "' (" << path << ":" << lineNumber << ")" << endl;
+            continue;
+        }
+        loaded.push_back(index);
+    }
+
+    if (loaded.empty()) {
+        cout << "Playback order: no systems in " << path << ", using default" << endl;
+        return false;
+    }
+    order = loaded;
+    cout << "Playback order: " << loaded.size() << " systems from " << path << endl;
+    return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "ofMain.h"
+#include "VisualSystem.h"
+#include <memory>
+#include <vector>
+
+// ビジュアルシステムの登録情報
+struct SystemDescriptor {
+    const char* id;              // 再生順序の設定ファイル・ベンチの --system で使う名前
+    const char* displayName;     // UI表示名
+    const char* updateZone;      // プロファイラのゾーン名（静的な文字列）
+    const char* drawZone;
+    const char* hotkeys;         // 直接切り替えるキー（なければ空）
+    bool monochrome;             // モノクロのパターン
+    bool experimental;           // ライブの再生順序には入れない（ヘッドレスベンチのみ）
+    bool glSetup;                // setup()がGLに触れる（描画スレッドでセットアップする）
+    // pipelinedなら、シミュレーションと描画を分離できるシステムはPipelinedSystemで包む
+    std::unique_ptr<VisualSystem> (*create)(bool pipelined);
+};
+
+// ビジュアルシステムの登録表（ofAppとヘッドレスベンチで共有）
+// - 登録番号 = システム番号 = 乱数ストリームの番号（並びを変えると乱数列が変わるので、追加は後ろへ）
+// - ライブ用のシステムが先、実験システムはその後ろ
+class SystemRegistry {
+public:
+    static const std::vector<SystemDescriptor>& all();
+    static const SystemDescriptor& get(std::size_t index) { return all()[index]; }
+    static std::size_t getLiveCount();
+
+    // idか表示名（大文字小文字・空白・記号を無視）、またはシステム番号。見つからなければ-1
+    static int find(const string& name, bool liveOnly = true);
+    static int findByHotkey(int key);
+
+    // 既定の再生順序（ライブ用のカラーとモノクロを交互に、余りは後ろに）
+    static std::vector<int> getDefaultPlaybackOrder();
+
+    // 1行に1システム（#以降はコメント）。読めなければorderはそのまま
+    static bool loadPlaybackOrder(const string& path, std::vector<int>& order);
+};
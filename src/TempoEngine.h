@@ -0,0 +1,320 @@
+#pragma once
+
+#include "ofMain.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+// テンポの推定とビート位置の予測
+// - キック: 打点を固定長のリングに積み、間隔を今のテンポの周期に折り返した中央値でBPMを推定する
+//   （1つ抜けた間隔は2で割って使い、半端な間隔は捨てるので、キックの抜け・余分な打点で崩れない）
+// - ビートのグリッドは位相同期で追従する。予測したビートの近くに来た打点だけで位相を少し寄せ、
+//   打点がなくても予測でビートは進む（一定時間打点がなければ止まる）
+// - MIDIクロック（0xF8、24PPQN）とスタート/ストップが届いている間はそちらに従う
+// 時刻はSimViewportの時間軸の秒（double）。getBeatPosition()は任意の時刻のビート位置を返す
+enum TempoSource {
+    TEMPO_SOURCE_NONE,
+    TEMPO_SOURCE_KICK,
+    TEMPO_SOURCE_CLOCK
+};
+
+class TempoEngine {
+public:
+    static constexpr float MIN_BPM = 60.0f;
+    static constexpr float MAX_BPM = 200.0f;
+
+    void reset(float initialBpm = 120.0f) {
+        period = 60.0 / initialBpm;
+        onsetCount = 0;
+        onsetHead = 0;
+        locked = false;
+        hasGrid = false;
+        gridTime = 0.0;
+        gridBeat = 0;
+        restartBeat = 0;
+        restartOnBeat = false;
+        lastOnsetTime = 0.0;
+        missedOnsets = 0;
+        clockRunning = false;
+        clockTicks = 0;
+        lastClockTime = -1.0;
+        tickIntervalCount = 0;
+        tickIntervalHead = 0;
+    }
+
+    void setClockSyncEnabled(bool enabled) { clockSyncEnabled = enabled; }
+    bool isClockSyncEnabled() const { return clockSyncEnabled; }
+
+    // キックの打点
+    void onOnset(double time) {
+        if (isClockActive(time)) return;  // クロック同期中は打点でテンポを動かさない
+
+        // 打点が来た時点のグリッドでのビート位置（最初の打点は次のビート、取り直しではそのビート）
+        double arrivalBeat = hasGrid ? getBeatPosition(time) : (restartOnBeat ? restartBeat : restartBeat + 1);
+        pushOnset(time, arrivalBeat);
+        lastOnsetTime = time;
+
+        if (!hasGrid) {
+            hasGrid = true;
+            gridTime = time;
+            gridBeat = (int64_t)arrivalBeat;
+            return;
+        }
+
+        double beats = (time - gridTime) / period;
+        int64_t nearest = (int64_t)std::floor(beats + 0.5);
+        double error = time - (gridTime + nearest * period);
+
+        if (!locked) {
+            // 推定に必要な打点が揃うまでは、打点ごとに1ビート進める（最高BPMより詰まった打点は数えない）
+            if (time - gridTime < 60.0 / MAX_BPM) return;
+            gridBeat += 1;
+            gridTime = time;
+            estimatePeriod();
+            locked = onsetCount >= MIN_ONSETS_TO_LOCK;
+            return;
+        }
+
+        if (std::abs(error) < period * PHASE_WINDOW && nearest == 0) {
+            // 今のビートへの2打目（フラム・ダブルキック）は数えない
+            return;
+        } else if (nearest >= 1 && std::abs(error) < period * PHASE_WINDOW) {
+            // 予測したビートの近く: 位相を寄せ、周期を推定し直す
+            gridBeat += nearest;
+            gridTime += nearest * period + error * PHASE_GAIN;
+            if (missedOnsets > 0) missedOnsets--;  // テンポが変わると外れと偶然の一致が混ざるので、0には戻さない
+            estimatePeriod();
+        } else {
+            // 外れが重なるか、直近の間隔が揃って別のテンポを示したら取り直す（ビート番号は続ける）
+            double newPeriod = period;
+            bool steady = findSteadyPeriod(newPeriod);
+            bool tempoChanged = steady && std::abs(newPeriod - period) > period * STEADY_TOLERANCE;
+            if (++missedOnsets >= RELOCK_ONSETS || tempoChanged) {
+                // 間隔が揃っていれば、揃い始めた打点から新しい周期で数える（古いグリッドは変わった後の打点を誤って拾っている）
+                // そうでなければ今のグリッドで最も近いビート。どちらもこの打点をそのビートとして取り直す
+                int64_t beat = steady ? countBeatsSinceTempoChange(newPeriod) : std::llround(arrivalBeat);
+                restartFrom(beat, true);
+                period = newPeriod;
+                onOnset(time);
+            }
+        }
+    }
+
+    // MIDIのリアルタイムメッセージ
+    void onClockTick(double time) {
+        if (!clockSyncEnabled) return;
+        if (lastClockTime >= 0.0) {
+            double interval = time - lastClockTime;
+            if (interval > 0.0 && interval < MAX_TICK_INTERVAL) {
+                tickIntervals[tickIntervalHead] = interval;
+                tickIntervalHead = (tickIntervalHead + 1) % TICKS_PER_BEAT;
+                if (tickIntervalCount < TICKS_PER_BEAT) tickIntervalCount++;
+                if (tickIntervalCount >= TICKS_PER_BEAT / 2) {
+                    period = ofClamp(median(tickIntervals.data(), tickIntervalCount) * TICKS_PER_BEAT, 60.0 / MAX_BPM, 60.0 / MIN_BPM);
+                }
+            }
+        }
+        lastClockTime = time;
+
+        // スタートを受けていなくても、クロックが流れていれば追従する
+        if (!clockRunning) {
+            clockRunning = true;
+            clockTicks = getBeatCount(time) * TICKS_PER_BEAT;
+        }
+        clockTicks++;
+    }
+
+    void onClockStart(double time) {
+        if (!clockSyncEnabled) return;
+        clockRunning = true;
+        clockTicks = 0;   // 次のティックが曲頭（ビート0）
+        lastClockTime = -1.0;
+        clockStartTime = time;
+    }
+
+    void onClockContinue(double time) {
+        if (!clockSyncEnabled) return;
+        clockRunning = true;
+        lastClockTime = -1.0;
+        clockStartTime = time;
+    }
+
+    void onClockStop(double time) {
+        if (!clockSyncEnabled) return;
+        // 止まった位置のビートのまま、次のキックから追従し直す
+        restartFrom(clockTicks / TICKS_PER_BEAT);
+    }
+
+    // 任意の時刻（フレーム中のクエリ）のビート位置。打点が途切れたら最後の打点から少し先で止まる
+    double getBeatPosition(double time) const {
+        if (isClockActive(time)) {
+            double ticksSince = lastClockTime >= 0.0 ? std::min((time - lastClockTime) / (period / TICKS_PER_BEAT), 1.0) : 0.0;
+            return std::max(0.0, (clockTicks - 1 + ticksSince) / (double)TICKS_PER_BEAT);
+        }
+        if (!hasGrid) return restartBeat;
+
+        double clamped = std::min(time, lastOnsetTime + period * COAST_BEATS);
+        return std::max(0.0, gridBeat + (clamped - gridTime) / period);
+    }
+
+    int64_t getBeatCount(double time) const { return (int64_t)std::floor(getBeatPosition(time)); }
+    float getBeatPhase(double time) const {
+        double position = getBeatPosition(time);
+        return position - std::floor(position);
+    }
+
+    // ビート位置の予測時刻（getBeatPosition()の逆。打点が途切れても止めずに延長する）
+    // ビートの基準がまだなければ無限大
+    double getBeatTime(double beat) const {
+        if (clockSyncEnabled && clockRunning) {
+            double tickSeconds = period / TICKS_PER_BEAT;
+            if (lastClockTime < 0.0) return clockStartTime + (beat * TICKS_PER_BEAT - clockTicks) * tickSeconds;
+            return lastClockTime + (beat * TICKS_PER_BEAT - (clockTicks - 1)) * tickSeconds;
+        }
+        if (!hasGrid) return std::numeric_limits<double>::infinity();
+        return gridTime + (beat - gridBeat) * period;
+    }
+
+    // 次のビートの予測時刻（クロック・キックどちらでも）
+    double getNextBeatTime(double time) const {
+        return time + (1.0 - getBeatPhase(time)) * period;
+    }
+
+    float getBpm() const { return 60.0 / period; }
+    double getBeatPeriod() const { return period; }
+    bool isLocked() const { return locked; }
+
+    TempoSource getSource(double time) const {
+        if (isClockActive(time)) return TEMPO_SOURCE_CLOCK;
+        if (hasGrid && time - lastOnsetTime < period * COAST_BEATS) return TEMPO_SOURCE_KICK;
+        return TEMPO_SOURCE_NONE;
+    }
+
+private:
+    static const int ONSET_CAPACITY = 16;
+    static const int TICKS_PER_BEAT = 24;
+    static const int MIN_ONSETS_TO_LOCK = 4;
+    static const int RELOCK_ONSETS = 4;
+    static const int STEADY_INTERVALS = 6;            // テンポが変わったと判断する、揃った間隔の数
+    static const int MAX_SAMPLES = 24;                // median()に渡す最大個数（打点・ティックの大きい方）
+    static constexpr double PHASE_WINDOW = 0.25;      // 予測ビートから周期の±25%以内なら同じビート
+    static constexpr double PHASE_GAIN = 0.3;         // 位相誤差の何割を寄せるか
+    static constexpr double FOLD_TOLERANCE = 0.2;     // 折り返した間隔が周期から±20%以内なら使う
+    static constexpr double STEADY_TOLERANCE = 0.1;   // 間隔が揃っているとみなす中央値からのずれ
+    static constexpr double COAST_BEATS = 8.0;        // 打点なしで予測を進めるビート数
+    static constexpr double MAX_TICK_INTERVAL = 0.25;  // これより空いたティックは測らない（40BPM未満）
+    static constexpr double CLOCK_TIMEOUT = 0.5;      // これだけティックが来なければクロック同期を外れる
+
+    bool isClockActive(double time) const {
+        return clockSyncEnabled && clockRunning &&
+               (lastClockTime >= 0.0 ? time - lastClockTime < CLOCK_TIMEOUT : time - clockStartTime < CLOCK_TIMEOUT);
+    }
+
+    // 打点の履歴を捨てて取り直す（テンポ・ビート番号は引き継ぐ）
+    // onsetIsBeatなら次の打点をbeatそのもの、そうでなければbeatの次のビートとする
+    void restartFrom(int64_t beat, bool onsetIsBeat = false) {
+        double previousPeriod = period;
+        reset();
+        period = previousPeriod;
+        restartBeat = beat;
+        restartOnBeat = onsetIsBeat;
+    }
+
+    void pushOnset(double time, double beat) {
+        onsets[onsetHead] = time;
+        onsetBeats[onsetHead] = beat;
+        onsetHead = (onsetHead + 1) % ONSET_CAPACITY;
+        if (onsetCount < ONSET_CAPACITY) onsetCount++;
+    }
+
+    // 隣り合う打点の間隔を今の周期に折り返し、その中央値を周期とする
+    void estimatePeriod() {
+        std::array<double, ONSET_CAPACITY> intervals;
+        int count = 0;
+        int first = (onsetHead - onsetCount + ONSET_CAPACITY) % ONSET_CAPACITY;
+        for (int i = 1; i < onsetCount; i++) {
+            double interval = onsets[(first + i) % ONSET_CAPACITY] - onsets[(first + i - 1) % ONSET_CAPACITY];
+            if (!locked) {
+                // 取り始めは範囲内の生の間隔だけを使う
+                if (interval >= 60.0 / MAX_BPM && interval <= 60.0 / MIN_BPM) {
+                    intervals[count++] = interval;
+                }
+                continue;
+            }
+            double multiple = std::floor(interval / period + 0.5);
+            if (multiple < 1.0) continue;
+            double folded = interval / multiple;
+            if (std::abs(folded - period) < period * FOLD_TOLERANCE) {
+                intervals[count++] = folded;
+            }
+        }
+        if (count >= MIN_ONSETS_TO_LOCK - 1) {
+            period = ofClamp(median(intervals.data(), count), 60.0 / MAX_BPM, 60.0 / MIN_BPM);
+        }
+    }
+
+    // 直近の打点の間隔が範囲内で揃っていれば、その周期を返す
+    bool findSteadyPeriod(double& steadyPeriod) const {
+        if (onsetCount <= STEADY_INTERVALS) return false;
+        std::array<double, STEADY_INTERVALS> intervals;
+        int last = (onsetHead - 1 + ONSET_CAPACITY) % ONSET_CAPACITY;
+        for (int i = 0; i < STEADY_INTERVALS; i++) {
+            int index = (last - i + ONSET_CAPACITY) % ONSET_CAPACITY;
+            intervals[i] = onsets[index] - onsets[(index - 1 + ONSET_CAPACITY) % ONSET_CAPACITY];
+        }
+        double candidate = median(intervals.data(), STEADY_INTERVALS);
+        if (candidate < 60.0 / MAX_BPM || candidate > 60.0 / MIN_BPM) return false;
+        for (double interval : intervals) {
+            if (std::abs(interval - candidate) > candidate * STEADY_TOLERANCE) return false;
+        }
+        steadyPeriod = candidate;
+        return true;
+    }
+
+    // 直近の打点まで間隔がsteadyPeriodで揃っている区間の始まりを探し、そのビート番号（来た時点のグリッド）から
+    // 新しい周期で直近の打点のビート番号を数える
+    int64_t countBeatsSinceTempoChange(double steadyPeriod) const {
+        int last = (onsetHead - 1 + ONSET_CAPACITY) % ONSET_CAPACITY;
+        int start = last;
+        for (int i = 1; i < onsetCount; i++) {
+            int previous = (start - 1 + ONSET_CAPACITY) % ONSET_CAPACITY;
+            double interval = onsets[start] - onsets[previous];
+            if (std::abs(interval - steadyPeriod) > steadyPeriod * STEADY_TOLERANCE) break;
+            start = previous;
+        }
+        return std::llround(onsetBeats[start]) + std::llround((onsets[last] - onsets[start]) / steadyPeriod);
+    }
+
+    static double median(const double* values, int count) {
+        std::array<double, MAX_SAMPLES> sorted;
+        std::copy(values, values + count, sorted.begin());
+        std::nth_element(sorted.begin(), sorted.begin() + count / 2, sorted.begin() + count);
+        return sorted[count / 2];
+    }
+
+    // キック
+    double period = 0.5;
+    std::array<double, ONSET_CAPACITY> onsets;
+    std::array<double, ONSET_CAPACITY> onsetBeats;   // 打点が来た時点のグリッドでのビート位置
+    int onsetCount = 0;
+    int onsetHead = 0;
+    bool locked = false;
+    bool hasGrid = false;
+    double gridTime = 0.0;      // gridBeat番目のビートの時刻
+    int64_t gridBeat = 0;
+    int64_t restartBeat = 0;    // 取り直したときのビート番号（最初の打点が次のビート）
+    bool restartOnBeat = false; // 最初の打点をrestartBeatそのものとする（テンポの取り直し）
+    double lastOnsetTime = 0.0;
+    int missedOnsets = 0;
+
+    // MIDIクロック
+    bool clockSyncEnabled = true;
+    bool clockRunning = false;
+    int64_t clockTicks = 0;
+    double lastClockTime = -1.0;
+    double clockStartTime = 0.0;
+    std::array<double, TICKS_PER_BEAT> tickIntervals;
+    int tickIntervalCount = 0;
+    int tickIntervalHead = 0;
+};
@@ -0,0 +1,5 @@
+#include "VisualRandom.h"
+#include <random>
+
+// 静的メンバ変数の定義（--seed未指定時は起動ごとに変わる）
+uint64_t VisualRandom::globalSeed = std::random_device{}();
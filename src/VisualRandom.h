@@ -0,0 +1,141 @@
+#pragma once
+
+#include "ofMain.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+
+// システム専用のシード可能な乱数生成器（xoshiro128+、状態16バイト）
+// ofRandomはlibcのrand()のグローバル状態を共有するため、並列化もフレームの再現もできない
+// 各VisualSystemが1つずつ所有し、グローバルシード＋ストリーム番号から初期化する
+class VisualRandom {
+public:
+    VisualRandom(uint64_t seedValue = 0) {
+        seed(seedValue);
+    }
+    
+    // SplitMix64で64bitシードを128bitの状態に展開
+    void seed(uint64_t seedValue) {
+        for (int i = 0; i < 4; i += 2) {
+            uint64_t z = (seedValue += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            z = z ^ (z >> 31);
+            state[i] = (uint32_t)z;
+            state[i + 1] = (uint32_t)(z >> 32);
+        }
+    }
+    
+    uint32_t nextUInt() {
+        uint32_t result = state[0] + state[3];
+        uint32_t t = state[1] << 9;
+        
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 11);
+        
+        return result;
+    }
+    
+    uint64_t nextUInt64() {
+        uint64_t high = nextUInt();
+        return (high << 32) | nextUInt();
+    }
+    
+    // [0, 1)（上位24bitを使用）
+    float randomuf() {
+        return (nextUInt() >> 8) * (1.0f / 16777216.0f);
+    }
+    
+    // [-1, 1)
+    float randomf() {
+        return randomuf() * 2.0f - 1.0f;
+    }
+    
+    // ofRandom(max)互換: [0, max)
+    float random(float max) {
+        return randomuf() * max;
+    }
+    
+    // ofRandom(min, max)互換: [min, max)
+    float random(float min, float max) {
+        return min + randomuf() * (max - min);
+    }
+    
+    // === ベクトルヘルパー ===
+    ofVec2f randomVec2(float maxX, float maxY) {
+        return ofVec2f(random(maxX), random(maxY));
+    }
+    
+    ofVec2f randomVec2(float minX, float maxX, float minY, float maxY) {
+        return ofVec2f(random(minX, maxX), random(minY, maxY));
+    }
+    
+    // 単位ベクトル
+    ofVec2f randomDirection() {
+        float angle = random(TWO_PI);
+        return ofVec2f(cos(angle), sin(angle));
+    }
+    
+    // 円内に一様分布
+    ofVec2f randomInCircle(float radius) {
+        float r = radius * sqrt(randomuf());
+        return randomDirection() * r;
+    }
+    
+    // === バッチAPI（スポーン時の一括生成） ===
+    void fill(float* out, std::size_t count, float min, float max) {
+        float range = max - min;
+        for (std::size_t i = 0; i < count; i++) {
+            out[i] = min + randomuf() * range;
+        }
+    }
+    
+    void fill(std::vector<float>& out, float min, float max) {
+        fill(out.data(), out.size(), min, max);
+    }
+    
+    void fillVec2(ofVec2f* out, std::size_t count, float maxX, float maxY) {
+        for (std::size_t i = 0; i < count; i++) {
+            out[i].x = random(maxX);
+            out[i].y = random(maxY);
+        }
+    }
+    
+    // 状態のフィンガープリント（再現性の確認用）
+    uint64_t fingerprint() const {
+        return ((uint64_t)(state[0] ^ state[2]) << 32) | (state[1] ^ state[3]);
+    }
+    
+    // === グローバルシード ===
+    // 同じシード・同じMIDI入力ならシミュレーション状態がビット単位で一致する
+    static void setGlobalSeed(uint64_t seedValue) { globalSeed = seedValue; }
+    static uint64_t getGlobalSeed() { return globalSeed; }
+    
+    // 起動引数のシード（10進の符号なし整数）を読む。数値でなければfalse（例外は投げない）
+    static bool parseSeed(const char* text, uint64_t& seedValue) {
+        if (!text || *text == '\0' || *text == '-') return false;
+        char* end = nullptr;
+        errno = 0;
+        unsigned long long value = std::strtoull(text, &end, 10);
+        if (errno != 0 || *end != '\0') return false;
+        seedValue = value;
+        return true;
+    }
+    
+    // グローバルシードとストリーム番号から独立したシードを導出
+    static uint64_t deriveSeed(uint64_t stream) {
+        return globalSeed ^ (stream * 0xD1B54A32D192ED03ULL);
+    }
+    
+private:
+    static uint32_t rotl(uint32_t x, int k) {
+        return (x << k) | (x >> (32 - k));
+    }
+    
+    uint32_t state[4];
+    static uint64_t globalSeed;
+};
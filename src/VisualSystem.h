@@ -2,30 +2,115 @@
 
 #include "ofMain.h"
 #include "ofxMidi.h"
+#include "DrawCommandList.h"
+#include "FrameProfiler.h"
+#include "LineBatch.h"
+#include "PostEffects.h"
+#include "RenderTargetPool.h"
+#include "SimViewport.h"
+#include "SoftwareRenderer.h"
+#include "SpriteBatch.h"
+#include "VisualRandom.h"
+
+template<class T> class PipelinedSystem;
 
 class VisualSystem {
+    template<class T> friend class PipelinedSystem;
+    
 public:
     VisualSystem() {}
     virtual ~VisualSystem() {}
     
+    // PipelinedSystemで包めるか（状態を丸ごとコピーしてスナップショットにしてよいか）
+    // 包むシステムは、自分の要素を指すポインタ・参照や、コピーで共有されるGL・スレッドの資源を持たないことを確かめてtrueにする
+    // レンダーターゲットとバッチは基底クラス側で扱う（入れ替え・コピーしない）
+    static constexpr bool SNAPSHOT_COPYABLE = false;
+    
     virtual void setup() = 0;
     virtual void update(float deltaTime) = 0;
     virtual void draw() = 0;
     
     virtual void onMidiMessage(ofxMidiMessage& msg) = 0;
     
+    // アクティブな間だけプールからレンダーターゲットを借りる
     void setActive(bool active) { 
         isActive = active; 
-        if (active && !isInitialized) {
-            setupGlobalEffects();
-            isInitialized = true;
+        if (active) {
+            acquireRenderTargets();
+        } else {
+            releaseRenderTargets();
         }
     }
     bool getActive() const { return isActive; }
     
+    // 切替前の準備: 非アクティブのままレンダーターゲットだけ先に借りる／使わなかったら返す
+    void prepareRenderTargets() { acquireRenderTargets(); }
+    void discardPreparedTargets() {
+        if (!isActive) releaseRenderTargets();
+    }
+    
+    // シミュレーションと描画を分離したシステム（PipelinedSystem）はtrue
+    // update()をワーカースレッドで回してよく、draw()はpublishSnapshot()で公開した状態だけを読む
+    virtual bool isPipelined() const { return false; }
+    
+    // そのフレームの最後のupdate()の後に1回呼ぶ（ワーカースレッド可）。結果を公開待ちのスナップショットに写す
+    virtual void captureSnapshot() {}
+    
+    // フレーム境界（ワーカー停止中）で呼ぶ。captureSnapshot()で写した結果を描画側に公開する
+    virtual void publishSnapshot() {}
+    
+    // 1フレーム描く（外からはdraw()ではなくこちらを呼ぶ）
+    // draw()の中で使う乱数は、今のシミュレーションの乱数状態から導いた描画専用のストリームに差し替え、
+    // 描き終えたら乱数とアクセントカラーを戻す。シミュレーションの状態は描いた回数によらずupdate()だけで決まる
+    void render() {
+        VisualRandom simulationRng = rng;
+        int simulationAccent = accentIndex;
+        rng.seed(simulationRng.fingerprint() ^ DRAW_STREAM_SALT);
+        draw();
+        rng = simulationRng;
+        accentIndex = simulationAccent;
+    }
+    
+    // 固定dtでupdateだけを回して状態を温める（レンダーターゲットを借りる前ならGLに触れないので別スレッドから呼べる）
+    void prewarm(int steps, float deltaTime) {
+        for (int i = 0; i < steps; i++) {
+            update(deltaTime);
+        }
+        captureSnapshot();
+    }
+    
+    // 乱数ストリームの初期化（グローバルシード＋システム番号、setup()より前に呼ぶ）
+    void seedRandom(uint64_t stream) { rng.seed(VisualRandom::deriveSeed(stream)); }
+    uint64_t getRandomFingerprint() const { return rng.fingerprint(); }
+    
+    // 詳細度（密度上限の倍率、1.0 = 従来の上限）。QualityGovernorがフレーム予算に合わせて調整する
+    void setDetailBudget(float budget) { detailBudget = budget; }
+    float getDetailBudget() const { return detailBudget; }
+    
+    // 描画時の補間の割合（update()は固定の刻みで進むので、直前の2ステップの間のどこを描くか、0〜1）
+    void setRenderInterpolation(float alpha) { renderAlpha = alpha; }
+    
 protected:
     bool isActive = false;
-    bool isInitialized = false;
+    
+    // システム専用の乱数（ofRandomの代わり）
+    VisualRandom rng;
+    
+    // 詳細度と、それでスケールした上限値（各システムの密度上限はこれを通す）
+    float detailBudget = 1.0f;
+    // 要素数（size()）と比べるのでsize_tで返す
+    std::size_t detailCap(float baseCap) const { return (std::size_t)std::max(1, (int)(baseCap * detailBudget)); }
+    
+    // 描画用の補間（previousは直前のステップ開始時の値）
+    float renderAlpha = 1.0f;
+    ofVec2f interpolate(const ofVec2f& previous, const ofVec2f& current) const {
+        return previous + (current - previous) * renderAlpha;
+    }
+    
+    // 60fpsで調整した1フレームあたりの減衰率を、刻み幅に依らない形にする
+    static float frameDecay(float perFrame, float deltaTime) {
+        return pow(perFrame, deltaTime * 60.0f);
+    }
     
     // 共通のMIDIパラメータ
     float intensity = 0.0f;
@@ -44,11 +129,16 @@ protected:
     float decayTimer = 0.0f;               // 崩壊タイマー
     float collapseThreshold = 1.0f;        // 崩壊開始閾値
     float collapseDuration = 5.0f;         // 崩壊継続時間
+    uint32_t growthResetCount = 0;         // 成長リセットの回数（描画側がバッファのクリアを検出する）
+    uint32_t clearedResetCount = 0;        // バッファをクリア済みのリセット回数
     
     // === 画面全体エフェクト ===
-    ofFbo masterBuffer;                    // メインレンダリングバッファ
-    ofFbo trailBuffer;                     // 累積トレイルバッファ
-    ofFbo distortionBuffer;                // 歪みエフェクトバッファ
+    RenderTarget masterBuffer;             // メインレンダリングバッファ（アクティブ中のみ）
+    RenderTarget trailBuffer;              // 累積トレイルバッファ（アクティブ中のみ）
+    std::shared_ptr<SoftwareBuffers> softwareBuffers;  // ヘッドレスでSoftwareRendererに描くときのマスター・トレイル
+    SpriteBatch sprites;                   // パーティクルのスプライトの一括描画（ブレンドモードごとにdraw()）
+    LineBatch lines;                       // 線分の一括描画（ブレンドモードごとにdraw()）
+    DrawCommandList commands;              // 状態つきの描画の記録（flush()で並べ替えてまとめて再生）
     
     float screenShakeIntensity = 0.0f;     // 画面振動強度
     ofVec2f screenOffset;                  // 画面オフセット
@@ -68,6 +158,8 @@ protected:
     
     // === カラーモード管理 ===
     bool isMonochromeMode = false;         // モノクロモードフラグ
+    int accentIndex = 0;                   // 現在のアクセントカラー（描画中に選び直した分はrender()が戻す）
+    static constexpr uint64_t DRAW_STREAM_SALT = 0x44524157ULL;   // 描画専用の乱数ストリーム（"DRAW"）
     static bool globalMonochromeMode;       // 全システム共通のモノクロモード
     
     // ドラムタイプの識別（General MIDI準拠）
@@ -83,32 +175,29 @@ protected:
         TOM_LOW = 45
     };
     
-    // === セットアップ関数 ===
-    void setupGlobalEffects() {
-        int width = ofGetWidth();
-        int height = ofGetHeight();
+    // === レンダーターゲットの貸し借り ===
+    // システム固有のバッファを持つ場合はオーバーライドして基底も呼ぶ
+    virtual void acquireRenderTargets() {
+        // ヘッドレス時はシミュレーションのみ（FBOは確保しない）
+        if (SimViewport::isHeadless() || masterBuffer) return;
         
-        // FBOの初期化
-        masterBuffer.allocate(width, height, GL_RGBA);
-        trailBuffer.allocate(width, height, GL_RGBA);
-        distortionBuffer.allocate(width, height, GL_RGBA);
+        int width = SimViewport::getWidth();
+        int height = SimViewport::getHeight();
         
-        // バッファをクリア
-        masterBuffer.begin();
-        ofClear(0, 0);
-        masterBuffer.end();
-        
-        trailBuffer.begin();
-        ofClear(0, 0);
-        trailBuffer.end();
-        
-        distortionBuffer.begin();
-        ofClear(0, 0);
-        distortionBuffer.end();
+        // プールから借りた時点でクリア済み
+        masterBuffer = RenderTargetPool::acquire(width, height, GL_RGBA);
+        trailBuffer = RenderTargetPool::acquire(width, height, GL_RGBA);
+    }
+    
+    virtual void releaseRenderTargets() {
+        masterBuffer.reset();
+        trailBuffer.reset();
+        softwareBuffers.reset();
     }
     
     // === 更新関数 ===
     void updateGlobalEffects(float deltaTime) {
+        PROFILE_ZONE("updateGlobalEffects");
         systemTime += deltaTime;
         
         // 成長システムの更新
@@ -133,7 +222,7 @@ protected:
             globalGrowthLevel += deltaTime * acceleratedGrowth;
             
             // 成長加速度の減衰
-            growthAcceleration *= 0.98f;
+            growthAcceleration *= frameDecay(0.98f, deltaTime);
             
             // 成長完了チェック
             if (globalGrowthLevel >= collapseThreshold) {
@@ -155,17 +244,17 @@ protected:
     void updateScreenEffects(float deltaTime) {
         // 画面振動の更新
         if (screenShakeIntensity > 0.01f) {
-            screenOffset.x = ofRandom(-screenShakeIntensity, screenShakeIntensity) * 10;
-            screenOffset.y = ofRandom(-screenShakeIntensity, screenShakeIntensity) * 10;
-            screenShakeIntensity *= 0.9f;
+            screenOffset.x = rng.random(-screenShakeIntensity, screenShakeIntensity) * 10;
+            screenOffset.y = rng.random(-screenShakeIntensity, screenShakeIntensity) * 10;
+            screenShakeIntensity *= frameDecay(0.9f, deltaTime);
         } else {
-            screenOffset *= 0.8f;
+            screenOffset *= frameDecay(0.8f, deltaTime);
         }
         
         // 歪みエフェクトの更新
-        distortionLevel *= 0.95f;
-        chromaticAberration *= 0.98f;
-        bloomIntensity *= 0.96f;
+        distortionLevel *= frameDecay(0.95f, deltaTime);
+        chromaticAberration *= frameDecay(0.98f, deltaTime);
+        bloomIntensity *= frameDecay(0.96f, deltaTime);
         
         // ビネット効果
         vignette = globalGrowthLevel * 0.3f + impactIntensity * 0.2f;
@@ -183,22 +272,57 @@ protected:
     
     // === エフェクト描画 ===
     void beginMasterBuffer() {
-        masterBuffer.begin();
+        PROFILE_ZONE("beginMasterBuffer");
+        
+        // 成長リセット後の最初の描画でバッファをクリア
+        if (clearedResetCount != growthResetCount) {
+            clearRenderTargets();
+            clearedResetCount = growthResetCount;
+        }
+        
+        if (masterBuffer) {
+            masterBuffer->begin();
+        } else if (SoftwareRenderer* software = SoftwareRenderer::getCurrent()) {
+            // ヘッドレス: FBOの代わりにCPUのバッファに描く
+            if (!softwareBuffers) {
+                softwareBuffers = std::make_shared<SoftwareBuffers>();
+            }
+            software->beginTarget(softwareBuffers->master, SimViewport::getWidth(), SimViewport::getHeight());
+        }
         
         // 背景のクリア（完全ではなく、トレイル効果を残す）- ホワイトアウト防止で大幅に暗く
         ofEnableBlendMode(OF_BLENDMODE_MULTIPLY);
         ofColor fadeColor = urbanColor(currentNote, 0.1f);
         fadeColor.setBrightness(ofClamp(60 - globalGrowthLevel * 10, 15, 80)); // 非常に暗い背景に変更
         ofSetColor(fadeColor);
-        ofDrawRectangle(0, 0, ofGetWidth(), ofGetHeight());
+        ofDrawRectangle(0, 0, SimViewport::getWidth(), SimViewport::getHeight());
         ofDisableBlendMode();
     }
     
     void endMasterBuffer() {
-        masterBuffer.end();
+        if (masterBuffer) {
+            masterBuffer->end();
+        } else if (SoftwareRenderer* software = SoftwareRenderer::getCurrent()) {
+            software->endTarget();
+        }
     }
     
     void drawFullscreenEffects() {
+        PROFILE_ZONE("drawFullscreenEffects");
+        
+        if (!masterBuffer) {
+            drawSoftwareEffects();
+            return;
+        }
+        
+        // シェーダーが使えればトレイル更新1パス + 合成1パス
+        if (PostEffects::isAvailable()) {
+            PostEffectParams params = makePostEffectParams();
+            PostEffects::updateTrail(*trailBuffer, *masterBuffer, params);
+            PostEffects::composite(*masterBuffer, *trailBuffer, params);
+            return;
+        }
+        
         // 累積トレイルの更新
         updateTrailBuffer();
         
@@ -209,23 +333,77 @@ protected:
         drawAdditionalEffects();
     }
     
+    // ヘッドレス: 同じ全画面エフェクトをCPUの参照実装で計算し、今の描く先（画面）の全面を上書きする
+    void drawSoftwareEffects() {
+        SoftwareRenderer* software = SoftwareRenderer::getCurrent();
+        if (!software || !softwareBuffers) return;
+        
+        SoftwareBuffers& buffers = *softwareBuffers;
+        if (buffers.trail.getWidth() != buffers.master.getWidth() || buffers.trail.getHeight() != buffers.master.getHeight()) {
+            buffers.trail.allocate(buffers.master.getWidth(), buffers.master.getHeight(), OF_PIXELS_RGBA);
+            buffers.trail.set(0);
+        }
+        
+        PostEffectParams params = makePostEffectParams();
+        PostEffects::referenceTrail(buffers.trail, buffers.master, params, buffers.scratch);
+        buffers.trail.swap(buffers.scratch);
+        PostEffects::referenceComposite(buffers.master, buffers.trail, params, software->getTargetPixels());
+    }
+    
+    // 今の状態から全画面エフェクトのパラメータを作る（下の複数パスの描画と同じ値・同じ乱数の消費順）
+    PostEffectParams makePostEffectParams() {
+        PostEffectParams params;
+        params.width = SimViewport::getWidth();
+        params.height = SimViewport::getHeight();
+        
+        // ofSetColorに渡していた0〜255の値と同じ丸め
+        params.trailFade = (int)(254 - globalGrowthLevel * 10) / 255.0f;
+        params.trailGain = (int)(100 + globalGrowthLevel * 100) / 255.0f;
+        params.trailMix = (int)(150 + globalGrowthLevel * 80) / 255.0f;
+        
+        params.offset = screenOffset;
+        if (distortionLevel > 0.1f) {
+            params.scale = 1.0f + distortionLevel * 0.1f;
+        }
+        if (chromaticAberration > 0.1f) {
+            params.aberration = chromaticAberration * 5;
+        }
+        if (vignette > 0.1f) {
+            params.vignette = vignette;
+        }
+        
+        if (saturationBoost > 1.1f || contrastLevel > 1.1f) {
+            ofColor boostColor = accentColor(globalGrowthLevel);
+            params.boostColor = ofFloatColor(boostColor.r / 255.0f, boostColor.g / 255.0f, boostColor.b / 255.0f,
+                                             (unsigned char)ofClamp((saturationBoost - 1.0f) * 30, 0, 255) / 255.0f);
+        }
+        
+        if (globalGrowthLevel > 0.1f) {
+            ofColor glowColor = isCollapsing ? ofColor(255, 100, 100) : accentColor(globalGrowthLevel);
+            params.glowColor = ofFloatColor(glowColor.r / 255.0f, glowColor.g / 255.0f, glowColor.b / 255.0f,
+                                            (unsigned char)(globalGrowthLevel * 80) / 255.0f);
+            params.glowThickness = globalGrowthLevel * 20;
+        }
+        return params;
+    }
+    
     void updateTrailBuffer() {
-        trailBuffer.begin();
+        trailBuffer->begin();
         
         // 軽い減衰
         ofEnableBlendMode(OF_BLENDMODE_MULTIPLY);
         float fadeAmount = 254 - globalGrowthLevel * 10; // 成長に応じてトレイルを残す
         ofSetColor(fadeAmount);
-        ofDrawRectangle(0, 0, ofGetWidth(), ofGetHeight());
+        ofDrawRectangle(0, 0, SimViewport::getWidth(), SimViewport::getHeight());
         ofDisableBlendMode();
         
         // メインバッファの内容を追加
         ofEnableBlendMode(OF_BLENDMODE_ADD);
         ofSetColor(255, 100 + globalGrowthLevel * 100); // 成長に応じて強く
-        masterBuffer.draw(0, 0);
+        masterBuffer->draw(0, 0);
         ofDisableBlendMode();
         
-        trailBuffer.end();
+        trailBuffer->end();
     }
     
     void drawBufferWithEffects() {
@@ -238,9 +416,9 @@ protected:
         if (distortionLevel > 0.1f) {
             // 簡易的な歪み（拡大縮小）
             float scale = 1.0f + distortionLevel * 0.1f;
-            ofTranslate(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f);
+            ofTranslate(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f);
             ofScale(scale, scale);
-            ofTranslate(-ofGetWidth() * 0.5f, -ofGetHeight() * 0.5f);
+            ofTranslate(-SimViewport::getWidth() * 0.5f, -SimViewport::getHeight() * 0.5f);
         }
         
         // 色収差効果
@@ -250,26 +428,26 @@ protected:
             // 赤チャンネル
             ofEnableBlendMode(OF_BLENDMODE_ADD);
             ofSetColor(255, 0, 0, 180);
-            masterBuffer.draw(-offset, 0);
+            masterBuffer->draw(-offset, 0);
             
             // 緑チャンネル
             ofSetColor(0, 255, 0, 180);
-            masterBuffer.draw(0, 0);
+            masterBuffer->draw(0, 0);
             
             // 青チャンネル
             ofSetColor(0, 0, 255, 180);
-            masterBuffer.draw(offset, 0);
+            masterBuffer->draw(offset, 0);
             ofDisableBlendMode();
         } else {
             // 通常描画
             ofSetColor(255);
-            masterBuffer.draw(0, 0);
+            masterBuffer->draw(0, 0);
         }
         
         // トレイルバッファの合成
         ofEnableBlendMode(OF_BLENDMODE_ADD);
         ofSetColor(255, 150 + globalGrowthLevel * 80);
-        trailBuffer.draw(0, 0);
+        trailBuffer->draw(0, 0);
         ofDisableBlendMode();
         
         ofPopMatrix();
@@ -283,8 +461,8 @@ protected:
             ofMesh vignetteMesh;
             vignetteMesh.setMode(OF_PRIMITIVE_TRIANGLE_FAN);
             
-            float centerX = ofGetWidth() * 0.5f;
-            float centerY = ofGetHeight() * 0.5f;
+            float centerX = SimViewport::getWidth() * 0.5f;
+            float centerY = SimViewport::getHeight() * 0.5f;
             float maxRadius = sqrt(centerX * centerX + centerY * centerY);
             
             // 中心点
@@ -317,7 +495,7 @@ protected:
             boostColor.a = (saturationBoost - 1.0f) * 30;
             
             ofSetColor(boostColor);
-            ofDrawRectangle(0, 0, ofGetWidth(), ofGetHeight());
+            ofDrawRectangle(0, 0, SimViewport::getWidth(), SimViewport::getHeight());
             
             ofDisableBlendMode();
         }
@@ -341,12 +519,12 @@ protected:
             float glowThickness = globalGrowthLevel * 20;
             
             // 上下のグロー
-            ofDrawRectangle(0, 0, ofGetWidth(), glowThickness);
-            ofDrawRectangle(0, ofGetHeight() - glowThickness, ofGetWidth(), glowThickness);
+            ofDrawRectangle(0, 0, SimViewport::getWidth(), glowThickness);
+            ofDrawRectangle(0, SimViewport::getHeight() - glowThickness, SimViewport::getWidth(), glowThickness);
             
             // 左右のグロー
-            ofDrawRectangle(0, 0, glowThickness, ofGetHeight());
-            ofDrawRectangle(ofGetWidth() - glowThickness, 0, glowThickness, ofGetHeight());
+            ofDrawRectangle(0, 0, glowThickness, SimViewport::getHeight());
+            ofDrawRectangle(SimViewport::getWidth() - glowThickness, 0, glowThickness, SimViewport::getHeight());
             
             ofDisableBlendMode();
         }
@@ -354,7 +532,7 @@ protected:
     
     // === インパクトエフェクトの更新 ===
     void updateImpact(float deltaTime) {
-        impactIntensity *= pow(impactDecay, deltaTime * 60.0f);
+        impactIntensity *= frameDecay(impactDecay, deltaTime);
         if (impactIntensity < 0.01f) impactIntensity = 0.0f;
         
         // intensityも徐々に減衰
@@ -433,14 +611,23 @@ protected:
         chromaticAberration = 0.0f;
         bloomIntensity = 0.0f;
         
-        // バッファクリア
-        trailBuffer.begin();
-        ofClear(0, 0);
-        trailBuffer.end();
-        
-        masterBuffer.begin();
-        ofClear(0, 0);
-        masterBuffer.end();
+        // バッファクリアは次のbeginMasterBuffer()で行う（update()をGLなしのワーカーで回せるように）
+        growthResetCount++;
+    }
+    
+    void clearRenderTargets() {
+        if (masterBuffer) {
+            trailBuffer->begin();
+            ofClear(0, 0);
+            trailBuffer->end();
+            
+            masterBuffer->begin();
+            ofClear(0, 0);
+            masterBuffer->end();
+        } else if (softwareBuffers) {
+            softwareBuffers->master.set(0);
+            softwareBuffers->trail.set(0);
+        }
     }
     
     // === ユーティリティ関数 ===
@@ -516,12 +703,11 @@ protected:
                 ofVec3f(255, 140, 0),   // 街灯・アンバー
             };
             
-            static int lastIndex = 0;
             if (intensity > 0.7f || impactIntensity > 0.8f) {
-                lastIndex = ofRandom(urbanAccents.size());
+                accentIndex = rng.random(urbanAccents.size());
             }
             
-            ofVec3f accent = urbanAccents[lastIndex];
+            ofVec3f accent = urbanAccents[accentIndex];
             ofColor color;
             
             float boostFactor = 1.0f + globalGrowthLevel * 0.5f + impactIntensity * 0.8f;
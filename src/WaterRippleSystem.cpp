@@ -1,7 +1,7 @@
 #include "WaterRippleSystem.h"
 
 WaterRippleSystem::WaterRippleSystem() {
-    waterLevel = ofGetHeight() * 0.5f;
+    waterLevel = SimViewport::getHeight() * 0.5f;
     waterOpacity = 80.0f;
     surfaceTension = 0.8f;
     waveAmplitude = 10.0f;
@@ -40,20 +40,20 @@ void WaterRippleSystem::setup() {
     // 自律的な波紋中心点の初期化
     for (int i = 0; i < 6; i++) {
         ofVec2f center(
-            ofRandom(ofGetWidth() * 0.2f, ofGetWidth() * 0.8f),
-            ofRandom(ofGetHeight() * 0.2f, ofGetHeight() * 0.8f)
+            rng.random(SimViewport::getWidth() * 0.2f, SimViewport::getWidth() * 0.8f),
+            rng.random(SimViewport::getHeight() * 0.2f, SimViewport::getHeight() * 0.8f)
         );
         autonomousRippleCenters.push_back(center);
     }
     
     // 初期波紋の生成
     for (int i = 0; i < 3; i++) {
-        createRipple(ofVec2f(ofRandom(ofGetWidth()), ofRandom(ofGetHeight())), 0.5f);
+        createRipple(ofVec2f(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight())), 0.5f);
     }
 }
 
 void WaterRippleSystem::update(float deltaTime) {
-    float currentTime = ofGetElapsedTimef();
+    float currentTime = SimViewport::getElapsedTimef();
     
     // 時間歪曲効果
     float adjustedDeltaTime = deltaTime * timeDistortionFactor;
@@ -74,15 +74,15 @@ void WaterRippleSystem::update(float deltaTime) {
     calculateRippleInteraction();
     
     // ランダムな波紋生成
-    if (ofRandom(1.0f) < rippleSpawnRate * adjustedDeltaTime) {
-        ofVec2f randomPos(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
-        createRipple(randomPos, ofRandom(0.3f, 0.8f));
+    if (rng.random(1.0f) < rippleSpawnRate * adjustedDeltaTime) {
+        ofVec2f randomPos(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
+        createRipple(randomPos, rng.random(0.3f, 0.8f));
     }
     
     // 量子揺らぎによる波紋
-    if (ofRandom(1.0f) < quantumFluctuationRate * adjustedDeltaTime) {
-        ofVec2f quantumPos(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
-        createRippleCluster(quantumPos, ofRandom(3, 7), ofRandom(50, 120));
+    if (rng.random(1.0f) < quantumFluctuationRate * adjustedDeltaTime) {
+        ofVec2f quantumPos(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
+        createRippleCluster(quantumPos, rng.random(3, 7), rng.random(50, 120));
     }
     
     // 環境効果の更新
@@ -90,10 +90,10 @@ void WaterRippleSystem::update(float deltaTime) {
     turbulenceStrength = 0.2f + sin(currentTime * 0.5f) * 0.15f;
     
     // MIDI連動強度の減衰
-    kickIntensity *= 0.90f;
-    snareIntensity *= 0.85f;
-    hihatIntensity *= 0.80f;
-    crashIntensity *= 0.75f;
+    kickIntensity *= frameDecay(0.90f, deltaTime);
+    snareIntensity *= frameDecay(0.85f, deltaTime);
+    hihatIntensity *= frameDecay(0.80f, deltaTime);
+    crashIntensity *= frameDecay(0.75f, deltaTime);
     
     // 成長レベルに基づく時間歪曲
     timeDistortionFactor = 1.0f + globalGrowthLevel * 0.5f;
@@ -132,14 +132,14 @@ void WaterRippleSystem::createRipple(ofVec2f position, float intensity) {
     ripple.radius = 0.0f;
     ripple.maxRadius = 150.0f + intensity * 100.0f;
     ripple.intensity = intensity;
-    ripple.speed = rippleSpeed + ofRandom(-20, 20);
-    ripple.creationTime = ofGetElapsedTimef();
-    ripple.lifetime = rippleLifetime + ofRandom(-1, 1);
+    ripple.speed = rippleSpeed + rng.random(-20, 20);
+    ripple.creationTime = SimViewport::getElapsedTimef();
+    ripple.lifetime = rippleLifetime + rng.random(-1, 1);
     ripple.isActive = true;
     ripple.rippleColor = ofColor(
-        rippleColor.r + ofRandom(-20, 20),
-        rippleColor.g + ofRandom(-20, 20),
-        rippleColor.b + ofRandom(-20, 20)
+        rippleColor.r + rng.random(-20, 20),
+        rippleColor.g + rng.random(-20, 20),
+        rippleColor.b + rng.random(-20, 20)
     );
     
     ripples.push_back(ripple);
@@ -152,13 +152,13 @@ void WaterRippleSystem::createRippleCluster(ofVec2f center, int count, float spr
     RippleCluster cluster;
     cluster.center = center;
     cluster.clusterRadius = spread;
-    cluster.activationTime = ofGetElapsedTimef();
-    cluster.intensity = ofRandom(0.5f, 1.2f);
+    cluster.activationTime = SimViewport::getElapsedTimef();
+    cluster.intensity = rng.random(0.5f, 1.2f);
     cluster.isExpanding = true;
     
     for (int i = 0; i < count; i++) {
         float angle = (float)i / count * TWO_PI;
-        float distance = ofRandom(0, spread);
+        float distance = rng.random(0, spread);
         ofVec2f ripplePos = center + ofVec2f(
             cos(angle) * distance,
             sin(angle) * distance
@@ -168,9 +168,9 @@ void WaterRippleSystem::createRippleCluster(ofVec2f center, int count, float spr
         ripple.center = ripplePos;
         ripple.radius = 0.0f;
         ripple.maxRadius = 80.0f + distance * 0.5f;
-        ripple.intensity = cluster.intensity * ofRandom(0.7f, 1.3f);
-        ripple.speed = rippleSpeed * ofRandom(0.8f, 1.2f);
-        ripple.creationTime = ofGetElapsedTimef() + i * 0.1f;
+        ripple.intensity = cluster.intensity * rng.random(0.7f, 1.3f);
+        ripple.speed = rippleSpeed * rng.random(0.8f, 1.2f);
+        ripple.creationTime = SimViewport::getElapsedTimef() + i * 0.1f;
         ripple.lifetime = rippleLifetime;
         ripple.isActive = true;
         ripple.rippleColor = rippleColor;
@@ -185,7 +185,7 @@ void WaterRippleSystem::updateRipples(float deltaTime) {
     for (auto& ripple : ripples) {
         if (!ripple.isActive) continue;
         
-        float age = ofGetElapsedTimef() - ripple.creationTime;
+        float age = SimViewport::getElapsedTimef() - ripple.creationTime;
         if (age > ripple.lifetime) {
             ripple.isActive = false;
             continue;
@@ -196,7 +196,7 @@ void WaterRippleSystem::updateRipples(float deltaTime) {
         
         // 異常な物理: 重力異常による波紋の歪み
         if (gravitationalAnomalyStrength > 0.0f) {
-            ofVec2f screenCenter(ofGetWidth() * 0.5f, ofGetHeight() * 0.5f);
+            ofVec2f screenCenter(SimViewport::getWidth() * 0.5f, SimViewport::getHeight() * 0.5f);
             ofVec2f toCenter = screenCenter - ripple.center;
             float distance = toCenter.length();
             
@@ -243,8 +243,8 @@ void WaterRippleSystem::updateWaterParticles(float deltaTime) {
         particle.size = 2.0f + (1.0f - particle.life / particle.maxLife) * 3.0f;
         
         // 画面外で非活性化
-        if (particle.position.x < -50 || particle.position.x > ofGetWidth() + 50 ||
-            particle.position.y < -50 || particle.position.y > ofGetHeight() + 50) {
+        if (particle.position.x < -50 || particle.position.x > SimViewport::getWidth() + 50 ||
+            particle.position.y < -50 || particle.position.y > SimViewport::getHeight() + 50) {
             particle.isActive = false;
         }
     }
@@ -256,7 +256,7 @@ void WaterRippleSystem::updateRippleClusters(float deltaTime) {
         for (auto& ripple : cluster.ripples) {
             if (!ripple.isActive) continue;
             
-            float rippleAge = ofGetElapsedTimef() - ripple.creationTime;
+            float rippleAge = SimViewport::getElapsedTimef() - ripple.creationTime;
             if (rippleAge > ripple.lifetime) {
                 ripple.isActive = false;
                 continue;
@@ -285,39 +285,39 @@ void WaterRippleSystem::updateRippleClusters(float deltaTime) {
 void WaterRippleSystem::updateAutonomousRipples(float deltaTime) {
     for (auto& center : autonomousRippleCenters) {
         // 自律的な移動
-        float moveAngle = ofNoise(center.x * 0.01f, center.y * 0.01f, ofGetElapsedTimef() * 0.5f) * TWO_PI;
+        float moveAngle = ofNoise(center.x * 0.01f, center.y * 0.01f, SimViewport::getElapsedTimef() * 0.5f) * TWO_PI;
         ofVec2f moveDir(cos(moveAngle), sin(moveAngle));
         
         center += moveDir * autonomousMovementSpeed * deltaTime;
         
         // 画面境界での反射
-        if (center.x < 50 || center.x > ofGetWidth() - 50) {
-            center.x = ofClamp(center.x, 50, ofGetWidth() - 50);
+        if (center.x < 50 || center.x > SimViewport::getWidth() - 50) {
+            center.x = ofClamp(center.x, 50, SimViewport::getWidth() - 50);
         }
-        if (center.y < 50 || center.y > ofGetHeight() - 50) {
-            center.y = ofClamp(center.y, 50, ofGetHeight() - 50);
+        if (center.y < 50 || center.y > SimViewport::getHeight() - 50) {
+            center.y = ofClamp(center.y, 50, SimViewport::getHeight() - 50);
         }
         
         // 自律的な波紋生成
-        if (ofRandom(1.0f) < 0.02f) {
-            createRipple(center, ofRandom(0.4f, 0.9f));
+        if (rng.random(1.0f) < 0.02f) {
+            createRipple(center, rng.random(0.4f, 0.9f));
         }
     }
 }
 
 void WaterRippleSystem::drawWaterSurface() {
     ofSetColor(waterDark.r, waterDark.g, waterDark.b, waterOpacity);
-    ofDrawRectangle(0, 0, ofGetWidth(), ofGetHeight());
+    ofDrawRectangle(0, 0, SimViewport::getWidth(), SimViewport::getHeight());
     
     // 水面の波の描画
     ofSetColor(waterMedium.r, waterMedium.g, waterMedium.b, waterOpacity * 0.7f);
     ofSetLineWidth(2.0f);
     
-    for (float y = 0; y < ofGetHeight(); y += 30) {
+    for (float y = 0; y < SimViewport::getHeight(); y += 30) {
         ofBeginShape();
-        for (float x = 0; x <= ofGetWidth(); x += 10) {
-            float waveHeight = sin(x * waveFrequency + ofGetElapsedTimef() * 2.0f) * waveAmplitude;
-            waveHeight += sin(x * waveFrequency * 2.3f + ofGetElapsedTimef() * 1.5f) * waveAmplitude * 0.5f;
+        for (float x = 0; x <= SimViewport::getWidth(); x += 10) {
+            float waveHeight = sin(x * waveFrequency + SimViewport::getElapsedTimef() * 2.0f) * waveAmplitude;
+            waveHeight += sin(x * waveFrequency * 2.3f + SimViewport::getElapsedTimef() * 1.5f) * waveAmplitude * 0.5f;
             
             ofVertex(x, y + waveHeight);
         }
@@ -358,9 +358,9 @@ void WaterRippleSystem::drawWaterParticles() {
     for (const auto& particle : waterParticles) {
         if (!particle.isActive) continue;
         
-        ofSetColor(foamColor.r, foamColor.g, foamColor.b, particle.alpha);
-        ofDrawCircle(particle.position.x, particle.position.y, particle.size);
+        sprites.addCircle(particle.position, particle.size, foamColor, particle.alpha);
     }
+    sprites.draw();
 }
 
 void WaterRippleSystem::drawRippleClusters() {
@@ -380,8 +380,7 @@ void WaterRippleSystem::drawRippleClusters() {
 }
 
 void WaterRippleSystem::drawInterferencePattern() {
-    ofSetColor(waterLight.r, waterLight.g, waterLight.b, 40);
-    
+    // 線分は水面の波と同じ太さでまとめて描く
     // 波紋同士の干渉パターンを描画
     for (int i = 0; i < ripples.size(); i++) {
         for (int j = i + 1; j < ripples.size(); j++) {
@@ -391,13 +390,11 @@ void WaterRippleSystem::drawInterferencePattern() {
             if (distance < 200.0f) {
                 float interferenceStrength = (200.0f - distance) / 200.0f;
                 
-                ofSetColor(waterLight.r, waterLight.g, waterLight.b, 
-                          interferenceStrength * 30.0f);
-                ofDrawLine(ripples[i].center.x, ripples[i].center.y,
-                          ripples[j].center.x, ripples[j].center.y);
+                lines.addLine(ripples[i].center, ripples[j].center, 2.0f, waterLight, interferenceStrength * 30.0f);
             }
         }
     }
+    lines.draw();
 }
 
 void WaterRippleSystem::drawQuantumFluctuations() {
@@ -405,9 +402,9 @@ void WaterRippleSystem::drawQuantumFluctuations() {
     
     // 量子揺らぎによる微細な波紋
     for (int i = 0; i < 20; i++) {
-        float noiseX = ofNoise(i * 0.1f, ofGetElapsedTimef() * 0.3f) * ofGetWidth();
-        float noiseY = ofNoise(i * 0.1f + 100, ofGetElapsedTimef() * 0.3f) * ofGetHeight();
-        float noiseRadius = ofNoise(i * 0.1f + 200, ofGetElapsedTimef() * 0.5f) * 30.0f + 5.0f;
+        float noiseX = ofNoise(i * 0.1f, SimViewport::getElapsedTimef() * 0.3f) * SimViewport::getWidth();
+        float noiseY = ofNoise(i * 0.1f + 100, SimViewport::getElapsedTimef() * 0.3f) * SimViewport::getHeight();
+        float noiseRadius = ofNoise(i * 0.1f + 200, SimViewport::getElapsedTimef() * 0.5f) * 30.0f + 5.0f;
         
         ofDrawCircle(noiseX, noiseY, noiseRadius);
     }
@@ -442,15 +439,15 @@ void WaterRippleSystem::spawnWaterParticles(ofVec2f position, float intensity) {
     
     for (int i = 0; i < particleCount; i++) {
         WaterParticle particle;
-        particle.position = position + ofVec2f(ofRandom(-10, 10), ofRandom(-10, 10));
+        particle.position = position + ofVec2f(rng.random(-10, 10), rng.random(-10, 10));
         
-        float angle = ofRandom(TWO_PI);
-        float speed = ofRandom(50, 150) * intensity;
+        float angle = rng.random(TWO_PI);
+        float speed = rng.random(50, 150) * intensity;
         particle.velocity.set(cos(angle) * speed, sin(angle) * speed - 100);
         
-        particle.life = ofRandom(0.5f, 2.0f);
+        particle.life = rng.random(0.5f, 2.0f);
         particle.maxLife = particle.life;
-        particle.size = ofRandom(1.0f, 4.0f);
+        particle.size = rng.random(1.0f, 4.0f);
         particle.alpha = 255.0f;
         particle.isActive = true;
         
@@ -487,7 +484,7 @@ void WaterRippleSystem::onMidiMessage(ofxMidiMessage& msg) {
             kickIntensity = velocity;
             
             // 強力な波紋を生成
-            ofVec2f kickPos(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
+            ofVec2f kickPos(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
             createRipple(kickPos, velocity * 1.5f);
         }
         else if (note == 38) {  // SNARE
@@ -495,7 +492,7 @@ void WaterRippleSystem::onMidiMessage(ofxMidiMessage& msg) {
             
             // 複数の波紋を同時生成
             for (int i = 0; i < 3; i++) {
-                ofVec2f snarePos(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
+                ofVec2f snarePos(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
                 createRipple(snarePos, velocity * 0.8f);
             }
         }
@@ -503,15 +500,15 @@ void WaterRippleSystem::onMidiMessage(ofxMidiMessage& msg) {
             hihatIntensity = velocity;
             
             // 小さな波紋を高頻度で生成
-            ofVec2f hihatPos(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
+            ofVec2f hihatPos(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
             createRipple(hihatPos, velocity * 0.5f);
         }
         else if (note == 49) {  // CRASH
             crashIntensity = velocity;
             
             // 大規模な波紋クラスターを生成
-            ofVec2f crashPos(ofRandom(ofGetWidth() * 0.3f, ofGetWidth() * 0.7f),
-                            ofRandom(ofGetHeight() * 0.3f, ofGetHeight() * 0.7f));
+            ofVec2f crashPos(rng.random(SimViewport::getWidth() * 0.3f, SimViewport::getWidth() * 0.7f),
+                            rng.random(SimViewport::getHeight() * 0.3f, SimViewport::getHeight() * 0.7f));
             createRippleCluster(crashPos, 8, 200.0f * velocity);
             
             // 時間歪曲効果を一時的に強化
@@ -523,13 +520,13 @@ void WaterRippleSystem::onMidiMessage(ofxMidiMessage& msg) {
 void WaterRippleSystem::onBeatDetected(float velocity) {
     // ビート検出で自律的な波紋中心を移動
     for (auto& center : autonomousRippleCenters) {
-        float angle = ofRandom(TWO_PI);
+        float angle = rng.random(TWO_PI);
         float distance = velocity * 50.0f;
         center += ofVec2f(cos(angle) * distance, sin(angle) * distance);
         
         // 画面内に制限
-        center.x = ofClamp(center.x, 50, ofGetWidth() - 50);
-        center.y = ofClamp(center.y, 50, ofGetHeight() - 50);
+        center.x = ofClamp(center.x, 50, SimViewport::getWidth() - 50);
+        center.y = ofClamp(center.y, 50, SimViewport::getHeight() - 50);
     }
     
     // 波紋の生成頻度を一時的に上げる
@@ -62,11 +62,11 @@ public:
         // 初期波レイヤーの設定（密度削減）
         for (int i = 0; i < 3; i++) {
             WaveLayer layer;
-            layer.amplitude = ofRandom(30, 120);
-            layer.frequency = ofRandom(0.003f, 0.025f);
-            layer.speed = ofRandom(0.3f, 2.5f);
-            layer.phase = ofRandom(TWO_PI);
-            layer.growthPhase = ofRandom(TWO_PI);
+            layer.amplitude = rng.random(30, 120);
+            layer.frequency = rng.random(0.003f, 0.025f);
+            layer.speed = rng.random(0.3f, 2.5f);
+            layer.phase = rng.random(TWO_PI);
+            layer.growthPhase = rng.random(TWO_PI);
             layer.color = urbanColor(i * 18, 0.8f);
             waveLayers.push_back(layer);
         }
@@ -80,10 +80,10 @@ public:
         vectorField.clear();
         for (int i = 0; i < 8; i++) {
             VectorNode node;
-            node.position = ofVec2f(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
-            node.velocity = ofVec2f(ofRandom(-0.5f, 0.5f), ofRandom(-0.5f, 0.5f));
-            node.phase = ofRandom(TWO_PI);
-            node.influence = ofRandom(0.3f, 0.8f);
+            node.position = ofVec2f(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
+            node.velocity = ofVec2f(rng.random(-0.5f, 0.5f), rng.random(-0.5f, 0.5f));
+            node.phase = rng.random(TWO_PI);
+            node.influence = rng.random(0.3f, 0.8f);
             node.lifespan = 1.0f;
             vectorField.push_back(node);
         }
@@ -92,10 +92,10 @@ public:
         fluidPoints.clear();
         for (int i = 0; i < 12; i++) {
             FluidPoint point;
-            point.position = ofVec2f(ofGetWidth() * (i / 12.0f), ofGetHeight() * 0.5f + ofRandom(-100, 100));
-            point.velocity = ofVec2f(ofRandom(-0.3f, 0.3f), ofRandom(-0.2f, 0.2f));
-            point.phase = ofRandom(TWO_PI);
-            point.influence = ofRandom(0.4f, 0.9f);
+            point.position = ofVec2f(SimViewport::getWidth() * (i / 12.0f), SimViewport::getHeight() * 0.5f + rng.random(-100, 100));
+            point.velocity = ofVec2f(rng.random(-0.3f, 0.3f), rng.random(-0.2f, 0.2f));
+            point.phase = rng.random(TWO_PI);
+            point.influence = rng.random(0.4f, 0.9f);
             point.color = urbanColor(i * 15, 0.6f);
             fluidPoints.push_back(point);
         }
@@ -228,7 +228,7 @@ public:
             } else if (msg.control == 7) { // Volume
                 float vol = mapCC(msg.value);
                 for (auto& layer : waveLayers) {
-                    layer.amplitude = ofRandom(30, 120) * vol * (1.0f + globalGrowthLevel);
+                    layer.amplitude = rng.random(30, 120) * vol * (1.0f + globalGrowthLevel);
                 }
             }
         }
@@ -239,8 +239,8 @@ private:
         // 流体的相互作用背景帯
         ofEnableBlendMode(OF_BLENDMODE_ADD);
         
-        float width = ofGetWidth();
-        float height = ofGetHeight();
+        float width = SimViewport::getWidth();
+        float height = SimViewport::getHeight();
         
         // 流体ポイント間の接続による帯の形成
         for (int i = 0; i < fluidPoints.size() - 1; i++) {
@@ -316,8 +316,8 @@ private:
     void drawMainWaves() {
         ofEnableBlendMode(OF_BLENDMODE_ADD);
         
-        float width = ofGetWidth();
-        float height = ofGetHeight();
+        float width = SimViewport::getWidth();
+        float height = SimViewport::getHeight();
         
         for (int layerIdx = 0; layerIdx < waveLayers.size(); layerIdx++) {
             auto& layer = waveLayers[layerIdx];
@@ -460,13 +460,13 @@ private:
             node.position += node.velocity * deltaTime * 20.0f;
             
             // 境界での反射
-            if (node.position.x < 0 || node.position.x > ofGetWidth()) {
+            if (node.position.x < 0 || node.position.x > SimViewport::getWidth()) {
                 node.velocity.x *= -0.8f;
-                node.position.x = ofClamp(node.position.x, 0, ofGetWidth());
+                node.position.x = ofClamp(node.position.x, 0, SimViewport::getWidth());
             }
-            if (node.position.y < 0 || node.position.y > ofGetHeight()) {
+            if (node.position.y < 0 || node.position.y > SimViewport::getHeight()) {
                 node.velocity.y *= -0.8f;
-                node.position.y = ofClamp(node.position.y, 0, ofGetHeight());
+                node.position.y = ofClamp(node.position.y, 0, SimViewport::getHeight());
             }
             
             // 寿命管理
@@ -544,9 +544,9 @@ private:
         // 高成長時の粒子効果（密度削減）
         int numParticles = 8 + globalGrowthLevel * 12;
         for (int i = 0; i < numParticles; i++) {
-            float x = ofRandom(ofGetWidth());
+            float x = rng.random(SimViewport::getWidth());
             // ランダムな散在配置（中央集中を避ける）
-            float baseY = ofRandom(ofGetHeight() * 0.2f, ofGetHeight() * 0.8f);
+            float baseY = rng.random(SimViewport::getHeight() * 0.2f, SimViewport::getHeight() * 0.8f);
             
             // 波形に沿った粒子
             float waveY = 0;
@@ -554,14 +554,14 @@ private:
                 waveY += sin(x * layer.frequency + layer.phase) * layer.amplitude * waveAmplitude / 300.0f; // 振幅を縮小
             }
             
-            float y = baseY + waveY + ofRandom(-30, 30);
+            float y = baseY + waveY + rng.random(-30, 30);
             
             ofColor particleColor = accentColor(globalGrowthLevel);
-            particleColor.a = ofRandom(30, 100) * globalGrowthLevel; // 透明度を下げる
+            particleColor.a = rng.random(30, 100) * globalGrowthLevel; // 透明度を下げる
             particleColor.setBrightness(ofClamp(particleColor.getBrightness() * 0.6f, 20, 80)); // 輝度制限
             ofSetColor(particleColor);
             
-            float size = ofRandom(0.3, 1.2) * globalGrowthLevel; // サイズを小さく
+            float size = rng.random(0.3, 1.2) * globalGrowthLevel; // サイズを小さく
             ofDrawCircle(x, y, size);
         }
         
@@ -573,7 +573,7 @@ private:
         for (auto& trail : waveTrails) {
             if (trail.size() > 1) {
                 // 末尾の点を少しずつ削除
-                if (ofRandom(1.0f) < 0.02f + globalGrowthLevel * 0.01f) {
+                if (rng.random(1.0f) < 0.02f + globalGrowthLevel * 0.01f) {
                     if (trail.size() > 0) {
                         trail.getVertices().pop_back();
                     }
@@ -587,8 +587,8 @@ private:
             WaveLayer newLayer;
             newLayer.amplitude = amplitude * 80;
             newLayer.frequency = frequency;
-            newLayer.speed = ofRandom(0.5f, 2.0f);
-            newLayer.phase = ofRandom(TWO_PI);
+            newLayer.speed = rng.random(0.5f, 2.0f);
+            newLayer.phase = rng.random(TWO_PI);
             newLayer.growthPhase = 0;
             newLayer.color = color;
             waveLayers.push_back(newLayer);
@@ -597,17 +597,17 @@ private:
     
     void addWaveTrail() {
         // 新しいトレイルを追加
-        int trailIndex = ofRandom(waveTrails.size());
+        int trailIndex = rng.random(waveTrails.size());
         auto& trail = waveTrails[trailIndex];
         
         trail.clear();
         
         // ランダムなベース位置（中央帯を避ける）
-        float baseY = ofRandom(ofGetHeight() * 0.2f, ofGetHeight() * 0.8f);
+        float baseY = rng.random(SimViewport::getHeight() * 0.2f, SimViewport::getHeight() * 0.8f);
         int numPoints = 15 + globalGrowthLevel * 25;  // 点数を削減
         
         for (int i = 0; i < numPoints; i++) {
-            float x = ofMap(i, 0, numPoints - 1, 0, ofGetWidth());
+            float x = ofMap(i, 0, numPoints - 1, 0, SimViewport::getWidth());
             float y = baseY;
             
             // 現在の波形に基づいてトレイルを生成
@@ -623,7 +623,7 @@ private:
         // クラッシュ時の波形爆発
         for (auto& layer : waveLayers) {
             layer.amplitude *= 1.5f;
-            layer.speed += ofRandom(0.5f, 1.5f);
+            layer.speed += rng.random(0.5f, 1.5f);
             layer.color = accentColor(1.0f);
         }
         
@@ -657,7 +657,7 @@ private:
             }
             
             // 画面中央への復帰力（帯状を維持）
-            float centerY = ofGetHeight() * 0.5f;
+            float centerY = SimViewport::getHeight() * 0.5f;
             float restoreForce = (centerY - point.position.y) * 0.002f;
             totalForce.y += restoreForce;
             
@@ -678,15 +678,15 @@ private:
             
             // 水平方向の境界処理（循環）
             if (point.position.x < -50) {
-                point.position.x = ofGetWidth() + 50;
-            } else if (point.position.x > ofGetWidth() + 50) {
+                point.position.x = SimViewport::getWidth() + 50;
+            } else if (point.position.x > SimViewport::getWidth() + 50) {
                 point.position.x = -50;
             }
             
             // 垂直方向の境界処理（反射）
-            if (point.position.y < ofGetHeight() * 0.2f || point.position.y > ofGetHeight() * 0.8f) {
+            if (point.position.y < SimViewport::getHeight() * 0.2f || point.position.y > SimViewport::getHeight() * 0.8f) {
                 point.velocity.y *= -0.7f;
-                point.position.y = ofClamp(point.position.y, ofGetHeight() * 0.2f, ofGetHeight() * 0.8f);
+                point.position.y = ofClamp(point.position.y, SimViewport::getHeight() * 0.2f, SimViewport::getHeight() * 0.8f);
             }
             
             // 色の更新
@@ -697,10 +697,10 @@ private:
     void addVectorNode() {
         if (vectorField.size() < 12) { // 最大数制限
             VectorNode newNode;
-            newNode.position = ofVec2f(ofRandom(ofGetWidth()), ofRandom(ofGetHeight()));
-            newNode.velocity = ofVec2f(ofRandom(-1, 1), ofRandom(-1, 1));
-            newNode.phase = ofRandom(TWO_PI);
-            newNode.influence = ofRandom(0.4f, 0.9f);
+            newNode.position = ofVec2f(rng.random(SimViewport::getWidth()), rng.random(SimViewport::getHeight()));
+            newNode.velocity = ofVec2f(rng.random(-1, 1), rng.random(-1, 1));
+            newNode.phase = rng.random(TWO_PI);
+            newNode.influence = rng.random(0.4f, 0.9f);
             newNode.lifespan = 1.0f;
             vectorField.push_back(newNode);
         }
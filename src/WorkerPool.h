@@ -0,0 +1,102 @@
+#pragma once
+
+#include "ofMain.h"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 常駐の小さなスレッドプール（フォーク・ジョイン）
+// run(count, task) は task(0..count-1) を呼び出し元とワーカーで分担し、全部終わるまで待つ
+// タスクはシステム1つ分のupdate()程度の粗さを想定（取り出しはmutexで行う）
+// 別のスレッドが実行中なら待たずに呼び出し元で順に実行する
+class WorkerPool {
+public:
+    ~WorkerPool() { stop(); }
+
+    void start(int numWorkers) {
+        stop();
+        stopping = false;
+        for (int i = 0; i < numWorkers; i++) {
+            workers.emplace_back(&WorkerPool::workerLoop, this);
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeCondition.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+    }
+
+    int getNumWorkers() const { return workers.size(); }
+
+    void run(std::size_t count, const std::function<void(std::size_t)>& fn) {
+        std::unique_lock<std::mutex> runLock(runMutex, std::try_to_lock);
+        if (count <= 1 || workers.empty() || !runLock.owns_lock()) {
+            for (std::size_t i = 0; i < count; i++) {
+                fn(i);
+            }
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        task = &fn;
+        taskCount = count;
+        nextTask = 0;
+        pendingTasks = count;
+        lock.unlock();
+        wakeCondition.notify_all();
+
+        // 呼び出し元も分担する
+        lock.lock();
+        while (nextTask < taskCount) {
+            std::size_t index = nextTask++;
+            lock.unlock();
+            fn(index);
+            lock.lock();
+            pendingTasks--;
+        }
+        doneCondition.wait(lock, [this]() { return pendingTasks == 0; });
+        task = nullptr;
+        taskCount = 0;
+        nextTask = 0;
+    }
+
+private:
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wakeCondition.wait(lock, [this]() { return stopping || (task && nextTask < taskCount); });
+            if (stopping) break;
+
+            // タスクはpendingTasksが0になるまで有効（run()が待っている）
+            std::size_t index = nextTask++;
+            const std::function<void(std::size_t)>* fn = task;
+            lock.unlock();
+            (*fn)(index);
+            lock.lock();
+
+            if (--pendingTasks == 0) {
+                doneCondition.notify_all();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex runMutex;   // 同時に実行するバッチは1つ
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+    const std::function<void(std::size_t)>* task = nullptr;
+    std::size_t taskCount = 0;
+    std::size_t nextTask = 0;
+    std::size_t pendingTasks = 0;
+    bool stopping = false;
+};
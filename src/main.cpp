@@ -1,7 +1,100 @@
 #include "ofMain.h"
 #include "ofApp.h"
 
-int main(){
+#ifdef MIDIVIS_HEADLESS
+#include "HeadlessBenchApp.h"
+
+int main(int argc, char* argv[]){
+    // --gl なら非表示のウィンドウでGLを使えるようにする（全画面エフェクトのシェーダーを参照実装と比べる）
+    bool useGL = false;
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--gl") useGL = true;
+    }
+    if (useGL) {
+        ofGLFWWindowSettings settings;
+        settings.setSize(1920, 1080);
+        settings.visible = false;
+        ofCreateWindow(settings);
+    } else {
+        // ウィンドウ・GLなしでシミュレーションのみ実行
+        auto window = std::make_shared<ofAppNoWindow>();
+        ofSetupOpenGL(window, 1920, 1080, OF_WINDOW);
+    }
+    ofRunApp(new HeadlessBenchApp(argc, argv));
+}
+#else
+int main(int argc, char* argv[]){
+    ofApp* app = new ofApp();
+    
+    // --seed N で乱数を固定（同じMIDI入力なら同じシミュレーション結果）
+    // --play FILE でセッションログを再生（--fast で固定dtの高速再生、--dt で刻み幅）
+    // --render OUT で固定dt再生の各フレームを書き出す（OUTが .y4m ならY4M、それ以外はPNG連番のディレクトリ）
+    // --tail SEC で曲の終わり（SMFのEnd of Track）の後も再生・書き出しを続ける秒数（既定4）
+    // --glitch-format rgba8|rgba16f|rgba32f で合成ターゲットのフォーマットを選ぶ（既定 rgba32f）
+    // --detail X で詳細度を固定（品質ガバナーを無効化、1.0 = 従来の上限）
+    // --serial-update でシミュレーションのワーカーを使わず、従来どおり描画スレッドで順に更新
+    // --quiet でイベントごとのログ（MIDI・キー入力・グリッチ）を止めて起動（本番用、Vキーで切替）
+    // --sim-rate HZ でシミュレーションの固定ステップのレート（既定60）、--max-substeps N で1フレームあたりの上限（既定4）
+    // --no-midi-clock でドラムポートのMIDIクロックに同期せず、常にキックからテンポを推定
+    // --display-offset MS で表示遅延の校正値（Cキーの校正結果）を指定
+    // --playback-order FILE で再生順序を読み込む（1行に1システム、既定は data/playback_order.txt があれば）
+    // --eager-setup で起動時にすべてのシステムを作る（既定は最初のシステムだけ作り、残りはバックグラウンド）
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--seed" && hasValue) {
+            uint64_t seed = 0;
+            if (VisualRandom::parseSeed(argv[++i], seed)) {
+                VisualRandom::setGlobalSeed(seed);
+            } else {
+                cout << "Invalid --seed value: " << argv[i] << " (expected an unsigned integer, using a random seed)" << endl;
+            }
+        } else if (arg == "--play" && hasValue) {
+            app->sessionPath = argv[++i];
+        } else if (arg == "--fast") {
+            app->startupPlaybackFast = true;
+        } else if (arg == "--dt" && hasValue) {
+            app->playbackDeltaTime = std::max(0.001f, ofToFloat(argv[++i]));
+        } else if (arg == "--render" && hasValue) {
+            app->renderOutputPath = argv[++i];
+        } else if (arg == "--tail" && hasValue) {
+            app->playbackTailSeconds = std::max(0.0f, ofToFloat(argv[++i]));
+        } else if (arg == "--detail" && hasValue) {
+            app->fixedDetailBudget = ofClamp(ofToFloat(argv[++i]), QualityGovernor::MIN_BUDGET, QualityGovernor::MAX_BUDGET);
+        } else if (arg == "--serial-update") {
+            app->pipelinedUpdate = false;
+        } else if (arg == "--quiet") {
+            AsyncLog::setQuiet(true);
+        } else if (arg == "--sim-rate" && hasValue) {
+            app->simulationRate = ofClamp(ofToFloat(argv[++i]), 10.0f, 1000.0f);
+        } else if (arg == "--max-substeps" && hasValue) {
+            app->maxSimulationSubsteps = std::max(1, ofToInt(argv[++i]));
+        } else if (arg == "--no-midi-clock") {
+            app->tempoEngine.setClockSyncEnabled(false);
+        } else if (arg == "--display-offset" && hasValue) {
+            app->beatScheduler.setDisplayOffset(ofToFloat(argv[++i]) / 1000.0);
+        } else if (arg == "--playback-order" && hasValue) {
+            app->playbackOrderPath = argv[++i];
+        } else if (arg == "--eager-setup") {
+            app->eagerSystemSetup = true;
+        } else if (arg == "--glitch-format" && hasValue) {
+            string format = ofToLower(argv[++i]);
+            if (format == "rgba8") {
+                app->glitchAreaSystem.setTargetFormat(GLITCH_FORMAT_RGBA8);
+            } else if (format == "rgba16f") {
+                app->glitchAreaSystem.setTargetFormat(GLITCH_FORMAT_RGBA16F);
+            } else {
+                app->glitchAreaSystem.setTargetFormat(GLITCH_FORMAT_RGBA32F);
+            }
+        }
+    }
+    
+    // レンダー時はsetup前から仮想時計を0で開始し、実行ごとに同じ時刻列にする
+    if (!app->renderOutputPath.empty()) {
+        SimViewport::startFixedClock(0.0f);
+    }
+    
     ofSetupOpenGL(1920, 1080, OF_WINDOW);
-    ofRunApp(new ofApp());
-}
\ No newline at end of file
+    ofRunApp(app);
+}
+#endif
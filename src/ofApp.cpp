@@ -1,6 +1,11 @@
 #include "ofApp.h"
 
 void ofApp::setup(){
+    setupStartMicros = midiNowMicros();
+    
+    // MIDI・入力のログはバックグラウンドで書き出す
+    AsyncLog::start();
+    
     ofSetVerticalSync(true);
     ofBackground(0);
     ofSetCircleResolution(64);
@@ -83,115 +88,335 @@ void ofApp::setup(){
         cout << "No MIDI input ports available!" << endl;
     }
     
+    // 再生順序（既定はカラーとモノクロを交互に、data/playback_order.txt か --playback-order FILE で上書き）
+    // 0: Particles (color), 7: Infinite Corridor (mono), 1: Fractals (color), 8: Building Perspective (mono), ...
+    playbackOrder = SystemRegistry::getDefaultPlaybackOrder();
+    if (playbackOrderPath.empty()) {
+        string defaultPath = ofToDataPath("playback_order.txt", true);
+        if (ofFile::doesFileExist(defaultPath, false)) {
+            playbackOrderPath = defaultPath;
+        }
+    }
+    if (!playbackOrderPath.empty()) {
+        SystemRegistry::loadPlaybackOrder(playbackOrderPath, playbackOrder);
+    }
+    
     // ビジュアルシステムの初期化
-    visualSystems.push_back(std::make_unique<ParticleSystem>());
-    visualSystems.push_back(std::make_unique<FractalSystem>());
-    visualSystems.push_back(std::make_unique<WaveSystem>());
-    visualSystems.push_back(std::make_unique<FlowFieldSystem>());
-    visualSystems.push_back(std::make_unique<LSystemSystem>());
-    visualSystems.push_back(std::make_unique<PerlinFlowSystem>());
-    visualSystems.push_back(std::make_unique<CurlNoiseSystem>());
-    visualSystems.push_back(std::make_unique<InfiniteCorridorSystem>());
-    visualSystems.push_back(std::make_unique<BuildingPerspectiveSystem>());
-    visualSystems.push_back(std::make_unique<WaterRippleSystem>());
-    visualSystems.push_back(std::make_unique<SandParticleSystem>());
+    // 最初に表示するシステムだけをここで作り、残りは再生順にバックグラウンドで作る（setup()がGLに触れるものは初めて使うとき）
+    // 乱数ストリームはシステム番号で決まるので、作る順番・スレッドに依らない
+    cout << "Random seed: " << VisualRandom::getGlobalSeed() << endl;
+    std::size_t numSystems = SystemRegistry::getLiveCount();
+    visualSystems.assign(numSystems, nullptr);
+    systemLoader.setup(numSystems, fixedDetailBudget > 0.0f ? fixedDetailBudget : 1.0f, pipelinedUpdate);
     
-    for (auto& system : visualSystems) {
-        system->setup();
-    }
+    currentSystemIndex = playbackOrder.front();
+    isMonochromePattern = SystemRegistry::get(currentSystemIndex).monochrome;
+    VisualSystem::setGlobalMonochromeMode(isMonochromePattern);
+    ensureSystem(currentSystemIndex)->setActive(true);
     
-    // 最初のシステムをアクティブに
-    if (!visualSystems.empty()) {
-        visualSystems[currentSystemIndex]->setActive(true);
+    if (eagerSystemSetup) {
+        for (std::size_t i = 0; i < numSystems; i++) {
+            ensureSystem(i);
+        }
+    } else {
+        systemLoader.startBackground(playbackOrder);
     }
     
     // グリッチシステムの初期化（高品質）
+    glitchAreaSystem.seedRandom(visualSystems.size());
     glitchAreaSystem.setup(ofGetWidth(), ofGetHeight());
-    glitchOutputFbo.allocate(ofGetWidth(), ofGetHeight(), GL_RGBA32F_ARB);
+    glitchOutputFbo = RenderTargetPool::acquire(ofGetWidth(), ofGetHeight(), glitchAreaSystem.getInternalFormat());
+    layerCompositor.setup();
     
-    // 再生順序の設定（カラーとモノクロを交互に）
-    // 0: Particles (color), 7: Infinite Corridor (mono), 1: Fractals (color), 8: Building Perspective (mono), ...
-    playbackOrder = {0, 7, 1, 8, 2, 9, 3, 10, 4, 5, 6};
+    // 品質ガバナー（ビジュアルシステム＋グリッチ）
+    qualityGovernor.setup(visualSystems.size() + 1);
+    glitchGovernorEntry = visualSystems.size();
+    if (fixedDetailBudget > 0.0f || !renderOutputPath.empty()) {
+        // 固定の詳細度（オフラインレンダーは再現性のため常に固定）
+        autoQuality = false;
+        qualityGovernor.setAllBudgets(fixedDetailBudget > 0.0f ? fixedDetailBudget : 1.0f);
+        applyDetailBudgets();
+    }
+    
+    // シミュレーションのワーカーと、クロスフェード中の2システムを並列に更新するプール（起動引数 --serial-update で無効）
+    if (pipelinedUpdate) {
+        updatePool.start(2);
+        simulationPipeline.setWorkerPool(&updatePool);
+        simulationPipeline.start();
+    }
+    simulationClock.setup(simulationRate, maxSimulationSubsteps);
+    tempoEngine.reset();
+    cout << "Simulation: " << simulationClock.getRate() << " Hz, max " << simulationClock.getMaxSubsteps() << " steps/frame" << endl;
+    pipelineJobs.reserve(visualSystems.size());
+    serialJobs.reserve(visualSystems.size());
+    
+    // MIDIキューのドレイン用バッファを事前確保
+    drainedMidiEvents.reserve(MidiEventQueue::CAPACITY * NUM_MIDI_PORTS);
+    orderedMidiEvents.reserve(MidiEventQueue::CAPACITY * NUM_MIDI_PORTS);
+    
+    lastActivityTime = SimViewport::getElapsedTimef();
     
-    lastActivityTime = ofGetElapsedTimef();
+    // 起動引数で指定されたログを再生
+    if (!sessionPath.empty() && loadMidiSession(sessionPath)) {
+        bool offline = !renderOutputPath.empty();
+        startMidiPlayback((startupPlaybackFast || offline) ? PLAYBACK_FIXED_STEP : PLAYBACK_REALTIME);
+        if (offline) {
+            offlineRenderer.start(renderOutputPath, glitchOutputFbo->getWidth(), glitchOutputFbo->getHeight(), playbackDeltaTime);
+        }
+    } else if (!renderOutputPath.empty()) {
+        cout << "Offline render: --render requires --play FILE" << endl;
+    }
 }
 
 void ofApp::update(){
+    uint64_t updateStart = midiNowMicros();
+    
+    // 前フレームのバッファ入れ替えが戻った時刻（そのフレームで描いたMIDIの反映が画面に出た）
+    latencyTracker.beginFrame(updateStart);
+    
+    // 起動から最初のフレームが画面に出るまで（2フレーム目のupdate()の頭 = 1フレーム目の入れ替えの戻り）
+    if (!firstFrameLogged && ofGetFrameNum() > 0) {
+        firstFrameLogged = true;
+        MVLOG_INFO(LOG_CATEGORY_SYSTEM, "Startup: first frame after %.1fms (%zu/%zu systems ready)", (updateStart - setupStartMicros) / 1000.0f,
+                   systemLoader.getReadyCount(), systemLoader.size());
+    }
+    
+    // 前フレームに投げたシミュレーションの完了を待ち、結果を描画側に公開（スナップショット境界）
+    finishPipelinedUpdates();
+    adoptLoadedSystems();
+    
     float deltaTime = ofGetLastFrameTime();
-    float currentTime = ofGetElapsedTimef();
+    
+    // 高速再生中は実時間に関係なく固定dtで進める
+    if (midiPlayer.isPlaying() && midiPlayer.isFixedStep()) {
+        playbackFrameTimes.push_back(deltaTime);
+        deltaTime = midiPlayer.getFixedDeltaTime();
+        SimViewport::advance(deltaTime);
+    }
+    float currentTime = SimViewport::getElapsedTimef();
+    
+    // ビート同期の基準（このフレームが画面に出る予測時刻）。固定dt再生・レンダーでは遅延なし
+    beatScheduler.beginFrame(SimViewport::getElapsedTime(), ofGetLastFrameTime(), !SimViewport::isFixedClock());
+    
+    // シミュレーションは固定の刻みで進める（描画レートに依らない）。上限を超えた遅れは捨てる
+    // 固定dt再生・オフラインレンダーは時計と一致させるため上限なし
+    bool fixedPlayback = midiPlayer.isPlaying() && midiPlayer.isFixedStep();
+    int simulationSteps = simulationClock.advance(deltaTime, !fixedPlayback);
+    float stepSeconds = simulationClock.getStepSeconds();
+    float renderAlpha = simulationClock.getAlpha();
+    
+    // MIDIスレッドから届いたイベントをフレーム頭で一括処理
+    {
+        PROFILE_ZONE("processMidi");
+        processMidiQueues();
+    }
     
     // トランジションの更新
     if (isTransitioning) {
         updateTransition(deltaTime);
     }
     
-    // テンポ同期の自動切替チェック
+    // テンポ同期の自動切替チェック（切替ビートの直前に予約）
     if (autoSwitchEnabled && !manualTempoOverride) {
         handleAutoSwitch();
+        prepareUpcomingSystem();
     }
+    scheduleBeatPulse();
+    runBeatActions();
+    systemPreparer.poll();
     
-    // アクティブなシステムを更新（トランジション中は両方）
-    for (auto& system : visualSystems) {
+    // アクティブなシステムを更新（トランジション中は両方）、コストは品質ガバナーへ
+    // 分離済みのシステムはワーカーに渡し、このフレームの描画と並行して次の状態を作る
+    // それ以外はここで更新する（クロスフェード中の2システムはプールで並列に）
+    pipelineJobs.clear();
+    serialJobs.clear();
+    bool midiReflectedNextFrame = true;   // アクティブなシステムがすべてワーカーで回るなら、MIDIは次フレームで描かれる
+    for (std::size_t i = 0; i < visualSystems.size(); i++) {
+        VisualSystem* system = visualSystems[i];
+        if (!system) continue;
         if (system->getActive() || 
-            (isTransitioning && (&system == &visualSystems[nextSystemIndex]))) {
-            system->update(deltaTime);
+            (isTransitioning && i == nextSystemIndex)) {
+            SimulationPipeline::Job job;
+            job.system = system;
+            job.index = i;
+            job.deltaTime = stepSeconds;
+            job.steps = simulationSteps;
+            job.name = SystemRegistry::get(i).updateZone;
+            if (pipelinedUpdate && system->isPipelined()) {
+                // 描画しているのは前フレームに投げた分なので、補間の割合も前フレームのもの
+                system->setRenderInterpolation(pipelineRenderAlpha);
+                if (simulationSteps > 0) pipelineJobs.push_back(job);
+            } else {
+                system->setRenderInterpolation(renderAlpha);
+                if (simulationSteps > 0) serialJobs.push_back(job);
+                midiReflectedNextFrame = false;
+            }
+        }
+    }
+    pipelineRenderAlpha = renderAlpha;
+    simulationPipeline.submit(pipelineJobs);
+    uint64_t serialWallMicros = SimulationPipeline::runJobs(serialJobs, pipelinedUpdate ? &updatePool : nullptr);
+    // 描画スレッドで更新したシステムはここで公開する（分離済みのシステムでも描画が止まらないように）
+    for (const auto& job : serialJobs) {
+        job.system->publishSnapshot();
+    }
+    
+    uint64_t crossfadeCostMicros = pipelineWorkMicros;
+    for (const auto& job : serialJobs) {
+        qualityGovernor.addCost(job.index, job.costMicros);
+        crossfadeCostMicros += job.costMicros;
+    }
+    
+    // クロスフェード中の並列化の効果（2システムの更新時間の合計 / 実際にかかった時間）
+    // 分離済みのシステムは前フレームにワーカーで回した分で数える
+    if (isTransitioning) {
+        uint64_t crossfadeWallMicros = std::max(serialWallMicros, pipelineWallMicros);
+        if (crossfadeWallMicros > 0) {
+            float speedup = crossfadeCostMicros / (float)crossfadeWallMicros;
+            crossfadeSpeedup = crossfadeSpeedup > 0.0f ? ofLerp(crossfadeSpeedup, speedup, 0.1f) : speedup;
         }
+    } else {
+        crossfadeSpeedup = 0.0f;
     }
     
     // グリッチシステムの更新
-    glitchAreaSystem.update(deltaTime);
+    uint64_t glitchStart = midiNowMicros();
+    {
+        PROFILE_ZONE("update Glitch");
+        glitchAreaSystem.update(deltaTime);
+    }
+    if (glitchAreaSystem.hasActiveGlitch()) {
+        qualityGovernor.addCost(glitchGovernorEntry, midiNowMicros() - glitchStart);
+    }
     
     // UIのフェードアウト
-    float timeSinceActivity = ofGetElapsedTimef() - lastActivityTime;
+    float timeSinceActivity = SimViewport::getElapsedTimef() - lastActivityTime;
     if (timeSinceActivity > 3.0f) {
         uiFadeAlpha = ofLerp(uiFadeAlpha, 0, deltaTime * 2.0f);
     } else {
         uiFadeAlpha = ofLerp(uiFadeAlpha, 255, deltaTime * 4.0f);
     }
+    
+    latencyTracker.endUpdate(midiNowMicros(), midiReflectedNextFrame);
+    updateWorkMicros = midiNowMicros() - updateStart;
 }
 
 void ofApp::draw(){
+    uint64_t drawStart = midiNowMicros();
+    
     // 一時FBOに通常の描画を行う
-    glitchOutputFbo.begin();
+    glitchOutputFbo->begin();
     ofClear(0, 0, 0, 255);
     
     if (isTransitioning) {
         // トランジション描画（クロスフェード）
         drawTransition();
     } else {
-        // アクティブなビジュアルシステムを描画
-        for (auto& system : visualSystems) {
-            if (system->getActive()) {
-                system->draw();
+        // アクティブなビジュアルシステムを描画（1システムなので合成せず直接描く）
+        layerCompositor.releaseTargets();
+        for (std::size_t i = 0; i < visualSystems.size(); i++) {
+            if (visualSystems[i] && visualSystems[i]->getActive()) {
+                PROFILE_ZONE(SystemRegistry::get(i).drawZone);
+                uint64_t systemStart = midiNowMicros();
+                visualSystems[i]->render();
+                qualityGovernor.addCost(i, midiNowMicros() - systemStart);
                 break; // 一度に一つだけ描画
             }
         }
     }
-    glitchOutputFbo.end();
+    glitchOutputFbo->end();
     
-    // グリッチエフェクトを適用（モノクロモードでは無効）
-    if (glitchAreaSystem.hasActiveGlitch() && !isMonochromePattern) {
-        ofFbo tempFbo;
-        tempFbo.allocate(ofGetWidth(), ofGetHeight(), GL_RGBA32F_ARB);
-        glitchAreaSystem.applyGlitch(glitchOutputFbo, tempFbo);
-        tempFbo.draw(0, 0);
-    } else {
-        glitchOutputFbo.draw(0, 0);
+    // グリッチエフェクトを適用（モノクロモードでは無効、エリアがなければ入力がそのまま返る）
+    const ofFbo* compositeFbo = glitchOutputFbo.get();
+    if (!isMonochromePattern) {
+        uint64_t glitchStart = midiNowMicros();
+        compositeFbo = &glitchAreaSystem.applyGlitch(*glitchOutputFbo);
+        if (glitchAreaSystem.hasActiveGlitch()) {
+            qualityGovernor.addCost(glitchGovernorEntry, midiNowMicros() - glitchStart);
+        }
+    }
+    compositeFbo->draw(0, 0);
+    
+    // オフラインレンダー中はUIを含まない合成結果を書き出し、再生（曲の終わり＋余韻）が終わったら終了
+    // 途中でサイズが変わったら書き出せないので中断する
+    if (offlineRenderer.isActive()) {
+        bool captured = offlineRenderer.capture(*compositeFbo);
+        if (!captured || !midiPlayer.isPlaying()) {
+            offlineRenderer.stop();
+            ofExit(captured ? 0 : 1);
+        }
+    }
+    
+    // 表示遅延の校正の点滅（予約した表示時刻に画面に出るフレームだけ白く塗る）
+    if (beatScheduler.isCalibrating() && calibrationFlashFrame == ofGetFrameNum()) {
+        ofPushStyle();
+        ofSetColor(255);
+        ofDrawRectangle(0, 0, ofGetWidth(), ofGetHeight());
+        ofPopStyle();
     }
     
     // UIを描画（フェードアウト付き）
     if (showUI && uiFadeAlpha > 10) {
         drawUI();
     }
+    
+    // 品質ガバナー（固定dt再生中は再現性のため詳細度を動かさない）
+    qualityGovernor.setEnabled(autoQuality && !(midiPlayer.isPlaying() && midiPlayer.isFixedStep()));
+    if (qualityGovernor.endFrame(updateWorkMicros + (midiNowMicros() - drawStart), ofGetLastFrameTime())) {
+        detailBudgetsChanged = true;  // ワーカーが止まるフレーム境界で反映
+    }
+    
+    // プロファイラ（このフレームのゾーンを回収してから、UIパネルの右に表示）
+    FrameProfiler::endFrame(ofGetLastFrameTime());
+    DrawCommandList::endFrame();
+    if (showProfiler) {
+        FrameProfiler::drawOverlay(420, 10, 255);
+    }
+    if (showLatency) {
+        latencyTracker.drawOverlay(ofGetWidth() - 370, 10, 255);
+    }
+}
+
+void ofApp::finishPipelinedUpdates() {
+    {
+        PROFILE_ZONE("pipeline wait");
+        pipelineWaitMicros = simulationPipeline.wait();
+    }
+    pipelineWallMicros = simulationPipeline.getCompletedWallMicros();
+    
+    pipelineWorkMicros = 0;
+    for (const auto& job : simulationPipeline.getCompletedJobs()) {
+        job.system->publishSnapshot();
+        qualityGovernor.addCost(job.index, job.costMicros);
+        pipelineWorkMicros += job.costMicros;
+    }
+    if (!simulationPipeline.getCompletedJobs().empty()) {
+        latencyTracker.onPublished(midiNowMicros());
+    }
+    simulationPipeline.clearCompletedJobs();
+    
+    if (detailBudgetsChanged) {
+        applyDetailBudgets();
+        detailBudgetsChanged = false;
+    }
+}
+
+void ofApp::applyDetailBudgets() {
+    for (std::size_t i = 0; i < visualSystems.size(); i++) {
+        if (!visualSystems[i] || systemPreparer.isPreparing(i)) continue;  // ワーカーが温めている間は触らない
+        visualSystems[i]->setDetailBudget(qualityGovernor.getBudget(i));
+    }
+    glitchAreaSystem.setDetailBudget(qualityGovernor.getBudget(glitchGovernorEntry));
 }
 
 void ofApp::drawUI(){
+    PROFILE_ZONE("drawUI");
     ofPushStyle();
     ofEnableBlendMode(OF_BLENDMODE_ALPHA);
     
     // 背景
     ofSetColor(0, 0, 0, 150 * (uiFadeAlpha / 255.0f));
-    ofDrawRectangle(10, 10, 400, 250);
+    ofDrawRectangle(10, 10, 400, 355);
     
     ofSetColor(255, uiFadeAlpha);
     
@@ -199,9 +424,8 @@ void ofApp::drawUI(){
     ofDrawBitmapString("MIDI Generative Art Visualizer", 20, y);
     y += 20;
     
-    string systemNames[] = {"Particles", "Fractals", "Waves", "Flow Field", "L-System", "Perlin Flow", "Curl Noise", "Infinite Corridor", "Building Perspective", "Water Ripple", "Sand Particle"};
     string modeStr = isMonochromePattern ? " [MONO]" : " [COLOR]";
-    ofDrawBitmapString("System [" + ofToString(currentSystemIndex + 1) + "/" + ofToString(visualSystems.size()) + "]: " + systemNames[currentSystemIndex] + modeStr, 20, y);
+    ofDrawBitmapString("System [" + ofToString(currentSystemIndex + 1) + "/" + ofToString(visualSystems.size()) + "]: " + SystemRegistry::get(currentSystemIndex).displayName + modeStr, 20, y);
     y += 15;
     
     // 複数MIDI接続状況を表示
@@ -218,27 +442,89 @@ void ofApp::drawUI(){
     ofDrawBitmapString("Intensity: " + ofToString(intensity, 2), 20, y);
     y += 15;
     
-    ofDrawBitmapString("Keys: Space=Next, 1-9,0,-=Direct System, H=UI, G=Glitch, P=MIDI Status", 20, y);
+    // MIDIキューの統計
+    ofDrawBitmapString("MIDI Queue: depth " + ofToString(drumQueue.getMaxDepth()) + "/" + ofToString(push2Queue.getMaxDepth()) +
+                       " drops " + ofToString(drumQueue.getDroppedCount() + push2Queue.getDroppedCount()) +
+                       " worst " + ofToString(std::max(drumQueue.getWorstLatencyMicros(), push2Queue.getWorstLatencyMicros()) / 1000.0f, 2) + "ms", 20, y);
+    y += 15;
+    
+    // レンダーターゲットプールのVRAM使用量
+    ofDrawBitmapString("Render Targets: " + ofToString(RenderTargetPool::getNumLeased()) + "/" + ofToString(RenderTargetPool::getNumTargets()) +
+                       " leased, " + ofToString(RenderTargetPool::getAllocatedBytes() / (1024.0f * 1024.0f), 1) + " MB", 20, y);
+    y += 15;
+    
+    // 記録した描画コマンドと実際の描画の回数（直前のフレーム）
+    const DrawCommandStats& drawStats = DrawCommandList::getLastFrameStats();
+    ofDrawBitmapString("Draw Commands: " + ofToString(drawStats.recorded) + " recorded -> " + ofToString(drawStats.drawCalls) +
+                       " draws, " + ofToString(drawStats.blendChanges) + " blend changes", 20, y);
+    y += 15;
+    
+    // 品質ガバナー（負荷 = フレーム予算に対する割合）
+    ofDrawBitmapString("Quality: " + string(autoQuality ? "AUTO" : "FIXED") + " load " + ofToString(qualityGovernor.getLoad(), 2) +
+                       " | detail x" + ofToString(qualityGovernor.getBudget(currentSystemIndex), 2) +
+                       " (" + ofToString(qualityGovernor.getCostMillis(currentSystemIndex), 2) + "ms)", 20, y);
+    y += 15;
+    
+    // シミュレーションのワーカー（work = 描画と並行した更新時間、wait = フレーム頭で待った時間）
+    ofDrawBitmapString("Simulation: " + string(pipelinedUpdate ? "PIPELINED work " + ofToString(pipelineWorkMicros / 1000.0f, 2) +
+                       "ms, wait " + ofToString(pipelineWaitMicros / 1000.0f, 2) + "ms" : "SERIAL"), 20, y);
+    y += 15;
+    
+    // 固定ステップ（上限で捨てたステップ数が増えていれば、実時間に追いつけていない）
+    ofDrawBitmapString("Step: " + ofToString(simulationClock.getRate(), 0) + "Hz x" + ofToString(simulationClock.getMaxSubsteps()) +
+                       " max, dropped " + ofToString(simulationClock.getDroppedSteps()), 20, y);
+    y += 15;
+    
+    // セッション録音・再生の状態
+    if (midiRecorder.isRecording()) {
+        ofDrawBitmapString("Session: REC " + ofToString(midiRecorder.getEventCount()) + " events", 20, y);
+    } else if (midiPlayer.isPlaying()) {
+        ofDrawBitmapString("Session: PLAY " + ofToString(midiPlayer.getProgress() * 100, 1) + "%" +
+                           (midiPlayer.isFixedStep() ? " (fast)" : ""), 20, y);
+    } else {
+        ofDrawBitmapString("Session: idle (R=Rec, L=Replay, F=Fast replay)", 20, y);
+    }
+    y += 15;
+    
+    ofDrawBitmapString("Keys: Space=Next, 1-9,0,-=Direct, H=UI, G=Glitch, P=Status, O/T=Prof, M=Latency, V=Log, B/K/C=Beat", 20, y);
     y += 15;
     
     // テンポ情報の表示
-    ofDrawBitmapString("BPM: " + ofToString(bpm, 1) + " | Beat: " + ofToString(beatCount), 20, y);
+    double now = SimViewport::getElapsedTime();
+    TempoSource tempoSource = tempoEngine.getSource(now);
+    string sourceName = tempoSource == TEMPO_SOURCE_CLOCK ? "CLOCK" : (tempoSource == TEMPO_SOURCE_KICK ? (tempoEngine.isLocked() ? "KICK" : "KICK (locking)") : "-");
+    ofDrawBitmapString("BPM: " + ofToString(tempoEngine.getBpm(), 1) + " | Beat: " + ofToString(tempoEngine.getBeatCount(now)) +
+                       " + " + ofToString(tempoEngine.getBeatPhase(now), 2) + " | Sync: " + sourceName, 20, y);
     y += 15;
     
     // 自動切替情報
     string autoStatus = autoSwitchEnabled ? "ON" : "OFF";
     if (manualTempoOverride) autoStatus += " (Manual Override)";
+    if (systemPreparer.getSystemIndex() >= 0) {
+        autoStatus += systemPreparer.isReady() ? " | next " + ofToString(systemPreparer.getSystemIndex()) + " ready (" + ofToString(systemPreparer.getLastPrepareMillis(), 0) + "ms)"
+                                               : " | preparing " + ofToString(systemPreparer.getSystemIndex());
+    }
     ofDrawBitmapString("Auto Switch: " + autoStatus + " | " + ofToString(barsPerSwitch) + " bars", 20, y);
     y += 15;
     
+    // ビート同期（表示までの遅延と校正）
+    string beatSync = "Latency: " + ofToString(beatScheduler.getPresentLatency() * 1000.0, 1) + "ms (offset " + ofToString(beatScheduler.getDisplayOffset() * 1000.0, 1) + "ms)";
+    if (beatScheduler.isCalibrating()) {
+        beatSync += " | CALIBRATING " + ofToString(beatScheduler.getCalibrationTapCount()) + " taps, " + ofToString(beatScheduler.getCalibrationError() * 1000.0, 1) + "ms";
+    } else {
+        beatSync += string(" | Quantize: ") + (quantizeGlitches ? "ON" : "OFF") + " | Pulse: " + (beatPulseEnabled ? "ON" : "OFF");
+    }
+    ofDrawBitmapString(beatSync, 20, y);
+    y += 15;
+    
     // パターンモード情報
     ofDrawBitmapString("Playback Order [" + ofToString(playbackIndex + 1) + "/" + ofToString(playbackOrder.size()) + "] - Mode: " + string(isMonochromePattern ? "MONOCHROME" : "COLOR"), 20, y);
     y += 15;
     
     // トランジション情報
     if (isTransitioning) {
-        string systemNames[] = {"Particles", "Fractals", "Waves", "Flow Field", "L-System", "Perlin Flow", "Curl Noise", "Infinite Corridor", "Building Perspective", "Water Ripple", "Sand Particle"};
-        ofDrawBitmapString("Transitioning to: " + systemNames[nextSystemIndex] + " (" + ofToString(transitionProgress * 100, 1) + "%)", 20, y);
+        string parallelInfo = crossfadeSpeedup > 0.0f ? " | update x" + ofToString(crossfadeSpeedup, 2) : "";
+        ofDrawBitmapString("Transitioning to: " + string(SystemRegistry::get(nextSystemIndex).displayName) + " (" + ofToString(transitionProgress * 100, 1) + "%)" + parallelInfo, 20, y);
         y += 15;
     }
     
@@ -287,6 +573,16 @@ void ofApp::drawUI(){
 }
 
 void ofApp::exit(){
+    finishPipelinedUpdates();
+    simulationPipeline.stop();
+    updatePool.stop();
+    systemPreparer.cancel();
+    systemLoader.stop();
+    midiRecorder.stop();
+    offlineRenderer.stop();
+    layerCompositor.releaseTargets();
+    RenderTargetPool::clear();
+    
     if (drumMidiConnected) {
         midiInDrums.closePort();
         midiInDrums.removeListener(drumListener.get());
@@ -295,6 +591,8 @@ void ofApp::exit(){
         midiInPush2.closePort();
         midiInPush2.removeListener(push2Listener.get());
     }
+    
+    AsyncLog::stop();
 }
 
 void ofApp::newMidiMessage(ofxMidiMessage& msg){
@@ -303,21 +601,222 @@ void ofApp::newMidiMessage(ofxMidiMessage& msg){
     while(midiMessages.size() > maxMessages){
         midiMessages.erase(midiMessages.begin());
     }
-    lastActivityTime = ofGetElapsedTimef();
+    lastActivityTime = SimViewport::getElapsedTimef();
+}
+
+void ofApp::processMidiQueues() {
+    // 各ポートのキューをドレイン（ポート内は到着順に並んでいる）
+    drainedMidiEvents.clear();
+    orderedMidiEvents.clear();
+    
+    MidiEvent event;
+    drumQueue.recordDepth(drumQueue.size());
+    while (drumQueue.pop(event)) {
+        drainedMidiEvents.push_back(event);
+    }
+    std::size_t drumCount = drainedMidiEvents.size();
+    
+    push2Queue.recordDepth(push2Queue.size());
+    while (push2Queue.pop(event)) {
+        drainedMidiEvents.push_back(event);
+    }
+    
+    // 再生中はライブ入力を捨て、ログのイベントだけを流す（リプレイを正確に再現するため）
+    if (midiPlayer.isPlaying()) {
+        midiPlayer.poll(orderedMidiEvents);
+        
+        ofxMidiMessage msg;
+        for (const auto& played : orderedMidiEvents) {
+            played.toMessage(msg);
+            double eventTime = playbackOriginTime + played.timestampMicros / 1000000.0;
+            if (played.port == MIDI_PORT_DRUMS) {
+                onDrumMidiMessage(msg, eventTime);
+            } else {
+                onPush2MidiMessage(msg, eventTime);
+            }
+        }
+        
+        if (midiPlayer.isFinished()) {
+            finishMidiPlayback();
+        }
+        return;
+    }
+    
+    if (drainedMidiEvents.empty()) {
+        return;
+    }
+    
+    // ポート間をタイムスタンプ順にマージ（事前確保済みなので確保は発生しない）
+    std::merge(drainedMidiEvents.begin(), drainedMidiEvents.begin() + drumCount,
+               drainedMidiEvents.begin() + drumCount, drainedMidiEvents.end(),
+               std::back_inserter(orderedMidiEvents),
+               [](const MidiEvent& a, const MidiEvent& b) { return a.timestampMicros < b.timestampMicros; });
+    
+    // 録音中は到着時刻付きでログに書き出す
+    if (midiRecorder.isRecording()) {
+        for (const auto& queued : orderedMidiEvents) {
+            midiRecorder.record(queued);
+        }
+    }
+    
+    // 到着時刻をSimViewport::getElapsedTime()の時間軸に換算してディスパッチ
+    uint64_t frameMicros = midiNowMicros();
+    double frameTime = SimViewport::getElapsedTime();
+    ofxMidiMessage msg;
+    for (const auto& queued : orderedMidiEvents) {
+        queued.toMessage(msg);
+        double eventTime = frameTime - (frameMicros - queued.timestampMicros) / 1000000.0;
+        
+        // クロックなどのシステムメッセージは描画に反映しないのでレイテンシに数えない
+        uint64_t dispatchMicros = midiNowMicros();
+        if (queued.status < MIDI_SYSEX) {
+            latencyTracker.addDispatch(queued, dispatchMicros);
+        }
+        
+        if (queued.port == MIDI_PORT_DRUMS) {
+            drumQueue.recordDispatch(queued, dispatchMicros);
+            onDrumMidiMessage(msg, eventTime);
+        } else {
+            push2Queue.recordDispatch(queued, dispatchMicros);
+            onPush2MidiMessage(msg, eventTime);
+        }
+    }
+}
+
+void ofApp::toggleMidiRecording() {
+    if (midiRecorder.isRecording()) {
+        midiRecorder.stop();
+        sessionPath = midiRecorder.getPath();
+    } else {
+        string path = ofToDataPath("session_" + ofGetTimestampString("%Y%m%d_%H%M%S") + ".mvlog", true);
+        if (midiRecorder.start(path)) {
+            MVLOG_INFO(LOG_CATEGORY_SESSION, "MIDI recorder: recording to %s", path.c_str());
+        }
+    }
+}
+
+bool ofApp::loadMidiSession(const string& path) {
+    if (!midiPlayer.load(path)) {
+        return false;
+    }
+    sessionPath = path;
+    return true;
 }
 
-void ofApp::onDrumMidiMessage(ofxMidiMessage& msg) {
-    cout << "=== DRUM MIDI ===" << endl;
-    cout << "Pitch: " << msg.pitch << ", Velocity: " << msg.velocity << ", Port: " << drumPortName << endl;
+void ofApp::startMidiPlayback(MidiPlaybackMode mode) {
+    if (!midiPlayer.hasEvents()) {
+        MVLOG_WARN(LOG_CATEGORY_SESSION, "MIDI player: no session loaded");
+        return;
+    }
+    
+    // 録音中のログにリプレイが混ざらないよう停止
+    if (midiRecorder.isRecording()) {
+        midiRecorder.stop();
+    }
+    
+    if (mode == PLAYBACK_FIXED_STEP) {
+        // 垂直同期・フレームレート制限を外して可能な限り高速に回す
+        SimViewport::setFixedClock(true);
+        ofSetVerticalSync(false);
+        ofSetFrameRate(0);
+        playbackFrameTimes.clear();
+        playbackFrameTimes.reserve(midiPlayer.getDurationMicros() / 1000000.0f / playbackDeltaTime + 1);
+    }
+    
+    midiPlayer.setTail(playbackTailSeconds);
+    midiPlayer.start(mode, playbackDeltaTime);
+    playbackOriginTime = SimViewport::getElapsedTime();
+    
+    // 再生ごとに同じビート列になるよう、テンポは取り直す（ビートで予約したアクションも捨てる）
+    tempoEngine.reset();
+    lastAutoSwitchBeat = -1;
+    lastScheduledPulseBeat = -1;
+    lastPulseBeat = -1;
+    beatScheduler.cancel(BEAT_ACTION_TRANSITION);
+    beatScheduler.cancel(BEAT_ACTION_GLITCH);
+    beatScheduler.cancel(BEAT_ACTION_IMPACT);
+    playbackWallStartMicros = midiNowMicros();
+    
+    MVLOG_INFO(LOG_CATEGORY_SESSION, "MIDI player: %s playback of %zu events",
+               (mode == PLAYBACK_FIXED_STEP ? "fast (dt " + ofToString(playbackDeltaTime, 4) + "s)" : string("realtime")).c_str(),
+               midiPlayer.getEventCount());
+}
+
+void ofApp::seekMidiPlayback(float offsetSeconds) {
+    if (!midiPlayer.isPlaying()) return;
+    
+    int64_t target = (int64_t)midiPlayer.getPositionMicros() + (int64_t)(offsetSeconds * 1000000.0f);
+    target = std::max<int64_t>(0, std::min<int64_t>(target, midiPlayer.getDurationMicros()));
+    midiPlayer.seek(target);
+    
+    // イベント時刻が現在時刻から連続するよう基準時刻をずらす
+    playbackOriginTime = SimViewport::getElapsedTime() - target / 1000000.0;
+    MVLOG_INFO(LOG_CATEGORY_SESSION, "MIDI player: seek to %.1fs", target / 1000000.0f);
+}
+
+void ofApp::finishMidiPlayback() {
+    bool fixedStep = midiPlayer.isFixedStep();
+    midiPlayer.stop();
+    
+    float wallSeconds = (midiNowMicros() - playbackWallStartMicros) / 1000000.0f;
+    float sessionSeconds = midiPlayer.getDurationMicros() / 1000000.0f;
+    MVLOG_INFO(LOG_CATEGORY_SESSION, "=== PLAYBACK FINISHED ===");
+    MVLOG_INFO(LOG_CATEGORY_SESSION, "Session: %.2fs, wall: %.2fs", sessionSeconds, wallSeconds);
+    
+    if (fixedStep) {
+        SimViewport::setFixedClock(false);
+        ofSetVerticalSync(true);
+        ofSetFrameRate(60);
+        
+        // フレーム時間の統計（ビルド間の比較用）
+        std::vector<float> sorted = playbackFrameTimes;
+        std::sort(sorted.begin(), sorted.end());
+        if (!sorted.empty()) {
+            float total = 0.0f;
+            for (float t : sorted) total += t;
+            auto percentile = [&](float p) { return sorted[std::min(sorted.size() - 1, (size_t)(sorted.size() * p))] * 1000.0f; };
+            
+            MVLOG_INFO(LOG_CATEGORY_SESSION, "Frames: %zu, speed: %.1fx", sorted.size(), sessionSeconds / std::max(wallSeconds, 0.001f));
+            MVLOG_INFO(LOG_CATEGORY_SESSION, "Frame time (ms): mean %.2f p50 %.2f p95 %.2f p99 %.2f max %.2f",
+                       total / sorted.size() * 1000.0f, percentile(0.5f), percentile(0.95f), percentile(0.99f), sorted.back() * 1000.0f);
+            
+            // 2ms刻みのヒストグラム（32ms以上は最後のビン）
+            const int numBins = 17;
+            int bins[numBins] = {0};
+            for (float t : sorted) {
+                bins[std::min(numBins - 1, (int)(t * 1000.0f / 2.0f))]++;
+            }
+            for (int i = 0; i < numBins; i++) {
+                if (bins[i] == 0) continue;
+                string label = (i == numBins - 1) ? ">=" + ofToString(i * 2) : ofToString(i * 2) + "-" + ofToString(i * 2 + 2);
+                MVLOG_INFO(LOG_CATEGORY_SESSION, "  %sms: %d", label.c_str(), bins[i]);
+            }
+        }
+    }
+    MVLOG_INFO(LOG_CATEGORY_SESSION, "=========================");
+}
+
+void ofApp::onDrumMidiMessage(ofxMidiMessage& msg, double eventTime) {
+    // MIDIクロック（1拍24回）とスタート/ストップはテンポエンジンだけに渡す（履歴・ログには残さない）
+    switch (msg.status) {
+        case MIDI_TIME_CLOCK: tempoEngine.onClockTick(eventTime); return;
+        case MIDI_START: tempoEngine.onClockStart(eventTime); return;
+        case MIDI_CONTINUE: tempoEngine.onClockContinue(eventTime); return;
+        case MIDI_STOP: tempoEngine.onClockStop(eventTime); return;
+        default: break;
+    }
+    
+    MVLOG_DEBUG(LOG_CATEGORY_MIDI, "Drum: pitch %d, velocity %d, port %s", msg.pitch, msg.velocity, drumPortName.c_str());
     
     // MIDIメッセージ履歴に追加
     midiMessages.push_back(msg);
     while(midiMessages.size() > maxMessages){
         midiMessages.erase(midiMessages.begin());
     }
-    lastActivityTime = ofGetElapsedTimef();
+    lastActivityTime = SimViewport::getElapsedTimef();
     
     // レガシー情報の更新
+    bool pulsedKick = false;
     if(msg.status == MIDI_NOTE_ON && msg.velocity > 0){
         currentNote = msg.pitch;
         currentVelocity = msg.velocity;
@@ -325,8 +824,12 @@ void ofApp::onDrumMidiMessage(ofxMidiMessage& msg) {
         
         // KICKでテンポトラッキング（ドラムの4つ打ちをビートとして認識）
         if (msg.pitch == 36 || msg.pitch == 35) {  // 一般的なKICKのNOTE番号
-            cout << "KICK detected (pitch " << msg.pitch << ") - updating tempo tracking" << endl;
-            updateTempoTracking(ofGetElapsedTimef());
+            MVLOG_DEBUG(LOG_CATEGORY_MIDI, "KICK detected (pitch %d) - updating tempo tracking", msg.pitch);
+            lastKickVelocity = msg.velocity;
+            
+            // 予測したビートで既に反応させたキックは、システムに送らない（二重に反応させない）
+            pulsedKick = beatPulseEnabled && std::llround(tempoEngine.getBeatPosition(eventTime)) == lastPulseBeat;
+            tempoEngine.onOnset(eventTime);
         }
     }else if(msg.status == MIDI_NOTE_OFF || (msg.status == MIDI_NOTE_ON && msg.velocity == 0)){
         if(msg.pitch == currentNote){
@@ -335,47 +838,64 @@ void ofApp::onDrumMidiMessage(ofxMidiMessage& msg) {
         }
     }
     
+    if (!pulsedKick) {
+        forwardToActiveSystems(msg);
+    }
+}
+
+void ofApp::forwardToActiveSystems(ofxMidiMessage& msg) {
     // アクティブなシステムにMIDIメッセージを送信（トランジション中は両方に送信）
-    for (auto& system : visualSystems) {
+    for (std::size_t i = 0; i < visualSystems.size(); i++) {
+        VisualSystem* system = visualSystems[i];
+        if (!system) continue;
         if (system->getActive() || 
-            (isTransitioning && (&system == &visualSystems[nextSystemIndex]))) {
+            (isTransitioning && i == nextSystemIndex)) {
             system->onMidiMessage(msg);
         }
     }
-    cout << "=================" << endl;
 }
 
-void ofApp::onPush2MidiMessage(ofxMidiMessage& msg) {
-    cout << "=== PUSH2 MIDI ===" << endl;
-    cout << "Pitch: " << msg.pitch << ", Velocity: " << msg.velocity << ", Port: " << push2PortName << endl;
+void ofApp::onPush2MidiMessage(ofxMidiMessage& msg, double eventTime) {
+    // Push2が送るクロックなどのリアルタイムメッセージは使わない
+    if (msg.status == MIDI_TIME_CLOCK || msg.status == MIDI_START || msg.status == MIDI_CONTINUE || msg.status == MIDI_STOP) {
+        return;
+    }
+    
+    MVLOG_DEBUG(LOG_CATEGORY_MIDI, "Push2: pitch %d, velocity %d, port %s", msg.pitch, msg.velocity, push2PortName.c_str());
     
     // MIDIメッセージ履歴に追加（Push2メッセージも履歴に残す）
     midiMessages.push_back(msg);
     while(midiMessages.size() > maxMessages){
         midiMessages.erase(midiMessages.begin());
     }
-    lastActivityTime = ofGetElapsedTimef();
+    lastActivityTime = SimViewport::getElapsedTimef();
+    
+    // 表示遅延の校正中はパッドを打鍵として使う（MIDIの到着時刻なのでキーより正確）
+    if (beatScheduler.isCalibrating()) {
+        if (msg.status == MIDI_NOTE_ON && msg.velocity > 0) {
+            beatScheduler.addCalibrationTap(eventTime);
+        }
+        return;
+    }
     
     // Push2のパッド範囲からのグリッチトリガー
     if (msg.status == MIDI_NOTE_ON && msg.velocity > 0 && msg.pitch >= 36 && msg.pitch <= 99) {
-        cout << ">>> PUSH2 PAD DETECTED <<<" << endl;
-        
         // モノクロモードではグリッチを無効化
         if (isMonochromePattern) {
-            cout << "GLITCH BLOCKED: Monochrome mode active (System " << (currentSystemIndex + 1) << ")" << endl;
+            MVLOG_DEBUG(LOG_CATEGORY_GLITCH, "Push2 pad blocked: monochrome mode active (system %d)", currentSystemIndex + 1);
         } else {
             // 厳格な安全チェック
             if (glitchSystemBusy) {
-                cout << "GLITCH BLOCKED: System busy" << endl;
+                MVLOG_DEBUG(LOG_CATEGORY_GLITCH, "Push2 pad blocked: system busy");
                 return;
             }
             
-            float currentTime = ofGetElapsedTimef();
+            float currentTime = SimViewport::getElapsedTimef();
             if (currentTime - lastGlitchTime >= glitchCooldown) {
                 // 複数の安全性チェック
                 int currentAreas = glitchAreaSystem.getActiveAreaCount();
-                if (currentAreas >= 2) { // さらに厳格に：最大2個まで
-                    cout << "GLITCH BLOCKED: Too many active areas (" << currentAreas << ")" << endl;
+                if (currentAreas >= glitchAreaSystem.getMaxAreas()) { // 詳細度で決まる上限まで
+                    MVLOG_DEBUG(LOG_CATEGORY_GLITCH, "Push2 pad blocked: too many active areas (%d)", currentAreas);
                     return;
                 }
                 
@@ -383,124 +903,95 @@ void ofApp::onPush2MidiMessage(ofxMidiMessage& msg) {
                 glitchSystemBusy = true;
                 
                 try {
-                    cout << ">>> GLITCH TRIGGERED! (Safe Mode) <<<" << endl;
+                    MVLOG_DEBUG(LOG_CATEGORY_GLITCH, "Push2 pad: glitch triggered");
                     // 軽量モード：1個のエリアのみ
-                    glitchAreaSystem.triggerGlitch(1);
+                    queueGlitch();
                     lastGlitchTime = currentTime;
                 } catch (const std::exception& e) {
-                    cout << "Error in glitch trigger: " << e.what() << endl;
+                    MVLOG_ERROR(LOG_CATEGORY_GLITCH, "Glitch trigger failed: %s", e.what());
                 } catch (...) {
-                    cout << "Unknown error in glitch trigger" << endl;
+                    MVLOG_ERROR(LOG_CATEGORY_GLITCH, "Glitch trigger failed: unknown error");
                 }
                 
                 // ビジー状態を解除（0.5秒後）
                 glitchSystemBusy = false;
             } else {
-                cout << "GLITCH BLOCKED: Cooldown active (" << (glitchCooldown - (currentTime - lastGlitchTime)) << "s remaining)" << endl;
+                MVLOG_DEBUG(LOG_CATEGORY_GLITCH, "Push2 pad blocked: cooldown active (%.2fs remaining)", glitchCooldown - (currentTime - lastGlitchTime));
             }
         }
     }
-    cout << "==================" << endl;
 }
 
 void ofApp::keyPressed(int key){
-    lastActivityTime = ofGetElapsedTimef();
+    // ワーカーが更新中のシステムに触れないよう、先にフレーム境界まで進める
+    finishPipelinedUpdates();
+    lastActivityTime = SimViewport::getElapsedTimef();
     
-    cout << "Key pressed: " << key << " (char: '" << (char)key << "')" << endl;
-    cout << "Checking conditions..." << endl;
+    MVLOG_DEBUG(LOG_CATEGORY_INPUT, "Key pressed: %d ('%c')", key, (char)key);
     
     if (key == ' ' || key == 32) {
         // スペースキーで次のシステムに切り替え（再生順序に従う）
-        cout << "Space key pressed - switching system" << endl;
         playbackIndex = (playbackIndex + 1) % playbackOrder.size();
         int nextSystem = playbackOrder[playbackIndex];
         switchToSystem(nextSystem);
-        cout << "Switched to system: " << nextSystem << " (playback index: " << playbackIndex << ")" << endl;
+        MVLOG_INFO(LOG_CATEGORY_INPUT, "Switched to system: %d (playback index: %d)", nextSystem, playbackIndex);
     } else if (key == 'h' || key == 'H') {
         // UIの表示切り替え
-        cout << "Toggle UI" << endl;
         showUI = !showUI;
-    } else if (key >= '1' && key <= '9') {
-        // 直接システム切り替え（優先）
-        int systemIndex = key - '1';
-        if (systemIndex < visualSystems.size()) {
-            cout << "Direct system switch to: " << systemIndex << endl;
-            // 直接選択時は再生位置も更新
-            for (int i = 0; i < playbackOrder.size(); i++) {
-                if (playbackOrder[i] == systemIndex) {
-                    playbackIndex = i;
-                    break;
-                }
-            }
-            switchToSystem(systemIndex);
-        }
-    } else if (key == '0') {
-        // 10番目のシステム（Water Ripple）へ直接切り替え
-        if (9 < visualSystems.size()) {
-            cout << "Direct system switch to: 9 (Water Ripple)" << endl;
-            for (int i = 0; i < playbackOrder.size(); i++) {
-                if (playbackOrder[i] == 9) {
-                    playbackIndex = i;
-                    break;
-                }
-            }
-            switchToSystem(9);
-        }
-    } else if (key == '-' || key == '_') {
-        // 11番目のシステム（Sand Particle）へ直接切り替え  
-        if (10 < visualSystems.size()) {
-            cout << "Direct system switch to: 10 (Sand Particle)" << endl;
-            for (int i = 0; i < playbackOrder.size(); i++) {
-                if (playbackOrder[i] == 10) {
-                    playbackIndex = i;
-                    break;
-                }
-            }
-            switchToSystem(10);
-        }
+    } else if (SystemRegistry::findByHotkey(key) >= 0) {
+        // 直接システム切り替え（優先、キーはSystemRegistryの登録）
+        selectSystem(SystemRegistry::findByHotkey(key));
     } else if (key == 'p' || key == 'P') {
         // MIDI接続状況の表示
-        cout << "=== MIDI CONNECTION STATUS ===" << endl;
-        cout << "Drum MIDI (IAC): " << (drumMidiConnected ? "✓ CONNECTED" : "✗ NOT CONNECTED") << endl;
+        MVLOG_INFO(LOG_CATEGORY_MIDI, "=== MIDI CONNECTION STATUS ===");
+        MVLOG_INFO(LOG_CATEGORY_MIDI, "Drum MIDI (IAC): %s", drumMidiConnected ? "✓ CONNECTED" : "✗ NOT CONNECTED");
         if (drumMidiConnected) {
-            cout << "  Port: " << drumPortName << endl;
+            MVLOG_INFO(LOG_CATEGORY_MIDI, "  Port: %s", drumPortName.c_str());
         }
-        cout << "Push2 Glitch: " << (push2MidiConnected ? "✓ CONNECTED" : "✗ NOT CONNECTED") << endl;
+        MVLOG_INFO(LOG_CATEGORY_MIDI, "Push2 Glitch: %s", push2MidiConnected ? "✓ CONNECTED" : "✗ NOT CONNECTED");
         if (push2MidiConnected) {
-            cout << "  Port: " << push2PortName << endl;
+            MVLOG_INFO(LOG_CATEGORY_MIDI, "  Port: %s", push2PortName.c_str());
         }
         
         if (drumMidiConnected && push2MidiConnected) {
-            cout << ">>> DUAL MIDI MODE ACTIVE <<<" << endl;
-            cout << "Both drum triggers and glitch effects available simultaneously" << endl;
+            MVLOG_INFO(LOG_CATEGORY_MIDI, ">>> DUAL MIDI MODE ACTIVE <<<");
         }
-        cout << "==============================" << endl;
+        
+        // キュー統計（表示後にピーク値をリセット）
+        MVLOG_INFO(LOG_CATEGORY_MIDI, "Drum queue: max depth %zu, drops %llu, worst latency %lluus", drumQueue.getMaxDepth(),
+                   (unsigned long long)drumQueue.getDroppedCount(), (unsigned long long)drumQueue.getWorstLatencyMicros());
+        MVLOG_INFO(LOG_CATEGORY_MIDI, "Push2 queue: max depth %zu, drops %llu, worst latency %lluus", push2Queue.getMaxDepth(),
+                   (unsigned long long)push2Queue.getDroppedCount(), (unsigned long long)push2Queue.getWorstLatencyMicros());
+        drumQueue.resetStats();
+        push2Queue.resetStats();
+        
+        // レンダーターゲットの使用状況・ログの取りこぼし
+        RenderTargetPool::printStats();
+        const DrawCommandStats& drawStats = DrawCommandList::getLastFrameStats();
+        MVLOG_INFO(LOG_CATEGORY_RENDER, "Draw commands: %zu recorded, %zu draws (peak %zu), %zu blend changes",
+                   drawStats.recorded, drawStats.drawCalls, DrawCommandList::getPeakDrawCalls(), drawStats.blendChanges);
+        DrawCommandList::resetPeak();
+        MVLOG_INFO(LOG_CATEGORY_APP, "Log: %s, dropped %llu", AsyncLog::isQuiet() ? "QUIET" : "VERBOSE",
+                   (unsigned long long)AsyncLog::getDroppedCount());
     } else if (key == 'g' || key == 'G') {
         // グリッチエフェクトのテストトリガー（モノクロモードでは無効）
-        cout << "=== MANUAL GLITCH TEST (G KEY) ===" << endl;
-        cout << "Current System: " << (currentSystemIndex + 1) << endl;
-        cout << "Monochrome Mode: " << (isMonochromePattern ? "YES" : "NO") << endl;
-        
         if (isMonochromePattern) {
-            cout << "GLITCH BLOCKED: Monochrome mode active" << endl;
-            cout << "=================================" << endl;
+            MVLOG_DEBUG(LOG_CATEGORY_GLITCH, "Manual glitch blocked: monochrome mode active (system %d)", currentSystemIndex + 1);
             return;
         }
         
         // 厳格な安全チェック
         if (glitchSystemBusy) {
-            cout << "GLITCH BLOCKED: System busy" << endl;
-            cout << "=================================" << endl;
+            MVLOG_DEBUG(LOG_CATEGORY_GLITCH, "Manual glitch blocked: system busy");
             return;
         }
         
-        float currentTime = ofGetElapsedTimef();
+        float currentTime = SimViewport::getElapsedTimef();
         if (currentTime - lastGlitchTime >= glitchCooldown) {
             // 複数の安全性チェック
             int currentAreas = glitchAreaSystem.getActiveAreaCount();
-            if (currentAreas >= 2) { // さらに厳格に：最大2個まで
-                cout << "GLITCH BLOCKED: Too many active areas (" << currentAreas << ")" << endl;
-                cout << "=================================" << endl;
+            if (currentAreas >= glitchAreaSystem.getMaxAreas()) { // 詳細度で決まる上限まで
+                MVLOG_DEBUG(LOG_CATEGORY_GLITCH, "Manual glitch blocked: too many active areas (%d)", currentAreas);
                 return;
             }
             
@@ -508,38 +999,97 @@ void ofApp::keyPressed(int key){
             glitchSystemBusy = true;
             
             try {
-                cout << ">>> MANUAL GLITCH TRIGGERED! (Safe Mode) <<<" << endl;
                 // 軽量モード：1個のエリアのみ
-                glitchAreaSystem.triggerGlitch(1);
+                queueGlitch();
                 lastGlitchTime = currentTime;
-                cout << "Glitch areas created: " << glitchAreaSystem.getActiveAreaCount() << endl;
+                MVLOG_DEBUG(LOG_CATEGORY_GLITCH, "Manual glitch triggered: %d areas active", glitchAreaSystem.getActiveAreaCount());
             } catch (const std::exception& e) {
-                cout << "Error in manual glitch trigger: " << e.what() << endl;
+                MVLOG_ERROR(LOG_CATEGORY_GLITCH, "Manual glitch trigger failed: %s", e.what());
             } catch (...) {
-                cout << "Unknown error in manual glitch trigger" << endl;
+                MVLOG_ERROR(LOG_CATEGORY_GLITCH, "Manual glitch trigger failed: unknown error");
             }
             
             // ビジー状態を解除
             glitchSystemBusy = false;
         } else {
-            cout << "GLITCH BLOCKED: Cooldown active (" << (glitchCooldown - (currentTime - lastGlitchTime)) << "s remaining)" << endl;
+            MVLOG_DEBUG(LOG_CATEGORY_GLITCH, "Manual glitch blocked: cooldown active (%.2fs remaining)", glitchCooldown - (currentTime - lastGlitchTime));
+        }
+    } else if (key == 'r' || key == 'R') {
+        // MIDIセッションの録音開始/停止
+        toggleMidiRecording();
+    } else if (key == 'l' || key == 'L' || key == 'f' || key == 'F') {
+        // 最後のログを再生（L=実時間、F=固定dtで高速）、再生中なら停止
+        if (midiPlayer.isPlaying()) {
+            finishMidiPlayback();
+        } else if (!sessionPath.empty() && (midiPlayer.hasEvents() || loadMidiSession(sessionPath))) {
+            startMidiPlayback((key == 'f' || key == 'F') ? PLAYBACK_FIXED_STEP : PLAYBACK_REALTIME);
+        } else {
+            MVLOG_WARN(LOG_CATEGORY_SESSION, "MIDI player: no session recorded or loaded");
+        }
+    } else if (key == 'q' || key == 'Q') {
+        // 品質ガバナーの切替（オフにすると詳細度1.0 = 従来の固定上限に戻す）
+        autoQuality = !autoQuality;
+        if (!autoQuality) {
+            qualityGovernor.setAllBudgets(1.0f);
+            applyDetailBudgets();
+        }
+        MVLOG_INFO(LOG_CATEGORY_APP, "Quality governor: %s", autoQuality ? "AUTO" : "FIXED (detail 1.0)");
+    } else if (key == 'v' || key == 'V') {
+        // イベントごとのログ（MIDI・キー入力・グリッチ）の切替。本番中は止める
+        AsyncLog::setQuiet(!AsyncLog::isQuiet());
+        MVLOG_INFO(LOG_CATEGORY_APP, "Log: %s", AsyncLog::isQuiet() ? "QUIET (per-event logs off)" : "VERBOSE");
+    } else if (key == 'o' || key == 'O') {
+        // プロファイラのオーバーレイ表示切替
+        showProfiler = !showProfiler;
+    } else if (key == 't' || key == 'T') {
+        // プロファイラの記録をCSVとChromeトレース（chrome://tracing / Perfetto）に書き出す
+        string stamp = ofGetTimestampString("%Y%m%d_%H%M%S");
+        FrameProfiler::dumpCsv(ofToDataPath("profile_" + stamp + ".csv", true));
+        FrameProfiler::dumpTrace(ofToDataPath("trace_" + stamp + ".json", true));
+        latencyTracker.dumpCsv(ofToDataPath("latency_" + stamp + ".csv", true));
+    } else if (key == 'm' || key == 'M') {
+        // MIDI-to-photonのレイテンシ（キュー・シミュレーション・描画の内訳）の表示切替
+        showLatency = !showLatency;
+    } else if (key == 'b' || key == 'B') {
+        // グリッチを次のビートに量子化（予約したビートが画面に出るフレームで発生）
+        quantizeGlitches = !quantizeGlitches;
+        MVLOG_INFO(LOG_CATEGORY_APP, "Glitch quantize: %s", quantizeGlitches ? "ON (next beat)" : "OFF (immediate)");
+    } else if (key == 'k' || key == 'K') {
+        // キックの反応を予測したビートに合わせて先に出す
+        beatPulseEnabled = !beatPulseEnabled;
+        beatScheduler.cancel(BEAT_ACTION_IMPACT);
+        lastScheduledPulseBeat = -1;
+        MVLOG_INFO(LOG_CATEGORY_APP, "Beat pulse: %s", beatPulseEnabled ? "ON" : "OFF");
+    } else if (key == 'c' || key == 'C') {
+        // 表示遅延の校正（点滅に合わせてEnterキーかPush2のパッドを叩き、もう一度Cで反映）
+        if (!beatScheduler.isCalibrating()) {
+            beatScheduler.startCalibration();
+            MVLOG_INFO(LOG_CATEGORY_APP, "Display calibration: tap Enter or a Push2 pad with the flashes, press C again to apply");
+        } else if (beatScheduler.finishCalibration()) {
+            MVLOG_INFO(LOG_CATEGORY_APP, "Display calibration: offset %.1fms (%d taps, latency %.1fms), reuse with --display-offset %.1f",
+                       beatScheduler.getDisplayOffset() * 1000.0, beatScheduler.getCalibrationTapCount(),
+                       beatScheduler.getPresentLatency() * 1000.0, beatScheduler.getDisplayOffset() * 1000.0);
+        } else {
+            MVLOG_WARN(LOG_CATEGORY_APP, "Display calibration: not enough taps (%d/%d), offset unchanged",
+                       beatScheduler.getCalibrationTapCount(), BeatScheduler::MIN_CALIBRATION_TAPS);
         }
-        cout << "=================================" << endl;
+    } else if (key == OF_KEY_RETURN && beatScheduler.isCalibrating()) {
+        beatScheduler.addCalibrationTap(SimViewport::getElapsedTime());
+    } else if (key == OF_KEY_LEFT || key == OF_KEY_RIGHT) {
+        // 再生中のスクラブ（±10秒）
+        seekMidiPlayback(key == OF_KEY_LEFT ? -10.0f : 10.0f);
     }
 }
 
 void ofApp::switchToSystem(int systemIndex) {
-    cout << "switchToSystem called with index: " << systemIndex << endl;
-    cout << "Current system index: " << currentSystemIndex << endl;
-    cout << "Total systems: " << visualSystems.size() << endl;
-    
     if (systemIndex >= 0 && systemIndex < visualSystems.size() && systemIndex != currentSystemIndex) {
-        // システム番号に基づいてモノクロ/カラーを設定
-        // 7以上（Infinite Corridor以降）はモノクロ
-        isMonochromePattern = (systemIndex >= 7);
-        VisualSystem::setGlobalMonochromeMode(isMonochromePattern);
+        // 準備中のシステムがあればワーカーの終了を待つ（別のシステムなら破棄）
+        systemPreparer.claim(systemIndex);
+        ensureSystem(systemIndex);
         
-        cout << "System: " << systemIndex << " - Mode: " << (isMonochromePattern ? "MONOCHROME" : "COLOR") << endl;
+        // 登録のモノクロ/カラーを設定
+        isMonochromePattern = SystemRegistry::get(systemIndex).monochrome;
+        VisualSystem::setGlobalMonochromeMode(isMonochromePattern);
         
         if (isTransitioning) {
             // 既にトランジション中の場合は即座切替
@@ -554,11 +1104,49 @@ void ofApp::switchToSystem(int systemIndex) {
             startTransition(systemIndex);
             manualTempoOverride = true;  // 手動切替時は自動を一時停止
         }
-        cout << "Started transition to system: " << systemIndex << endl;
+        MVLOG_INFO(LOG_CATEGORY_SYSTEM, "Switching from system %d to %d (%s)", currentSystemIndex, systemIndex,
+                   isMonochromePattern ? "MONOCHROME" : "COLOR");
     } else if (systemIndex == currentSystemIndex) {
-        cout << "Already on system: " << systemIndex << endl;
+        MVLOG_DEBUG(LOG_CATEGORY_SYSTEM, "Already on system: %d", systemIndex);
     } else {
-        cout << "Invalid system index: " << systemIndex << endl;
+        MVLOG_WARN(LOG_CATEGORY_SYSTEM, "Invalid system index: %d (%zu systems)", systemIndex, visualSystems.size());
+    }
+}
+
+void ofApp::selectSystem(int systemIndex) {
+    if (systemIndex < 0 || systemIndex >= (int)visualSystems.size()) {
+        return;
+    }
+    MVLOG_INFO(LOG_CATEGORY_INPUT, "Direct system switch to: %d (%s)", systemIndex, SystemRegistry::get(systemIndex).displayName);
+    
+    // 直接選択時は再生位置も更新（再生順序にないシステムならそのまま）
+    for (std::size_t i = 0; i < playbackOrder.size(); i++) {
+        if (playbackOrder[i] == systemIndex) {
+            playbackIndex = i;
+            break;
+        }
+    }
+    switchToSystem(systemIndex);
+}
+
+VisualSystem* ofApp::ensureSystem(int systemIndex) {
+    VisualSystem*& system = visualSystems[systemIndex];
+    if (!system) {
+        system = systemLoader.acquire(systemIndex);
+        system->setDetailBudget(qualityGovernor.getBudget(systemIndex));
+    }
+    return system;
+}
+
+void ofApp::adoptLoadedSystems() {
+    // 取り込むまでは描画スレッドから見えない（更新・MIDI・詳細度の対象外）
+    for (std::size_t i = 0; i < visualSystems.size(); i++) {
+        if (visualSystems[i]) continue;
+        VisualSystem* system = systemLoader.get(i);
+        if (system) {
+            system->setDetailBudget(qualityGovernor.getBudget(i));
+            visualSystems[i] = system;
+        }
     }
 }
 
@@ -566,16 +1154,20 @@ void ofApp::startTransition(int targetSystemIndex) {
     if (targetSystemIndex >= 0 && targetSystemIndex < visualSystems.size() && targetSystemIndex != currentSystemIndex) {
         nextSystemIndex = targetSystemIndex;
         isTransitioning = true;
-        transitionStartTime = ofGetElapsedTimef();
+        transitionStartTime = SimViewport::getElapsedTimef();
         transitionProgress = 0.0f;
         
+        // 事前に準備済みならターゲットは借りてあり、状態も温まっている
+        systemPreparer.claim(nextSystemIndex);
+        ensureSystem(nextSystemIndex);
+        
         // ターゲットシステムをアクティブにして更新を開始
         visualSystems[nextSystemIndex]->setActive(true);
     }
 }
 
 void ofApp::updateTransition(float deltaTime) {
-    float currentTime = ofGetElapsedTimef();
+    float currentTime = SimViewport::getElapsedTimef();
     transitionProgress = (currentTime - transitionStartTime) / transitionDuration;
     
     if (transitionProgress >= 1.0f) {
@@ -584,86 +1176,160 @@ void ofApp::updateTransition(float deltaTime) {
         currentSystemIndex = nextSystemIndex;
         isTransitioning = false;
         transitionProgress = 1.0f;
-        cout << "Transition completed to system: " << currentSystemIndex << endl;
+        MVLOG_INFO(LOG_CATEGORY_SYSTEM, "Transition completed to system: %d", currentSystemIndex);
     }
 }
 
 void ofApp::drawTransition() {
-    ofPushStyle();
-    ofEnableBlendMode(OF_BLENDMODE_ALPHA);
-    
     // スムーズなイージング（コサインカーブ）を適用
     float easedProgress = (1.0f - cos(transitionProgress * PI)) * 0.5f;
     
-    // 現在のシステムをフェードアウト
-    float currentAlpha = 1.0f - easedProgress;
-    ofSetColor(255, 255, 255, currentAlpha * 255);
-    visualSystems[currentSystemIndex]->draw();
-    
-    // 次のシステムをフェードイン
-    float nextAlpha = easedProgress;
-    ofSetColor(255, 255, 255, nextAlpha * 255);
-    visualSystems[nextSystemIndex]->draw();
-    
-    ofDisableBlendMode();
-    ofPopStyle();
+    // 2システムをそれぞれのレイヤーに1回ずつ描き、次のシステムを不透明度で重ねて1パスで合成
+    layerCompositor.begin(glitchOutputFbo->getWidth(), glitchOutputFbo->getHeight());
+    drawSystemLayer(currentSystemIndex, 1.0f);
+    drawSystemLayer(nextSystemIndex, easedProgress);
+    layerCompositor.composite();
 }
 
-void ofApp::updateTempoTracking(float currentTime) {
-    // ビート間隔の記録（最新8ビート）
-    if (lastBeatTime > 0) {
-        float interval = currentTime - lastBeatTime;
-        recentBeatIntervals.push_back(interval);
-        if (recentBeatIntervals.size() > 8) {
-            recentBeatIntervals.erase(recentBeatIntervals.begin());
-        }
-        calculateBPM();
+void ofApp::drawSystemLayer(int systemIndex, float opacity) {
+    if (!layerCompositor.beginLayer(opacity, LAYER_BLEND_ALPHA)) {
+        return;
     }
-    lastBeatTime = currentTime;
-    beatCount++;
-}
-
-void ofApp::calculateBPM() {
-    if (recentBeatIntervals.size() >= 4) {
-        float avgInterval = 0;
-        for (float interval : recentBeatIntervals) {
-            avgInterval += interval;
-        }
-        avgInterval /= recentBeatIntervals.size();
-        
-        // BPMを計算（一分間のビート数）
-        if (avgInterval > 0.1f && avgInterval < 2.0f) {  // 合理的な範囲内
-            bpm = 60.0f / avgInterval;
-            bpm = ofClamp(bpm, 60.0f, 200.0f);  // BPM範囲制限
-        }
+    uint64_t systemStart = midiNowMicros();
+    {
+        PROFILE_ZONE(SystemRegistry::get(systemIndex).drawZone);
+        visualSystems[systemIndex]->render();
     }
+    qualityGovernor.addCost(systemIndex, midiNowMicros() - systemStart);
+    layerCompositor.endLayer();
 }
 
 bool ofApp::shouldAutoSwitch() {
-    if (!autoSwitchEnabled || manualTempoOverride || isTransitioning) {
+    if (!autoSwitchEnabled || manualTempoOverride || isTransitioning || beatScheduler.hasPending(BEAT_ACTION_TRANSITION)) {
         return false;
     }
     
     // 8小節（基本的に32ビート）をチェック
+    // このフレームが画面に出る時刻のビート位置で、次の切替ビートまで1ビートを切ったら予約する
+    double displayBeat = getDisplayBeat();
+    int64_t switchBeat = getNextSwitchBeat(displayBeat);
+    
+    return switchBeat - displayBeat <= 1.0 && switchBeat != lastAutoSwitchBeat;
+}
+
+double ofApp::getDisplayBeat() const {
+    return tempoEngine.getBeatPosition(beatScheduler.getDisplayTime());
+}
+
+int64_t ofApp::getNextSwitchBeat(double beat) const {
     int beatsPerBar = 4;  // 4/4拍子
     int totalBeats = barsPerSwitch * beatsPerBar;
-    
-    return (beatCount % totalBeats == 0) && (beatCount > 0);
+    return ((int64_t)std::floor(beat) / totalBeats + 1) * totalBeats;
 }
 
 void ofApp::handleAutoSwitch() {
     if (shouldAutoSwitch()) {
-        // 再生順序に従って次のシステムに切り替え
-        playbackIndex = (playbackIndex + 1) % playbackOrder.size();
-        int nextSystem = playbackOrder[playbackIndex];
-        cout << "Auto-switching to system: " << nextSystem << " (playback index: " << playbackIndex << ", Beat: " << beatCount << ", BPM: " << bpm << ")" << endl;
-        startTransition(nextSystem);
-        
-        // 手動オーバーライドをリセット（次の自動切替を有効に）
-        manualTempoOverride = false;
+        // 切替ビートが画面に出るフレームでクロスフェードが始まるよう予約（実行はrunBeatActions）
+        lastAutoSwitchBeat = getNextSwitchBeat(getDisplayBeat());
+        beatScheduler.scheduleAtBeat(BEAT_ACTION_TRANSITION, lastAutoSwitchBeat, -1);
+    }
+}
+
+void ofApp::scheduleBeatPulse() {
+    double displayTime = beatScheduler.getDisplayTime();
+    TempoSource source = tempoEngine.getSource(displayTime);
+    if (!beatPulseEnabled || source == TEMPO_SOURCE_NONE || (source == TEMPO_SOURCE_KICK && !tempoEngine.isLocked())) {
+        return;
+    }
+    
+    // 次のビートを1つずつ予約。パイプライン化したシステムはMIDIの反映が1フレーム後に描かれるので1フレーム早める
+    int64_t nextBeat = tempoEngine.getBeatCount(displayTime) + 1;
+    if (nextBeat != lastScheduledPulseBeat) {
+        int leadFrames = (pipelinedUpdate && visualSystems[currentSystemIndex]->isPipelined()) ? 1 : 0;
+        beatScheduler.scheduleAtBeat(BEAT_ACTION_IMPACT, nextBeat, 36, lastKickVelocity, leadFrames);  // 36 = KICK
+        lastScheduledPulseBeat = nextBeat;
     }
 }
 
+void ofApp::runBeatActions() {
+    int count = beatScheduler.collectDue(tempoEngine, dueBeatActions.data(), BeatScheduler::CAPACITY);
+    for (int i = 0; i < count; i++) {
+        const BeatAction& action = dueBeatActions[i];
+        switch (action.type) {
+            case BEAT_ACTION_TRANSITION: {
+                // 予約の後に手動で切り替えた場合は取りやめ
+                if (isTransitioning || manualTempoOverride || playbackOrder.empty()) break;
+                
+                // 再生順序に従って次のシステムに切り替え
+                int nextSystem = action.value1;
+                if (nextSystem < 0) {
+                    playbackIndex = (playbackIndex + 1) % playbackOrder.size();
+                    nextSystem = playbackOrder[playbackIndex];
+                }
+                MVLOG_INFO(LOG_CATEGORY_SYSTEM, "Auto-switching to system: %d (playback index: %d, beat: %lld, BPM: %.1f, latency: %.1fms)", nextSystem, playbackIndex,
+                           (long long)action.beat, tempoEngine.getBpm(), beatScheduler.getPresentLatency() * 1000.0);
+                startTransition(nextSystem);
+                
+                // 手動オーバーライドをリセット（次の自動切替を有効に）
+                manualTempoOverride = false;
+                break;
+            }
+            case BEAT_ACTION_GLITCH:
+                // 予約の間にモノクロに切り替わった・エリアが埋まった場合は取りやめ
+                if (!isMonochromePattern && glitchAreaSystem.getActiveAreaCount() < glitchAreaSystem.getMaxAreas()) {
+                    glitchAreaSystem.triggerGlitch(action.value1);
+                }
+                break;
+            case BEAT_ACTION_IMPACT: {
+                ofxMidiMessage msg;
+                msg.status = MIDI_NOTE_ON;
+                msg.channel = 10;
+                msg.pitch = action.value1;
+                msg.velocity = action.value2;
+                msg.control = 0;
+                msg.value = 0;
+                forwardToActiveSystems(msg);
+                lastPulseBeat = (int64_t)action.beat;
+                break;
+            }
+            case BEAT_ACTION_FLASH:
+                calibrationFlashFrame = ofGetFrameNum();
+                break;
+        }
+    }
+}
+
+void ofApp::queueGlitch() {
+    // 量子化が有効でテンポが取れていれば、次のビートが画面に出るフレームに予約する
+    double displayTime = beatScheduler.getDisplayTime();
+    if (quantizeGlitches && tempoEngine.getSource(displayTime) != TEMPO_SOURCE_NONE) {
+        beatScheduler.scheduleAtBeat(BEAT_ACTION_GLITCH, std::floor(tempoEngine.getBeatPosition(displayTime)) + 1.0, 1);
+    } else {
+        glitchAreaSystem.triggerGlitch(1);
+    }
+}
+
+void ofApp::prepareUpcomingSystem() {
+    if (isTransitioning || playbackOrder.empty()) {
+        return;
+    }
+    
+    // 次の自動切替までprepareAheadBars小節を切ったら、次のシステムを準備する
+    // 切替の判定（shouldAutoSwitch）と同じ表示時刻のビート位置で数え、境界で別の枠を準備しないようにする
+    int beatsPerBar = 4;  // 4/4拍子
+    double displayBeat = getDisplayBeat();
+    double beatsUntilSwitch = getNextSwitchBeat(displayBeat) - displayBeat;
+    if (beatsUntilSwitch > prepareAheadBars * beatsPerBar) {
+        return;
+    }
+    
+    int upcoming = playbackOrder[(playbackIndex + 1) % playbackOrder.size()];
+    if (upcoming == currentSystemIndex || upcoming == systemPreparer.getSystemIndex()) {
+        return;
+    }
+    systemPreparer.start(upcoming, ensureSystem(upcoming), prewarmSeconds, simulationClock.getStepSeconds());
+}
+
 void ofApp::keyReleased(int key){}
 void ofApp::mouseMoved(int x, int y){}
 void ofApp::mouseDragged(int x, int y, int button){}
@@ -672,23 +1338,46 @@ void ofApp::mouseReleased(int x, int y, int button){}
 void ofApp::mouseEntered(int x, int y){}
 void ofApp::mouseExited(int x, int y){}
 void ofApp::windowResized(int w, int h){
+    finishPipelinedUpdates();
+    
     // グリッチシステムのFBOをリサイズ
     glitchAreaSystem.setup(w, h);
-    glitchOutputFbo.allocate(w, h, GL_RGBA32F_ARB);
+    glitchOutputFbo = RenderTargetPool::acquire(w, h, glitchAreaSystem.getInternalFormat());
+    layerCompositor.releaseTargets();
+    
+    // 準備済みのターゲットは古いサイズなので破棄（次のフレームで準備し直す）
+    systemPreparer.cancel();
     
-    // 各ビジュアルシステムのリサイズ処理（必要に応じて）
-    for (auto& system : visualSystems) {
-        // システムがリサイズ対応している場合はここで処理
+    // アクティブなシステムは新しいサイズで借り直し、古いサイズの空きを解放
+    for (VisualSystem* system : visualSystems) {
+        if (system && system->getActive()) {
+            system->setActive(false);
+            system->setActive(true);
+        }
+    }
+    RenderTargetPool::trim();
+}
+void ofApp::dragEvent(ofDragInfo dragInfo){
+    finishPipelinedUpdates();
+    
+    // セッションログ・MIDIファイルをドロップすると実時間で再生
+    for (const auto& file : dragInfo.files) {
+        string ext = ofToLower(ofFilePath::getFileExt(file));
+        bool playable = ext == "mvlog" || ext == "mid" || ext == "midi";
+        if (playable && loadMidiSession(file)) {
+            startMidiPlayback(PLAYBACK_REALTIME);
+            break;
+        }
     }
 }
-void ofApp::dragEvent(ofDragInfo dragInfo){}
 void ofApp::gotMessage(ofMessage msg){}
 
-// カスタムMIDIリスナーの実装
+// カスタムMIDIリスナーの実装（MIDIスレッドではキューに積むだけ）
+// 到着時刻はコールバックに入った直後に押す（MIDI-to-photonのレイテンシの起点）
 void DrumMidiListener::newMidiMessage(ofxMidiMessage& msg) {
-    app->onDrumMidiMessage(msg);
+    app->drumQueue.push(msg, MIDI_PORT_DRUMS, midiNowMicros());
 }
 
 void Push2MidiListener::newMidiMessage(ofxMidiMessage& msg) {
-    app->onPush2MidiMessage(msg);
+    app->push2Queue.push(msg, MIDI_PORT_PUSH2, midiNowMicros());
 }
\ No newline at end of file
@@ -4,18 +4,24 @@
 #include <sstream>  // ofxMidiのコンパイルエラー対策
 #include "ofxMidi.h"
 #include "VisualSystem.h"
-#include "ParticleSystem.h"
-#include "FractalSystem.h"
-#include "WaveSystem.h"
-#include "FlowFieldSystem.h"
-#include "LSystemSystem.h"
-#include "PerlinFlowSystem.h"
-#include "CurlNoiseSystem.h"
-#include "InfiniteCorridorSystem.h"
-#include "BuildingPerspectiveSystem.h"
-#include "WaterRippleSystem.h"
-#include "SandParticleSystem.h"
+#include "SystemRegistry.h"
+#include "SystemLoader.h"
 #include "GlitchAreaSystem.h"
+#include "LayerCompositor.h"
+#include "MidiEventQueue.h"
+#include "MidiSession.h"
+#include "OfflineRenderer.h"
+#include "QualityGovernor.h"
+#include "SystemPreparer.h"
+#include "PipelinedSystem.h"
+#include "SimulationPipeline.h"
+#include "WorkerPool.h"
+#include "FixedTimestep.h"
+#include "FrameProfiler.h"
+#include "AsyncLog.h"
+#include "TempoEngine.h"
+#include "BeatScheduler.h"
+#include "MidiLatencyTracker.h"
 #include <memory>
 
 // 前方宣言
@@ -57,17 +63,42 @@ public:
     void gotMessage(ofMessage msg);
     
     void newMidiMessage(ofxMidiMessage& eventArgs);  // デフォルトMIDIコールバック
-    void onDrumMidiMessage(ofxMidiMessage& msg);     // ドラムMIDI処理
-    void onPush2MidiMessage(ofxMidiMessage& msg);    // Push2 MIDI処理
+    void processMidiQueues();                        // キューのドレインとディスパッチ（メインスレッド）
+    void onDrumMidiMessage(ofxMidiMessage& msg, double eventTime);   // ドラムMIDI処理
+    void onPush2MidiMessage(ofxMidiMessage& msg, double eventTime);  // Push2 MIDI処理
     void drawUI();
     void switchToSystem(int systemIndex);
     void startTransition(int targetSystemIndex);
     void updateTransition(float deltaTime);
     void drawTransition();
-    void updateTempoTracking(float currentTime);
-    void calculateBPM();
+    void drawSystemLayer(int systemIndex, float opacity);   // システムをコンポジタのレイヤーに描く
     bool shouldAutoSwitch();
     void handleAutoSwitch();
+    int64_t getNextSwitchBeat(double beat) const;
+    double getDisplayBeat() const;   // このフレームが画面に出る時刻のビート位置（自動切替と準備で共通）
+    void scheduleBeatPulse();
+    void runBeatActions();      // このフレームが画面に出る時刻にビートが来るアクションを実行
+    void queueGlitch();         // 量子化が有効なら次のビートに予約、そうでなければ即座に
+    void forwardToActiveSystems(ofxMidiMessage& msg);
+    void prepareUpcomingSystem();
+    void selectSystem(int systemIndex);      // キーでの直接切替（再生位置も合わせる）
+    
+    // ビジュアルシステムの遅延構築
+    VisualSystem* ensureSystem(int systemIndex);   // 未構築ならここで作る（ロード中なら待つ）
+    void adoptLoadedSystems();                     // バックグラウンドで準備できたシステムを取り込む
+    
+    // MIDIセッションの録音・再生
+    void toggleMidiRecording();
+    bool loadMidiSession(const string& path);
+    void startMidiPlayback(MidiPlaybackMode mode);
+    void seekMidiPlayback(float offsetSeconds);
+    void finishMidiPlayback();
+    
+    // 詳細度（品質ガバナー）
+    void applyDetailBudgets();
+    
+    // シミュレーションのワーカー完了待ちとスナップショットの公開
+    void finishPipelinedUpdates();
     
     // 複数MIDI入力（同時受信）
     ofxMidiIn midiInDrums;    // IAC ドライバー用（ドラムMIDI）
@@ -75,6 +106,28 @@ public:
     std::vector<ofxMidiMessage> midiMessages;
     std::size_t maxMessages = 10;
     
+    // MIDIスレッド → フレームループ間のロックフリーキュー（ポートごと）
+    MidiEventQueue drumQueue;
+    MidiEventQueue push2Queue;
+    std::vector<MidiEvent> drainedMidiEvents;   // ドレイン用（再確保しない）
+    std::vector<MidiEvent> orderedMidiEvents;   // タイムスタンプ順にマージした結果
+    MidiLatencyTracker latencyTracker;          // 到着からバッファ入れ替えまでのレイテンシ（ライブ入力のみ）
+    
+    // MIDIセッションの録音・再生
+    MidiSessionRecorder midiRecorder;
+    MidiSessionPlayer midiPlayer;
+    string sessionPath = "";                    // 最後に録音・読み込みしたログ
+    double playbackOriginTime = 0.0;            // 再生開始時のシミュレーション時刻（テンポ推定に渡すので倍精度）
+    float playbackDeltaTime = 1.0f / 60.0f;     // 高速再生時の固定dt
+    float playbackTailSeconds = 4.0f;           // 曲の終わりの後も再生・書き出しを続ける秒数（起動引数 --tail）
+    uint64_t playbackWallStartMicros = 0;
+    std::vector<float> playbackFrameTimes;      // 高速再生中のフレーム時間
+    bool startupPlaybackFast = false;           // 起動引数 --play/--fast
+    
+    // オフラインレンダー（起動引数 --render、固定dtで再生しながら合成結果を書き出す）
+    OfflineRenderer offlineRenderer;
+    string renderOutputPath = "";
+    
     // カスタムMIDIリスナー
     std::unique_ptr<DrumMidiListener> drumListener;
     std::unique_ptr<Push2MidiListener> push2Listener;
@@ -85,9 +138,13 @@ public:
     string drumPortName = "";
     string push2PortName = "";
     
-    // ビジュアルシステム
-    std::vector<std::unique_ptr<VisualSystem>> visualSystems;
+    // ビジュアルシステム（SystemRegistryのライブ用の並び。実体はsystemLoaderが持ち、準備できるまでnullptr）
+    std::vector<VisualSystem*> visualSystems;
+    SystemLoader systemLoader;
     int currentSystemIndex = 0;
+    bool eagerSystemSetup = false;      // 起動引数 --eager-setup で、起動時にすべて描画スレッドで作る（従来どおり）
+    uint64_t setupStartMicros = 0;      // 起動から最初のフレームまでの計測
+    bool firstFrameLogged = false;
     
     // クロスフェード機能
     bool isTransitioning = false;
@@ -95,17 +152,30 @@ public:
     float transitionDuration = 4.0f;  // 4秒間のゆったりクロスフェード
     float transitionStartTime = 0.0f;
     float transitionProgress = 0.0f;
+    LayerCompositor layerCompositor;  // クロスフェード中は各システムを別のターゲットに描いて合成
     
     // MIDIテンポ同期
-    float bpm = 120.0f;  // デフォルトBPM
-    float lastBeatTime = 0.0f;
-    int beatCount = 0;
+    TempoEngine tempoEngine;  // キック・MIDIクロックからのBPMとビート位置
     bool autoSwitchEnabled = true;
     int barsPerSwitch = 8;  // 8小節ごとに切替
-    float timingAccumulator = 0.0f;
-    std::vector<float> recentBeatIntervals;
+    int64_t lastAutoSwitchBeat = -1;  // 同じビートで2度切り替えない
     bool manualTempoOverride = false;
     
+    // ビートに量子化したアクション（表示までの遅延を見込んで、ビートの瞬間に画面に出す）
+    BeatScheduler beatScheduler;      // 起動引数 --display-offset MS で校正値を指定
+    std::array<BeatAction, BeatScheduler::CAPACITY> dueBeatActions;
+    bool quantizeGlitches = false;    // Bキー: Push2・Gキーのグリッチを次のビートに合わせる
+    bool beatPulseEnabled = false;    // Kキー: キックの反応を予測したビートに合わせて先に出す
+    int64_t lastScheduledPulseBeat = -1;
+    int64_t lastPulseBeat = -1;       // 予測で反応させたビート（そのビートの実際のキックはシステムに送らない）
+    int lastKickVelocity = 100;
+    uint64_t calibrationFlashFrame = 0;
+    
+    // 次のシステムの事前準備（ターゲット確保＋固定dtでの温め）
+    SystemPreparer systemPreparer;
+    int prepareAheadBars = 2;         // 自動切替の何小節前から準備するか
+    float prewarmSeconds = 4.0f;      // 温める時間（クロスフェードの長さと同じ）
+    
     // レガシー用（デバッグ表示）
     int currentNote = 0;
     int currentVelocity = 0;
@@ -113,6 +183,8 @@ public:
     
     // UI
     bool showUI = true;
+    bool showProfiler = false;   // Oキーで切替、Tキーで記録を書き出し
+    bool showLatency = false;    // Mキーで切替（Tキーでlatency_*.csvも書き出す）
     float uiFadeAlpha = 255;
     float lastActivityTime = 0;
     
@@ -120,13 +192,39 @@ public:
     bool isMonochromePattern = false;  // 現在のパターンがモノクロかどうか
     int patternCount = 0;              // パターンの通し番号
     
+    // 品質ガバナー（システムごとの詳細度をフレーム予算に合わせて調整）
+    QualityGovernor qualityGovernor;
+    std::size_t glitchGovernorEntry = 0;    // グリッチのエントリ番号（ビジュアルシステムの後ろ）
+    bool autoQuality = true;                // Qキーで切替
+    float fixedDetailBudget = 0.0f;         // 起動引数 --detail（0なら自動）
+    uint64_t updateWorkMicros = 0;
+    bool detailBudgetsChanged = false;      // 次のフレーム境界で反映する
+    
+    // シミュレーションと描画のパイプライン（分離済みのシステムの更新をワーカーで回す）
+    SimulationPipeline simulationPipeline;
+    std::vector<SimulationPipeline::Job> pipelineJobs;
+    std::vector<SimulationPipeline::Job> serialJobs;   // 描画スレッドで更新するシステム
+    WorkerPool updatePool;                  // クロスフェード中の2システムを並列に更新
+    bool pipelinedUpdate = true;            // 起動引数 --serial-update で無効
+    uint64_t pipelineWorkMicros = 0;
+    uint64_t pipelineWallMicros = 0;
+    uint64_t pipelineWaitMicros = 0;
+    float pipelineRenderAlpha = 1.0f;       // ワーカーに投げたステップ列の補間の割合（公開後の描画で使う）
+    float crossfadeSpeedup = 0.0f;          // クロスフェード中の更新の並列化率（UI表示）
+    
+    // 固定ステップのシミュレーション（起動引数 --sim-rate HZ, --max-substeps N）
+    FixedTimestep simulationClock;
+    float simulationRate = FixedTimestep::DEFAULT_RATE;
+    int maxSimulationSubsteps = FixedTimestep::DEFAULT_MAX_SUBSTEPS;
+    
     // システムの再生順序マッピング
     std::vector<int> playbackOrder;     // 実際の再生順序
+    string playbackOrderPath = "";      // 起動引数 --playback-order FILE（既定はdata/playback_order.txt があれば）
     int playbackIndex = 0;             // 現在の再生位置
     
     // グリッチシステム
     GlitchAreaSystem glitchAreaSystem;
-    ofFbo glitchOutputFbo;
+    RenderTarget glitchOutputFbo;  // 合成用（レンダーターゲットプールから常時借りる）
     float lastGlitchTime = 0.0f;
     float glitchCooldown = 2.0f;  // 2.0秒のクールダウンに拡大（安全性最優先）
     bool glitchSystemBusy = false;  // グリッチシステムのビジー状態